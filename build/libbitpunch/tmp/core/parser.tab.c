@@ -0,0 +1,3020 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 32 "libbitpunch/src/core/parser.y"
+
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdarg.h>
+#include <stddef.h>
+
+#include "core/parser.h"
+
+  
+
+#line 85 "build/libbitpunch/tmp/core/parser.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "parser.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_TOK_ERROR = 3,                  /* TOK_ERROR  */
+  YYSYMBOL_IDENTIFIER = 4,                 /* IDENTIFIER  */
+  YYSYMBOL_INTEGER = 5,                    /* INTEGER  */
+  YYSYMBOL_LITERAL = 6,                    /* LITERAL  */
+  YYSYMBOL_KW_TRUE = 7,                    /* KW_TRUE  */
+  YYSYMBOL_KW_FALSE = 8,                   /* KW_FALSE  */
+  YYSYMBOL_KW_IF = 9,                      /* KW_IF  */
+  YYSYMBOL_KW_ELSE = 10,                   /* KW_ELSE  */
+  YYSYMBOL_KW_SELF = 11,                   /* KW_SELF  */
+  YYSYMBOL_KW_LET = 12,                    /* KW_LET  */
+  YYSYMBOL_KW_EXTERN = 13,                 /* KW_EXTERN  */
+  YYSYMBOL_14_ = 14,                       /* '|'  */
+  YYSYMBOL_15_ = 15,                       /* '^'  */
+  YYSYMBOL_16_ = 16,                       /* '&'  */
+  YYSYMBOL_17_ = 17,                       /* '>'  */
+  YYSYMBOL_18_ = 18,                       /* '<'  */
+  YYSYMBOL_19_ = 19,                       /* '+'  */
+  YYSYMBOL_20_ = 20,                       /* '-'  */
+  YYSYMBOL_21_ = 21,                       /* '*'  */
+  YYSYMBOL_22_ = 22,                       /* '/'  */
+  YYSYMBOL_23_ = 23,                       /* '%'  */
+  YYSYMBOL_24_ = 24,                       /* '!'  */
+  YYSYMBOL_25_ = 25,                       /* '~'  */
+  YYSYMBOL_26_ = 26,                       /* '.'  */
+  YYSYMBOL_27_ = 27,                       /* ':'  */
+  YYSYMBOL_TOK_LOR = 28,                   /* "||"  */
+  YYSYMBOL_TOK_LAND = 29,                  /* "&&"  */
+  YYSYMBOL_TOK_EQ = 30,                    /* "=="  */
+  YYSYMBOL_TOK_NE = 31,                    /* "!="  */
+  YYSYMBOL_TOK_GE = 32,                    /* ">="  */
+  YYSYMBOL_TOK_LE = 33,                    /* "<="  */
+  YYSYMBOL_TOK_LSHIFT = 34,                /* "<<"  */
+  YYSYMBOL_TOK_RSHIFT = 35,                /* ">>"  */
+  YYSYMBOL_TOK_RANGE = 36,                 /* ".."  */
+  YYSYMBOL_TOK_FILTER = 37,                /* "<>"  */
+  YYSYMBOL_TOK_SCOPE = 38,                 /* "::"  */
+  YYSYMBOL_OP_SIZEOF = 39,                 /* OP_SIZEOF  */
+  YYSYMBOL_OP_ARITH_UNARY_OP = 40,         /* OP_ARITH_UNARY_OP  */
+  YYSYMBOL_OP_ARRAY_DECL = 41,             /* OP_ARRAY_DECL  */
+  YYSYMBOL_OP_SUBSCRIPT = 42,              /* OP_SUBSCRIPT  */
+  YYSYMBOL_OP_FCALL = 43,                  /* OP_FCALL  */
+  YYSYMBOL_START_SCHEMA = 44,              /* START_SCHEMA  */
+  YYSYMBOL_START_EXPR = 45,                /* START_EXPR  */
+  YYSYMBOL_46_ = 46,                       /* '['  */
+  YYSYMBOL_47_ = 47,                       /* ']'  */
+  YYSYMBOL_48_ = 48,                       /* '('  */
+  YYSYMBOL_49_ = 49,                       /* ')'  */
+  YYSYMBOL_50_ = 50,                       /* '{'  */
+  YYSYMBOL_51_ = 51,                       /* '}'  */
+  YYSYMBOL_52_ = 52,                       /* ','  */
+  YYSYMBOL_53_ = 53,                       /* '='  */
+  YYSYMBOL_54_ = 54,                       /* ';'  */
+  YYSYMBOL_YYACCEPT = 55,                  /* $accept  */
+  YYSYMBOL_start = 56,                     /* start  */
+  YYSYMBOL_g_integer = 57,                 /* g_integer  */
+  YYSYMBOL_g_boolean = 58,                 /* g_boolean  */
+  YYSYMBOL_g_identifier = 59,              /* g_identifier  */
+  YYSYMBOL_g_self = 60,                    /* g_self  */
+  YYSYMBOL_g_literal = 61,                 /* g_literal  */
+  YYSYMBOL_start_expr = 62,                /* start_expr  */
+  YYSYMBOL_expr = 63,                      /* expr  */
+  YYSYMBOL_opt_expr = 64,                  /* opt_expr  */
+  YYSYMBOL_key_expr = 65,                  /* key_expr  */
+  YYSYMBOL_opt_key_expr = 66,              /* opt_key_expr  */
+  YYSYMBOL_opt_twin_index = 67,            /* opt_twin_index  */
+  YYSYMBOL_twin_index = 68,                /* twin_index  */
+  YYSYMBOL_func_params = 69,               /* func_params  */
+  YYSYMBOL_func_param_nonempty_list = 70,  /* func_param_nonempty_list  */
+  YYSYMBOL_func_param = 71,                /* func_param  */
+  YYSYMBOL_schema = 72,                    /* schema  */
+  YYSYMBOL_scope_block = 73,               /* scope_block  */
+  YYSYMBOL_filter_block = 74,              /* filter_block  */
+  YYSYMBOL_if_block = 75,                  /* if_block  */
+  YYSYMBOL_opt_else_block = 76,            /* opt_else_block  */
+  YYSYMBOL_else_block = 77,                /* else_block  */
+  YYSYMBOL_block_stmt_list = 78,           /* block_stmt_list  */
+  YYSYMBOL_attribute_stmt = 79,            /* attribute_stmt  */
+  YYSYMBOL_let_stmt = 80,                  /* let_stmt  */
+  YYSYMBOL_extern_stmt = 81                /* extern_stmt  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+/* Unqualified %code blocks.  */
+#line 525 "libbitpunch/src/core/parser.y"
+
+    const int SPAN_SIZE_UNDEF = (int64_t)-1;
+
+    struct ast_node_hdl *
+    ast_node_hdl_new(void) {
+        struct ast_node_hdl *nhdl;
+
+        nhdl = new_safe(struct ast_node_hdl);
+        dep_resolver_node_init(&nhdl->dr_node);
+        return nhdl;
+    }
+
+    void
+    init_block_stmt_list(struct block_stmt_list *dst)
+    {
+        memset(dst, 0, sizeof (*dst));
+        dst->field_list = new_safe(struct statement_list);
+        dst->named_expr_list = new_safe(struct statement_list);
+        dst->attribute_list = new_safe(struct statement_list);
+        TAILQ_INIT(dst->field_list);
+        TAILQ_INIT(dst->named_expr_list);
+        TAILQ_INIT(dst->attribute_list);
+    }
+
+    struct ast_node_hdl *
+    ast_node_hdl_create(enum ast_node_type type,
+                        const struct parser_location *loc)
+    {
+        struct ast_node_hdl *nhdl;
+
+        nhdl = ast_node_hdl_new();
+        if (NULL != loc) {
+            nhdl->loc = *loc;
+        }
+        nhdl->ndat = new_safe(struct ast_node_data);
+        nhdl->ndat->type = type;
+        return nhdl;
+    }
+    
+    struct ast_node_hdl *
+    ast_node_hdl_create_scope(const struct parser_location *loc)
+    {
+        struct ast_node_hdl *scope_node;
+
+        scope_node = ast_node_hdl_create(AST_NODE_TYPE_SCOPE_DEF, loc);
+        init_block_stmt_list(&scope_node->ndat->u.scope_def.block_stmt_list);
+
+        return scope_node;
+    }
+
+    static struct ast_node_hdl *
+    expr_gen_ast_node(enum ast_node_type op_type,
+                      struct ast_node_hdl *opd1,
+                      struct ast_node_hdl *opd2,
+                      const struct parser_location *loc)
+    {
+        struct ast_node_hdl *nhdl;
+
+        nhdl = ast_node_hdl_create(op_type, loc);
+        nhdl->ndat->u.op.operands[0] = opd1;
+        nhdl->ndat->u.op.operands[1] = opd2;
+        return nhdl;
+    }
+
+    static int
+    merge_block_stmt_list(struct block_stmt_list *dst,
+                          struct block_stmt_list *src)
+    {
+        TAILQ_CONCAT(dst->field_list, src->field_list, list);
+        TAILQ_CONCAT(dst->named_expr_list, src->named_expr_list, list);
+        TAILQ_CONCAT(dst->attribute_list, src->attribute_list, list);
+        return 0;
+    }
+
+    static void
+    attach_outer_conditional(struct ast_node_hdl **inner_condp,
+                             struct ast_node_hdl *outer_cond)
+    {
+        struct ast_node_hdl **condp;
+
+        for (condp = inner_condp;
+             NULL != *condp && *condp != outer_cond;
+             condp = &(*condp)->ndat->u.conditional.outer_cond)
+            ;
+        if (NULL == *condp) {
+            *condp = outer_cond;
+        }
+    }
+
+    static void
+    attribute_list_push(struct statement_list *attribute_list,
+                        const char *attr_name, struct parser_location *loc,
+                        struct ast_node_hdl *attr_expr)
+    {
+        struct named_expr *attr;
+
+        attr = new_safe(struct named_expr);
+        if (NULL != loc) {
+            attr->nstmt.stmt.loc = *loc;
+        }
+        attr->nstmt.name = strdup_safe(attr_name);
+        attr->expr = attr_expr;
+        TAILQ_INSERT_TAIL(attribute_list, (struct statement *)attr, list);
+    }
+ 
+
+#line 308 "build/libbitpunch/tmp/core/parser.tab.c"
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* 1 */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL \
+             && defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+  YYLTYPE yyls_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE) \
+             + YYSIZEOF (YYLTYPE)) \
+      + 2 * YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  31
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   872
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  55
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  27
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  83
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  149
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   286
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    24,     2,     2,     2,    23,    16,     2,
+      48,    49,    21,    19,    52,    20,    26,    22,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    27,    54,
+      18,    53,    17,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,    46,     2,    47,    15,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    50,    14,    51,    25,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    28,
+      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,    40,    41,    42,    43,    44,    45
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   695,   695,   696,   700,   705,   709,   714,   719,   723,
+     728,   739,   744,   745,   746,   747,   748,   749,   750,   751,
+     754,   757,   760,   763,   766,   769,   772,   775,   778,   781,
+     784,   787,   790,   793,   796,   799,   802,   805,   808,   811,
+     814,   817,   820,   823,   826,   830,   834,   838,   841,   847,
+     855,   860,   863,   883,   886,   889,   896,   899,   902,   905,
+     908,   913,   917,   922,   927,   933,   939,   947,   955,   962,
+     970,  1007,  1010,  1015,  1018,  1023,  1026,  1042,  1048,  1054,
+    1062,  1068,  1076,  1084
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "TOK_ERROR",
+  "IDENTIFIER", "INTEGER", "LITERAL", "KW_TRUE", "KW_FALSE", "KW_IF",
+  "KW_ELSE", "KW_SELF", "KW_LET", "KW_EXTERN", "'|'", "'^'", "'&'", "'>'",
+  "'<'", "'+'", "'-'", "'*'", "'/'", "'%'", "'!'", "'~'", "'.'", "':'",
+  "\"||\"", "\"&&\"", "\"==\"", "\"!=\"", "\">=\"", "\"<=\"", "\"<<\"",
+  "\">>\"", "\"..\"", "\"<>\"", "\"::\"", "OP_SIZEOF", "OP_ARITH_UNARY_OP",
+  "OP_ARRAY_DECL", "OP_SUBSCRIPT", "OP_FCALL", "START_SCHEMA",
+  "START_EXPR", "'['", "']'", "'('", "')'", "'{'", "'}'", "','", "'='",
+  "';'", "$accept", "start", "g_integer", "g_boolean", "g_identifier",
+  "g_self", "g_literal", "start_expr", "expr", "opt_expr", "key_expr",
+  "opt_key_expr", "opt_twin_index", "twin_index", "func_params",
+  "func_param_nonempty_list", "func_param", "schema", "scope_block",
+  "filter_block", "if_block", "opt_else_block", "else_block",
+  "block_stmt_list", "attribute_stmt", "let_stmt", "extern_stmt", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-49)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+     -36,   -49,   264,     6,   -49,   228,   -20,   -49,   -49,   -49,
+     -49,   -49,   264,   264,   264,   264,   264,   264,   264,   264,
+     264,   -49,   -49,   -49,   -49,   -49,    25,   -49,   607,   -49,
+     -49,   -49,   -22,    -4,    41,    43,   337,   -49,   -49,   -49,
+     -49,   -49,   116,   116,   116,   116,   116,   116,   116,   607,
+       1,   535,    84,   -49,   264,   264,   264,   264,   264,   264,
+     264,   264,   264,   264,    46,   264,   264,   264,   264,   264,
+     264,   264,   264,   264,    35,   264,   300,   264,   264,     9,
+      23,   -49,   264,   -49,   -49,   711,     3,   743,   796,   796,
+     824,   824,   116,   116,   116,   -49,   -49,   642,   677,   775,
+     775,   796,   796,   817,   817,   120,   -49,   -49,   498,   -49,
+      36,   -46,   607,    29,    27,   -49,   378,   571,   264,   -49,
+     120,   264,   -49,   -49,   264,   -49,   264,   -49,   300,   -49,
+      31,   419,   460,    37,   607,   -49,   -49,   -49,   -49,   -49,
+     132,    72,    -7,   -49,   -49,   -49,   -49,   180,   -49
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       0,    75,     0,     0,     2,    67,     7,     4,     9,     5,
+       6,     8,     0,     0,     0,     0,     0,     0,     0,    53,
+       0,    75,    12,    13,    14,    16,    15,     3,    11,    17,
+      18,     1,     7,     0,     0,     0,     0,    79,    76,    77,
+      78,    69,    25,    24,    19,    20,    21,    22,    23,    54,
+       0,     0,     0,    10,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,    56,    61,     0,     0,     0,
+       0,    81,     0,    51,    68,    28,    29,    30,    33,    34,
+      39,    40,    41,    42,    43,     7,    44,    26,    27,    31,
+      32,    35,    36,    37,    38,    47,    45,    46,    58,    57,
+       0,     7,    66,     0,    62,    63,     0,     0,     0,    83,
+      52,     0,    55,    59,    56,    48,     0,    50,     0,    80,
+       0,     0,     0,     0,    65,    64,    75,    82,    60,    49,
+       0,    71,     0,    70,    72,    75,    74,     0,    73
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -49,   -49,   -49,   -49,   -32,    11,   -49,   -49,    -2,   -49,
+     -49,   -38,   -49,   -49,   -49,   -49,   -41,   -49,    -5,   -49,
+     -48,   -49,   -49,   -18,   -49,   -49,   -49
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
+{
+       0,     3,    22,    23,    24,    25,    26,    27,    36,    50,
+     109,   110,   122,   123,   113,   114,   115,     4,    29,    30,
+      37,   143,   144,     5,    38,    39,    40
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_uint8 yytable[] =
+{
+      28,    41,    33,    52,    21,    77,    31,   126,     1,     2,
+      42,    43,    44,    45,    46,    47,    48,    49,    51,    56,
+      57,    58,    59,    60,    61,    62,    63,    41,    21,    64,
+      21,    53,    96,    67,    68,    69,    70,    71,    72,    95,
+      73,    74,   106,   145,    78,    79,    11,    80,    82,    75,
+      95,    76,    85,    86,    87,    88,    89,    90,    91,    92,
+      93,    94,   118,    97,    98,    99,   100,   101,   102,   103,
+     104,   105,   124,   108,   112,   116,   117,   119,   127,   128,
+     120,   136,   142,   125,   139,   107,   133,   135,    32,     7,
+       8,     9,    10,    33,   146,    11,    34,    35,     0,    12,
+      13,     0,     0,    14,    15,     0,    41,     0,    16,    17,
+       0,     0,     0,     0,     0,     0,   131,     0,   140,   132,
+       0,     0,   108,    18,   134,     0,   112,   147,     0,     0,
+      19,     0,    20,     0,    21,    84,    32,     7,     8,     9,
+      10,    33,    64,    11,    34,    35,    64,    12,    13,     0,
+       0,    14,    15,    73,    74,     0,    16,    17,    74,     0,
+       0,     0,    75,     0,    76,     0,    75,     0,    76,     0,
+       0,    18,     0,     0,     0,     0,     0,     0,    19,     0,
+      20,     0,    21,   141,    32,     7,     8,     9,    10,    33,
+       0,    11,    34,    35,     0,    12,    13,     0,     0,    14,
+      15,     0,     0,     0,    16,    17,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    18,
+       0,     0,     0,     0,     0,     0,    19,     0,    20,     0,
+      21,   148,    32,     7,     8,     9,    10,    33,     0,    11,
+      34,    35,     0,    12,    13,     0,     0,    14,    15,     0,
+       0,     0,    16,    17,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,    18,     6,     7,
+       8,     9,    10,     0,    19,    11,    20,     0,    21,    12,
+      13,     0,     0,    14,    15,     0,     0,     0,    16,    17,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,    18,   111,     7,     8,     9,    10,     0,
+      19,    11,    20,     0,    21,    12,    13,     0,     0,    14,
+      15,     0,     0,     0,    16,    17,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    18,
+       0,     0,     0,     0,     0,     0,    19,     0,    20,     0,
+      21,    54,    55,    56,    57,    58,    59,    60,    61,    62,
+      63,     0,     0,    64,     0,    65,    66,    67,    68,    69,
+      70,    71,    72,     0,    73,    74,     0,     0,     0,     0,
+       0,     0,     0,    75,     0,    76,     0,     0,     0,     0,
+       0,    81,    54,    55,    56,    57,    58,    59,    60,    61,
+      62,    63,     0,     0,    64,     0,    65,    66,    67,    68,
+      69,    70,    71,    72,     0,    73,    74,     0,     0,     0,
+       0,     0,     0,     0,    75,     0,    76,     0,     0,     0,
+       0,     0,   129,    54,    55,    56,    57,    58,    59,    60,
+      61,    62,    63,     0,     0,    64,     0,    65,    66,    67,
+      68,    69,    70,    71,    72,     0,    73,    74,     0,     0,
+       0,     0,     0,     0,     0,    75,     0,    76,     0,     0,
+       0,     0,     0,   137,    54,    55,    56,    57,    58,    59,
+      60,    61,    62,    63,     0,     0,    64,     0,    65,    66,
+      67,    68,    69,    70,    71,    72,     0,    73,    74,     0,
+       0,     0,     0,     0,     0,     0,    75,     0,    76,     0,
+       0,   138,    54,    55,    56,    57,    58,    59,    60,    61,
+      62,    63,     0,     0,    64,     0,    65,    66,    67,    68,
+      69,    70,    71,    72,     0,    73,    74,     0,     0,     0,
+       0,     0,     0,     0,    75,     0,    76,     0,   121,    54,
+      55,    56,    57,    58,    59,    60,    61,    62,    63,     0,
+       0,    64,     0,    65,    66,    67,    68,    69,    70,    71,
+      72,     0,    73,    74,     0,     0,     0,     0,     0,     0,
+       0,    75,     0,    76,    83,    54,    55,    56,    57,    58,
+      59,    60,    61,    62,    63,     0,     0,    64,     0,    65,
+      66,    67,    68,    69,    70,    71,    72,     0,    73,    74,
+       0,     0,     0,     0,     0,     0,     0,    75,     0,    76,
+     130,    54,    55,    56,    57,    58,    59,    60,    61,    62,
+      63,     0,     0,    64,     0,    65,    66,    67,    68,    69,
+      70,    71,    72,     0,    73,    74,     0,     0,     0,     0,
+       0,     0,     0,    75,     0,    76,    54,    55,    56,    57,
+      58,    59,    60,    61,    62,    63,     0,     0,    64,     0,
+       0,    66,    67,    68,    69,    70,    71,    72,     0,    73,
+      74,     0,     0,     0,     0,     0,     0,     0,    75,     0,
+      76,    54,    55,    56,    57,    58,    59,    60,    61,    62,
+      63,     0,     0,    64,     0,     0,     0,    67,    68,    69,
+      70,    71,    72,     0,    73,    74,     0,     0,     0,     0,
+       0,     0,     0,    75,     0,    76,    55,    56,    57,    58,
+      59,    60,    61,    62,    63,     0,     0,    64,     0,     0,
+       0,    67,    68,    69,    70,    71,    72,     0,    73,    74,
+       0,     0,     0,     0,     0,     0,     0,    75,     0,    76,
+      57,    58,    59,    60,    61,    62,    63,     0,     0,    64,
+       0,     0,     0,    67,    68,    69,    70,    71,    72,     0,
+      73,    74,     0,     0,     0,     0,     0,     0,     0,    75,
+       0,    76,    57,    58,    59,    60,    61,    62,    63,     0,
+       0,    64,     0,     0,     0,     0,     0,    69,    70,    71,
+      72,     0,    73,    74,     0,    59,    60,    61,    62,    63,
+       0,    75,    64,    76,     0,     0,     0,     0,     0,     0,
+      71,    72,     0,    73,    74,     0,    59,    60,    61,    62,
+      63,     0,    75,    64,    76,    61,    62,    63,     0,     0,
+      64,     0,     0,     0,    73,    74,     0,     0,     0,     0,
+       0,    73,    74,    75,     0,    76,     0,     0,     0,     0,
+      75,     0,    76
+};
+
+static const yytype_int16 yycheck[] =
+{
+       2,     6,     9,    21,    50,    27,     0,    53,    44,    45,
+      12,    13,    14,    15,    16,    17,    18,    19,    20,    16,
+      17,    18,    19,    20,    21,    22,    23,    32,    50,    26,
+      50,     6,    64,    30,    31,    32,    33,    34,    35,     4,
+      37,    38,    74,    50,    48,     4,    11,     4,    47,    46,
+       4,    48,    54,    55,    56,    57,    58,    59,    60,    61,
+      62,    63,    53,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    36,    75,    76,    77,    78,    54,    49,    52,
+      82,    50,    10,    47,    47,    74,   124,   128,     4,     5,
+       6,     7,     8,     9,   142,    11,    12,    13,    -1,    15,
+      16,    -1,    -1,    19,    20,    -1,   111,    -1,    24,    25,
+      -1,    -1,    -1,    -1,    -1,    -1,   118,    -1,   136,   121,
+      -1,    -1,   124,    39,   126,    -1,   128,   145,    -1,    -1,
+      46,    -1,    48,    -1,    50,    51,     4,     5,     6,     7,
+       8,     9,    26,    11,    12,    13,    26,    15,    16,    -1,
+      -1,    19,    20,    37,    38,    -1,    24,    25,    38,    -1,
+      -1,    -1,    46,    -1,    48,    -1,    46,    -1,    48,    -1,
+      -1,    39,    -1,    -1,    -1,    -1,    -1,    -1,    46,    -1,
+      48,    -1,    50,    51,     4,     5,     6,     7,     8,     9,
+      -1,    11,    12,    13,    -1,    15,    16,    -1,    -1,    19,
+      20,    -1,    -1,    -1,    24,    25,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    39,
+      -1,    -1,    -1,    -1,    -1,    -1,    46,    -1,    48,    -1,
+      50,    51,     4,     5,     6,     7,     8,     9,    -1,    11,
+      12,    13,    -1,    15,    16,    -1,    -1,    19,    20,    -1,
+      -1,    -1,    24,    25,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    39,     4,     5,
+       6,     7,     8,    -1,    46,    11,    48,    -1,    50,    15,
+      16,    -1,    -1,    19,    20,    -1,    -1,    -1,    24,    25,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    39,     4,     5,     6,     7,     8,    -1,
+      46,    11,    48,    -1,    50,    15,    16,    -1,    -1,    19,
+      20,    -1,    -1,    -1,    24,    25,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    39,
+      -1,    -1,    -1,    -1,    -1,    -1,    46,    -1,    48,    -1,
+      50,    14,    15,    16,    17,    18,    19,    20,    21,    22,
+      23,    -1,    -1,    26,    -1,    28,    29,    30,    31,    32,
+      33,    34,    35,    -1,    37,    38,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    46,    -1,    48,    -1,    -1,    -1,    -1,
+      -1,    54,    14,    15,    16,    17,    18,    19,    20,    21,
+      22,    23,    -1,    -1,    26,    -1,    28,    29,    30,    31,
+      32,    33,    34,    35,    -1,    37,    38,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    46,    -1,    48,    -1,    -1,    -1,
+      -1,    -1,    54,    14,    15,    16,    17,    18,    19,    20,
+      21,    22,    23,    -1,    -1,    26,    -1,    28,    29,    30,
+      31,    32,    33,    34,    35,    -1,    37,    38,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    46,    -1,    48,    -1,    -1,
+      -1,    -1,    -1,    54,    14,    15,    16,    17,    18,    19,
+      20,    21,    22,    23,    -1,    -1,    26,    -1,    28,    29,
+      30,    31,    32,    33,    34,    35,    -1,    37,    38,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    46,    -1,    48,    -1,
+      -1,    51,    14,    15,    16,    17,    18,    19,    20,    21,
+      22,    23,    -1,    -1,    26,    -1,    28,    29,    30,    31,
+      32,    33,    34,    35,    -1,    37,    38,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    46,    -1,    48,    -1,    50,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    -1,
+      -1,    26,    -1,    28,    29,    30,    31,    32,    33,    34,
+      35,    -1,    37,    38,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    46,    -1,    48,    49,    14,    15,    16,    17,    18,
+      19,    20,    21,    22,    23,    -1,    -1,    26,    -1,    28,
+      29,    30,    31,    32,    33,    34,    35,    -1,    37,    38,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    46,    -1,    48,
+      49,    14,    15,    16,    17,    18,    19,    20,    21,    22,
+      23,    -1,    -1,    26,    -1,    28,    29,    30,    31,    32,
+      33,    34,    35,    -1,    37,    38,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    46,    -1,    48,    14,    15,    16,    17,
+      18,    19,    20,    21,    22,    23,    -1,    -1,    26,    -1,
+      -1,    29,    30,    31,    32,    33,    34,    35,    -1,    37,
+      38,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    46,    -1,
+      48,    14,    15,    16,    17,    18,    19,    20,    21,    22,
+      23,    -1,    -1,    26,    -1,    -1,    -1,    30,    31,    32,
+      33,    34,    35,    -1,    37,    38,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    46,    -1,    48,    15,    16,    17,    18,
+      19,    20,    21,    22,    23,    -1,    -1,    26,    -1,    -1,
+      -1,    30,    31,    32,    33,    34,    35,    -1,    37,    38,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    46,    -1,    48,
+      17,    18,    19,    20,    21,    22,    23,    -1,    -1,    26,
+      -1,    -1,    -1,    30,    31,    32,    33,    34,    35,    -1,
+      37,    38,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    46,
+      -1,    48,    17,    18,    19,    20,    21,    22,    23,    -1,
+      -1,    26,    -1,    -1,    -1,    -1,    -1,    32,    33,    34,
+      35,    -1,    37,    38,    -1,    19,    20,    21,    22,    23,
+      -1,    46,    26,    48,    -1,    -1,    -1,    -1,    -1,    -1,
+      34,    35,    -1,    37,    38,    -1,    19,    20,    21,    22,
+      23,    -1,    46,    26,    48,    21,    22,    23,    -1,    -1,
+      26,    -1,    -1,    -1,    37,    38,    -1,    -1,    -1,    -1,
+      -1,    37,    38,    46,    -1,    48,    -1,    -1,    -1,    -1,
+      46,    -1,    48
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,    44,    45,    56,    72,    78,     4,     5,     6,     7,
+       8,    11,    15,    16,    19,    20,    24,    25,    39,    46,
+      48,    50,    57,    58,    59,    60,    61,    62,    63,    73,
+      74,     0,     4,     9,    12,    13,    63,    75,    79,    80,
+      81,    73,    63,    63,    63,    63,    63,    63,    63,    63,
+      64,    63,    78,     6,    14,    15,    16,    17,    18,    19,
+      20,    21,    22,    23,    26,    28,    29,    30,    31,    32,
+      33,    34,    35,    37,    38,    46,    48,    27,    48,     4,
+       4,    54,    47,    49,    51,    63,    63,    63,    63,    63,
+      63,    63,    63,    63,    63,     4,    59,    63,    63,    63,
+      63,    63,    63,    63,    63,    63,    59,    60,    63,    65,
+      66,     4,    63,    69,    70,    71,    63,    63,    53,    54,
+      63,    50,    67,    68,    36,    47,    53,    49,    52,    54,
+      49,    63,    63,    66,    63,    71,    50,    54,    51,    47,
+      78,    51,    10,    76,    77,    50,    75,    78,    51
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    55,    56,    56,    57,    58,    58,    59,    60,    61,
+      61,    62,    63,    63,    63,    63,    63,    63,    63,    63,
+      63,    63,    63,    63,    63,    63,    63,    63,    63,    63,
+      63,    63,    63,    63,    63,    63,    63,    63,    63,    63,
+      63,    63,    63,    63,    63,    63,    63,    63,    63,    63,
+      63,    63,    63,    64,    64,    65,    66,    66,    67,    67,
+      68,    69,    69,    70,    70,    71,    71,    72,    73,    74,
+      75,    76,    76,    77,    77,    78,    78,    78,    78,    78,
+      79,    79,    80,    81
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     2,     2,     1,     1,     1,     1,     1,     1,
+       2,     1,     1,     1,     1,     1,     1,     1,     1,     2,
+       2,     2,     2,     2,     2,     2,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     4,     6,
+       4,     3,     4,     0,     1,     2,     0,     1,     0,     1,
+       3,     0,     1,     1,     3,     3,     1,     1,     3,     2,
+       8,     0,     1,     4,     2,     0,     2,     2,     2,     2,
+       4,     2,     5,     3
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (&yylloc, scanner, parser_ctx, out_param, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+#ifndef YYLLOC_DEFAULT
+# define YYLLOC_DEFAULT(Current, Rhs, N)                                \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;        \
+          (Current).first_column = YYRHSLOC (Rhs, 1).first_column;      \
+          (Current).last_line    = YYRHSLOC (Rhs, N).last_line;         \
+          (Current).last_column  = YYRHSLOC (Rhs, N).last_column;       \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).first_line   = (Current).last_line   =              \
+            YYRHSLOC (Rhs, 0).last_line;                                \
+          (Current).first_column = (Current).last_column =              \
+            YYRHSLOC (Rhs, 0).last_column;                              \
+        }                                                               \
+    while (0)
+#endif
+
+#define YYRHSLOC(Rhs, K) ((Rhs)[K])
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+/* YYLOCATION_PRINT -- Print the location on the stream.
+   This macro was not mandated originally: define only if we know
+   we won't break user code: when these are the locations we know.  */
+
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+
+/* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
+
+YY_ATTRIBUTE_UNUSED
+static int
+yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
+{
+  int res = 0;
+  int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
+  if (0 <= yylocp->first_line)
+    {
+      res += YYFPRINTF (yyo, "%d", yylocp->first_line);
+      if (0 <= yylocp->first_column)
+        res += YYFPRINTF (yyo, ".%d", yylocp->first_column);
+    }
+  if (0 <= yylocp->last_line)
+    {
+      if (yylocp->first_line < yylocp->last_line)
+        {
+          res += YYFPRINTF (yyo, "-%d", yylocp->last_line);
+          if (0 <= end_col)
+            res += YYFPRINTF (yyo, ".%d", end_col);
+        }
+      else if (0 <= end_col && yylocp->first_column < end_col)
+        res += YYFPRINTF (yyo, "-%d", end_col);
+    }
+  return res;
+}
+
+#   define YYLOCATION_PRINT  yy_location_print_
+
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, Location, scanner, parser_ctx, out_param); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, yyscan_t scanner, struct parser_ctx *parser_ctx, void *out_param)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
+  YY_USE (scanner);
+  YY_USE (parser_ctx);
+  YY_USE (out_param);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, yyscan_t scanner, struct parser_ctx *parser_ctx, void *out_param)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  YYLOCATION_PRINT (yyo, yylocationp);
+  YYFPRINTF (yyo, ": ");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, scanner, parser_ctx, out_param);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule, yyscan_t scanner, struct parser_ctx *parser_ctx, void *out_param)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]), scanner, parser_ctx, out_param);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, yylsp, Rule, scanner, parser_ctx, out_param); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
+/* Return the length of YYSTR.  */
+static YYPTRDIFF_T
+yystrlen (const char *yystr)
+{
+  YYPTRDIFF_T yylen;
+  for (yylen = 0; yystr[yylen]; yylen++)
+    continue;
+  return yylen;
+}
+# endif
+#endif
+
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
+/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
+   YYDEST.  */
+static char *
+yystpcpy (char *yydest, const char *yysrc)
+{
+  char *yyd = yydest;
+  const char *yys = yysrc;
+
+  while ((*yyd++ = *yys++) != '\0')
+    continue;
+
+  return yyd - 1;
+}
+# endif
+#endif
+
+#ifndef yytnamerr
+/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
+   quotes and backslashes, so that it's suitable for yyerror.  The
+   heuristic is that double-quoting is unnecessary unless the string
+   contains an apostrophe, a comma, or backslash (other than
+   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
+   null, do not copy; instead, return the length of what the result
+   would have been.  */
+static YYPTRDIFF_T
+yytnamerr (char *yyres, const char *yystr)
+{
+  if (*yystr == '"')
+    {
+      YYPTRDIFF_T yyn = 0;
+      char const *yyp = yystr;
+      for (;;)
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
+
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
+
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
+
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
+    do_not_strip_quotes: ;
+    }
+
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
+    return yystrlen (yystr);
+}
+#endif
+
+
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
+
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
+  {
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
+  }
+
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
+    }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
+  }
+  return 0;
+}
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, yyscan_t scanner, struct parser_ctx *parser_ctx, void *out_param)
+{
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
+  YY_USE (scanner);
+  YY_USE (parser_ctx);
+  YY_USE (out_param);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (yyscan_t scanner, struct parser_ctx *parser_ctx, void *out_param)
+{
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+/* Location data for the lookahead symbol.  */
+static YYLTYPE yyloc_default
+# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+  = { 1, 1, 1, 1 }
+# endif
+;
+YYLTYPE yylloc = yyloc_default;
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+    /* The location stack: array, bottom, top.  */
+    YYLTYPE yylsa[YYINITDEPTH];
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+  YYLTYPE yyloc;
+
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
+  /* Buffer for error messages, and its allocated size.  */
+  char yymsgbuf[128];
+  char *yymsg = yymsgbuf;
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  yylsp[0] = yylloc;
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+        YYLTYPE *yyls1 = yyls;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yyls1, yysize * YYSIZEOF (*yylsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+        yyls = yyls1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        YYSTACK_RELOCATE (yyls_alloc, yyls);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+      yylsp = yyls + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, &yylloc, scanner, parser_ctx, out_param);
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+  *++yylsp = yylloc;
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+  /* Default location. */
+  YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
+  yyerror_range[1] = yyloc;
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 4: /* g_integer: INTEGER  */
+#line 700 "libbitpunch/src/core/parser.y"
+            {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_INTEGER, &(yyloc));
+        (yyval.ast_node_hdl)->ndat->u.integer = (yyvsp[0].integer);
+    }
+#line 1911 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 5: /* g_boolean: KW_TRUE  */
+#line 705 "libbitpunch/src/core/parser.y"
+            {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_BOOLEAN, &(yyloc));
+        (yyval.ast_node_hdl)->ndat->u.boolean = 1;
+    }
+#line 1920 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 6: /* g_boolean: KW_FALSE  */
+#line 709 "libbitpunch/src/core/parser.y"
+             {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_BOOLEAN, &(yyloc));
+        (yyval.ast_node_hdl)->ndat->u.boolean = 0;
+    }
+#line 1929 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 7: /* g_identifier: IDENTIFIER  */
+#line 714 "libbitpunch/src/core/parser.y"
+               {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_IDENTIFIER, &(yyloc));
+        (yyval.ast_node_hdl)->ndat->u.identifier = (yyvsp[0].ident);
+    }
+#line 1938 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 8: /* g_self: KW_SELF  */
+#line 719 "libbitpunch/src/core/parser.y"
+            {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_EXPR_SELF, &(yyloc));
+    }
+#line 1946 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 9: /* g_literal: LITERAL  */
+#line 723 "libbitpunch/src/core/parser.y"
+            {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_STRING, &(yyloc));
+        (yyval.ast_node_hdl)->ndat->u.string.str = (yyvsp[0].literal).str;
+        (yyval.ast_node_hdl)->ndat->u.string.len = (yyvsp[0].literal).len;
+    }
+#line 1956 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 10: /* g_literal: g_literal LITERAL  */
+#line 728 "libbitpunch/src/core/parser.y"
+                      {
+      int64_t new_len;
+
+      // concatenate consecutive string literals
+      (yyval.ast_node_hdl) = (yyvsp[-1].ast_node_hdl);
+      new_len = (yyval.ast_node_hdl)->ndat->u.string.len + (yyvsp[0].literal).len;
+      (yyval.ast_node_hdl)->ndat->u.string.str = realloc_safe((char *)(yyval.ast_node_hdl)->ndat->u.string.str, new_len);
+      memcpy((char *)(yyval.ast_node_hdl)->ndat->u.string.str + (yyval.ast_node_hdl)->ndat->u.string.len, (yyvsp[0].literal).str, (yyvsp[0].literal).len);
+      (yyval.ast_node_hdl)->ndat->u.string.len = new_len;
+    }
+#line 1971 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 11: /* start_expr: expr  */
+#line 739 "libbitpunch/src/core/parser.y"
+                 {
+    memcpy(out_param, &(yyvsp[0].ast_node_hdl), sizeof((yyvsp[0].ast_node_hdl)));
+}
+#line 1979 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 19: /* expr: '+' expr  */
+#line 751 "libbitpunch/src/core/parser.y"
+                                     {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_UPLUS, (yyvsp[0].ast_node_hdl), NULL, &(yylsp[-1]));
+    }
+#line 1987 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 20: /* expr: '-' expr  */
+#line 754 "libbitpunch/src/core/parser.y"
+                                     {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_UMINUS, (yyvsp[0].ast_node_hdl), NULL, &(yylsp[-1]));
+    }
+#line 1995 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 21: /* expr: '!' expr  */
+#line 757 "libbitpunch/src/core/parser.y"
+             {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_LNOT, (yyvsp[0].ast_node_hdl), NULL, &(yylsp[-1]));
+    }
+#line 2003 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 22: /* expr: '~' expr  */
+#line 760 "libbitpunch/src/core/parser.y"
+             {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_BWNOT, (yyvsp[0].ast_node_hdl), NULL, &(yylsp[-1]));
+    }
+#line 2011 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 23: /* expr: OP_SIZEOF expr  */
+#line 763 "libbitpunch/src/core/parser.y"
+                   {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_SIZEOF, (yyvsp[0].ast_node_hdl), NULL, &(yylsp[-1]));
+    }
+#line 2019 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 24: /* expr: '&' expr  */
+#line 766 "libbitpunch/src/core/parser.y"
+                                     {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_ADDROF, (yyvsp[0].ast_node_hdl), NULL, &(yylsp[-1]));
+    }
+#line 2027 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 25: /* expr: '^' expr  */
+#line 769 "libbitpunch/src/core/parser.y"
+                                     {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_ANCESTOR, (yyvsp[0].ast_node_hdl), NULL, &(yylsp[-1]));
+    }
+#line 2035 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 26: /* expr: expr "||" expr  */
+#line 772 "libbitpunch/src/core/parser.y"
+                   {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_LOR, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2043 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 27: /* expr: expr "&&" expr  */
+#line 775 "libbitpunch/src/core/parser.y"
+                   {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_LAND, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2051 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 28: /* expr: expr '|' expr  */
+#line 778 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_BWOR, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2059 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 29: /* expr: expr '^' expr  */
+#line 781 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_BWXOR, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2067 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 30: /* expr: expr '&' expr  */
+#line 784 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_BWAND, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2075 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 31: /* expr: expr "==" expr  */
+#line 787 "libbitpunch/src/core/parser.y"
+                   {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_EQ, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2083 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 32: /* expr: expr "!=" expr  */
+#line 790 "libbitpunch/src/core/parser.y"
+                   {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_NE, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2091 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 33: /* expr: expr '>' expr  */
+#line 793 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_GT, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2099 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 34: /* expr: expr '<' expr  */
+#line 796 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_LT, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2107 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 35: /* expr: expr ">=" expr  */
+#line 799 "libbitpunch/src/core/parser.y"
+                   {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_GE, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2115 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 36: /* expr: expr "<=" expr  */
+#line 802 "libbitpunch/src/core/parser.y"
+                   {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_LE, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2123 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 37: /* expr: expr "<<" expr  */
+#line 805 "libbitpunch/src/core/parser.y"
+                   {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_LSHIFT, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2131 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 38: /* expr: expr ">>" expr  */
+#line 808 "libbitpunch/src/core/parser.y"
+                   {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_RSHIFT, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2139 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 39: /* expr: expr '+' expr  */
+#line 811 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_ADD, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2147 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 40: /* expr: expr '-' expr  */
+#line 814 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_SUB, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2155 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 41: /* expr: expr '*' expr  */
+#line 817 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_MUL, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2163 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 42: /* expr: expr '/' expr  */
+#line 820 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_DIV, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2171 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 43: /* expr: expr '%' expr  */
+#line 823 "libbitpunch/src/core/parser.y"
+                  {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_MOD, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2179 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 44: /* expr: expr '.' g_identifier  */
+#line 826 "libbitpunch/src/core/parser.y"
+                          {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_MEMBER, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+        parser_location_make_span(&(yyval.ast_node_hdl)->loc, &(yylsp[-2]), &(yylsp[0]));
+    }
+#line 2188 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 45: /* expr: expr "::" g_identifier  */
+#line 830 "libbitpunch/src/core/parser.y"
+                                {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_SCOPE, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+        parser_location_make_span(&(yyval.ast_node_hdl)->loc, &(yylsp[-2]), &(yylsp[0]));
+    }
+#line 2197 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 46: /* expr: expr "::" g_self  */
+#line 834 "libbitpunch/src/core/parser.y"
+                          {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_SCOPE, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+        parser_location_make_span(&(yyval.ast_node_hdl)->loc, &(yylsp[-2]), &(yylsp[0]));
+    }
+#line 2206 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 47: /* expr: expr "<>" expr  */
+#line 838 "libbitpunch/src/core/parser.y"
+                         {
+        (yyval.ast_node_hdl) = expr_gen_ast_node(AST_NODE_TYPE_OP_FILTER, (yyvsp[-2].ast_node_hdl), (yyvsp[0].ast_node_hdl), &(yylsp[-1]));
+    }
+#line 2214 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 48: /* expr: expr '[' opt_key_expr ']'  */
+#line 841 "libbitpunch/src/core/parser.y"
+                                                 {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_OP_SUBSCRIPT, NULL);
+        parser_location_make_span(&(yyval.ast_node_hdl)->loc, &(yylsp[-2]), &(yylsp[0]));
+        (yyval.ast_node_hdl)->ndat->u.op_subscript_common.anchor_expr = (yyvsp[-3].ast_node_hdl);
+        (yyval.ast_node_hdl)->ndat->u.op_subscript.index = (yyvsp[-1].subscript_index);
+    }
+#line 2225 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 49: /* expr: expr '[' opt_key_expr ".." opt_key_expr ']'  */
+#line 848 "libbitpunch/src/core/parser.y"
+                                                               {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_OP_SUBSCRIPT_SLICE, &(yyloc));
+        parser_location_make_span(&(yyval.ast_node_hdl)->loc, &(yylsp[-4]), &(yylsp[0]));
+        (yyval.ast_node_hdl)->ndat->u.op_subscript_common.anchor_expr = (yyvsp[-5].ast_node_hdl);
+        (yyval.ast_node_hdl)->ndat->u.op_subscript_slice.start = (yyvsp[-3].subscript_index);
+        (yyval.ast_node_hdl)->ndat->u.op_subscript_slice.end = (yyvsp[-1].subscript_index);
+    }
+#line 2237 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 50: /* expr: expr '(' func_params ')'  */
+#line 855 "libbitpunch/src/core/parser.y"
+                                            {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_OP_FCALL, &(yyvsp[-3].ast_node_hdl)->loc);
+        (yyval.ast_node_hdl)->ndat->u.op_fcall.func = (yyvsp[-3].ast_node_hdl);
+        (yyval.ast_node_hdl)->ndat->u.op_fcall.func_params = (yyvsp[-1].statement_list);
+    }
+#line 2247 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 51: /* expr: '(' expr ')'  */
+#line 860 "libbitpunch/src/core/parser.y"
+                 {
+        (yyval.ast_node_hdl) = (yyvsp[-1].ast_node_hdl);
+    }
+#line 2255 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 52: /* expr: '[' opt_expr ']' expr  */
+#line 863 "libbitpunch/src/core/parser.y"
+                                              {
+      /* Array declaration syntax is equivalent to regular filter
+       * block syntax with filter type "array", and attributes @item
+       * and (optionally) @length set. */
+
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_FILTER_DEF, NULL);
+        parser_location_make_span(&(yyval.ast_node_hdl)->loc, &(yylsp[-3]), &(yylsp[0]));
+        (yyval.ast_node_hdl)->ndat->u.filter_def.filter_type = "array";
+        init_block_stmt_list(&(yyval.ast_node_hdl)->ndat->u.scope_def.block_stmt_list);
+        attribute_list_push(
+            (yyval.ast_node_hdl)->ndat->u.scope_def.block_stmt_list.attribute_list,
+            "@item", &(yylsp[0]), (yyvsp[0].ast_node_hdl));
+        if (NULL != (yyvsp[-2].ast_node_hdl)) {
+            attribute_list_push(
+                (yyval.ast_node_hdl)->ndat->u.scope_def.block_stmt_list.attribute_list,
+                "@length", &(yylsp[-2]), (yyvsp[-2].ast_node_hdl));
+        }
+    }
+#line 2278 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 53: /* opt_expr: %empty  */
+#line 883 "libbitpunch/src/core/parser.y"
+                {
+      memset(&(yyval.ast_node_hdl), 0, sizeof ((yyval.ast_node_hdl)));
+    }
+#line 2286 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 55: /* key_expr: expr opt_twin_index  */
+#line 889 "libbitpunch/src/core/parser.y"
+                        {
+      memset(&(yyval.subscript_index), 0, sizeof ((yyval.subscript_index)));
+      (yyval.subscript_index).key = (yyvsp[-1].ast_node_hdl);
+      (yyval.subscript_index).twin = (yyvsp[0].ast_node_hdl);
+    }
+#line 2296 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 56: /* opt_key_expr: %empty  */
+#line 896 "libbitpunch/src/core/parser.y"
+                {
+      memset(&(yyval.subscript_index), 0, sizeof ((yyval.subscript_index)));
+    }
+#line 2304 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 58: /* opt_twin_index: %empty  */
+#line 902 "libbitpunch/src/core/parser.y"
+                {
+        (yyval.ast_node_hdl) = NULL;
+    }
+#line 2312 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 60: /* twin_index: '{' expr '}'  */
+#line 908 "libbitpunch/src/core/parser.y"
+                 {
+        (yyval.ast_node_hdl) = (yyvsp[-1].ast_node_hdl);
+    }
+#line 2320 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 61: /* func_params: %empty  */
+#line 913 "libbitpunch/src/core/parser.y"
+                {
+        (yyval.statement_list) = new_safe(struct statement_list);
+        TAILQ_INIT((yyval.statement_list));
+    }
+#line 2329 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 62: /* func_params: func_param_nonempty_list  */
+#line 917 "libbitpunch/src/core/parser.y"
+                             {
+        (yyval.statement_list) = (yyvsp[0].statement_list);
+    }
+#line 2337 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 63: /* func_param_nonempty_list: func_param  */
+#line 922 "libbitpunch/src/core/parser.y"
+               {
+        (yyval.statement_list) = new_safe(struct statement_list);
+        TAILQ_INIT((yyval.statement_list));
+        TAILQ_INSERT_TAIL((yyval.statement_list), (struct statement *)(yyvsp[0].named_expr), list);
+    }
+#line 2347 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 64: /* func_param_nonempty_list: func_param_nonempty_list ',' func_param  */
+#line 927 "libbitpunch/src/core/parser.y"
+                                            {
+        (yyval.statement_list) = (yyvsp[-2].statement_list);
+        TAILQ_INSERT_TAIL((yyval.statement_list), (struct statement *)(yyvsp[0].named_expr), list);
+    }
+#line 2356 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 65: /* func_param: IDENTIFIER '=' expr  */
+#line 933 "libbitpunch/src/core/parser.y"
+                        {
+        (yyval.named_expr) = new_safe(struct named_expr);
+        (yyval.named_expr)->nstmt.stmt.loc = (yylsp[-2]);
+        (yyval.named_expr)->nstmt.name = (yyvsp[-2].ident);
+        (yyval.named_expr)->expr = (yyvsp[0].ast_node_hdl);
+    }
+#line 2367 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 66: /* func_param: expr  */
+#line 939 "libbitpunch/src/core/parser.y"
+         {
+        (yyval.named_expr) = new_safe(struct named_expr);
+        (yyval.named_expr)->nstmt.stmt.loc = (yylsp[0]);
+        (yyval.named_expr)->expr = (yyvsp[0].ast_node_hdl);
+    }
+#line 2377 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 67: /* schema: block_stmt_list  */
+#line 947 "libbitpunch/src/core/parser.y"
+                    {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_SCOPE_DEF, &(yyloc));
+        (yyval.ast_node_hdl)->loc = (yylsp[0]);
+        (yyval.ast_node_hdl)->ndat->u.scope_def.block_stmt_list = (yyvsp[0].block_stmt_list);
+        memcpy(out_param, &(yyval.ast_node_hdl), sizeof((yyval.ast_node_hdl)));
+    }
+#line 2388 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 68: /* scope_block: '{' block_stmt_list '}'  */
+#line 955 "libbitpunch/src/core/parser.y"
+                            {
+        (yyval.ast_node_hdl) = ast_node_hdl_create(AST_NODE_TYPE_SCOPE_DEF, &(yyloc));
+        (yyval.ast_node_hdl)->loc = (yylsp[-2]);
+        (yyval.ast_node_hdl)->ndat->u.scope_def.block_stmt_list = (yyvsp[-1].block_stmt_list);
+    }
+#line 2398 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 69: /* filter_block: IDENTIFIER scope_block  */
+#line 962 "libbitpunch/src/core/parser.y"
+                           {
+        (yyval.ast_node_hdl) = (yyvsp[0].ast_node_hdl);
+        (yyval.ast_node_hdl)->ndat->type = AST_NODE_TYPE_FILTER_DEF;
+        (yyval.ast_node_hdl)->loc = (yylsp[-1]);
+        (yyval.ast_node_hdl)->ndat->u.filter_def.filter_type = (yyvsp[-1].ident);
+    }
+#line 2409 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 70: /* if_block: KW_IF '(' expr ')' '{' block_stmt_list '}' opt_else_block  */
+#line 970 "libbitpunch/src/core/parser.y"
+                                                              {
+        struct ast_node_hdl *cond;
+        struct statement *stmt;
+
+        cond = ast_node_hdl_create(AST_NODE_TYPE_CONDITIONAL, &(yylsp[-5]));
+        cond->ndat->u.conditional.cond_expr = (yyvsp[-5].ast_node_hdl);
+
+        TAILQ_FOREACH(stmt, (yyvsp[-2].block_stmt_list).field_list, list) {
+            attach_outer_conditional(&stmt->cond, cond);
+        }
+        TAILQ_FOREACH(stmt, (yyvsp[-2].block_stmt_list).named_expr_list, list) {
+            attach_outer_conditional(&stmt->cond, cond);
+        }
+        TAILQ_FOREACH(stmt, (yyvsp[-2].block_stmt_list).attribute_list, list) {
+            attach_outer_conditional(&stmt->cond, cond);
+        }
+        (yyval.block_stmt_list) = (yyvsp[-2].block_stmt_list);
+
+        cond = ast_node_hdl_create(AST_NODE_TYPE_CONDITIONAL, &(yylsp[-5]));
+        cond->ndat->u.conditional.cond_expr = (yyvsp[-5].ast_node_hdl);
+        cond->flags |= ASTFLAG_REVERSE_COND;
+
+        TAILQ_FOREACH(stmt, (yyvsp[0].block_stmt_list).field_list, list) {
+            attach_outer_conditional(&stmt->cond, cond);
+        }
+        TAILQ_FOREACH(stmt, (yyvsp[0].block_stmt_list).named_expr_list, list) {
+            attach_outer_conditional(&stmt->cond, cond);
+        }
+        TAILQ_FOREACH(stmt, (yyvsp[0].block_stmt_list).attribute_list, list) {
+            attach_outer_conditional(&stmt->cond, cond);
+        }
+        if (-1 == merge_block_stmt_list(&(yyval.block_stmt_list), &(yyvsp[0].block_stmt_list))) {
+            YYERROR;
+        }
+    }
+#line 2449 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 71: /* opt_else_block: %empty  */
+#line 1007 "libbitpunch/src/core/parser.y"
+                {
+        init_block_stmt_list(&(yyval.block_stmt_list));
+    }
+#line 2457 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 72: /* opt_else_block: else_block  */
+#line 1010 "libbitpunch/src/core/parser.y"
+               {
+        (yyval.block_stmt_list) = (yyvsp[0].block_stmt_list);
+    }
+#line 2465 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 73: /* else_block: KW_ELSE '{' block_stmt_list '}'  */
+#line 1015 "libbitpunch/src/core/parser.y"
+                                    {
+        (yyval.block_stmt_list) = (yyvsp[-1].block_stmt_list);
+    }
+#line 2473 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 74: /* else_block: KW_ELSE if_block  */
+#line 1018 "libbitpunch/src/core/parser.y"
+                     {
+        (yyval.block_stmt_list) = (yyvsp[0].block_stmt_list);
+    }
+#line 2481 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 75: /* block_stmt_list: %empty  */
+#line 1023 "libbitpunch/src/core/parser.y"
+                {
+        init_block_stmt_list(&(yyval.block_stmt_list));
+    }
+#line 2489 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 76: /* block_stmt_list: block_stmt_list attribute_stmt  */
+#line 1026 "libbitpunch/src/core/parser.y"
+                                   {
+        (yyval.block_stmt_list) = (yyvsp[-1].block_stmt_list);
+        if (NULL != (yyvsp[0].named_expr)->nstmt.name
+            && (yyvsp[0].named_expr)->nstmt.name[0] == '@') {
+            TAILQ_INSERT_TAIL((yyval.block_stmt_list).attribute_list,
+                              (struct statement *)(yyvsp[0].named_expr), list);
+        } else {
+            struct field *field;
+
+            field = new_safe(struct field);
+            field->nstmt = (yyvsp[0].named_expr)->nstmt;
+            field->filter = (yyvsp[0].named_expr)->expr;
+            TAILQ_INSERT_TAIL((yyval.block_stmt_list).field_list, (struct statement *)field, list);
+        }
+    }
+#line 2509 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 77: /* block_stmt_list: block_stmt_list let_stmt  */
+#line 1042 "libbitpunch/src/core/parser.y"
+                             {
+        (yyval.block_stmt_list) = (yyvsp[-1].block_stmt_list);
+        TAILQ_INSERT_TAIL((yyval.block_stmt_list).named_expr_list,
+                          (struct statement *)(yyvsp[0].named_expr), list);
+    }
+#line 2519 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 78: /* block_stmt_list: block_stmt_list extern_stmt  */
+#line 1048 "libbitpunch/src/core/parser.y"
+                                {
+        (yyval.block_stmt_list) = (yyvsp[-1].block_stmt_list);
+        TAILQ_INSERT_TAIL((yyval.block_stmt_list).named_expr_list,
+                          (struct statement *)(yyvsp[0].named_expr), list);
+    }
+#line 2529 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 79: /* block_stmt_list: block_stmt_list if_block  */
+#line 1054 "libbitpunch/src/core/parser.y"
+                             {
+      /* join 'if' node children to block stmt lists */
+      if (-1 == merge_block_stmt_list(&(yyval.block_stmt_list), &(yyvsp[0].block_stmt_list))) {
+          YYERROR;
+      }
+  }
+#line 2540 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 80: /* attribute_stmt: IDENTIFIER ':' expr ';'  */
+#line 1062 "libbitpunch/src/core/parser.y"
+                            {
+        (yyval.named_expr) = new_safe(struct named_expr);
+        (yyval.named_expr)->nstmt.name = (yyvsp[-3].ident);
+        (yyval.named_expr)->nstmt.stmt.loc = (yyloc);
+        (yyval.named_expr)->expr = (yyvsp[-1].ast_node_hdl);
+    }
+#line 2551 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 81: /* attribute_stmt: expr ';'  */
+#line 1068 "libbitpunch/src/core/parser.y"
+             {
+        (yyval.named_expr) = new_safe(struct named_expr);
+        (yyval.named_expr)->nstmt.name = NULL;
+        (yyval.named_expr)->nstmt.stmt.loc = (yyloc);
+        (yyval.named_expr)->expr = (yyvsp[-1].ast_node_hdl);
+    }
+#line 2562 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 82: /* let_stmt: KW_LET IDENTIFIER '=' expr ';'  */
+#line 1076 "libbitpunch/src/core/parser.y"
+                                   {
+        (yyval.named_expr) = new_safe(struct named_expr);
+        (yyval.named_expr)->nstmt.stmt.loc = (yyloc);
+        (yyval.named_expr)->nstmt.name = (yyvsp[-3].ident);
+        (yyval.named_expr)->expr = (yyvsp[-1].ast_node_hdl);
+    }
+#line 2573 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+  case 83: /* extern_stmt: KW_EXTERN IDENTIFIER ';'  */
+#line 1084 "libbitpunch/src/core/parser.y"
+                             {
+        (yyval.named_expr) = new_safe(struct named_expr);
+        (yyval.named_expr)->nstmt.stmt.loc = (yyloc);
+        (yyval.named_expr)->nstmt.name = (yyvsp[-1].ident);
+        (yyval.named_expr)->expr = ast_node_hdl_create(AST_NODE_TYPE_EXTERN_NAME, &(yyloc));
+        (yyval.named_expr)->expr->ndat->u.extern_name.name = strdup_safe((yyvsp[-1].ident));
+    }
+#line 2585 "build/libbitpunch/tmp/core/parser.tab.c"
+    break;
+
+
+#line 2589 "build/libbitpunch/tmp/core/parser.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+  *++yylsp = yyloc;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (&yylloc, scanner, parser_ctx, out_param, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
+      }
+    }
+
+  yyerror_range[1] = yylloc;
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, &yylloc, scanner, parser_ctx, out_param);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+      yyerror_range[1] = *yylsp;
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, scanner, parser_ctx, out_param);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  yyerror_range[2] = yylloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (&yylloc, scanner, parser_ctx, out_param, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, &yylloc, scanner, parser_ctx, out_param);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, scanner, parser_ctx, out_param);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+  if (yymsg != yymsgbuf)
+    YYSTACK_FREE (yymsg);
+  return yyresult;
+}
+
+#line 1092 "libbitpunch/src/core/parser.y"
+
+
+
+void
+parser_location_make_span(struct parser_location *dest_loc,
+                          const struct parser_location *start_loc,
+                          const struct parser_location *end_loc)
+{
+    dest_loc->parser_ctx   = start_loc->parser_ctx;
+    dest_loc->first_line   = start_loc->first_line;
+    dest_loc->first_column = start_loc->first_column;
+    dest_loc->last_line    = end_loc->last_line;
+    dest_loc->last_column  = end_loc->last_column;
+    dest_loc->start_offset = start_loc->start_offset;
+    dest_loc->end_offset   = end_loc->end_offset;
+}
+
+/**
+ * @brief pretty-print parser location information @loc into buffer
+ * @out_buf of size @out_buf_size
+ *
+ * @return the number of printed characters into @out_buf, not
+ * including the final \0, or the number of characters that would have
+ * been printed if @out_buf_size was big enough
+ */
+size_t
+bitpunch_parser_print_location(const struct parser_location *loc,
+                               FILE *out)
+{
+    const struct parser_ctx *parser_ctx;
+    const char *schema_end;
+    const char *line_start;
+    const char *line_end;
+
+    parser_ctx = loc->parser_ctx;
+    if (NULL == parser_ctx) {
+        return 0;
+    }
+    if (NULL != parser_ctx->parser_filepath) {
+        fprintf(out, "%s:%d:\n",
+                parser_ctx->parser_filepath, loc->last_line);
+    }
+    line_start = (parser_ctx->parser_data + loc->end_offset)
+        - loc->last_column;
+    schema_end =
+        parser_ctx->parser_data +
+        parser_ctx->parser_data_length;
+    if (0 == parser_ctx->parser_data_length) {
+        line_end = parser_ctx->parser_data;
+    } else {
+        line_end = memchr(line_start, '\n', schema_end - line_start);
+        if (NULL == line_end)
+            line_end = schema_end;
+    }
+    return fprintf(out, "%.*s\n%*s\n",
+                   (int)(line_end - line_start), line_start,
+                   (int)(loc->end_offset
+                         - (line_start - parser_ctx->parser_data)),
+                   "^");
+}
+
+const char *semantic_loglevel2str(enum semantic_loglevel lvl)
+{
+    switch (lvl) {
+#define MAP(LEVEL, STR) case SEMANTIC_LOGLEVEL_##LEVEL: return STR
+        MAP(INFO, "");
+        MAP(WARNING, "warning");
+        MAP(ERROR, "error");
+#undef MAP
+    default:
+        return "";
+    }
+}
+
+void semantic_error(enum semantic_loglevel lvl,
+                    const struct parser_location *loc,
+                    const char *fmt, ...)
+{
+    va_list ap;
+
+    if (NULL != loc && NULL != loc->parser_ctx) {
+        if (NULL != loc->parser_ctx->parser_filepath) {
+            fprintf(stderr, "%s at %s:%d:\n",
+                    semantic_loglevel2str(lvl),
+                    loc->parser_ctx->parser_filepath, loc->last_line);
+        } else {
+            fprintf(stderr, "%s at line %d:\n",
+                    semantic_loglevel2str(lvl), loc->last_line);
+        }
+        bitpunch_parser_print_location(loc, stderr);
+    } else {
+        fprintf(stderr, "%s: ", semantic_loglevel2str(lvl));
+    }
+    if (NULL != fmt) {
+        va_start(ap, fmt);
+        vfprintf(stderr, fmt, ap);
+        fputs("\n", stderr);
+        va_end(ap);
+    }
+}
+
+const char *
+ast_node_type_str(enum ast_node_type type)
+{
+    switch (type) {
+    case AST_NODE_TYPE_NONE: return "none";
+    case AST_NODE_TYPE_INTEGER: return "integer";
+    case AST_NODE_TYPE_BOOLEAN: return "boolean";
+    case AST_NODE_TYPE_STRING: return "string";
+    case AST_NODE_TYPE_IDENTIFIER: return "identifier";
+    case AST_NODE_TYPE_SCOPE_DEF: return "scope def";
+    case AST_NODE_TYPE_FILTER_DEF: return "filter def";
+    case AST_NODE_TYPE_ARRAY: return "array";
+    case AST_NODE_TYPE_BYTE: return "byte";
+    case AST_NODE_TYPE_BYTE_ARRAY: return "byte array";
+    case AST_NODE_TYPE_ARRAY_SLICE: return "slice";
+    case AST_NODE_TYPE_BYTE_SLICE: return "byte slice";
+    case AST_NODE_TYPE_CONDITIONAL: return "conditional";
+    case AST_NODE_TYPE_EXTERN_NAME: return "extern name";
+    case AST_NODE_TYPE_EXTERN_FUNC:
+    case AST_NODE_TYPE_REXPR_EXTERN_FUNC: return "extern func";
+    case AST_NODE_TYPE_EXTERN_FILTER: return "extern filter";
+    case AST_NODE_TYPE_REXPR_NATIVE: return "native type";
+    case AST_NODE_TYPE_OP_FCALL:
+    case AST_NODE_TYPE_REXPR_OP_FCALL: return "function call";
+    case AST_NODE_TYPE_EXPR_SELF:
+    case AST_NODE_TYPE_REXPR_SELF: return "'self' expr";
+    case AST_NODE_TYPE_OP_EQ:
+    case AST_NODE_TYPE_REXPR_OP_EQ: return "operator '=='";
+    case AST_NODE_TYPE_OP_NE:
+    case AST_NODE_TYPE_REXPR_OP_NE: return "operator '!='";
+    case AST_NODE_TYPE_OP_GT:
+    case AST_NODE_TYPE_REXPR_OP_GT: return "operator '>'";
+    case AST_NODE_TYPE_OP_LT:
+    case AST_NODE_TYPE_REXPR_OP_LT: return "operator '<'";
+    case AST_NODE_TYPE_OP_GE:
+    case AST_NODE_TYPE_REXPR_OP_GE: return "operator '>='";
+    case AST_NODE_TYPE_OP_LE:
+    case AST_NODE_TYPE_REXPR_OP_LE: return "operator '<='";
+    case AST_NODE_TYPE_OP_LOR:
+    case AST_NODE_TYPE_REXPR_OP_LOR: return "logical 'or'";
+    case AST_NODE_TYPE_OP_LAND:
+    case AST_NODE_TYPE_REXPR_OP_LAND: return "logical 'and'";
+    case AST_NODE_TYPE_OP_BWOR:
+    case AST_NODE_TYPE_REXPR_OP_BWOR: return "bitwise 'or'";
+    case AST_NODE_TYPE_OP_BWXOR:
+    case AST_NODE_TYPE_REXPR_OP_BWXOR: return "bitwise 'xor'";
+    case AST_NODE_TYPE_OP_BWAND:
+    case AST_NODE_TYPE_REXPR_OP_BWAND: return "bitwise 'and'";
+    case AST_NODE_TYPE_OP_LSHIFT:
+    case AST_NODE_TYPE_REXPR_OP_LSHIFT: return "operator 'left-shift'";
+    case AST_NODE_TYPE_OP_RSHIFT:
+    case AST_NODE_TYPE_REXPR_OP_RSHIFT: return "operator 'right-shift'";
+    case AST_NODE_TYPE_OP_ADD:
+    case AST_NODE_TYPE_REXPR_OP_ADD: return "operator 'add'";
+    case AST_NODE_TYPE_OP_SUB:
+    case AST_NODE_TYPE_REXPR_OP_SUB: return "operator 'substract'";
+    case AST_NODE_TYPE_OP_MUL:
+    case AST_NODE_TYPE_REXPR_OP_MUL: return "operator 'multiply'";
+    case AST_NODE_TYPE_OP_DIV:
+    case AST_NODE_TYPE_REXPR_OP_DIV: return "operator 'divide'";
+    case AST_NODE_TYPE_OP_MOD:
+    case AST_NODE_TYPE_REXPR_OP_MOD: return "operator 'modulo'";
+    case AST_NODE_TYPE_OP_FILTER:
+    case AST_NODE_TYPE_REXPR_OP_FILTER: return "operator 'filter'";
+    case AST_NODE_TYPE_REXPR_FILTER: return "filter";
+    case AST_NODE_TYPE_OP_UPLUS:
+    case AST_NODE_TYPE_REXPR_OP_UPLUS: return "unary 'plus'";
+    case AST_NODE_TYPE_OP_UMINUS:
+    case AST_NODE_TYPE_REXPR_OP_UMINUS: return "unary 'minus'";
+    case AST_NODE_TYPE_OP_LNOT:
+    case AST_NODE_TYPE_REXPR_OP_LNOT: return "logical 'not'";
+    case AST_NODE_TYPE_OP_BWNOT:
+    case AST_NODE_TYPE_REXPR_OP_BWNOT: return "bitwise 'not'";
+    case AST_NODE_TYPE_OP_SIZEOF:
+    case AST_NODE_TYPE_REXPR_OP_SIZEOF: return "operator 'sizeof'";
+    case AST_NODE_TYPE_OP_ADDROF:
+    case AST_NODE_TYPE_REXPR_OP_ADDROF: return "operator 'addr of'";
+    case AST_NODE_TYPE_OP_ANCESTOR:
+    case AST_NODE_TYPE_REXPR_OP_ANCESTOR: return "operator 'ancestor'";
+    case AST_NODE_TYPE_OP_SUBSCRIPT:
+    case AST_NODE_TYPE_REXPR_OP_SUBSCRIPT: return "array subscript";
+    case AST_NODE_TYPE_OP_SUBSCRIPT_SLICE:
+    case AST_NODE_TYPE_REXPR_OP_SUBSCRIPT_SLICE:
+        return "array subscript slice";
+    case AST_NODE_TYPE_OP_MEMBER:
+    case AST_NODE_TYPE_REXPR_OP_MEMBER: return "operator 'member of'";
+    case AST_NODE_TYPE_OP_SCOPE:
+    case AST_NODE_TYPE_REXPR_OP_SCOPE: return "operator 'scope'";
+    case AST_NODE_TYPE_REXPR_FIELD: return "field value";
+    case AST_NODE_TYPE_REXPR_NAMED_EXPR: return "named expression";
+    case AST_NODE_TYPE_REXPR_POLYMORPHIC: return "polymorphic value";
+    case AST_NODE_TYPE_REXPR_BUILTIN: return "builtin function";
+    }
+    return "!!bad value type!!";
+}
+
+void yyerror(YYLTYPE *loc, yyscan_t scanner,
+             struct parser_ctx *parser_ctx, void *out_param,
+             const char *str)
+{
+    semantic_error(SEMANTIC_LOGLEVEL_ERROR, loc, "%s", str);
+}
@@ -0,0 +1,614 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_BUILD_LIBBITPUNCH_TMP_CORE_PARSER_TAB_H_INCLUDED
+# define YY_YY_BUILD_LIBBITPUNCH_TMP_CORE_PARSER_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+/* "%code requires" blocks.  */
+#line 46 "libbitpunch/src/core/parser.y"
+
+
+#include <inttypes.h>
+#include "api/bitpunch-structs.h"
+#include "core/ast.h"
+#include "core/expr.h"
+#include "utils/dep_resolver.h"
+
+#define YYLTYPE struct parser_location
+#define YYLLOC_DEFAULT(Cur, Rhs, N)                             \
+    do {                                                        \
+        if (N){                                                 \
+            (Cur).parser_ctx   = YYRHSLOC(Rhs, 1).parser_ctx;   \
+            (Cur).first_line   = YYRHSLOC(Rhs, 1).first_line;   \
+            (Cur).first_column = YYRHSLOC(Rhs, 1).first_column; \
+            (Cur).last_line    = YYRHSLOC(Rhs, N).last_line;    \
+            (Cur).last_column  = YYRHSLOC(Rhs, N).last_column;  \
+            (Cur).start_offset = YYRHSLOC(Rhs, 1).start_offset; \
+            (Cur).end_offset   = YYRHSLOC(Rhs, N).end_offset;   \
+        } else {                                                \
+            (Cur).parser_ctx   = YYRHSLOC(Rhs, 0).parser_ctx;   \
+            (Cur).first_line   = (Cur).last_line   =            \
+                YYRHSLOC(Rhs, 0).last_line;                     \
+            (Cur).first_column = (Cur).last_column =            \
+                YYRHSLOC(Rhs, 0).last_column;                   \
+            (Cur).start_offset = (Cur).end_offset =             \
+                YYRHSLOC(Rhs, 0).end_offset;                    \
+        }                                                       \
+    } while (0)
+
+
+#include "utils/queue.h"
+
+    typedef void *yyscan_t;
+
+    struct parser_location {
+        struct parser_ctx *parser_ctx;
+        int parser_line_column;
+        int first_line;
+        int first_column;
+        int last_line;
+        int last_column;
+        size_t start_offset;
+        size_t end_offset;
+    };
+
+    struct ast_node_data;
+    struct ast_node_ref;
+    struct param;
+
+    struct statement;
+    struct filter_instance;
+
+    TAILQ_HEAD(statement_list, statement);
+
+#define	STATEMENT_FIRST(stmt_type, head)        \
+    (struct stmt_type *)TAILQ_FIRST((head))
+
+#define STATEMENT_NEXT(stmt_type, var, field)                           \
+    (struct stmt_type *)TAILQ_NEXT(((struct statement *)(var)), field)
+
+#define	STATEMENT_FOREACH(stmt_type, var, head, field)                  \
+    for ((var) = STATEMENT_FIRST(stmt_type, head);                      \
+     (var); (var) = STATEMENT_NEXT(stmt_type, var, field))
+
+
+    struct block_stmt_list {
+        struct statement_list *field_list;
+        struct statement_list *named_expr_list;
+        struct statement_list *attribute_list;
+    };
+
+    typedef expr_value_t
+        (*expr_evalop_fn_t)(expr_value_t operands[]);
+
+    struct expr_evaluator {
+        enum expr_value_type res_type_mask;
+        expr_evalop_fn_t eval_fn;
+    };
+
+    const struct expr_evaluator *
+        expr_lookup_evaluator(enum ast_node_type op_type,
+                              enum expr_value_type opd_types[]);
+
+    typedef bitpunch_status_t
+        (*extern_func_fn_t)(
+            void *user_arg,
+            expr_value_t *valuep,
+            expr_dpath_t *dpathp,
+            struct browse_state *bst);
+
+    extern const int SPAN_SIZE_UNDEF;
+
+    enum ast_node_flag {
+        ASTFLAG_IS_ANONYMOUS_MEMBER         = (1<<0),
+        ASTFLAG_HAS_POLYMORPHIC_ANCHOR      = (1<<1),
+        ASTFLAG_REVERSE_COND                = (1<<2),
+        ASTFLAG_CONTAINS_LAST_ATTR          = (1<<3),
+        ASTFLAG_DUMPING                     = (1<<4),
+        /** item defined by the user */
+        ASTFLAG_EXTERNAL                    = (1<<5),
+    };
+
+    enum ast_node_data_flag {
+        /** template filter */
+        ASTFLAG_DATA_TEMPLATE               = (1<<0),
+    };
+
+    struct rexpr {
+        enum expr_value_type value_type_mask;
+        enum expr_dpath_type dpath_type_mask;
+    };
+
+    enum item_flag {
+        ITEMFLAG_IS_SPAN_SIZE_VARIABLE       = (1<<0),
+        ITEMFLAG_IS_USED_SIZE_VARIABLE       = (1<<1),
+        ITEMFLAG_USES_SLACK                  = (1<<2),
+        ITEMFLAG_SPREADS_SLACK               = (1<<3),
+        ITEMFLAG_CONDITIONALLY_SPREADS_SLACK = (1<<4),
+        ITEMFLAG_FILLS_SLACK                 = (1<<5),
+        ITEMFLAG_CONDITIONALLY_FILLS_SLACK   = (1<<6),
+        ITEMFLAG_FILTER_MAPS_LIST            = (1<<7),
+        ITEMFLAG_FILTER_MAPS_OBJECT          = (1<<8),
+    };
+
+    struct item_node {
+        struct rexpr rexpr; /* inherits */
+        enum item_flag flags;
+        int64_t min_span_size; /* minimum size */
+    };
+
+    struct dpath_node {
+        struct ast_node_hdl *item;
+        struct ast_node_hdl *filter;
+        struct dep_resolver_node dr_node;
+    };
+
+    enum statement_type {
+        STATEMENT_TYPE_FIELD = (1<<0),
+        STATEMENT_TYPE_NAMED_EXPR = (1<<1),
+        STATEMENT_TYPE_ATTRIBUTE = (1<<2),
+    };
+
+    struct named_statement_spec {
+        enum statement_type stmt_type;
+        struct named_statement *nstmt;
+        const struct ast_node_hdl *anchor_filter;
+        int anonymous_member;
+    };
+
+    struct ast_node_data {
+        /* when changing this enum, don't forget to update
+         * ast_node_type_str() */
+        enum ast_node_type {
+            AST_NODE_TYPE_NONE = 0,
+            AST_NODE_TYPE_INTEGER,
+            AST_NODE_TYPE_BOOLEAN,
+            AST_NODE_TYPE_STRING,
+            AST_NODE_TYPE_IDENTIFIER,
+            AST_NODE_TYPE_SCOPE_DEF,
+            AST_NODE_TYPE_FILTER_DEF,
+            AST_NODE_TYPE_ARRAY,
+            AST_NODE_TYPE_BYTE,
+            AST_NODE_TYPE_BYTE_ARRAY,
+            AST_NODE_TYPE_ARRAY_SLICE,
+            AST_NODE_TYPE_BYTE_SLICE,
+            AST_NODE_TYPE_CONDITIONAL,
+            AST_NODE_TYPE_EXTERN_NAME,
+            AST_NODE_TYPE_EXTERN_FUNC,
+            AST_NODE_TYPE_EXTERN_FILTER,
+            AST_NODE_TYPE_OP_EQ,
+            AST_NODE_TYPE_OP_NE,
+            AST_NODE_TYPE_OP_GT,
+            AST_NODE_TYPE_OP_LT,
+            AST_NODE_TYPE_OP_GE,
+            AST_NODE_TYPE_OP_LE,
+            AST_NODE_TYPE_OP_LOR,
+            AST_NODE_TYPE_OP_LAND,
+            AST_NODE_TYPE_OP_BWOR,
+            AST_NODE_TYPE_OP_BWXOR,
+            AST_NODE_TYPE_OP_BWAND,
+            AST_NODE_TYPE_OP_LSHIFT,
+            AST_NODE_TYPE_OP_RSHIFT,
+            AST_NODE_TYPE_OP_ADD,
+            AST_NODE_TYPE_OP_SUB,
+            AST_NODE_TYPE_OP_MUL,
+            AST_NODE_TYPE_OP_DIV,
+            AST_NODE_TYPE_OP_MOD,
+            AST_NODE_TYPE_OP_UPLUS,
+            AST_NODE_TYPE_OP_UMINUS,
+            AST_NODE_TYPE_OP_LNOT,
+            AST_NODE_TYPE_OP_BWNOT,
+            AST_NODE_TYPE_OP_SIZEOF,
+            AST_NODE_TYPE_OP_ADDROF,
+            AST_NODE_TYPE_OP_ANCESTOR,
+            AST_NODE_TYPE_OP_SUBSCRIPT,
+            AST_NODE_TYPE_OP_SUBSCRIPT_SLICE,
+            AST_NODE_TYPE_OP_MEMBER,
+            AST_NODE_TYPE_OP_SCOPE,
+            AST_NODE_TYPE_OP_FILTER,
+            AST_NODE_TYPE_OP_FCALL,
+            AST_NODE_TYPE_EXPR_SELF,
+            AST_NODE_TYPE_REXPR_NATIVE,
+            AST_NODE_TYPE_REXPR_OP_EQ,
+            AST_NODE_TYPE_REXPR_OP_NE,
+            AST_NODE_TYPE_REXPR_OP_GT,
+            AST_NODE_TYPE_REXPR_OP_LT,
+            AST_NODE_TYPE_REXPR_OP_GE,
+            AST_NODE_TYPE_REXPR_OP_LE,
+            AST_NODE_TYPE_REXPR_OP_LOR,
+            AST_NODE_TYPE_REXPR_OP_LAND,
+            AST_NODE_TYPE_REXPR_OP_BWOR,
+            AST_NODE_TYPE_REXPR_OP_BWXOR,
+            AST_NODE_TYPE_REXPR_OP_BWAND,
+            AST_NODE_TYPE_REXPR_OP_LSHIFT,
+            AST_NODE_TYPE_REXPR_OP_RSHIFT,
+            AST_NODE_TYPE_REXPR_OP_ADD,
+            AST_NODE_TYPE_REXPR_OP_SUB,
+            AST_NODE_TYPE_REXPR_OP_MUL,
+            AST_NODE_TYPE_REXPR_OP_DIV,
+            AST_NODE_TYPE_REXPR_OP_MOD,
+            AST_NODE_TYPE_REXPR_OP_UPLUS,
+            AST_NODE_TYPE_REXPR_OP_UMINUS,
+            AST_NODE_TYPE_REXPR_OP_LNOT,
+            AST_NODE_TYPE_REXPR_OP_BWNOT,
+            AST_NODE_TYPE_REXPR_OP_SIZEOF,
+            AST_NODE_TYPE_REXPR_OP_ADDROF,
+            AST_NODE_TYPE_REXPR_OP_ANCESTOR,
+            AST_NODE_TYPE_REXPR_OP_FILTER,
+            AST_NODE_TYPE_REXPR_FILTER,
+            AST_NODE_TYPE_REXPR_OP_MEMBER,
+            AST_NODE_TYPE_REXPR_OP_SCOPE,
+            AST_NODE_TYPE_REXPR_FIELD,
+            AST_NODE_TYPE_REXPR_NAMED_EXPR,
+            AST_NODE_TYPE_REXPR_POLYMORPHIC,
+            AST_NODE_TYPE_REXPR_BUILTIN,
+            AST_NODE_TYPE_REXPR_OP_SUBSCRIPT,
+            AST_NODE_TYPE_REXPR_OP_SUBSCRIPT_SLICE,
+            AST_NODE_TYPE_REXPR_OP_FCALL,
+            AST_NODE_TYPE_REXPR_SELF,
+            AST_NODE_TYPE_REXPR_EXTERN_FUNC,
+        } type;
+        enum ast_node_data_flag flags;
+        union {
+            int64_t integer;
+            int boolean;
+            struct expr_value_string string;
+            char *identifier;
+            struct item_node item;
+            struct scope_def {
+                struct block_stmt_list block_stmt_list;
+            } scope_def;
+            struct filter_def {
+                struct scope_def scope_def; /* inherits */
+                const char *filter_type;
+            } filter_def;
+            struct conditional {
+                struct ast_node_hdl *cond_expr;
+                struct ast_node_hdl *outer_cond;
+            } conditional;
+            struct extern_name {
+                char *name;
+            } extern_name;
+            struct extern_func {
+                extern_func_fn_t extern_func_fn;
+                void *user_arg;
+            } extern_func;
+            struct extern_filter {
+                struct filter_class *filter_cls;
+            } extern_filter;
+            struct op {
+                struct ast_node_hdl *operands[2];
+            } op;
+            struct subscript_common {
+                struct ast_node_hdl *anchor_expr;
+            } op_subscript_common;
+            struct subscript {
+                struct subscript_common common; /* inherits */
+                struct subscript_index {
+                    struct ast_node_hdl *key;
+                    struct ast_node_hdl *twin;
+                    struct dep_resolver_node dr_node;
+                } index;
+            } op_subscript;
+            struct subscript_slice {
+                struct subscript_common common; /* inherits */
+                struct subscript_index start;
+                struct subscript_index end;
+            } op_subscript_slice;
+            struct fcall {
+                struct ast_node_hdl *object;
+                struct ast_node_hdl *func;
+                struct statement_list *func_params;
+            } op_fcall;
+            struct rexpr rexpr; /* base, not instanciable */
+            struct rexpr_filter {
+                struct item_node item; /* inherits */
+                struct filter_def *filter_def;
+                const struct filter_class *filter_cls;
+                struct filter_instance *f_instance;
+            } rexpr_filter;
+            struct rexpr_op_filter {
+                struct rexpr_filter rexpr_filter; /* inherits */
+                struct ast_node_hdl *filter_expr;
+                struct ast_node_hdl *target;
+            } rexpr_op_filter;
+            struct rexpr_native {
+                struct rexpr rexpr; /* inherits */
+                expr_value_t value;
+            } rexpr_native;
+            struct rexpr_member_common {
+                struct rexpr rexpr; /* inherits */
+                struct ast_node_hdl *anchor_expr;
+                struct ast_node_hdl *anchor_filter;
+            } rexpr_member_common;
+            struct rexpr_self {
+                struct rexpr_member_common rexpr; /* inherits */
+            } rexpr_self;
+            struct rexpr_field {
+                /* inherits */
+                struct rexpr_member_common rexpr_member_common;
+                const struct field *field;
+            } rexpr_field;
+            struct rexpr_named_expr {
+                /* inherits */
+                struct rexpr_member_common rexpr_member_common;
+                const struct named_expr *named_expr;
+            } rexpr_named_expr;
+            struct rexpr_polymorphic {
+                /* inherits */
+                struct rexpr_member_common rexpr_member_common;
+                const char *identifier;
+                struct named_statement_spec *visible_statements;
+                int n_visible_statements;
+            } rexpr_polymorphic;
+            struct rexpr_builtin {
+                struct rexpr rexpr; /* inherits */
+                //struct ast_node_hdl *anchor_expr;
+                const struct expr_builtin_fn *builtin;
+            } rexpr_builtin;
+            struct rexpr_op {
+                struct rexpr rexpr; /* inherits */
+                struct op op;
+                const struct expr_evaluator *evaluator;
+            } rexpr_op;
+            struct rexpr_op_subscript_common {
+                struct rexpr rexpr; /* inherits */
+                struct ast_node_hdl *anchor_expr;
+            } rexpr_op_subscript_common;
+            struct rexpr_op_subscript {
+                struct rexpr_op_subscript_common common; /* inherits */
+                struct subscript_index index;
+            } rexpr_op_subscript;
+            struct rexpr_op_subscript_slice {
+                struct rexpr_op_subscript_common common; /* inherits */
+                struct subscript_index start;
+                struct subscript_index end;
+            } rexpr_op_subscript_slice;
+            struct rexpr_op_fcall {
+                struct rexpr rexpr; /* inherits */
+                const struct expr_builtin_fn *builtin;
+                int n_func_params;
+                struct statement_list *func_params;
+            } rexpr_op_fcall;
+            struct rexpr_extern_func {
+                struct rexpr rexpr; /* inherits */
+                struct extern_func extern_func;
+            } rexpr_extern_func;
+        } u;
+    };
+
+    struct ast_node_hdl {
+        struct ast_node_data *ndat;
+        struct parser_location loc;
+        enum ast_node_flag flags;
+        enum resolve_identifiers_tag resolved_tags;
+        struct dep_resolver_node dr_node;
+    };
+
+    struct statement {
+        TAILQ_ENTRY(statement) list;
+        struct parser_location loc;
+        int stmt_flags; // type-specific flags
+        struct ast_node_hdl *cond;
+    };
+
+    enum statement_flag {
+        STATEMENT_FLAGS_END = (1<<0),
+    };
+
+    struct named_statement {
+        struct statement stmt; // inherits
+        char *name;
+    };
+
+    enum named_statement_flag {
+        NAMED_STATEMENT_FLAGS_END          = (STATEMENT_FLAGS_END<<0),
+    };
+
+    struct named_expr {
+        struct named_statement nstmt; // inherits
+        struct ast_node_hdl *expr;
+    };
+
+    struct field {
+        struct named_statement nstmt; // inherits
+        struct ast_node_hdl *filter;
+        struct dep_resolver_node dr_node;
+    };
+
+    enum field_flag {
+        FIELD_FLAG_HIDDEN        = (NAMED_STATEMENT_FLAGS_END<<0),
+        FIELD_FLAG_HEADER        = (NAMED_STATEMENT_FLAGS_END<<1),
+        FIELD_FLAG_TRAILER       = (NAMED_STATEMENT_FLAGS_END<<2),
+    };
+
+    typedef bitpunch_status_t
+        (*expr_eval_builtin_fn_t)(
+            struct ast_node_hdl *object,
+            struct statement_list *params,
+            int n_params,
+            enum expr_evaluate_flag flags,
+            expr_value_t *valuep,
+            expr_dpath_t *dpathp,
+            struct browse_state *bst);
+
+    struct expr_builtin_fn {
+        const char *builtin_name;
+        enum expr_value_type res_value_type_mask;
+        enum expr_value_type res_dpath_type_mask;
+        expr_eval_builtin_fn_t eval_fn;
+        int min_n_params;
+        int max_n_params;
+    };
+
+    enum semantic_loglevel {
+        SEMANTIC_LOGLEVEL_INFO,
+        SEMANTIC_LOGLEVEL_WARNING,
+        SEMANTIC_LOGLEVEL_ERROR,
+    };
+
+    void yyerror(YYLTYPE *loc, yyscan_t scanner,
+                 struct parser_ctx *parser_ctx, void *out_param,
+                 const char *str);
+
+    size_t
+        bitpunch_parser_print_location(const struct parser_location *loc,
+                                       FILE *out);
+    void
+        parser_location_make_span(struct parser_location *dest_loc,
+                                  const struct parser_location *start_loc,
+                                  const struct parser_location *end_loc);
+    const char *semantic_loglevel2str(enum semantic_loglevel lvl);
+    void semantic_error(enum semantic_loglevel lvl,
+                        const struct parser_location *loc,
+                        const char *fmt, ...)
+        __attribute__((format(printf,3,4)));
+    const char *ast_node_type_str(enum ast_node_type type);
+    struct ast_node_hdl *ast_node_hdl_new(void);
+    struct ast_node_hdl *
+    ast_node_hdl_create(enum ast_node_type type,
+                        const struct parser_location *loc);
+    struct ast_node_hdl *
+    ast_node_hdl_create_scope(const struct parser_location *loc);
+
+    void init_block_stmt_list(struct block_stmt_list *dst);
+
+#line 517 "build/libbitpunch/tmp/core/parser.tab.h"
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    TOK_ERROR = 258,               /* TOK_ERROR  */
+    IDENTIFIER = 259,              /* IDENTIFIER  */
+    INTEGER = 260,                 /* INTEGER  */
+    LITERAL = 261,                 /* LITERAL  */
+    KW_TRUE = 262,                 /* KW_TRUE  */
+    KW_FALSE = 263,                /* KW_FALSE  */
+    KW_IF = 264,                   /* KW_IF  */
+    KW_ELSE = 265,                 /* KW_ELSE  */
+    KW_SELF = 266,                 /* KW_SELF  */
+    KW_LET = 267,                  /* KW_LET  */
+    KW_EXTERN = 268,               /* KW_EXTERN  */
+    TOK_LOR = 269,                 /* "||"  */
+    TOK_LAND = 270,                /* "&&"  */
+    TOK_EQ = 271,                  /* "=="  */
+    TOK_NE = 272,                  /* "!="  */
+    TOK_GE = 273,                  /* ">="  */
+    TOK_LE = 274,                  /* "<="  */
+    TOK_LSHIFT = 275,              /* "<<"  */
+    TOK_RSHIFT = 276,              /* ">>"  */
+    TOK_RANGE = 277,               /* ".."  */
+    TOK_FILTER = 278,              /* "<>"  */
+    TOK_SCOPE = 279,               /* "::"  */
+    OP_SIZEOF = 280,               /* OP_SIZEOF  */
+    OP_ARITH_UNARY_OP = 281,       /* OP_ARITH_UNARY_OP  */
+    OP_ARRAY_DECL = 282,           /* OP_ARRAY_DECL  */
+    OP_SUBSCRIPT = 283,            /* OP_SUBSCRIPT  */
+    OP_FCALL = 284,                /* OP_FCALL  */
+    START_SCHEMA = 285,            /* START_SCHEMA  */
+    START_EXPR = 286               /* START_EXPR  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 631 "libbitpunch/src/core/parser.y"
+
+    int64_t integer;
+    int boolean;
+    char *ident;
+    struct expr_value_string literal;
+    struct ast_node_hdl *ast_node_hdl;
+    struct field *field;
+    struct block_stmt_list block_stmt_list;
+    struct statement_list *statement_list;
+    struct named_expr *named_expr;
+    struct func_param *func_param;
+    struct subscript_index subscript_index;
+
+#line 579 "build/libbitpunch/tmp/core/parser.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+/* Location type.  */
+#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
+typedef struct YYLTYPE YYLTYPE;
+struct YYLTYPE
+{
+  int first_line;
+  int first_column;
+  int last_line;
+  int last_column;
+};
+# define YYLTYPE_IS_DECLARED 1
+# define YYLTYPE_IS_TRIVIAL 1
+#endif
+
+
+
+
+int yyparse (yyscan_t scanner, struct parser_ctx *parser_ctx, void *out_param);
+
+/* "%code provides" blocks.  */
+#line 520 "libbitpunch/src/core/parser.y"
+
+    int yylex(YYSTYPE *lvalp, YYLTYPE *llocp, yyscan_t yyscanner,
+              struct parser_ctx *parser_ctx, void *out_param);
+ 
+
+#line 613 "build/libbitpunch/tmp/core/parser.tab.h"
+
+#endif /* !YY_YY_BUILD_LIBBITPUNCH_TMP_CORE_PARSER_TAB_H_INCLUDED  */
@@ -33,6 +33,7 @@
 #define __BITPUNCH_STRUCTS_H__
 
 #include <stdio.h>
+#include <stdint.h>
 
 #define BITPUNCH_SCHEMA_MAX_LENGTH   1048576
 
@@ -50,9 +51,12 @@ typedef enum bitpunch_status {
     BITPUNCH_STATUS_LAST = -9,
 } bitpunch_status_t;
 
+struct lazy_fmt;
+
 struct bitpunch_error_context_info {
-    /** error context messages pointing to offsets in @ref error_buf */
-    const char *message;
+    /** error context message, formatted on demand by
+     * bitpunch_error_get_context_message() */
+    struct lazy_fmt *message;
     struct tracker *tk;
     struct box *box;
     const struct ast_node_hdl *node;
@@ -82,20 +86,17 @@ struct bitpunch_error {
 
     const struct ast_node_hdl *node; /**< node that relates to the error */
 
-#define BITPUNCH_ERROR_BUF_SIZE 2048
-    /**< string table holding custom error message and context
-     * information */
-    char error_buf[BITPUNCH_ERROR_BUF_SIZE];
-
-    char *error_buf_end;     /**< end of @ref error_buf contents */
-
-    const char *reason;      /**< points to the reason phrase in @ref
-                              * error_buf */
+    struct lazy_fmt *reason; /**< reason phrase, formatted on demand
+                              * by bitpunch_error_get_reason() */
 
     int n_contexts;          /**< number of error context messages */
 
+    int n_alloc_contexts;    /**< allocated size of @ref contexts */
+
 #define BITPUNCH_ERROR_MAX_CONTEXTS 64
-    struct bitpunch_error_context_info contexts[BITPUNCH_ERROR_MAX_CONTEXTS];
+    /** error contexts in the order they were added, at most
+     * BITPUNCH_ERROR_MAX_CONTEXTS */
+    struct bitpunch_error_context_info *contexts;
 
     bitpunch_error_info_t *error_info; /**< error-specific additional info */
 
@@ -132,27 +133,113 @@ enum bitpunch_data_source_flag {
     BITPUNCH_DATA_SOURCE_EXTERNAL = (1u<<1),
 };
 
+/**
+ * @brief range of data source contents made accessible in memory
+ *
+ * Contents in [start_offset, end_offset) are readable from @ref base
+ * until the pin is released with bitpunch_data_source_unpin(). The
+ * pinned range may be larger than the range requested.
+ */
+struct bitpunch_data_pin {
+    const char *base;
+    int64_t start_offset;
+    int64_t end_offset;
+    /** backend-specific pin handle, NULL when there is nothing to
+     * release */
+    void *handle;
+};
+
 typedef int (*bitpunch_data_source_close_func_t)(
     struct bitpunch_data_source *ds);
 
+typedef int (*bitpunch_data_source_read_range_func_t)(
+    struct bitpunch_data_source *ds,
+    int64_t offset, int64_t length, char *buf);
+
+typedef int (*bitpunch_data_source_pin_range_func_t)(
+    struct bitpunch_data_source *ds,
+    int64_t offset, int64_t length, struct bitpunch_data_pin *pin);
+
+typedef void (*bitpunch_data_source_unpin_func_t)(
+    struct bitpunch_data_source *ds, struct bitpunch_data_pin *pin);
+
+typedef char *(*bitpunch_data_source_get_index_key_func_t)(
+    struct bitpunch_data_source *ds);
+
+/**
+ * @brief data source backend hooks
+ *
+ * Range hooks are only set by backends that do not expose their
+ * whole contents in ds_data (ds_data is then NULL).
+ */
 struct bitpunch_data_source_backend {
     bitpunch_data_source_close_func_t close;
+    bitpunch_data_source_read_range_func_t read_range;
+    bitpunch_data_source_pin_range_func_t pin_range;
+    bitpunch_data_source_unpin_func_t unpin;
+    /** optional: allocate a key identifying contents across
+     * sessions, or return NULL if they have no stable identity */
+    bitpunch_data_source_get_index_key_func_t get_index_key;
 };
 
 struct bitpunch_data_source {
     enum bitpunch_data_source_flag flags;
     struct bitpunch_data_source_backend backend;
+    /** flat contents, or NULL if only accessible through
+     * bitpunch_data_source_pin_range() */
     char              *ds_data;
     size_t            ds_data_length;
     int               use_count;
 };
 
+struct data_window_cache;
+
 struct bitpunch_file_source {
     struct bitpunch_data_source ds; /* inherits */
     char      *path;
     int       fd;
+    /** whole file mapping, if any */
     char      *map;
     size_t    map_length;
+    /** windows of file contents, if not mapped as a whole */
+    struct data_window_cache *windows;
+};
+
+struct bitpunch_file_cache_stats {
+    uint64_t n_hits;
+    uint64_t n_misses;
+    /** entries evicted to stay within the cache limits */
+    uint64_t n_evictions;
+    /** stale entries dropped after their file changed */
+    uint64_t n_invalidations;
+    size_t n_entries;
+    /** total size of cached file contents */
+    size_t n_bytes;
+};
+
+struct bitpunch_filter_cache_stats {
+    uint64_t n_hits;
+    uint64_t n_misses;
+    /** entries evicted to stay within the cache limits */
+    uint64_t n_evictions;
+    size_t n_entries;
+    /** total size of cached filter output */
+    size_t n_bytes;
+};
+
+struct bitpunch_alloc_stats {
+    uint64_t n_box_allocs;
+    /** boxes reusing the memory of a freed box */
+    uint64_t n_box_reuses;
+    uint64_t n_box_frees;
+    uint64_t n_tracker_allocs;
+    /** trackers reusing the memory of a freed tracker */
+    uint64_t n_tracker_reuses;
+    uint64_t n_tracker_frees;
+    /** slabs of boxes or trackers allocated from the system */
+    uint64_t n_slabs;
+    /** memory held by slabs */
+    size_t n_bytes;
 };
 
 struct bitpunch_board {
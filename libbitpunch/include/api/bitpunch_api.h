@@ -48,6 +48,10 @@ enum filter_class_flag {
     FILTER_CLASS_MAPS_LIST = (1u<<0),
     /** set when the filter maps to an object type */
     FILTER_CLASS_MAPS_OBJECT = (1u<<1),
+    /** set when the output data source of a filter only depends on
+     * the filter node, its attributes and its input bytes, so that it
+     * can be cached */
+    FILTER_CLASS_CACHED_OUTPUT = (1u<<2),
 };
 
 typedef struct filter_instance *
@@ -65,6 +69,16 @@ int
 bitpunch_init(void);
 void
 bitpunch_cleanup(void);
+void
+bitpunch_set_index_dir(const char *dir);
+void
+bitpunch_set_array_prescan(int n_workers, int64_t min_array_size);
+void
+bitpunch_set_filter_cache_limits(size_t max_entries, size_t max_bytes);
+void
+bitpunch_get_filter_cache_stats(struct bitpunch_filter_cache_stats *statsp);
+void
+bitpunch_get_alloc_stats(struct bitpunch_alloc_stats *statsp);
 int
 bitpunch_schema_create_from_path(
     struct ast_node_hdl **schemap, const char *path);
@@ -88,10 +102,23 @@ bitpunch_data_source_create_from_file_path(
 void
 bitpunch_data_source_notify_file_change(const char *path);
 
+void
+bitpunch_data_source_set_file_cache_limits(size_t max_entries,
+                                           size_t max_bytes);
+
+void
+bitpunch_data_source_get_file_cache_stats(
+    struct bitpunch_file_cache_stats *statsp);
+
 int
 bitpunch_data_source_create_from_file_descriptor(
     struct bitpunch_data_source **dsp, int fd);
 
+int
+bitpunch_data_source_create_windowed_from_file_descriptor(
+    struct bitpunch_data_source **dsp, int fd,
+    size_t window_size, int max_cached_windows);
+
 void
 bitpunch_data_source_create_from_memory(
     struct bitpunch_data_source **dsp,
@@ -108,6 +135,23 @@ bitpunch_data_source_acquire(struct bitpunch_data_source *ds);
 int
 bitpunch_data_source_release(struct bitpunch_data_source *ds);
 
+int
+bitpunch_data_source_read_range(struct bitpunch_data_source *ds,
+                                int64_t offset, int64_t length, char *buf);
+
+int
+bitpunch_data_source_pin_range(struct bitpunch_data_source *ds,
+                               int64_t offset, int64_t length,
+                               struct bitpunch_data_pin *pin,
+                               const char **datap);
+
+void
+bitpunch_data_source_unpin(struct bitpunch_data_source *ds,
+                           struct bitpunch_data_pin *pin);
+
+char *
+bitpunch_data_source_get_index_key(struct bitpunch_data_source *ds);
+
 struct ast_node_hdl *
 bitpunch_data_source_to_filter(struct bitpunch_data_source *ds);
 
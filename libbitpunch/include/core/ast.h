@@ -83,12 +83,22 @@ ARRAY_GENERATE_API_DECLS(ast_node_hdl_array, struct ast_node_hdl *)
 void
 compile_global_nodes(void);
 
+void
+compile_lock(void);
+
+void
+compile_unlock(void);
+
 int
 bitpunch_compile_schema(struct ast_node_hdl *schema);
 
 int
 bitpunch_resolve_expr(struct ast_node_hdl *expr, struct box *scope);
 
+const struct statement_list *
+block_stmt_lists_get_list(enum statement_type stmt_type,
+                          const struct block_stmt_list *stmt_lists);
+
 int
 identifier_is_visible_in_block_stmt_lists(
     enum statement_type stmt_mask,
@@ -186,6 +196,8 @@ ast_node_is_item(const struct ast_node_hdl *node);
 int
 ast_node_is_trackable(const struct ast_node_hdl *node);
 int
+ast_node_is_pure(const struct ast_node_hdl *expr);
+int
 ast_node_is_type(const struct ast_node_hdl *node);
 int
 ast_node_is_scope_only(const struct ast_node_hdl *node);
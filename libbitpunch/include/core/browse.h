@@ -54,6 +54,9 @@ struct browse_state {
     struct box *scope;
     struct bitpunch_error_slist *expected_errors;
     struct bitpunch_error *last_error;
+    /** set when an evaluated result depends on the environment
+     * (hence must not be memoized) */
+    int impure;
 };
 
 enum box_offset_type {
@@ -197,10 +200,33 @@ struct box {
 
     filter_state_t *filter_state;
     struct track_path track_path;
+
+    /** data pinned from data sources for the lifetime of the box
+     * (see box_unpin_data()) */
+    struct box_data_pin *data_pins;
+
+    /** results of pure named expressions and attributes evaluated
+     * in the box (see box_memo_store()) */
+    struct box_memo_entry *memo;
 };
 
 struct bitpunch_error;
 
+struct box_data_pin {
+    struct box_data_pin *next;
+    struct bitpunch_data_source *ds;
+    struct bitpunch_data_pin pin;
+};
+
+struct box_memo_entry {
+    struct box_memo_entry *next;
+    const struct named_expr *named_expr;
+    /** memoized value, EXPR_VALUE_TYPE_UNSET if not memoized */
+    expr_value_t value;
+    /** memoized dpath, EXPR_DPATH_TYPE_UNSET if not memoized */
+    expr_dpath_t dpath;
+};
+
 struct tracker {
     struct box *box;         /**< container box */
 
@@ -223,6 +249,11 @@ struct tracker {
 
     /** internal tracking state */
     struct track_path cur;
+
+    /** data source of @ref raw_pin */
+    struct bitpunch_data_source *raw_pin_ds;
+    /** contents returned by the last tracker_read_item_raw() */
+    struct bitpunch_data_pin raw_pin;
 };
 
 enum tracker_state {
@@ -299,6 +330,15 @@ box_read_value(struct box *box,
                expr_value_t *valuep,
                struct bitpunch_error **errp);
 bitpunch_status_t
+box_read_values_bulk(struct box *box,
+                     int64_t index, int64_t n_items,
+                     int64_t *values, int64_t *n_readp,
+                     struct bitpunch_error **errp);
+bitpunch_status_t
+box_pin_data(struct box *box, struct bitpunch_data_source *ds,
+             int64_t offset, int64_t length, const char **datap,
+             struct bitpunch_error **errp);
+bitpunch_status_t
 box_compute_offset(struct box *box,
                    enum box_offset_type off_type,
                    int64_t *offsetp,
@@ -427,6 +467,37 @@ tracker_read_item_value(struct tracker *tk,
                         expr_value_t *valuep,
                         struct bitpunch_error **errp);
 
+/** what tracker_read_items_batch() records of each item */
+enum tracker_batch_flag {
+    TRACKER_BATCH_KEY      = (1u<<0), /**< item key and twin index */
+    TRACKER_BATCH_LOCATION = (1u<<1), /**< item offset and size */
+    TRACKER_BATCH_VALUE    = (1u<<2), /**< item value or box */
+};
+
+/**
+ * @brief item record filled by tracker_read_items_batch(), release
+ * with tracker_item_record_destroy()
+ */
+struct tracker_item_record {
+    expr_value_t key;       /**< item key (index for arrays) */
+    int nth_twin;           /**< rank of item among items with same key */
+    int64_t offset;         /**< absolute byte offset of item */
+    int64_t size;           /**< byte size of item */
+    expr_value_t value;     /**< value of non-structured items */
+    struct box *box;        /**< filtered box of structured items
+                             * (blocks and arrays) instead of value */
+};
+
+bitpunch_status_t
+tracker_read_items_batch(struct tracker *tk,
+                         struct tracker_item_record *records,
+                         int64_t max_records,
+                         enum tracker_batch_flag flags,
+                         int64_t *n_recordsp,
+                         struct bitpunch_error **errp);
+void
+tracker_item_record_destroy(struct tracker_item_record *record);
+
 /* dpath API */
 
 bitpunch_status_t
@@ -457,6 +528,13 @@ expr_dpath_get_filtered_data(
 void
 bitpunch_error_dump_full(struct bitpunch_error *bp_err, FILE *out);
 
+const char *
+bitpunch_error_get_reason(struct bitpunch_error *bp_err);
+
+const char *
+bitpunch_error_get_context_message(struct bitpunch_error *bp_err,
+                                   int ctx_i);
+
 void
 bitpunch_error_attach_user_arg(struct bitpunch_error *bp_err, void *user_arg);
 
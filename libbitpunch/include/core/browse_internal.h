@@ -67,6 +67,14 @@ struct item_backend {
         int64_t *item_sizep,
         struct browse_state *bst);
 
+    /**
+     * @brief compute the item size from a buffer starting at the item
+     *
+     * The buffer may be a prefix of the available contents: an item
+     * size equal to @ref buffer_size tells the item may extend past
+     * the buffer, errors must only be returned for contents that
+     * cannot start a valid item whatever follows.
+     */
     bitpunch_status_t (*compute_item_size_from_buffer)(
         struct ast_node_hdl *filter,
         struct box *scope,
@@ -74,6 +82,14 @@ struct item_backend {
         int64_t *item_sizep,
         struct browse_state *bst);
 
+    bitpunch_status_t (*read_value)(
+        struct ast_node_hdl *filter,
+        struct box *scope,
+        int64_t item_offset,
+        int64_t item_size,
+        expr_value_t *valuep,
+        struct browse_state *bst);
+
     bitpunch_status_t (*read_value_from_buffer)(
         struct ast_node_hdl *filter,
         struct box *scope,
@@ -104,6 +120,11 @@ struct box_backend {
                                                     int get_left_offset,
                                                     int64_t *max_slack_offsetp,
                                                     struct browse_state *bst);
+    bitpunch_status_t (*read_values_bulk)(struct box *box,
+                                          int64_t index, int64_t n_items,
+                                          int64_t *values,
+                                          int64_t *n_readp,
+                                          struct browse_state *bst);
 };
 
 struct tracker_backend {
@@ -139,6 +160,12 @@ struct tracker_backend {
     bitpunch_status_t (*goto_end_path)(struct tracker *tk,
                                        struct browse_state *bst);
     void              (*goto_nil)(struct tracker *tk);
+    /** optional: get the field from which forward browsing to
+     * @to_field may start, with its offset from the start of the
+     * box, when known at compile time (returns FALSE if none) */
+    int               (*get_static_field_start)(
+        struct tracker *tk, const struct field *to_field, int flat,
+        const struct field **start_fieldp, int64_t *start_offsetp);
 };
 
 int
@@ -205,10 +232,16 @@ box_get_slack_child_allocation(struct box *box,
                                int64_t *max_slack_offsetp,
                                struct browse_state *bst);
 
+struct box *
+box_alloc(void);
+void
+browse_global_destroy(void);
 struct box *
 box_new_filter_box(struct box *parent_box,
                    struct ast_node_hdl *filter,
                    struct browse_state *bst);
+struct box *
+box_dup_chain(struct box *box, struct browse_state *bst);
 bitpunch_status_t
 box_apply_parent_filter_internal(struct box *box,
                                  struct browse_state *bst);
@@ -291,6 +324,32 @@ box_read_value_internal(struct box *box,
                         expr_value_t *valuep,
                         struct browse_state *bst);
 bitpunch_status_t
+box_read_values_bulk_internal(struct box *box,
+                              int64_t index, int64_t n_items,
+                              int64_t *values, int64_t *n_readp,
+                              struct browse_state *bst);
+bitpunch_status_t
+box_pin_data_internal(struct box *box, struct bitpunch_data_source *ds,
+                      int64_t offset, int64_t length,
+                      struct bitpunch_data_pin *pin, const char **datap,
+                      struct browse_state *bst);
+void
+box_unpin_data(struct box *box, struct bitpunch_data_source *ds,
+               struct bitpunch_data_pin *pin, int retain);
+bitpunch_status_t
+box_compute_item_size_from_buffer(struct box *box,
+                                  struct ast_node_hdl *filter,
+                                  int64_t start_offset, int64_t end_offset,
+                                  int64_t *item_sizep,
+                                  struct browse_state *bst);
+
+int
+box_memo_lookup(struct box *box, const struct named_expr *named_expr,
+                expr_value_t *valuep, expr_dpath_t *dpathp);
+void
+box_memo_store(struct box *box, const struct named_expr *named_expr,
+               const expr_value_t *valuep, const expr_dpath_t *dpathp);
+bitpunch_status_t
 box_get_filtered_data_internal(
     struct box *box,
     struct bitpunch_data_source **dsp, int64_t *offsetp, int64_t *sizep,
@@ -395,6 +454,9 @@ tracker_goto_index_internal(struct tracker *tk,
                             struct browse_state *bst);
 
 bitpunch_status_t
+tracker_set_item_size(struct tracker *tk, int64_t item_size,
+                      struct browse_state *bst);
+bitpunch_status_t
 tracker_goto_field_internal(struct tracker *tk,
                             const struct field *to_field, int flat,
                             struct browse_state *bst);
@@ -454,6 +516,13 @@ tracker_read_item_value_internal(struct tracker *tk,
                                  expr_value_t *valuep,
                                  struct browse_state *bst);
 bitpunch_status_t
+tracker_read_items_batch_internal(struct tracker *tk,
+                                  struct tracker_item_record *records,
+                                  int64_t max_records,
+                                  enum tracker_batch_flag flags,
+                                  int64_t *n_recordsp,
+                                  struct browse_state *bst);
+bitpunch_status_t
 tracker_read_item_value_direct_internal(struct tracker *tk,
                                         expr_value_t *valuep,
                                         struct browse_state *bst);
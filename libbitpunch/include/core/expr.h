@@ -85,16 +85,28 @@ enum expr_value_type {
                            EXPR_VALUE_TYPE_DATA_RANGE),
 };
 
+/**
+ * @brief data source contents pinned on behalf of string and bytes
+ * values referencing them, released with the last value
+ */
+struct expr_value_pin {
+    int use_count;
+    struct bitpunch_data_source *ds;
+    struct bitpunch_data_pin pin;
+};
+
 struct expr_value_string {
     const char *str;
     int64_t len;
     struct box *from_box;
+    struct expr_value_pin *pin;
 };
 
 struct expr_value_bytes {
     const char *buf;
     int64_t len;
     struct box *from_box;
+    struct expr_value_pin *pin;
 };
 
 struct expr_value_data {
@@ -147,6 +159,8 @@ static inline expr_dpath_t
 expr_dpath_as_container(struct box *box);
 void
 expr_value_destroy(expr_value_t value);
+expr_value_t
+expr_value_dup(expr_value_t src_value);
 static inline expr_value_t
 expr_value_unset(void);
 static inline expr_value_t
@@ -166,6 +180,13 @@ expr_value_as_data_range(struct bitpunch_data_source *ds,
                          int64_t start_offset, int64_t end_offset);
 void
 expr_value_attach_box(expr_value_t *value, struct box *box);
+void
+expr_value_attach_pin(expr_value_t *value, struct bitpunch_data_source *ds,
+                      struct bitpunch_data_pin *pin);
+int
+expr_value_get_pinned_data_offset(const expr_value_t *value,
+                                  struct bitpunch_data_source *ds,
+                                  const char *data, int64_t *offsetp);
 int
 expr_value_cmp_integer(expr_value_t value1, expr_value_t value2);
 int
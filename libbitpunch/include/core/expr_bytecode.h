@@ -0,0 +1,138 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/*
+ * Bytecode for scalar operator expressions
+ *
+ * Trees of integer and boolean operators are lowered at compile time
+ * into a flat stack program stored on the root operator node, with
+ * constant sub-expressions folded. Operands that are not operators
+ * (fields, named expressions, function calls...) are still evaluated
+ * through the AST by an EVAL instruction.
+ */
+
+#ifndef __EXPR_BYTECODE_H__
+#define __EXPR_BYTECODE_H__
+
+#include "core/expr.h"
+
+/** maximum number of instructions in a program */
+#define EXPR_BYTECODE_MAX_INSNS 64
+/** maximum evaluation stack depth of a program */
+#define EXPR_BYTECODE_MAX_DEPTH 16
+
+enum expr_opcode {
+    /** push a constant */
+    EXPR_OPCODE_PUSH,
+    /** evaluate an AST node and push its integer value */
+    EXPR_OPCODE_EVAL_INTEGER,
+    /** evaluate an AST node and push its boolean value */
+    EXPR_OPCODE_EVAL_BOOLEAN,
+
+    EXPR_OPCODE_UMINUS,
+    EXPR_OPCODE_BWNOT,
+    EXPR_OPCODE_LNOT,
+
+    /* binary operators: each one is followed by its variant taking
+     * the right operand from the instruction constant instead of the
+     * stack */
+    EXPR_OPCODE_ADD,
+    EXPR_OPCODE_ADD_K,
+    EXPR_OPCODE_SUB,
+    EXPR_OPCODE_SUB_K,
+    EXPR_OPCODE_MUL,
+    EXPR_OPCODE_MUL_K,
+    EXPR_OPCODE_DIV,
+    EXPR_OPCODE_DIV_K,
+    EXPR_OPCODE_MOD,
+    EXPR_OPCODE_MOD_K,
+    EXPR_OPCODE_BWAND,
+    EXPR_OPCODE_BWAND_K,
+    EXPR_OPCODE_BWOR,
+    EXPR_OPCODE_BWOR_K,
+    EXPR_OPCODE_BWXOR,
+    EXPR_OPCODE_BWXOR_K,
+    EXPR_OPCODE_LSHIFT,
+    EXPR_OPCODE_LSHIFT_K,
+    EXPR_OPCODE_RSHIFT,
+    EXPR_OPCODE_RSHIFT_K,
+    EXPR_OPCODE_EQ,
+    EXPR_OPCODE_EQ_K,
+    EXPR_OPCODE_NE,
+    EXPR_OPCODE_NE_K,
+    EXPR_OPCODE_LT,
+    EXPR_OPCODE_LT_K,
+    EXPR_OPCODE_LE,
+    EXPR_OPCODE_LE_K,
+    EXPR_OPCODE_GT,
+    EXPR_OPCODE_GT_K,
+    EXPR_OPCODE_GE,
+    EXPR_OPCODE_GE_K,
+    EXPR_OPCODE_LAND,
+    EXPR_OPCODE_LAND_K,
+    EXPR_OPCODE_LOR,
+    EXPR_OPCODE_LOR_K,
+};
+
+struct expr_insn {
+    enum expr_opcode opcode;
+    union {
+        /** PUSH and _K operators */
+        int64_t value;
+        /** EVAL_* */
+        struct ast_node_hdl *node;
+    };
+};
+
+struct expr_bytecode {
+    /** EXPR_VALUE_TYPE_INTEGER or EXPR_VALUE_TYPE_BOOLEAN */
+    enum expr_value_type result_type;
+    int n_insns;
+    /** number of EVAL_* instructions (scope is not needed if 0) */
+    int n_evals;
+    struct expr_insn insns[];
+};
+
+void
+expr_bytecode_compile(struct ast_node_hdl *expr);
+
+void
+expr_bytecode_free(struct expr_bytecode *bytecode);
+
+bitpunch_status_t
+expr_bytecode_evaluate(const struct expr_bytecode *bytecode,
+                       expr_value_t *valuep,
+                       struct browse_state *bst);
+
+void
+expr_bytecode_dump(const struct expr_bytecode *bytecode, FILE *out);
+
+#endif /* __EXPR_BYTECODE_H__ */
@@ -107,6 +107,7 @@ expr_value_as_string_len(const char *str, int64_t len)
     ev.string.str = str;
     ev.string.len = len;
     ev.string.from_box = NULL;
+    ev.string.pin = NULL;
     return ev;
 }
 
@@ -119,6 +120,7 @@ expr_value_as_bytes(const char *buf, int64_t len)
     ev.bytes.buf = buf;
     ev.bytes.len = len;
     ev.bytes.from_box = NULL;
+    ev.bytes.pin = NULL;
     return ev;
 }
 
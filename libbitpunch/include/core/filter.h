@@ -115,6 +115,11 @@ int
 filter_instance_build_shared(struct ast_node_hdl *node,
                              const char *filter_name);
 
+void
+filter_cache_global_init(void);
+void
+filter_cache_global_destroy(void);
+
 bitpunch_status_t
 filter_instance_read_value(struct ast_node_hdl *filter,
                            struct box *scope,
@@ -223,6 +228,12 @@ filter_get_first_declared_attribute(
     const struct ast_node_hdl *filter,
     const char *attr_name);
 
+static inline bitpunch_status_t
+filter_get_constant_attribute(
+    const struct ast_node_hdl *filter,
+    const char *attr_name,
+    expr_value_t *valuep);
+
 #include "core/filter_inlines.h"
 
 #endif
@@ -173,3 +173,13 @@ filter_get_first_declared_attribute(
   return scope_get_first_declared_attribute(
       filter_get_const_scope_def(filter), attr_name);
 }
+
+static inline bitpunch_status_t
+filter_get_constant_attribute(
+    const struct ast_node_hdl *filter,
+    const char *attr_name,
+    expr_value_t *valuep)
+{
+  return scope_get_constant_attribute(
+      filter_get_const_scope_def(filter), attr_name, valuep);
+}
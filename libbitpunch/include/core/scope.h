@@ -129,6 +129,11 @@ scope_attach_native_attribute(
     struct scope_def *scope_def,
     const char *attr_name, expr_value_t value);
 
+const struct field *
+scope_get_first_declared_field(
+    const struct scope_def *scope_def,
+    const char *name);
+
 struct ast_node_hdl *
 scope_get_first_declared_named_expr(
     const struct scope_def *scope_def,
@@ -139,6 +144,12 @@ scope_get_first_declared_attribute(
     const struct scope_def *scope_def,
     const char *attr_name);
 
+bitpunch_status_t
+scope_get_constant_attribute(
+    const struct scope_def *scope_def,
+    const char *attr_name,
+    expr_value_t *valuep);
+
 void
 scope_add_named_expr(
     struct scope_def *scope_def,
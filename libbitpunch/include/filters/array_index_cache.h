@@ -40,6 +40,12 @@ struct index_cache_mark_offset {
     int64_t item_offset;
 };
 
+enum array_cache_sidecar_state {
+    ARRAY_CACHE_SIDECAR_UNKNOWN = 0,
+    ARRAY_CACHE_SIDECAR_DISABLED,
+    ARRAY_CACHE_SIDECAR_ENABLED,
+};
+
 struct array_cache {
     struct bloom_book *cache_by_key;
     ARRAY_HEAD(index_cache_mark_offset_repo,
@@ -50,6 +56,14 @@ struct array_cache {
     int64_t last_cached_item_offset;
 #define BOX_INDEX_CACHE_DEFAULT_LOG2_N_KEYS_PER_MARK 5
     int cache_log2_n_keys_per_mark;
+    /** persistence of the cache in a sidecar index file, see
+     * tracker_index_cache_load_sidecar() */
+    enum array_cache_sidecar_state sidecar_state;
+    char *sidecar_key;
+    /** offset of the first item, sidecar offsets are relative to it */
+    int64_t sidecar_base_offset;
+    /** last cached index already persisted in the sidecar */
+    int64_t sidecar_saved_index;
 };
 
 struct index_cache_iterator {
@@ -72,10 +86,17 @@ array_index_cache_init(struct array_cache *cache, struct box *scope,
                        struct ast_node_hdl *filter, struct browse_state *bst);
 void
 array_index_cache_destroy(struct array_cache *cache);
+bitpunch_status_t
+tracker_index_cache_load_sidecar(struct tracker *tk,
+                                 struct browse_state *bst);
 
 bitpunch_status_t
 tracker_index_cache_add_item(struct tracker *tk, expr_value_t item_key,
                              struct browse_state *bst);
+void
+array_index_cache_add_item_offset(struct array_cache *cache,
+                                  struct ast_node_hdl *item,
+                                  int64_t index, int64_t item_offset);
 bitpunch_status_t
 box_index_cache_lookup_key_twins(struct box *box,
                                  expr_value_t item_key,
@@ -111,4 +132,9 @@ void
 tracker_goto_last_cached_item_internal(struct tracker *tk,
                                        struct browse_state *bst);
 
+void
+array_prescan_set_config(int n_workers, int64_t min_array_size);
+bitpunch_status_t
+tracker_index_cache_prescan(struct tracker *tk, struct browse_state *bst);
+
 #endif
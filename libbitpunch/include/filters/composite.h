@@ -41,6 +41,15 @@ struct filter_instance_composite {
         COMPOSITE_TYPE_STRUCT,
         COMPOSITE_TYPE_UNION,
     } type;
+    /** struct fields with a static offset, in declaration order:
+     * unconditional fields of constant size, followed by the first
+     * other unconditional field (only its offset is static) */
+    const struct field **static_fields;
+    /** offsets of static_fields from the start of the struct */
+    int64_t *static_offsets;
+    int n_static_fields;
+    /** number of leading static fields that are not anonymous */
+    int n_named_static_fields;
 };
 
 #endif
@@ -50,4 +50,9 @@ integer_read_endian_attribute(
     enum endian *endianp,
     struct browse_state *bst);
 
+bitpunch_status_t
+integer_read_bulk(struct ast_node_hdl *filter,
+                  const char *buffer, size_t item_size,
+                  int64_t n_items, int64_t *values);
+
 #endif
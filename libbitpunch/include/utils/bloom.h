@@ -32,6 +32,8 @@
 #ifndef __BLOOM_H__
 #define __BLOOM_H__
 
+#include <stdio.h>
+
 #include "utils/port.h"
 
 typedef int64_t bloom_book_mark_t;
@@ -53,6 +55,15 @@ bloom_book_suggested_n_words_per_mark(struct bloom_book *book);
 bloom_book_mark_t
 bloom_book_add_mark(struct bloom_book *book);
 
+bloom_book_mark_t
+bloom_book_get_n_marks(const struct bloom_book *book);
+
+int
+bloom_book_save(const struct bloom_book *book, FILE *file);
+
+struct bloom_book *
+bloom_book_load(FILE *file);
+
 bloom_book_mark_t
 bloom_book_get_cookie_mark(const struct bloom_book *book,
                            const struct bloom_book_cookie *cookie);
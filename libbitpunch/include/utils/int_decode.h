@@ -0,0 +1,112 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+#ifndef __INT_DECODE_H__
+#define __INT_DECODE_H__
+
+#include "utils/port.h"
+
+/**
+ * @brief decode a packed array of fixed-size binary integers into
+ * 64-bit values
+ *
+ * Uses SIMD kernels when supported by the CPU (detected at runtime),
+ * otherwise a scalar loop.
+ *
+ * @param buffer packed input integers
+ * @param item_size size in bytes of each integer: 1, 2, 4 or 8
+ * @param _signed non-zero to sign-extend values, zero-extend otherwise
+ * @param swap_bytes non-zero if integers are not in host byte order
+ * @param n_items number of integers to decode
+ * @param[out] values output array of @ref n_items values
+ */
+void
+int_decode_array(const char *buffer, size_t item_size,
+                 int _signed, int swap_bytes,
+                 int64_t n_items, int64_t *values);
+
+/**
+ * @brief varint decoding flags
+ */
+enum varint_flag {
+    /** the first byte of each varint holds its most significant
+     * bits, instead of the usual little-endian (LEB128) order */
+    VARINT_FLAG_BIG_ENDIAN  = (1u<<0),
+    /** zigzag-decode values (protobuf "sint32"/"sint64") */
+    VARINT_FLAG_ZIGZAG      = (1u<<1),
+    /** sign-extend values from the top payload bit of their last
+     * byte (signed LEB128) */
+    VARINT_FLAG_SIGN_EXTEND = (1u<<2),
+};
+
+/**
+ * @brief get the size of a varint
+ *
+ * @return size in bytes of the varint at start of @ref buffer, or 0
+ * if @ref buffer does not contain a complete varint
+ */
+size_t
+varint_get_size(const char *buffer, size_t buffer_size);
+
+/**
+ * @brief decode a run of consecutive varints into 64-bit values
+ *
+ * Varints are decoded a 64-bit word at a time (using PEXT when
+ * supported by the CPU), runs of single-byte varints eight at a time.
+ *
+ * @param flags mask of enum varint_flag values
+ * @param n_items maximum number of varints to decode
+ * @param[out] values output array of @ref n_items values
+ * @param[out] sizes if not NULL, output array of @ref n_items sizes
+ * in bytes of each varint
+ * @param[out] n_bytesp number of bytes of @ref buffer decoded
+ *
+ * @return number of varints decoded, less than @ref n_items if the
+ * end of @ref buffer is reached or if the next varint is incomplete
+ */
+int64_t
+varint_decode_run(const char *buffer, size_t buffer_size, int flags,
+                  int64_t n_items, int64_t *values, int64_t *sizes,
+                  size_t *n_bytesp);
+
+/**
+ * @brief decode a single varint
+ *
+ * @param flags see varint_decode_run()
+ *
+ * @return size in bytes of the varint at start of @ref buffer, or 0
+ * if @ref buffer does not contain a complete varint
+ */
+size_t
+varint_decode(const char *buffer, size_t buffer_size, int flags,
+              int64_t *valuep);
+
+#endif /* __INT_DECODE_H__ */
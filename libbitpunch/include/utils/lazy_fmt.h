@@ -0,0 +1,61 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief lazily formatted printf-style messages
+ *
+ * The arguments of a message are captured when it is created (strings
+ * are copied), and the message is only formatted when first asked
+ * for. This keeps raising errors cheap when their message is never
+ * looked at, e.g. when the caller handles the error status.
+ */
+
+#ifndef __LAZY_FMT_H__
+#define __LAZY_FMT_H__
+
+#include <stdarg.h>
+
+struct lazy_fmt;
+
+struct lazy_fmt *
+lazy_fmt_new(const char *fmt, va_list args);
+
+void
+lazy_fmt_append(struct lazy_fmt *msg, const char *fmt, va_list args);
+
+const char *
+lazy_fmt_get_str(struct lazy_fmt *msg);
+
+void
+lazy_fmt_free(struct lazy_fmt *msg);
+
+#endif /* __LAZY_FMT_H__ */
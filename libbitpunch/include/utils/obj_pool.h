@@ -0,0 +1,189 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief pools of fixed-size objects
+ *
+ * Objects are carved out of slabs of many objects, and freed objects
+ * are kept in a free list for reuse instead of being returned to
+ * malloc. Each thread allocates from its own cache (free list and
+ * partially used slab), so the fast path takes no lock. Objects may
+ * be freed by another thread than the one that allocated them.
+ *
+ * Slabs are only returned to the system by obj_pool_destroy(). Free
+ * objects of exiting threads are handed over to the pool for other
+ * threads to reuse.
+ *
+ * When built with AddressSanitizer, objects are allocated with
+ * malloc() so that use-after-free errors still get reported.
+ */
+
+#ifndef __OBJ_POOL_H__
+#define __OBJ_POOL_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "utils/port.h"
+
+#if defined __SANITIZE_ADDRESS__
+#define OBJ_POOL_USE_MALLOC
+#endif
+
+struct obj_pool_stats {
+    /** objects allocated */
+    uint64_t n_allocs;
+    /** objects allocated from a free list */
+    uint64_t n_reuses;
+    /** objects freed */
+    uint64_t n_frees;
+    /** slabs allocated from the system */
+    uint64_t n_slabs;
+    /** memory held by slabs */
+    size_t n_bytes;
+};
+
+struct obj_pool_slab;
+struct obj_pool_cache;
+
+struct obj_pool {
+    const char *name;
+    size_t obj_size;
+    int n_objs_per_slab;
+    pthread_mutex_t lock;
+    struct obj_pool_slab *slabs;
+    /** free list of objects given back by exited threads */
+    void *orphans;
+    /** caches of live threads */
+    struct obj_pool_cache *caches;
+    /** statistics of exited threads */
+    struct obj_pool_stats retired_stats;
+};
+
+/** per-thread cache, only accessed by its thread besides stats */
+struct obj_pool_cache {
+    struct obj_pool *pool;
+    struct obj_pool_cache *pool_next;
+    struct obj_pool_cache *thread_next;
+    void *free_list;
+    char *bump;
+    char *bump_end;
+    struct obj_pool_stats stats;
+};
+
+#define OBJ_POOL_ALIGN 16
+
+#define OBJ_POOL_INITIALIZER(_name, _obj_size, _n_objs_per_slab) {      \
+        .name = (_name),                                                \
+        .obj_size = ((_obj_size) + OBJ_POOL_ALIGN - 1)                  \
+                    & ~(size_t)(OBJ_POOL_ALIGN - 1),                    \
+        .n_objs_per_slab = (_n_objs_per_slab),                          \
+        .lock = PTHREAD_MUTEX_INITIALIZER,                              \
+    }
+
+struct obj_pool_cache *
+obj_pool_cache_create(struct obj_pool *pool, struct obj_pool_cache **cachep);
+
+void *
+obj_pool_refill(struct obj_pool *pool, struct obj_pool_cache *cache);
+
+void
+obj_pool_get_stats(struct obj_pool *pool, struct obj_pool_stats *statsp);
+
+void
+obj_pool_destroy(struct obj_pool *pool);
+
+/* counters are only written by the owner thread, but may be read
+ * concurrently by obj_pool_get_stats() */
+#define OBJ_POOL_STAT_INC(cache, counter)                               \
+    __atomic_store_n(&(cache)->stats.counter,                           \
+                     (cache)->stats.counter + 1, __ATOMIC_RELAXED)
+
+/**
+ * @brief allocate a zeroed object
+ *
+ * @param cachep address of the calling thread's cache pointer for
+ * this pool (a thread-local variable, initially NULL)
+ */
+static inline void *
+obj_pool_alloc(struct obj_pool *pool, struct obj_pool_cache **cachep)
+{
+    struct obj_pool_cache *cache;
+    void *obj;
+
+    cache = *cachep;
+    if (NULL == cache) {
+        cache = obj_pool_cache_create(pool, cachep);
+    }
+#if defined OBJ_POOL_USE_MALLOC
+    obj = malloc_safe(pool->obj_size);
+#else
+    if (NULL != cache->free_list) {
+        obj = cache->free_list;
+        cache->free_list = *(void **)obj;
+        OBJ_POOL_STAT_INC(cache, n_reuses);
+    } else if (cache->bump < cache->bump_end) {
+        obj = cache->bump;
+        cache->bump += pool->obj_size;
+    } else {
+        obj = obj_pool_refill(pool, cache);
+    }
+#endif
+    OBJ_POOL_STAT_INC(cache, n_allocs);
+    return memset(obj, 0, pool->obj_size);
+}
+
+static inline void
+obj_pool_free(struct obj_pool *pool, struct obj_pool_cache **cachep,
+              void *obj)
+{
+    struct obj_pool_cache *cache;
+
+    if (NULL == obj) {
+        return ;
+    }
+    cache = *cachep;
+    if (NULL == cache) {
+        cache = obj_pool_cache_create(pool, cachep);
+    }
+#if defined OBJ_POOL_USE_MALLOC
+    free(obj);
+#else
+    *(void **)obj = cache->free_list;
+    cache->free_list = obj;
+#endif
+    OBJ_POOL_STAT_INC(cache, n_frees);
+}
+
+#endif /*__OBJ_POOL_H__*/
@@ -101,6 +101,47 @@ static inline int log2_i(unsigned long n)
     return NBBY * sizeof (n) - 1 - __builtin_clzl(n);
 }
 
+/*
+ * reference counters of objects shared between threads
+ */
+
+static inline int refcount_read(const int *countp)
+{
+    return __atomic_load_n(countp, __ATOMIC_RELAXED);
+}
+
+static inline void refcount_inc(int *countp)
+{
+    __atomic_add_fetch(countp, 1, __ATOMIC_RELAXED);
+}
+
+/** @return the new count */
+static inline int refcount_dec(int *countp)
+{
+    return __atomic_sub_fetch(countp, 1, __ATOMIC_ACQ_REL);
+}
+
+/**
+ * @brief decrement unless this drops the last reference
+ *
+ * @return TRUE if decremented, FALSE if the count is 1, in which
+ * case the caller releases the last reference itself (e.g. while
+ * holding a lock that protects lookups of the object)
+ */
+static inline int refcount_dec_not_last(int *countp)
+{
+    int count;
+
+    count = __atomic_load_n(countp, __ATOMIC_RELAXED);
+    while (count > 1) {
+        if (__atomic_compare_exchange_n(countp, &count, count - 1, TRUE,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
 #define STATIC_ASSERT(cond) do {                \
         switch (cond) {                         \
         case 0:                                 \
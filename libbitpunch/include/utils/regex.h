@@ -0,0 +1,108 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+
+#ifndef __REGEX_H__
+#define __REGEX_H__
+
+#include <stddef.h>
+
+#include "utils/port.h"
+
+/**
+ * @brief compiled regular expression
+ *
+ * Patterns are compiled into a Thompson NFA over bytes, which is
+ * executed as a DFA built lazily: DFA states are created on first
+ * use and kept in a cache of bounded size (flushed when full), so
+ * that matching is linear in the text size whatever the pattern, and
+ * no backtracking ever happens.
+ *
+ * Supported syntax: literal bytes, '.' (any byte but '\n'), bracket
+ * classes ("[a-z_]", "[^\r\n]"), escapes ("\d", "\w", "\s" and their
+ * negations, "\n", "\r", "\t", "\f", "\v", "\0", "\xHH", "\" followed
+ * by a punctuation character), groups "(...)" and "(?:...)",
+ * alternation '|', and greedy quantifiers '*', '+', '?', "{m}",
+ * "{m,}" and "{m,n}". Anchors '^' and '$' are only supported at the
+ * start and end of the whole pattern, a top-level alternation must
+ * then be enclosed in a group ("^(a|b)$").
+ *
+ * A compiled regex may be used concurrently from several threads
+ * (searches are serialized on its DFA cache).
+ */
+struct regex;
+
+/**
+ * @brief compile a regular expression
+ *
+ * @param[out] errmsgp on error, set to a static string describing
+ * the error
+ *
+ * @return the compiled regex, or NULL on error
+ */
+struct regex *
+regex_compile(const char *pattern, size_t pattern_size,
+              const char **errmsgp);
+
+void
+regex_free(struct regex *regex);
+
+/**
+ * @brief tell if the regex matches the empty string
+ */
+int
+regex_matches_empty(const struct regex *regex);
+
+/**
+ * @brief tell if the regex matches anywhere in @ref text
+ */
+int
+regex_match(struct regex *regex, const char *text, size_t text_size);
+
+/**
+ * @brief find the first match of the regex in @ref text
+ *
+ * The match returned is the one ending first in @ref text: its start
+ * is the leftmost start of a match ending there, and it is then
+ * extended as far as the pattern allows from that start (greedy).
+ *
+ * @param[out] startp offset of the start of the match
+ * @param[out] endp offset of the end of the match
+ * @param[out] truncatedp if not NULL, set to TRUE when the match
+ * could extend past the end of @ref text with more contents
+ *
+ * @return TRUE if a match is found, FALSE otherwise
+ */
+int
+regex_search(struct regex *regex, const char *text, size_t text_size,
+             size_t *startp, size_t *endp, int *truncatedp);
+
+#endif /* __REGEX_H__ */
@@ -0,0 +1,80 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+
+#ifndef __STR_SEARCH_H__
+#define __STR_SEARCH_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "utils/port.h"
+
+/**
+ * @brief substring searcher compiled once for a given needle
+ *
+ * Candidate positions are found comparing the first and last bytes
+ * of the needle over whole SIMD vectors. If too many candidates turn
+ * out to be false positives (e.g. periodic haystacks), the search
+ * switches to the Two-Way algorithm, linear in the haystack size,
+ * whose critical factorization and shift table are precomputed.
+ */
+struct str_searcher {
+    /** needle, not owned: must outlive the searcher */
+    const char *needle;
+    size_t needle_size;
+    /** Two-Way critical position (start of the right half) */
+    size_t crit_pos;
+    /** Two-Way shift after a full right-half match */
+    size_t period;
+    /** non-zero if the needle is periodic (prefix memory in use) */
+    size_t mem0;
+    /** set of bytes present in the needle */
+    uint64_t byteset[4];
+    /** one past the last position of each byte in the needle */
+    size_t shift[256];
+};
+
+void
+str_searcher_init(struct str_searcher *searcher,
+                  const char *needle, size_t needle_size);
+
+/**
+ * @brief find the first occurrence of the searcher's needle
+ *
+ * @return pointer to the first occurrence in @ref haystack, or NULL
+ * if not found (an empty needle is found at @ref haystack)
+ */
+const char *
+str_searcher_find(const struct str_searcher *searcher,
+                  const char *haystack, size_t haystack_size);
+
+#endif /* __STR_SEARCH_H__ */
@@ -32,6 +32,27 @@
 /**
  * @file
  * @brief main API
+ *
+ * Threading model:
+ *
+ * - bitpunch_init() must be called once before other threads use
+ *   the library, and bitpunch_cleanup() once they are done.
+ *
+ * - compiled schemas and data sources may be shared between threads:
+ *   data source reference counts are atomic, and the file data source
+ *   cache, the filter output cache and the filter registry have their
+ *   own locks. Parsing, resolving and compiling are serialized by a
+ *   global compile lock.
+ *
+ * - boards, boxes, trackers and their caches (e.g. array item
+ *   offsets) are confined to the thread that created them, each
+ *   thread browsing a shared schema or data source must use its own
+ *   board.
+ *
+ * - configuration setters (bitpunch_set_index_dir(), cache limits,
+ *   bitpunch_set_array_prescan()) are meant to be called before
+ *   browsing starts. Array pre-scan workers are threads browsing
+ *   their own copies of the array box and the boxes it depends on.
  */
 
 #include <stdlib.h>
@@ -40,6 +61,8 @@
 #include "core/filter.h"
 #include "api/bitpunch_api.h"
 #include "api/data_source_internal.h"
+#include "utils/sidecar.h"
+#include "filters/array_index_cache.h"
 
 #if defined DEBUG
 int tracker_debug_mode = 0;
@@ -50,6 +73,7 @@ bitpunch_init(void)
 {
     builtin_filter_declare_std();
     data_source_global_init();
+    filter_cache_global_init();
     compile_global_nodes();
     return 0;
 }
@@ -57,7 +81,44 @@ bitpunch_init(void)
 void
 bitpunch_cleanup(void)
 {
+    filter_cache_global_destroy();
     data_source_global_destroy();
+    browse_global_destroy();
+    sidecar_set_dir(NULL);
+}
+
+/**
+ * @brief set the directory where index sidecar files are kept
+ *
+ * Indexes built while browsing (e.g. deflate checkpoints, item
+ * offsets and keys of variable-size arrays) are saved there and
+ * reloaded by later sessions browsing the same contents.
+ *
+ * @param dir existing directory, or NULL to disable sidecar files
+ */
+void
+bitpunch_set_index_dir(const char *dir)
+{
+    sidecar_set_dir(dir);
+}
+
+/**
+ * @brief enable parallel pre-scan of large arrays
+ *
+ * Slack arrays of variable-size items whose item type declares a
+ * constant "@sync" attribute get their index of item offsets built
+ * by @ref n_workers concurrent workers the first time they are
+ * accessed by index, if they span at least @ref min_array_size
+ * bytes. Results are identical to a sequential scan.
+ *
+ * @param n_workers number of workers, 0 or 1 to disable
+ * @param min_array_size minimum array size in bytes, or -1 for
+ * the default
+ */
+void
+bitpunch_set_array_prescan(int n_workers, int64_t min_array_size)
+{
+    array_prescan_set_config(n_workers, min_array_size);
 }
 
 const char *
@@ -152,16 +152,8 @@ bitpunch_board_get_item(
     struct bitpunch_board *board,
     const char *name)
 {
-    struct block_stmt_list *lists;
-    struct named_expr *named_expr;
-
-    lists = &board->ast_root->ndat->u.scope_def.block_stmt_list;
-    STATEMENT_FOREACH(named_expr, named_expr, lists->named_expr_list, list) {
-        if (0 == strcmp(name, named_expr->nstmt.name)) {
-            return named_expr->expr;
-        }
-    }
-    return NULL;
+    return scope_get_first_declared_named_expr(
+        &board->ast_root->ndat->u.scope_def, name);
 }
 
 struct ast_node_hdl *
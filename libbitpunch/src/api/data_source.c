@@ -34,6 +34,7 @@
  * @brief bitpunch data source API
  */
 
+#define _GNU_SOURCE
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
@@ -43,6 +44,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "utils/queue.h"
 #include "core/browse.h"
@@ -53,99 +55,408 @@
 static int
 data_source_free(struct bitpunch_data_source *ds);
 
-static int
-file_source_refresh_internal(struct bitpunch_file_source *fs);
+/*
+ * windowed file contents
+ *
+ * Files that cannot be mapped as a whole are accessed through
+ * windows mapped on demand. Windows are reference-counted by pins,
+ * and unpinned windows are kept in a LRU list up to a maximum count,
+ * beyond which the least recently used ones are unmapped. The window
+ * lists of a data source are protected by its window cache lock.
+ *
+ * Contents of pipes and other non-seekable files are first copied to
+ * an unlinked temporary file, which is then accessed through windows
+ * as well.
+ */
 
-struct cached_file_source {
-    LIST_ENTRY(cached_file_source) list;
-    struct bitpunch_file_source *fs;
+#define DATA_WINDOW_DEFAULT_SIZE        (1024 * 1024)
+#define DATA_WINDOW_DEFAULT_MAX_CACHED  64
+#define DATA_SPOOL_BUFFER_SIZE          65536
+
+struct data_window {
+    TAILQ_ENTRY(data_window) list; /* all windows */
+    TAILQ_ENTRY(data_window) lru;  /* unpinned windows only */
+    int64_t start_offset;
+    int64_t end_offset;
+    char *data;
+    /** page-aligned mapping of data, or NULL if data has been read
+     * into an allocated buffer */
+    void *map;
+    int pin_count;
 };
 
-LIST_HEAD(cached_file_source_list, cached_file_source) cached_file_sources;
+TAILQ_HEAD(data_window_list, data_window);
 
-void
-data_source_global_init(void)
+struct data_window_cache {
+    pthread_mutex_t lock;
+    int fd;
+    /** TRUE if @ref fd is a temporary file to close with the cache */
+    int owns_fd;
+    int64_t window_size;
+    int max_cached_windows;
+    int n_cached_windows;
+    struct data_window_list windows;
+    struct data_window_list lru;
+};
+
+static int
+pread_all(int fd, char *buf, size_t count, off_t offset)
 {
-    LIST_INIT(&cached_file_sources);
+    ssize_t n_read;
+
+    while (count > 0) {
+        n_read = pread(fd, buf, count, offset);
+        if (-1 == n_read) {
+            if (EINTR == errno) {
+                continue ;
+            }
+            fprintf(stderr, "Unable to read binary file: %s\n",
+                    strerror(errno));
+            return -1;
+        }
+        if (0 == n_read) {
+            fprintf(stderr, "Unable to read binary file: "
+                    "unexpected end of file\n");
+            return -1;
+        }
+        buf += n_read;
+        count -= n_read;
+        offset += n_read;
+    }
+    return 0;
 }
 
-void
-data_source_global_destroy(void)
+static struct data_window *
+data_window_load(struct bitpunch_file_source *fs,
+                 int64_t offset, int64_t length)
 {
-    struct cached_file_source *cfs, *tcfs;
+    struct data_window_cache *wc;
+    struct data_window *win;
+    int64_t start_offset;
+    int64_t end_offset;
+    size_t window_length;
 
-    LIST_FOREACH_SAFE(cfs, &cached_file_sources, list, tcfs) {
-        data_source_free((struct bitpunch_data_source *)cfs->fs);
-        free(cfs);
+    wc = fs->windows;
+    // ranges spanning window boundaries get a larger window
+    start_offset = offset - offset % wc->window_size;
+    end_offset = offset + length + wc->window_size - 1;
+    end_offset -= end_offset % wc->window_size;
+    if (end_offset > (int64_t)fs->ds.ds_data_length) {
+        end_offset = (int64_t)fs->ds.ds_data_length;
+    }
+    window_length = (size_t)(end_offset - start_offset);
+
+    win = new_safe(struct data_window);
+    win->start_offset = start_offset;
+    win->end_offset = end_offset;
+    // window size is a multiple of the page size
+    win->map = mmap(NULL, window_length, PROT_READ, MAP_PRIVATE,
+                    wc->fd, (off_t)start_offset);
+    if (MAP_FAILED != win->map) {
+        win->data = win->map;
+    } else {
+        win->map = NULL;
+        win->data = malloc_safe(window_length);
+        if (-1 == pread_all(wc->fd, win->data, window_length,
+                            (off_t)start_offset)) {
+            free(win->data);
+            free(win);
+            return NULL;
+        }
+    }
+    TAILQ_INSERT_HEAD(&wc->windows, win, list);
+    return win;
+}
+
+static void
+data_window_free(struct data_window_cache *wc, struct data_window *win)
+{
+    TAILQ_REMOVE(&wc->windows, win, list);
+    if (NULL != win->map) {
+        (void) munmap(win->map, (size_t)(win->end_offset - win->start_offset));
+    } else {
+        free(win->data);
     }
+    free(win);
 }
 
-static struct bitpunch_file_source *
-lookup_cached_file_source(const char *path)
+static struct data_window *
+data_window_lookup(struct data_window_cache *wc,
+                   int64_t offset, int64_t length)
 {
-    struct cached_file_source *cfs, *tcfs;
+    struct data_window *win;
 
-    LIST_FOREACH_SAFE(cfs, &cached_file_sources, list, tcfs) {
-        if (NULL != cfs->fs->path && 0 == strcmp(cfs->fs->path, path)) {
-            LIST_REMOVE(cfs, list);
-            LIST_INSERT_HEAD(&cached_file_sources, cfs, list);
-            return cfs->fs;
+    TAILQ_FOREACH(win, &wc->windows, list) {
+        if (offset >= win->start_offset
+            && offset + length <= win->end_offset) {
+            return win;
         }
     }
     return NULL;
 }
 
 static int
-refresh_cached_file_source(const char *path)
+data_source_pin_range_windowed(struct bitpunch_data_source *ds,
+                               int64_t offset, int64_t length,
+                               struct bitpunch_data_pin *pin)
 {
-    struct cached_file_source *cfs, *tcfs;
+    struct bitpunch_file_source *fs;
+    struct data_window_cache *wc;
+    struct data_window *win;
 
-    LIST_FOREACH_SAFE(cfs, &cached_file_sources, list, tcfs) {
-        if (NULL != cfs->fs->path && 0 == strcmp(cfs->fs->path, path)) {
-            file_source_refresh_internal(cfs->fs);
-            return 0;
+    fs = (struct bitpunch_file_source *)ds;
+    wc = fs->windows;
+    pthread_mutex_lock(&wc->lock);
+    win = data_window_lookup(wc, offset, length);
+    if (NULL == win) {
+        win = data_window_load(fs, offset, length);
+        if (NULL == win) {
+            pthread_mutex_unlock(&wc->lock);
+            return -1;
         }
+    } else if (0 == win->pin_count) {
+        TAILQ_REMOVE(&wc->lru, win, lru);
+        --wc->n_cached_windows;
     }
-    return -1;
+    ++win->pin_count;
+    pthread_mutex_unlock(&wc->lock);
+    pin->base = win->data;
+    pin->start_offset = win->start_offset;
+    pin->end_offset = win->end_offset;
+    pin->handle = win;
+    return 0;
 }
 
 static void
-add_file_source_to_cache(struct bitpunch_file_source *fs)
+data_source_unpin_windowed(struct bitpunch_data_source *ds,
+                           struct bitpunch_data_pin *pin)
 {
-    struct cached_file_source *cfs;
+    struct data_window_cache *wc;
+    struct data_window *win;
 
-    cfs = new_safe(struct cached_file_source);
-    cfs->fs = fs;
-    cfs->fs->ds.flags = BITPUNCH_DATA_SOURCE_CACHED;
-    LIST_INSERT_HEAD(&cached_file_sources, cfs, list);
+    wc = ((struct bitpunch_file_source *)ds)->windows;
+    win = (struct data_window *)pin->handle;
+    pthread_mutex_lock(&wc->lock);
+    assert(win->pin_count > 0);
+    --win->pin_count;
+    if (0 == win->pin_count) {
+        TAILQ_INSERT_HEAD(&wc->lru, win, lru);
+        ++wc->n_cached_windows;
+        while (wc->n_cached_windows > wc->max_cached_windows) {
+            win = TAILQ_LAST(&wc->lru, data_window_list);
+            TAILQ_REMOVE(&wc->lru, win, lru);
+            --wc->n_cached_windows;
+            data_window_free(wc, win);
+        }
+    }
+    pthread_mutex_unlock(&wc->lock);
+}
+
+static int
+data_source_read_range_windowed(struct bitpunch_data_source *ds,
+                                int64_t offset, int64_t length, char *buf)
+{
+    struct bitpunch_data_pin pin;
+
+    if (-1 == data_source_pin_range_windowed(ds, offset, length, &pin)) {
+        return -1;
+    }
+    memcpy(buf, pin.base + (offset - pin.start_offset), length);
+    data_source_unpin_windowed(ds, &pin);
+    return 0;
+}
+
+static void
+open_windowed_file_source(struct bitpunch_file_source *fs, int fd,
+                          int64_t file_size,
+                          size_t window_size, int max_cached_windows)
+{
+    struct data_window_cache *wc;
+    size_t page_size;
+
+    page_size = (size_t)sysconf(_SC_PAGESIZE);
+    if (0 == window_size) {
+        window_size = DATA_WINDOW_DEFAULT_SIZE;
+    }
+    if (max_cached_windows < 0) {
+        max_cached_windows = DATA_WINDOW_DEFAULT_MAX_CACHED;
+    }
+    wc = new_safe(struct data_window_cache);
+    pthread_mutex_init(&wc->lock, NULL);
+    wc->fd = fd;
+    // windows are mapped at multiples of the window size
+    wc->window_size = (int64_t)
+        ((window_size + page_size - 1) / page_size * page_size);
+    wc->max_cached_windows = max_cached_windows;
+    TAILQ_INIT(&wc->windows);
+    TAILQ_INIT(&wc->lru);
+
+    fs->fd = fd;
+    fs->windows = wc;
+    fs->ds.ds_data = NULL;
+    fs->ds.ds_data_length = (size_t)file_size;
+    fs->ds.backend.read_range = data_source_read_range_windowed;
+    fs->ds.backend.pin_range = data_source_pin_range_windowed;
+    fs->ds.backend.unpin = data_source_unpin_windowed;
+}
+
+static int
+write_all(int fd, const char *buf, size_t count)
+{
+    ssize_t n_written;
+
+    while (count > 0) {
+        n_written = write(fd, buf, count);
+        if (-1 == n_written) {
+            if (EINTR == errno) {
+                continue ;
+            }
+            fprintf(stderr, "Unable to write temporary file: %s\n",
+                    strerror(errno));
+            return -1;
+        }
+        buf += n_written;
+        count -= n_written;
+    }
+    return 0;
+}
+
+/**
+ * @brief copy the contents of a non-seekable file to an unlinked
+ * temporary file in $TMPDIR (or /tmp)
+ *
+ * @param[out] sizep size of contents copied
+ *
+ * @return the temporary file descriptor, or -1 on error
+ */
+static int
+spool_file_contents(int fd, int64_t *sizep)
+{
+    const char *tmpdir;
+    char *path;
+    char *buffer;
+    int64_t data_size;
+    ssize_t n_read;
+    int spool_fd;
+
+    tmpdir = getenv("TMPDIR");
+    if (NULL == tmpdir || '\0' == *tmpdir) {
+        tmpdir = "/tmp";
+    }
+    if (-1 == asprintf(&path, "%s/bitpunch_spool.XXXXXX", tmpdir)) {
+        return -1;
+    }
+    spool_fd = mkstemp(path);
+    if (-1 == spool_fd) {
+        fprintf(stderr, "Unable to create temporary file %s: %s\n",
+                path, strerror(errno));
+        free(path);
+        return -1;
+    }
+    (void) unlink(path);
+    free(path);
+    buffer = malloc_safe(DATA_SPOOL_BUFFER_SIZE);
+    data_size = 0;
+    while (TRUE) {
+        n_read = read(fd, buffer, DATA_SPOOL_BUFFER_SIZE);
+        if (-1 == n_read) {
+            if (EINTR == errno) {
+                continue ;
+            }
+            fprintf(stderr, "Unable to read binary file: %s\n",
+                    strerror(errno));
+            break ;
+        }
+        if (0 == n_read) {
+            free(buffer);
+            *sizep = data_size;
+            return spool_fd;
+        }
+        if (-1 == write_all(spool_fd, buffer, n_read)) {
+            break ;
+        }
+        data_size += n_read;
+    }
+    free(buffer);
+    (void) close(spool_fd);
+    return -1;
 }
 
 static int
 open_file_source_from_fd(struct bitpunch_file_source *fs, int fd)
 {
+    struct stat st;
     char *map;
-    size_t map_length;
+    int spool_fd;
+    int64_t spool_size;
 
-    map_length = lseek(fd, 0, SEEK_END);
-    map = mmap(NULL, map_length, PROT_READ, MAP_PRIVATE, fd, 0);
-    if (NULL == map) {
-        fprintf(stderr, "Unable to mmap binary file: %s\n",
+    if (-1 == fstat(fd, &st)) {
+        fprintf(stderr, "Unable to stat binary file: %s\n",
                 strerror(errno));
         return -1;
     }
+    if (!S_ISREG(st.st_mode) || 0 == st.st_size) {
+        // pipes and other special files cannot be mapped: copy their
+        // contents to a temporary file read through windows
+        spool_fd = spool_file_contents(fd, &spool_size);
+        if (-1 == spool_fd) {
+            return -1;
+        }
+        open_windowed_file_source(fs, spool_fd, spool_size,
+                                  0, -1 /* defaults */);
+        fs->windows->owns_fd = TRUE;
+        fs->fd = fd;
+        return 0;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == map) {
+        // not enough address space to map the whole file: map
+        // windows of it on demand
+        open_windowed_file_source(fs, fd, st.st_size,
+                                  0, -1 /* defaults */);
+        return 0;
+    }
     fs->fd = fd;
     fs->map = map;
-    fs->map_length = map_length;
+    fs->map_length = (size_t)st.st_size;
 
     fs->ds.ds_data = map;
-    fs->ds.ds_data_length = map_length;
+    fs->ds.ds_data_length = (size_t)st.st_size;
 
     return 0;
 }
 
+static int
+unload_file_source(struct bitpunch_file_source *fs)
+{
+    struct data_window *win, *twin;
+    int ret;
+
+    ret = 0;
+    if (NULL != fs->windows) {
+        TAILQ_FOREACH_SAFE(win, &fs->windows->windows, list, twin) {
+            data_window_free(fs->windows, win);
+        }
+        if (fs->windows->owns_fd) {
+            ret = close(fs->windows->fd);
+        }
+        pthread_mutex_destroy(&fs->windows->lock);
+        free(fs->windows);
+        fs->windows = NULL;
+        fs->ds.backend.read_range = NULL;
+        fs->ds.backend.pin_range = NULL;
+        fs->ds.backend.unpin = NULL;
+    } else if (NULL != fs->map) {
+        ret = munmap(fs->map, fs->map_length);
+        fs->map = NULL;
+        fs->map_length = 0;
+    }
+    return ret;
+}
+
 static int
 open_file_source_from_file_path(
-    struct bitpunch_file_source *fs, const char *path)
+    struct bitpunch_file_source *fs, const char *path, struct stat *stp)
 {
     int fd;
 
@@ -157,6 +468,12 @@ open_file_source_from_file_path(
                 path, strerror(errno));
         return -1;
     }
+    if (-1 == fstat(fd, stp)) {
+        fprintf(stderr, "Unable to open binary file %s: fstat failed: %s\n",
+                path, strerror(errno));
+        (void)close(fd);
+        return -1;
+    }
     if (-1 == open_file_source_from_fd(fs, fd)) {
         (void)close(fd);
         return -1;
@@ -164,13 +481,38 @@ open_file_source_from_file_path(
     return 0;
 }
 
+/**
+ * @brief identify a file source from the device, inode, modification
+ * time and size of the file, as long as it remains open
+ */
+static char *
+data_source_get_index_key_file(struct bitpunch_data_source *ds)
+{
+    struct bitpunch_file_source *fs;
+    struct stat st;
+    char *key;
+
+    fs = (struct bitpunch_file_source *)ds;
+    if (-1 == fstat(fs->fd, &st) || !S_ISREG(st.st_mode)
+        || (size_t)st.st_size != ds->ds_data_length) {
+        return NULL;
+    }
+    if (-1 == asprintf(&key, "%"PRIx64"-%"PRIx64"-%"PRIx64".%09ld-%"PRIx64,
+                       (uint64_t)st.st_dev, (uint64_t)st.st_ino,
+                       (uint64_t)st.st_mtim.tv_sec, st.st_mtim.tv_nsec,
+                       (uint64_t)st.st_size)) {
+        return NULL;
+    }
+    return key;
+}
+
 static int
 data_source_close_file_path(struct bitpunch_data_source *ds)
 {
     struct bitpunch_file_source *fs;
 
     fs = (struct bitpunch_file_source *)ds;
-    if (-1 == munmap(fs->map, fs->map_length)) {
+    if (-1 == unload_file_source(fs)) {
         return -1;
     }
     if (-1 == close(fs->fd)) {
@@ -180,37 +522,356 @@ data_source_close_file_path(struct bitpunch_data_source *ds)
     return 0;
 }
 
+/*
+ * file data source cache
+ *
+ * File sources opened by path are cached by file identity (device,
+ * inode, modification time and size), so that a file modified or
+ * replaced since it was cached is reopened instead of being reused.
+ * Cached entries no longer in use are kept in a LRU list, and evicted
+ * when the cache exceeds its entry or byte budget.
+ *
+ * The cache is protected by file_cache.lock, which is also held when
+ * the use count of a cached file source moves from or to zero, so
+ * that lookups never return an entry being released.
+ */
+
+#define FILE_CACHE_DEFAULT_MAX_ENTRIES 1024
+#define FILE_CACHE_DEFAULT_MAX_BYTES   ((size_t)1024 * 1024 * 1024)
+#define FILE_CACHE_MIN_BUCKETS         64
+
+struct file_source_key {
+    dev_t dev;
+    ino_t ino;
+    struct timespec mtime;
+    off_t size;
+};
+
+struct cached_file_source {
+    struct bitpunch_file_source fs; /* inherits */
+    struct file_source_key key;
+    struct cached_file_source *hash_next;
+    /** in file_cache.unused_lru when not in use */
+    TAILQ_ENTRY(cached_file_source) lru;
+};
+
+TAILQ_HEAD(cached_file_source_list, cached_file_source);
+
+static struct file_cache {
+    pthread_mutex_t lock;
+    struct cached_file_source **buckets;
+    size_t n_buckets;
+    struct cached_file_source_list unused_lru;
+    size_t max_entries;
+    size_t max_bytes;
+    struct bitpunch_file_cache_stats stats;
+} file_cache = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+void
+data_source_global_init(void)
+{
+    file_cache.n_buckets = FILE_CACHE_MIN_BUCKETS;
+    file_cache.buckets = malloc0_safe(
+        file_cache.n_buckets * sizeof (struct cached_file_source *));
+    TAILQ_INIT(&file_cache.unused_lru);
+    file_cache.max_entries = FILE_CACHE_DEFAULT_MAX_ENTRIES;
+    file_cache.max_bytes = FILE_CACHE_DEFAULT_MAX_BYTES;
+    memset(&file_cache.stats, 0, sizeof (file_cache.stats));
+}
+
+static void
+file_source_key_from_stat(struct file_source_key *key, const struct stat *st)
+{
+    memset(key, 0, sizeof (*key));
+    key->dev = st->st_dev;
+    key->ino = st->st_ino;
+    key->mtime = st->st_mtim;
+    key->size = st->st_size;
+}
+
+static int
+file_source_key_equals(const struct file_source_key *key1,
+                       const struct file_source_key *key2)
+{
+    return key1->dev == key2->dev
+        && key1->ino == key2->ino
+        && key1->mtime.tv_sec == key2->mtime.tv_sec
+        && key1->mtime.tv_nsec == key2->mtime.tv_nsec
+        && key1->size == key2->size;
+}
+
+static struct cached_file_source **
+file_cache_bucket(const struct file_source_key *key)
+{
+    uint64_t hash;
+
+    // only hash the file identity, so that stale versions of a file
+    // land in the same bucket as its current version
+    hash = ((uint64_t)key->dev * 0x9e3779b97f4a7c15ULL)
+        ^ ((uint64_t)key->ino * 0xc2b2ae3d27d4eb4fULL);
+    hash ^= hash >> 29;
+    return &file_cache.buckets[hash & (file_cache.n_buckets - 1)];
+}
+
+static void
+file_cache_resize(size_t n_buckets)
+{
+    struct cached_file_source **old_buckets;
+    size_t old_n_buckets;
+    struct cached_file_source *cfs;
+    struct cached_file_source **bucket;
+    size_t i;
+
+    old_buckets = file_cache.buckets;
+    old_n_buckets = file_cache.n_buckets;
+    file_cache.n_buckets = n_buckets;
+    file_cache.buckets = malloc0_safe(
+        n_buckets * sizeof (struct cached_file_source *));
+    for (i = 0; i < old_n_buckets; ++i) {
+        while (NULL != old_buckets[i]) {
+            cfs = old_buckets[i];
+            old_buckets[i] = cfs->hash_next;
+            bucket = file_cache_bucket(&cfs->key);
+            cfs->hash_next = *bucket;
+            *bucket = cfs;
+        }
+    }
+    free(old_buckets);
+}
+
+static void
+file_cache_insert(struct cached_file_source *cfs)
+{
+    struct cached_file_source **bucket;
+
+    if (file_cache.stats.n_entries >= file_cache.n_buckets) {
+        file_cache_resize(file_cache.n_buckets * 2);
+    }
+    bucket = file_cache_bucket(&cfs->key);
+    cfs->hash_next = *bucket;
+    *bucket = cfs;
+    cfs->fs.ds.flags |= BITPUNCH_DATA_SOURCE_CACHED;
+    ++file_cache.stats.n_entries;
+    file_cache.stats.n_bytes += cfs->fs.ds.ds_data_length;
+}
+
+/**
+ * @brief remove an entry from the cache
+ *
+ * The entry is freed if not in use, otherwise it is freed by
+ * bitpunch_data_source_release() when no longer in use.
+ */
+static void
+file_cache_remove(struct cached_file_source *cfs)
+{
+    struct cached_file_source **pcfs;
+
+    pcfs = file_cache_bucket(&cfs->key);
+    while (*pcfs != cfs) {
+        pcfs = &(*pcfs)->hash_next;
+    }
+    *pcfs = cfs->hash_next;
+    cfs->fs.ds.flags &= ~BITPUNCH_DATA_SOURCE_CACHED;
+    --file_cache.stats.n_entries;
+    file_cache.stats.n_bytes -= cfs->fs.ds.ds_data_length;
+    if (0 == refcount_read(&cfs->fs.ds.use_count)) {
+        TAILQ_REMOVE(&file_cache.unused_lru, cfs, lru);
+        (void) data_source_free((struct bitpunch_data_source *)cfs);
+    }
+}
+
+static void
+file_cache_enforce_budget(void)
+{
+    struct cached_file_source *cfs;
+
+    while ((file_cache.stats.n_entries > file_cache.max_entries
+            || file_cache.stats.n_bytes > file_cache.max_bytes)
+           && !TAILQ_EMPTY(&file_cache.unused_lru)) {
+        cfs = TAILQ_LAST(&file_cache.unused_lru, cached_file_source_list);
+        file_cache_remove(cfs);
+        ++file_cache.stats.n_evictions;
+    }
+}
+
+/**
+ * @brief lookup the cached version of a file matching @ref key
+ *
+ * Cached versions of the same file with a different modification
+ * time or size are stale, they are removed from the cache.
+ */
+static struct cached_file_source *
+file_cache_lookup(const struct file_source_key *key)
+{
+    struct cached_file_source *cfs, *next_cfs;
+    struct cached_file_source *found;
+
+    found = NULL;
+    for (cfs = *file_cache_bucket(key); NULL != cfs; cfs = next_cfs) {
+        next_cfs = cfs->hash_next;
+        if (file_source_key_equals(&cfs->key, key)) {
+            found = cfs;
+        } else if (cfs->key.dev == key->dev && cfs->key.ino == key->ino) {
+            file_cache_remove(cfs);
+            ++file_cache.stats.n_invalidations;
+        }
+    }
+    return found;
+}
+
+void
+data_source_global_destroy(void)
+{
+    struct cached_file_source *cfs;
+    size_t i;
+
+    for (i = 0; i < file_cache.n_buckets; ++i) {
+        while (NULL != file_cache.buckets[i]) {
+            cfs = file_cache.buckets[i];
+            file_cache.buckets[i] = cfs->hash_next;
+            (void) data_source_free((struct bitpunch_data_source *)cfs);
+        }
+    }
+    free(file_cache.buckets);
+    file_cache.buckets = NULL;
+    file_cache.n_buckets = 0;
+    TAILQ_INIT(&file_cache.unused_lru);
+    file_cache.stats.n_entries = 0;
+    file_cache.stats.n_bytes = 0;
+}
+
+/**
+ * @brief set limits of the file data source cache
+ *
+ * Entries not in use are evicted, least recently used first, while
+ * the cache holds more than @ref max_entries files or more than
+ * @ref max_bytes bytes of file contents.
+ */
+void
+bitpunch_data_source_set_file_cache_limits(size_t max_entries,
+                                           size_t max_bytes)
+{
+    pthread_mutex_lock(&file_cache.lock);
+    file_cache.max_entries = max_entries;
+    file_cache.max_bytes = max_bytes;
+    file_cache_enforce_budget();
+    pthread_mutex_unlock(&file_cache.lock);
+}
+
+void
+bitpunch_data_source_get_file_cache_stats(
+    struct bitpunch_file_cache_stats *statsp)
+{
+    pthread_mutex_lock(&file_cache.lock);
+    *statsp = file_cache.stats;
+    pthread_mutex_unlock(&file_cache.lock);
+}
+
+/**
+ * @brief take a reference on a cached file source
+ *
+ * Called with file_cache.lock held.
+ */
+static void
+file_cache_acquire_entry(struct cached_file_source *cfs)
+{
+    if (0 == refcount_read(&cfs->fs.ds.use_count)) {
+        TAILQ_REMOVE(&file_cache.unused_lru, cfs, lru);
+    }
+    refcount_inc(&cfs->fs.ds.use_count);
+}
+
 int
 bitpunch_data_source_create_from_file_path(
     struct bitpunch_data_source **dsp, const char *path)
 {
-    struct bitpunch_file_source *fs;
+    struct cached_file_source *cfs;
+    struct file_source_key key;
+    struct stat st;
 
     assert(NULL != path);
     assert(NULL != dsp);
 
-    fs = lookup_cached_file_source(path);
-    if (NULL == fs) {
-        fs = new_safe(struct bitpunch_file_source);
-        fs->ds.use_count = 1;
-        fs->ds.backend.close = data_source_close_file_path;
-        if (-1 == open_file_source_from_file_path(fs, path)) {
-            free(fs);
-            return -1;
+    pthread_mutex_lock(&file_cache.lock);
+    if (0 == stat(path, &st) && S_ISREG(st.st_mode)) {
+        file_source_key_from_stat(&key, &st);
+        cfs = file_cache_lookup(&key);
+        if (NULL != cfs) {
+            file_cache_acquire_entry(cfs);
+            ++file_cache.stats.n_hits;
+            pthread_mutex_unlock(&file_cache.lock);
+            *dsp = (struct bitpunch_data_source *)cfs;
+            return 0;
         }
-        fs->path = strdup_safe(path);
-        add_file_source_to_cache(fs);
-    } else {
-        ++fs->ds.use_count;
     }
-    *dsp = (struct bitpunch_data_source *)fs;
+    ++file_cache.stats.n_misses;
+    pthread_mutex_unlock(&file_cache.lock);
+    cfs = new_safe(struct cached_file_source);
+    cfs->fs.ds.use_count = 1;
+    cfs->fs.ds.backend.close = data_source_close_file_path;
+    cfs->fs.ds.backend.get_index_key = data_source_get_index_key_file;
+    if (-1 == open_file_source_from_file_path(&cfs->fs, path, &st)) {
+        free(cfs);
+        return -1;
+    }
+    cfs->fs.path = strdup_safe(path);
+    // contents of special files (e.g. named pipes) are not cached
+    if (S_ISREG(st.st_mode)) {
+        struct cached_file_source *found;
+
+        file_source_key_from_stat(&cfs->key, &st);
+        pthread_mutex_lock(&file_cache.lock);
+        // the file may have changed since the lookup, or another
+        // thread may have opened it meanwhile
+        found = file_cache_lookup(&cfs->key);
+        if (NULL != found) {
+            file_cache_acquire_entry(found);
+            pthread_mutex_unlock(&file_cache.lock);
+            (void) data_source_free((struct bitpunch_data_source *)cfs);
+            *dsp = (struct bitpunch_data_source *)found;
+            return 0;
+        }
+        file_cache_insert(cfs);
+        file_cache_enforce_budget();
+        pthread_mutex_unlock(&file_cache.lock);
+    }
+    *dsp = (struct bitpunch_data_source *)cfs;
     return 0;
 }
 
+/**
+ * @brief drop cached versions of file at @ref path
+ *
+ * Changes are detected automatically from the file modification time
+ * and size, this forces reopening a file rewritten without changing
+ * them. Data sources in use keep their current contents.
+ */
 void
 bitpunch_data_source_notify_file_change(const char *path)
 {
-    (void) refresh_cached_file_source(path);
+    struct cached_file_source *cfs, *next_cfs;
+    size_t i;
+
+    pthread_mutex_lock(&file_cache.lock);
+    for (i = 0; i < file_cache.n_buckets; ++i) {
+        for (cfs = file_cache.buckets[i]; NULL != cfs; cfs = next_cfs) {
+            next_cfs = cfs->hash_next;
+            if (0 == strcmp(cfs->fs.path, path)) {
+                file_cache_remove(cfs);
+                ++file_cache.stats.n_invalidations;
+            }
+        }
+    }
+    pthread_mutex_unlock(&file_cache.lock);
+}
+
+static void
+file_cache_release_entry(struct cached_file_source *cfs)
+{
+    TAILQ_INSERT_HEAD(&file_cache.unused_lru, cfs, lru);
+    file_cache_enforce_budget();
 }
 
 static int
@@ -219,7 +880,7 @@ data_source_close_from_file_descriptor(struct bitpunch_data_source *ds)
     struct bitpunch_file_source *fs;
 
     fs = (struct bitpunch_file_source *)ds;
-    return munmap(fs->map, fs->map_length);
+    return unload_file_source(fs);
 }
 
 int
@@ -234,6 +895,7 @@ bitpunch_data_source_create_from_file_descriptor(
     fs = new_safe(struct bitpunch_file_source);
     fs->ds.use_count = 1;
     fs->ds.backend.close = data_source_close_from_file_descriptor;
+    fs->ds.backend.get_index_key = data_source_get_index_key_file;
     fs->ds.flags = BITPUNCH_DATA_SOURCE_EXTERNAL;
 
     if (-1 == open_file_source_from_fd(fs, fd)) {
@@ -247,6 +909,48 @@ bitpunch_data_source_create_from_file_descriptor(
     return 0;
 }
 
+/**
+ * @brief create a data source reading a file through windows mapped
+ * on demand, rather than mapping the whole file at once
+ *
+ * @param window_size size of windows (rounded up to a multiple of
+ * the page size), or 0 for the default size
+ * @param max_cached_windows maximum number of unpinned windows kept
+ * mapped, or -1 for the default
+ */
+int
+bitpunch_data_source_create_windowed_from_file_descriptor(
+    struct bitpunch_data_source **dsp, int fd,
+    size_t window_size, int max_cached_windows)
+{
+    struct bitpunch_file_source *fs;
+    struct stat st;
+
+    assert(-1 != fd);
+    assert(NULL != dsp);
+
+    if (-1 == fstat(fd, &st)) {
+        fprintf(stderr, "Unable to stat binary file: %s\n",
+                strerror(errno));
+        return -1;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        fprintf(stderr,
+                "Windowed data source requires a regular file (fd=%d)\n",
+                fd);
+        return -1;
+    }
+    fs = new_safe(struct bitpunch_file_source);
+    fs->ds.use_count = 1;
+    fs->ds.backend.close = data_source_close_from_file_descriptor;
+    fs->ds.backend.get_index_key = data_source_get_index_key_file;
+    fs->ds.flags = BITPUNCH_DATA_SOURCE_EXTERNAL;
+    open_windowed_file_source(fs, fd, st.st_size,
+                              window_size, max_cached_windows);
+    *dsp = (struct bitpunch_data_source *)fs;
+    return 0;
+}
+
 static int
 data_source_close_managed_memory(struct bitpunch_data_source *ds)
 {
@@ -315,38 +1019,311 @@ data_source_free(struct bitpunch_data_source *ds)
 void
 bitpunch_data_source_acquire(struct bitpunch_data_source *ds)
 {
-    ++ds->use_count;
+    refcount_inc(&ds->use_count);
 }
 
 int
 bitpunch_data_source_release(struct bitpunch_data_source *ds)
 {
+    int cached;
+
     if (NULL == ds) {
         return 0;
     }
-    assert(ds->use_count > 0);
-    --ds->use_count;
-    if (0 == ds->use_count) {
-        if (0 == (ds->flags & (BITPUNCH_DATA_SOURCE_CACHED |
-                               BITPUNCH_DATA_SOURCE_EXTERNAL))) {
-            return data_source_free(ds);
-        }
-        // we could implement cleanup for less-used cache entries here
+    assert(refcount_read(&ds->use_count) > 0);
+    if (refcount_dec_not_last(&ds->use_count)) {
+        return 0;
+    }
+    // the last reference is dropped with the file cache locked, so
+    // that a concurrent cache lookup either takes a new reference
+    // before, or finds the entry back in the LRU list after
+    pthread_mutex_lock(&file_cache.lock);
+    if (0 != refcount_dec(&ds->use_count)) {
+        pthread_mutex_unlock(&file_cache.lock);
+        return 0;
+    }
+    cached = (0 != (ds->flags & BITPUNCH_DATA_SOURCE_CACHED));
+    if (cached) {
+        file_cache_release_entry((struct cached_file_source *)ds);
+    }
+    pthread_mutex_unlock(&file_cache.lock);
+    if (!cached && 0 == (ds->flags & BITPUNCH_DATA_SOURCE_EXTERNAL)) {
+        return data_source_free(ds);
     }
     return 0;
 }
 
-static int
-file_source_refresh_internal(struct bitpunch_file_source *fs)
+/**
+ * @brief copy a range of data source contents into @ref buf
+ *
+ * @retval 0 success
+ * @retval -1 range out of bounds or read error
+ */
+int
+bitpunch_data_source_read_range(struct bitpunch_data_source *ds,
+                                int64_t offset, int64_t length, char *buf)
 {
-    int ret;
-    char *path;
+    if (offset < 0 || length < 0
+        || offset + length > (int64_t)ds->ds_data_length) {
+        return -1;
+    }
+    if (NULL == ds->backend.read_range || 0 == length) {
+        memcpy(buf, ds->ds_data + offset, length);
+        return 0;
+    }
+    return ds->backend.read_range(ds, offset, length, buf);
+}
 
-    path = strdup(fs->path);
-    ret = data_source_close(&fs->ds);
-    if (-1 == ret) {
+/**
+ * @brief make a range of data source contents accessible in memory
+ *
+ * @param[out] pin pin to release with bitpunch_data_source_unpin()
+ * @param[out] datap pointer to contents at @ref offset
+ *
+ * @retval 0 success
+ * @retval -1 range out of bounds or read error
+ */
+int
+bitpunch_data_source_pin_range(struct bitpunch_data_source *ds,
+                               int64_t offset, int64_t length,
+                               struct bitpunch_data_pin *pin,
+                               const char **datap)
+{
+    static const char empty_data[1];
+
+    if (offset < 0 || length < 0
+        || offset + length > (int64_t)ds->ds_data_length) {
         return -1;
     }
-    return open_file_source_from_file_path(fs, path);
-    free(path);
+    if (NULL == ds->backend.pin_range) {
+        pin->base = ds->ds_data;
+        pin->start_offset = 0;
+        pin->end_offset = (int64_t)ds->ds_data_length;
+        pin->handle = NULL;
+    } else if (0 == length) {
+        pin->base = empty_data;
+        pin->start_offset = offset;
+        pin->end_offset = offset;
+        pin->handle = NULL;
+    } else if (-1 == ds->backend.pin_range(ds, offset, length, pin)) {
+        return -1;
+    }
+    *datap = pin->base + (offset - pin->start_offset);
+    return 0;
+}
+
+void
+bitpunch_data_source_unpin(struct bitpunch_data_source *ds,
+                           struct bitpunch_data_pin *pin)
+{
+    if (NULL != pin->handle) {
+        ds->backend.unpin(ds, pin);
+        pin->handle = NULL;
+    }
+}
+
+/**
+ * @brief get a key identifying data source contents across sessions
+ *
+ * Keys are used to name sidecar index files, two data sources with
+ * the same key have the same contents.
+ *
+ * @return the allocated key to be freed by the caller, or NULL if
+ * contents have no stable identity (e.g. memory buffers)
+ */
+char *
+bitpunch_data_source_get_index_key(struct bitpunch_data_source *ds)
+{
+    if (NULL == ds->backend.get_index_key) {
+        return NULL;
+    }
+    return ds->backend.get_index_key(ds);
+}
+
+
+#ifndef DISABLE_UTESTS
+
+#include <check.h>
+
+#define TEST_DATA_SOURCE_SIZE (256 * 1024 + 100)
+
+static char
+test_data_source_byte(int64_t offset)
+{
+    return (char)(offset * 7 % 251);
+}
+
+static void
+test_data_source_check_range(const char *data, int64_t offset,
+                             int64_t length)
+{
+    int64_t i;
+
+    for (i = 0; i < length; ++i) {
+        ck_assert(data[i] == test_data_source_byte(offset + i));
+    }
 }
+
+START_TEST(test_data_source_windowed)
+{
+    char path[] = "/tmp/check_bitpunch_data_source.XXXXXX";
+    char *contents;
+    char buf[10000];
+    struct bitpunch_data_source *ds;
+    struct bitpunch_data_pin pin;
+    struct bitpunch_data_pin pin2;
+    const char *data;
+    int64_t offset;
+    int64_t length;
+    int64_t i;
+    int fd;
+
+    contents = malloc_safe(TEST_DATA_SOURCE_SIZE);
+    for (i = 0; i < TEST_DATA_SOURCE_SIZE; ++i) {
+        contents[i] = test_data_source_byte(i);
+    }
+    fd = mkstemp(path);
+    ck_assert(-1 != fd);
+    (void) unlink(path);
+    ck_assert(TEST_DATA_SOURCE_SIZE
+              == write(fd, contents, TEST_DATA_SOURCE_SIZE));
+    free(contents);
+
+    // small windows and cache to exercise spanning ranges and eviction
+    ck_assert(0 == bitpunch_data_source_create_windowed_from_file_descriptor(
+                  &ds, fd, 4096, 2));
+    ck_assert(NULL == ds->ds_data);
+    ck_assert(TEST_DATA_SOURCE_SIZE == ds->ds_data_length);
+
+    for (offset = 0; offset < TEST_DATA_SOURCE_SIZE; offset += 3000) {
+        length = MIN((int64_t)sizeof (buf), TEST_DATA_SOURCE_SIZE - offset);
+        ck_assert(0 == bitpunch_data_source_pin_range(ds, offset, length,
+                                                      &pin, &data));
+        test_data_source_check_range(data, offset, length);
+        // a second pin on the same range must not invalidate the first
+        ck_assert(0 == bitpunch_data_source_pin_range(ds, 0, 100,
+                                                      &pin2, &data));
+        test_data_source_check_range(data, 0, 100);
+        bitpunch_data_source_unpin(ds, &pin2);
+        ck_assert(0 == bitpunch_data_source_read_range(ds, offset, length,
+                                                       buf));
+        test_data_source_check_range(buf, offset, length);
+        bitpunch_data_source_unpin(ds, &pin);
+    }
+    ck_assert(-1 == bitpunch_data_source_pin_range(
+                  ds, TEST_DATA_SOURCE_SIZE - 1, 2, &pin, &data));
+    ck_assert(-1 == bitpunch_data_source_read_range(
+                  ds, TEST_DATA_SOURCE_SIZE, 1, buf));
+    ck_assert(0 == bitpunch_data_source_pin_range(
+                  ds, TEST_DATA_SOURCE_SIZE, 0, &pin, &data));
+    bitpunch_data_source_unpin(ds, &pin);
+
+    ck_assert(0 == bitpunch_data_source_release(ds));
+    (void) close(fd);
+}
+END_TEST
+
+START_TEST(test_data_source_value_pins)
+{
+    char path[] = "/tmp/check_bitpunch_data_source.XXXXXX";
+    char *contents;
+    struct bitpunch_data_source *ds;
+    struct data_window_cache *wc;
+    struct data_window *win;
+    struct bitpunch_data_pin pin;
+    const char *data;
+    expr_value_t value;
+    expr_value_t value_dup;
+    int64_t offset;
+    int64_t i;
+    int n_windows;
+    int fd;
+
+    contents = malloc_safe(TEST_DATA_SOURCE_SIZE);
+    for (i = 0; i < TEST_DATA_SOURCE_SIZE; ++i) {
+        contents[i] = test_data_source_byte(i);
+    }
+    fd = mkstemp(path);
+    ck_assert(-1 != fd);
+    (void) unlink(path);
+    ck_assert(TEST_DATA_SOURCE_SIZE
+              == write(fd, contents, TEST_DATA_SOURCE_SIZE));
+    free(contents);
+
+    ck_assert(0 == bitpunch_data_source_create_windowed_from_file_descriptor(
+                  &ds, fd, 4096, 2));
+    wc = ((struct bitpunch_file_source *)ds)->windows;
+    for (offset = 0; offset + 100 <= TEST_DATA_SOURCE_SIZE; offset += 5000) {
+        ck_assert(0 == bitpunch_data_source_pin_range(ds, offset, 100,
+                                                      &pin, &data));
+        value = expr_value_as_string_len(data, 100);
+        expr_value_attach_pin(&value, ds, &pin);
+        ck_assert(NULL == pin.handle);
+        ck_assert(NULL != value.string.pin);
+        // contents remain pinned as long as a value references them
+        value_dup = expr_value_dup(value);
+        expr_value_destroy(value);
+        test_data_source_check_range(value_dup.string.str, offset, 100);
+        expr_value_destroy(value_dup);
+        // windows released by values are evicted past the cache limit
+        n_windows = 0;
+        TAILQ_FOREACH(win, &wc->windows, list) {
+            ck_assert(0 == win->pin_count);
+            ++n_windows;
+        }
+        ck_assert(n_windows <= 2);
+    }
+    ck_assert(0 == bitpunch_data_source_release(ds));
+    (void) close(fd);
+}
+END_TEST
+
+START_TEST(test_data_source_pipe)
+{
+    char contents[100000];
+    char read_contents[100000];
+    struct bitpunch_data_source *ds;
+    int pipe_fds[2];
+    pid_t pid;
+    int64_t i;
+
+    for (i = 0; i < sizeof (contents); ++i) {
+        contents[i] = test_data_source_byte(i);
+    }
+    ck_assert(0 == pipe(pipe_fds));
+    pid = fork();
+    ck_assert(-1 != pid);
+    if (0 == pid) {
+        (void) close(pipe_fds[0]);
+        (void) write(pipe_fds[1], contents, sizeof (contents));
+        _exit(0);
+    }
+    (void) close(pipe_fds[1]);
+
+    // non-seekable input is spooled to a temporary file read
+    // through windows, rather than loaded in memory
+    ck_assert(0 == bitpunch_data_source_create_from_file_descriptor(
+                  &ds, pipe_fds[0]));
+    ck_assert(NULL == ds->ds_data);
+    ck_assert(sizeof (contents) == ds->ds_data_length);
+    ck_assert(0 == bitpunch_data_source_read_range(ds, 0, sizeof (contents),
+                                                   read_contents));
+    ck_assert(0 == memcmp(read_contents, contents, sizeof (contents)));
+    ck_assert(NULL == bitpunch_data_source_get_index_key(ds));
+    ck_assert(0 == bitpunch_data_source_release(ds));
+    (void) close(pipe_fds[0]);
+}
+END_TEST
+
+void check_data_source_add_tcases(Suite *s)
+{
+    TCase *tc_data_source;
+
+    tc_data_source = tcase_create("data_source");
+    tcase_add_test(tc_data_source, test_data_source_windowed);
+    tcase_add_test(tc_data_source, test_data_source_value_pins);
+    tcase_add_test(tc_data_source, test_data_source_pipe);
+    suite_add_tcase(s, tc_data_source);
+}
+
+#endif // #ifndef DISABLE_UTESTS
@@ -29,15 +29,18 @@
  * DAMAGE.
  */
 
+#define _GNU_SOURCE
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <pthread.h>
 
 #include "api/bitpunch-structs.h"
 #include "core/ast.h"
 #include "core/expr.h"
+#include "core/expr_bytecode.h"
 #include "core/browse.h"
 #include "core/browse_internal.h"
 #include "core/print.h"
@@ -49,6 +52,7 @@
 #include "filters/byte.h"
 #include "filters/byte_array.h"
 #include "filters/byte_slice.h"
+#include "utils/regex.h"
 #include PATH_TO_PARSER_TAB_H
 
 //#define OUTPUT_DEP_GRAPH
@@ -128,8 +132,28 @@ compile_subscript_index_cb(struct compile_ctx *ctx,
 ARRAY_GENERATE_API_DEFS(ast_node_hdl_array, struct ast_node_hdl *)
 
 
-int
-bitpunch_compile_schema(struct ast_node_hdl *schema)
+/*
+ * Parsing, resolving and compiling mutate AST nodes that may be
+ * shared between boards browsed from different threads, they are
+ * serialized by the compile lock. It is recursive since compiling may
+ * parse and resolve internal expressions.
+ */
+static pthread_mutex_t compile_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+void
+compile_lock(void)
+{
+    pthread_mutex_lock(&compile_mutex);
+}
+
+void
+compile_unlock(void)
+{
+    pthread_mutex_unlock(&compile_mutex);
+}
+
+static int
+compile_schema_locked(struct ast_node_hdl *schema)
 {
     if (-1 == resolve_identifiers(schema, NULL,
                                   RESOLVE_EXPECT_TYPE,
@@ -148,6 +172,17 @@ bitpunch_compile_schema(struct ast_node_hdl *schema)
     return 0;
 }
 
+int
+bitpunch_compile_schema(struct ast_node_hdl *schema)
+{
+    int ret;
+
+    compile_lock();
+    ret = compile_schema_locked(schema);
+    compile_unlock();
+    return ret;
+}
+
 static void
 compile_ctx_init(struct compile_ctx *ctx)
 {
@@ -201,7 +236,7 @@ reverse_lookup_typename(const struct ast_node_hdl *node,
     return NULL;
 }
 
-static const struct statement_list *
+const struct statement_list *
 block_stmt_lists_get_list(enum statement_type stmt_type,
                           const struct block_stmt_list *stmt_lists)
 {
@@ -1041,6 +1076,7 @@ resolve_identifiers_internal(struct ast_node_hdl *node,
     case AST_NODE_TYPE_OP_MUL:
     case AST_NODE_TYPE_OP_DIV:
     case AST_NODE_TYPE_OP_MOD:
+    case AST_NODE_TYPE_OP_MATCH:
         return resolve_identifiers_operator(node, 2, visible_refs,
                                             expect_mask, resolve_tags);
     case AST_NODE_TYPE_OP_FILTER:
@@ -1137,6 +1173,8 @@ op_type_ast2rexpr(enum ast_node_type type)
         return AST_NODE_TYPE_REXPR_OP_DIV;
     case AST_NODE_TYPE_OP_MOD:
         return AST_NODE_TYPE_REXPR_OP_MOD;
+    case AST_NODE_TYPE_OP_MATCH:
+        return AST_NODE_TYPE_REXPR_OP_MATCH;
     case AST_NODE_TYPE_OP_UPLUS:
         return AST_NODE_TYPE_REXPR_OP_UPLUS;
     case AST_NODE_TYPE_OP_UMINUS:
@@ -1216,10 +1254,16 @@ resolve_expr_scoped_recur(struct ast_node_hdl *expr,
 int
 bitpunch_resolve_expr(struct ast_node_hdl *expr, struct box *scope)
 {
+    int ret;
+
+    compile_lock();
     if (NULL != scope) {
-        return resolve_expr_scoped_recur(expr, scope, NULL, NULL);
+        ret = resolve_expr_scoped_recur(expr, scope, NULL, NULL);
+    } else {
+        ret = resolve_expr_internal(expr, NULL);
     }
-    return resolve_expr_internal(expr, NULL);
+    compile_unlock();
+    return ret;
 }
 
 __attribute__((unused))
@@ -1623,6 +1667,24 @@ compile_field(struct field *field,
     return (DEP_RESOLVER_OK == ret ? 0 : -1);
 }
 
+/**
+ * @brief flag named expressions and attributes whose result can be
+ * memoized in the box they are evaluated in
+ */
+static void
+compile_named_exprs_purity(const struct statement_list *named_expr_list)
+{
+    struct named_expr *named_expr;
+
+    STATEMENT_FOREACH(named_expr, named_expr, named_expr_list, list) {
+        if (ast_node_is_pure(named_expr->expr)) {
+            named_expr->nstmt.stmt.stmt_flags |= NAMED_EXPR_FLAG_PURE;
+        } else {
+            named_expr->nstmt.stmt.stmt_flags &= ~NAMED_EXPR_FLAG_PURE;
+        }
+    }
+}
+
 int
 compile_attributes(const struct statement_list *attribute_list,
                    dep_resolver_tagset_t tags_pre,
@@ -1639,6 +1701,7 @@ compile_attributes(const struct statement_list *attribute_list,
     if (!compile_continue(ctx)) {
         return -1;
     }
+    compile_named_exprs_purity(attribute_list);
     return 0;
 }
 
@@ -1676,6 +1739,7 @@ compile_named_exprs(const struct statement_list *named_expr_list,
     if (!compile_continue(ctx)) {
         return -1;
     }
+    compile_named_exprs_purity(named_expr_list);
     return 0;
 }
 
@@ -2021,6 +2085,7 @@ compile_rexpr_operator_type(
 
         return compile_expr_native_internal(expr, eval_value);
     }
+    expr_bytecode_compile(expr);
     return 0;
 }
 
@@ -2047,6 +2112,85 @@ compile_rexpr_operator(
     return 0;
 }
 
+/**
+ * @brief compile the regular expression match operator "=~"
+ *
+ * The right operand must be a constant string, it is compiled once
+ * here into a matcher kept in the node.
+ */
+static int
+compile_rexpr_operator_match(
+    struct ast_node_hdl *expr,
+    dep_resolver_tagset_t tags,
+    struct compile_ctx *ctx)
+{
+    struct ast_node_hdl *subject;
+    struct ast_node_hdl *pattern_expr;
+    struct expr_value_string pattern;
+    expr_value_t subject_value;
+    struct regex *regex;
+    const char *errmsg;
+    int matched;
+
+    compile_node(expr->ndat->u.rexpr_op.op.operands[0], ctx,
+                 0u, tags, RESOLVE_EXPECT_EXPRESSION);
+    compile_node(expr->ndat->u.rexpr_op.op.operands[1], ctx,
+                 0u, tags, RESOLVE_EXPECT_EXPRESSION);
+    if (!compile_continue(ctx)) {
+        return -1;
+    }
+    if (0 == (tags & COMPILE_TAG_NODE_TYPE)
+        || NULL != expr->ndat->u.rexpr_op_match.regex) {
+        return 0;
+    }
+    subject = ast_node_get_named_expr_target(
+        expr->ndat->u.rexpr_op.op.operands[0]);
+    pattern_expr = ast_node_get_named_expr_target(
+        expr->ndat->u.rexpr_op.op.operands[1]);
+    if (EXPR_VALUE_TYPE_STRING != subject->ndat->u.rexpr.value_type_mask
+        && EXPR_VALUE_TYPE_BYTES != subject->ndat->u.rexpr.value_type_mask) {
+        semantic_error(SEMANTIC_LOGLEVEL_ERROR, &subject->loc,
+                       "left operand of %s must be a string or bytes, "
+                       "not '%s'",
+                       ast_node_type_str(expr->ndat->type),
+                       expr_value_type_str(
+                           subject->ndat->u.rexpr.value_type_mask));
+        return -1;
+    }
+    if (AST_NODE_TYPE_REXPR_NATIVE != pattern_expr->ndat->type
+        || EXPR_VALUE_TYPE_STRING !=
+        pattern_expr->ndat->u.rexpr_native.value.type) {
+        semantic_error(SEMANTIC_LOGLEVEL_ERROR, &pattern_expr->loc,
+                       "right operand of %s must be a constant string",
+                       ast_node_type_str(expr->ndat->type));
+        return -1;
+    }
+    pattern = pattern_expr->ndat->u.rexpr_native.value.string;
+    regex = regex_compile(pattern.str, pattern.len, &errmsg);
+    if (NULL == regex) {
+        semantic_error(SEMANTIC_LOGLEVEL_ERROR, &pattern_expr->loc,
+                       "invalid regular expression: %s", errmsg);
+        return -1;
+    }
+    expr->ndat->u.rexpr.value_type_mask = EXPR_VALUE_TYPE_BOOLEAN;
+    expr->ndat->u.rexpr.dpath_type_mask = EXPR_DPATH_TYPE_NONE;
+    if (AST_NODE_TYPE_REXPR_NATIVE == subject->ndat->type) {
+        subject_value = subject->ndat->u.rexpr_native.value;
+        if (EXPR_VALUE_TYPE_STRING == subject_value.type) {
+            matched = regex_match(regex, subject_value.string.str,
+                                  subject_value.string.len);
+        } else {
+            matched = regex_match(regex, subject_value.bytes.buf,
+                                  subject_value.bytes.len);
+        }
+        regex_free(regex);
+        return compile_expr_native_internal(
+            expr, expr_value_as_boolean(matched));
+    }
+    expr->ndat->u.rexpr_op_match.regex = regex;
+    return 0;
+}
+
 static int
 compile_expr_operator_filter(
     struct ast_node_hdl *node,
@@ -3066,6 +3210,7 @@ compile_node_type_int(struct ast_node_hdl *node,
     case AST_NODE_TYPE_OP_MUL:
     case AST_NODE_TYPE_OP_DIV:
     case AST_NODE_TYPE_OP_MOD:
+    case AST_NODE_TYPE_OP_MATCH:
         return compile_expr_operator(node, 2, tags, ctx);
     case AST_NODE_TYPE_OP_FILTER:
         return compile_expr_operator_filter(node, tags, ctx);
@@ -3112,6 +3257,8 @@ compile_node_type_int(struct ast_node_hdl *node,
     case AST_NODE_TYPE_REXPR_OP_DIV:
     case AST_NODE_TYPE_REXPR_OP_MOD:
         return compile_rexpr_operator(node, 2, tags, ctx);
+    case AST_NODE_TYPE_REXPR_OP_MATCH:
+        return compile_rexpr_operator_match(node, tags, ctx);
     case AST_NODE_TYPE_REXPR_OP_MEMBER:
         return compile_rexpr_member(node, FALSE, tags, ctx);
     case AST_NODE_TYPE_REXPR_OP_SCOPE:
@@ -3344,6 +3491,7 @@ ast_node_is_rexpr(const struct ast_node_hdl *node)
     case AST_NODE_TYPE_REXPR_OP_MUL:
     case AST_NODE_TYPE_REXPR_OP_DIV:
     case AST_NODE_TYPE_REXPR_OP_MOD:
+    case AST_NODE_TYPE_REXPR_OP_MATCH:
     case AST_NODE_TYPE_REXPR_OP_UPLUS:
     case AST_NODE_TYPE_REXPR_OP_UMINUS:
     case AST_NODE_TYPE_REXPR_OP_LNOT:
@@ -3679,6 +3827,103 @@ ast_node_is_trackable(const struct ast_node_hdl *node)
     }
 }
 
+/**
+ * @brief tell if an expression only depends on immutable data
+ *
+ * The result of a pure expression only depends on the box it is
+ * evaluated in, so it can be memoized per box. Named expressions and
+ * attributes referenced by @ref expr are not followed, their own
+ * purity is checked when they are evaluated.
+ */
+int
+ast_node_is_pure(const struct ast_node_hdl *expr)
+{
+    const struct named_expr *param;
+    const struct named_expr *named_expr;
+
+    if (NULL == expr) {
+        return TRUE;
+    }
+    switch (expr->ndat->type) {
+    case AST_NODE_TYPE_EXTERN_NAME:
+    case AST_NODE_TYPE_EXTERN_FUNC:
+    case AST_NODE_TYPE_EXTERN_FILTER:
+    case AST_NODE_TYPE_REXPR_EXTERN_FUNC:
+        // bound to the board at evaluation time
+        return FALSE;
+    case AST_NODE_TYPE_REXPR_OP_EQ:
+    case AST_NODE_TYPE_REXPR_OP_NE:
+    case AST_NODE_TYPE_REXPR_OP_GT:
+    case AST_NODE_TYPE_REXPR_OP_LT:
+    case AST_NODE_TYPE_REXPR_OP_GE:
+    case AST_NODE_TYPE_REXPR_OP_LE:
+    case AST_NODE_TYPE_REXPR_OP_LOR:
+    case AST_NODE_TYPE_REXPR_OP_LAND:
+    case AST_NODE_TYPE_REXPR_OP_BWOR:
+    case AST_NODE_TYPE_REXPR_OP_BWXOR:
+    case AST_NODE_TYPE_REXPR_OP_BWAND:
+    case AST_NODE_TYPE_REXPR_OP_LSHIFT:
+    case AST_NODE_TYPE_REXPR_OP_RSHIFT:
+    case AST_NODE_TYPE_REXPR_OP_ADD:
+    case AST_NODE_TYPE_REXPR_OP_SUB:
+    case AST_NODE_TYPE_REXPR_OP_MUL:
+    case AST_NODE_TYPE_REXPR_OP_DIV:
+    case AST_NODE_TYPE_REXPR_OP_MOD:
+    case AST_NODE_TYPE_REXPR_OP_MATCH:
+    case AST_NODE_TYPE_REXPR_OP_UPLUS:
+    case AST_NODE_TYPE_REXPR_OP_UMINUS:
+    case AST_NODE_TYPE_REXPR_OP_LNOT:
+    case AST_NODE_TYPE_REXPR_OP_BWNOT:
+    case AST_NODE_TYPE_REXPR_OP_SIZEOF:
+    case AST_NODE_TYPE_REXPR_OP_ADDROF:
+    case AST_NODE_TYPE_REXPR_OP_ANCESTOR:
+        return ast_node_is_pure(expr->ndat->u.rexpr_op.op.operands[0])
+            && ast_node_is_pure(expr->ndat->u.rexpr_op.op.operands[1]);
+    case AST_NODE_TYPE_REXPR_OP_FILTER:
+        return ast_node_is_pure(expr->ndat->u.rexpr_op_filter.target)
+            && ast_node_is_pure(expr->ndat->u.rexpr_op_filter.filter_expr);
+    case AST_NODE_TYPE_REXPR_OP_FCALL:
+        if (expr->ndat->u.rexpr_op_fcall.builtin->impure) {
+            return FALSE;
+        }
+        STATEMENT_FOREACH(named_expr, param,
+                          expr->ndat->u.rexpr_op_fcall.func_params, list) {
+            if (!ast_node_is_pure(param->expr)) {
+                return FALSE;
+            }
+        }
+        return TRUE;
+    case AST_NODE_TYPE_REXPR_NAMED_EXPR:
+        // external filters replace the named expression node itself
+        // at evaluation time
+        named_expr = expr->ndat->u.rexpr_named_expr.named_expr;
+        if (AST_NODE_TYPE_EXTERN_NAME == named_expr->expr->ndat->type) {
+            return FALSE;
+        }
+        /*FALLTHROUGH*/
+    case AST_NODE_TYPE_REXPR_FIELD:
+    case AST_NODE_TYPE_REXPR_POLYMORPHIC:
+    case AST_NODE_TYPE_REXPR_SELF:
+        return ast_node_is_pure(
+            expr->ndat->u.rexpr_member_common.anchor_expr);
+    case AST_NODE_TYPE_REXPR_OP_SUBSCRIPT:
+        return ast_node_is_pure(
+            expr->ndat->u.rexpr_op_subscript_common.anchor_expr)
+            && ast_node_is_pure(expr->ndat->u.rexpr_op_subscript.index.key);
+    case AST_NODE_TYPE_REXPR_OP_SUBSCRIPT_SLICE:
+        return ast_node_is_pure(
+            expr->ndat->u.rexpr_op_subscript_common.anchor_expr)
+            && ast_node_is_pure(
+                expr->ndat->u.rexpr_op_subscript_slice.start.key)
+            && ast_node_is_pure(
+                expr->ndat->u.rexpr_op_subscript_slice.end.key);
+    default:
+        // native values and types: attributes of filters are
+        // statements, checked on their own
+        return TRUE;
+    }
+}
+
 int
 ast_node_is_type(const struct ast_node_hdl *node)
 {
@@ -4183,6 +4428,7 @@ fdump_ast_recur(const struct ast_node_hdl *node, int depth,
     case AST_NODE_TYPE_OP_MUL:
     case AST_NODE_TYPE_OP_DIV:
     case AST_NODE_TYPE_OP_MOD:
+    case AST_NODE_TYPE_OP_MATCH:
     case AST_NODE_TYPE_OP_MEMBER:
     case AST_NODE_TYPE_OP_SCOPE:
     case AST_NODE_TYPE_OP_FILTER:
@@ -4312,6 +4558,7 @@ fdump_ast_recur(const struct ast_node_hdl *node, int depth,
     case AST_NODE_TYPE_REXPR_OP_MUL:
     case AST_NODE_TYPE_REXPR_OP_DIV:
     case AST_NODE_TYPE_REXPR_OP_MOD:
+    case AST_NODE_TYPE_REXPR_OP_MATCH:
         dump_ast_rexpr(node, out);
         fprintf(out, "\n");
         fdump_ast_recur(node->ndat->u.rexpr_op.op.operands[0], depth + 1,
@@ -4503,6 +4750,7 @@ dump_ast_type(const struct ast_node_hdl *node, int depth,
     case AST_NODE_TYPE_OP_MUL:
     case AST_NODE_TYPE_OP_DIV:
     case AST_NODE_TYPE_OP_MOD:
+    case AST_NODE_TYPE_OP_MATCH:
     case AST_NODE_TYPE_OP_UPLUS:
     case AST_NODE_TYPE_OP_UMINUS:
     case AST_NODE_TYPE_OP_LNOT:
@@ -4534,6 +4782,7 @@ dump_ast_type(const struct ast_node_hdl *node, int depth,
     case AST_NODE_TYPE_REXPR_OP_MUL:
     case AST_NODE_TYPE_REXPR_OP_DIV:
     case AST_NODE_TYPE_REXPR_OP_MOD:
+    case AST_NODE_TYPE_REXPR_OP_MATCH:
     case AST_NODE_TYPE_REXPR_OP_UPLUS:
     case AST_NODE_TYPE_REXPR_OP_UMINUS:
     case AST_NODE_TYPE_REXPR_OP_LNOT:
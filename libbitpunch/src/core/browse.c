@@ -45,6 +45,8 @@
 #include "core/browse_internal.h"
 #include "core/expr_internal.h"
 #include "core/debug.h"
+#include "utils/obj_pool.h"
+#include "utils/lazy_fmt.h"
 
 //FIXME remove once filters become isolated
 #include "filters/composite.h"
@@ -54,6 +56,60 @@
 #include "filters/array_slice.h"
 #include "filters/byte_slice.h"
 
+/*
+ * Boxes and trackers are created and freed at a high rate while
+ * browsing, they are allocated from object pools rather than with
+ * malloc().
+ */
+static struct obj_pool box_pool =
+    OBJ_POOL_INITIALIZER("box", sizeof (struct box), 64);
+static __thread struct obj_pool_cache *box_pool_cache;
+
+static struct obj_pool tracker_pool =
+    OBJ_POOL_INITIALIZER("tracker", sizeof (struct tracker), 64);
+static __thread struct obj_pool_cache *tracker_pool_cache;
+
+/**
+ * @brief allocate a zeroed box, to be constructed with
+ * box_construct()
+ */
+struct box *
+box_alloc(void)
+{
+    return obj_pool_alloc(&box_pool, &box_pool_cache);
+}
+
+static struct tracker *
+tracker_alloc(void)
+{
+    return obj_pool_alloc(&tracker_pool, &tracker_pool_cache);
+}
+
+void
+bitpunch_get_alloc_stats(struct bitpunch_alloc_stats *statsp)
+{
+    struct obj_pool_stats box_stats;
+    struct obj_pool_stats tracker_stats;
+
+    obj_pool_get_stats(&box_pool, &box_stats);
+    obj_pool_get_stats(&tracker_pool, &tracker_stats);
+    statsp->n_box_allocs = box_stats.n_allocs;
+    statsp->n_box_reuses = box_stats.n_reuses;
+    statsp->n_box_frees = box_stats.n_frees;
+    statsp->n_tracker_allocs = tracker_stats.n_allocs;
+    statsp->n_tracker_reuses = tracker_stats.n_reuses;
+    statsp->n_tracker_frees = tracker_stats.n_frees;
+    statsp->n_slabs = box_stats.n_slabs + tracker_stats.n_slabs;
+    statsp->n_bytes = box_stats.n_bytes + tracker_stats.n_bytes;
+}
+
+void
+browse_global_destroy(void)
+{
+    obj_pool_destroy(&box_pool);
+    obj_pool_destroy(&tracker_pool);
+}
+
 static struct bitpunch_error *
 error_get_expected(bitpunch_status_t bt_err,
                    struct browse_state *bst)
@@ -137,6 +193,10 @@ track_path_eq(struct track_path p1, struct track_path p2)
 
 static const char *
 box_offset_type_str(enum box_offset_type type);
+static int
+box_get_pinned_data_offset(struct box *box, const expr_value_t *value,
+                           struct bitpunch_data_source *ds,
+                           const char *data, int64_t *offsetp);
 
 static void
 tracker_set_dangling_internal(struct tracker *tk);
@@ -1050,7 +1110,7 @@ box_new_root_box_internal(struct ast_node_hdl *schema,
     struct box *root_box;
     bitpunch_status_t bt_ret;
 
-    root_box = new_safe(struct box);
+    root_box = box_alloc();
     bt_ret = box_construct(root_box, NULL, schema, NULL,
                            0, 0u, bst);
     if (BITPUNCH_OK != bt_ret) {
@@ -1085,7 +1145,7 @@ box_new_filter_box(struct box *parent_box,
     bitpunch_status_t bt_ret;
     enum box_flag flags;
 
-    box = new_safe(struct box);
+    box = box_alloc();
     flags = BOX_FILTER;
     if (NULL != parent_box) {
         flags |= (parent_box->flags & BOX_RALIGN);
@@ -1100,6 +1160,109 @@ box_new_filter_box(struct box *parent_box,
 }
 
 
+struct box_dup_entry {
+    struct box *orig;
+    struct box *dup;
+};
+
+ARRAY_HEAD(box_dup_map, struct box_dup_entry);
+
+static struct box *
+box_dup_chain_internal(struct box *box, struct box_dup_map *map,
+                       struct browse_state *bst)
+{
+    struct box_dup_entry *entry;
+    struct box_dup_entry new_entry;
+    struct box *parent_dup;
+    struct box *scope_dup;
+    struct box *dup;
+    enum box_flag flags;
+    bitpunch_status_t bt_ret;
+
+    // boxes reachable through several paths (e.g. a scope which is
+    // also an ancestor) are copied once
+    ARRAY_FOREACH(map, entry) {
+        if (entry->orig == box) {
+            box_acquire(entry->dup);
+            return entry->dup;
+        }
+    }
+    parent_dup = NULL;
+    if (NULL != box->parent_box) {
+        parent_dup = box_dup_chain_internal(box->parent_box, map, bst);
+        if (NULL == parent_dup) {
+            return NULL;
+        }
+    }
+    scope_dup = NULL;
+    if (NULL != box->scope) {
+        scope_dup = box_dup_chain_internal(box->scope, map, bst);
+        if (NULL == scope_dup) {
+            box_delete(parent_dup);
+            return NULL;
+        }
+    }
+    flags = box->flags & ~(COMPUTING_SPAN_SIZE |
+                           COMPUTING_SLACK_CHILD_ALLOCATION);
+    dup = box_alloc();
+    bt_ret = box_construct(dup, parent_dup, box->filter, scope_dup, -1,
+                           flags, bst);
+    // box_construct() took its own references
+    box_delete(parent_dup);
+    box_delete(scope_dup);
+    if (BITPUNCH_OK != bt_ret) {
+        box_delete_non_null(dup);
+        return NULL;
+    }
+    // BOX_DATA_SOURCE tells whether ds_out is owned, as for the original
+    dup->flags = flags;
+    dup->ds_in = box->ds_in;
+    dup->ds_out = box->ds_out;
+    if (0 != (dup->flags & BOX_DATA_SOURCE) && NULL != dup->ds_out) {
+        bitpunch_data_source_acquire(dup->ds_out);
+    }
+    dup->start_offset_parent = box->start_offset_parent;
+    dup->start_offset_slack = box->start_offset_slack;
+    dup->start_offset_max_span = box->start_offset_max_span;
+    dup->start_offset_span = box->start_offset_span;
+    dup->start_offset_min_span = box->start_offset_min_span;
+    dup->end_offset_parent = box->end_offset_parent;
+    dup->end_offset_slack = box->end_offset_slack;
+    dup->end_offset_max_span = box->end_offset_max_span;
+    dup->end_offset_span = box->end_offset_span;
+    dup->end_offset_min_span = box->end_offset_min_span;
+    dup->start_offset_used = box->start_offset_used;
+    dup->end_offset_used = box->end_offset_used;
+    dup->track_path = box->track_path;
+    new_entry.orig = box;
+    new_entry.dup = dup;
+    ARRAY_PUSH(map, new_entry);
+    return dup;
+}
+
+/**
+ * @brief copy @ref box with its ancestors and scopes, for browsing
+ * them from another thread
+ *
+ * The copies have the same filters, locations and data sources as
+ * the originals, with fresh internal state (filter states, memoized
+ * results, pinned data), so that they can be browsed concurrently
+ * with the originals.
+ *
+ * @return the copy of @ref box, or NULL on error
+ */
+struct box *
+box_dup_chain(struct box *box, struct browse_state *bst)
+{
+    struct box_dup_map map;
+    struct box *dup;
+
+    ARRAY_INIT(&map, 0);
+    dup = box_dup_chain_internal(box, &map, bst);
+    ARRAY_DESTROY(&map);
+    return dup;
+}
+
 static bitpunch_status_t
 box_apply_local_filter__data_filter(struct box *box, struct browse_state *bst)
 {
@@ -1109,6 +1272,7 @@ box_apply_local_filter__data_filter(struct box *box, struct browse_state *bst)
     expr_value_t filtered_value;
     const char *filtered_data;
     int64_t filtered_size;
+    int64_t filtered_offset;
 
     if (0 != (box->flags & BOX_RALIGN)) {
         bt_ret = box_compute_offset_internal(box, BOX_START_OFFSET_SPAN,
@@ -1172,12 +1336,11 @@ box_apply_local_filter__data_filter(struct box *box, struct browse_state *bst)
     default:
         assert(0);
     }
-    if (filtered_data >= box->ds_in->ds_data &&
-        filtered_data < box->ds_in->ds_data + box->ds_in->ds_data_length) {
+    if (box_get_pinned_data_offset(box, &filtered_value, box->ds_in,
+                                   filtered_data, &filtered_offset)) {
         box_setup_overlay(box);
-        box->start_offset_used = filtered_data - box->ds_out->ds_data;
-        box->end_offset_used =
-            (filtered_data + filtered_size) - box->ds_out->ds_data;
+        box->start_offset_used = filtered_offset;
+        box->end_offset_used = filtered_offset + filtered_size;
     } else {
         bitpunch_data_source_create_from_memory(
             &box->ds_out, filtered_data, filtered_size, TRUE);
@@ -1282,6 +1445,344 @@ box_apply_filter_internal(struct box *box,
     return bt_ret;
 }
 
+/**
+ * @brief get a pointer to @ref length bytes at @ref offset of data
+ * source @ref ds
+ *
+ * Data pinned previously in @ref box with box_unpin_data() is reused
+ * when it covers the requested range.
+ *
+ * @param[out] pin to be released with box_unpin_data()
+ * @param[out] datap pointer to contents at @ref offset
+ */
+bitpunch_status_t
+box_pin_data_internal(struct box *box, struct bitpunch_data_source *ds,
+                      int64_t offset, int64_t length,
+                      struct bitpunch_data_pin *pin, const char **datap,
+                      struct browse_state *bst)
+{
+    struct box_data_pin *box_pin;
+
+    if (NULL == ds->backend.pin_range) {
+        pin->handle = NULL;
+        *datap = ds->ds_data + offset;
+        return BITPUNCH_OK;
+    }
+    for (box_pin = box->data_pins; NULL != box_pin; box_pin = box_pin->next) {
+        if (box_pin->ds == ds
+            && offset >= box_pin->pin.start_offset
+            && offset + length <= box_pin->pin.end_offset) {
+            pin->handle = NULL;
+            *datap = box_pin->pin.base
+                + (offset - box_pin->pin.start_offset);
+            return BITPUNCH_OK;
+        }
+    }
+    if (-1 == bitpunch_data_source_pin_range(ds, offset, length,
+                                             pin, datap)) {
+        return box_error(BITPUNCH_DATA_ERROR, box, NULL, bst,
+                         "error reading %"PRIi64" bytes at offset "
+                         "%"PRIi64" from data source",
+                         length, offset);
+    }
+    return BITPUNCH_OK;
+}
+
+/**
+ * @brief release a pin obtained from box_pin_data_internal()
+ *
+ * @param retain if TRUE, keep data pinned until @ref box is freed,
+ * e.g. for buffers exported with box_pin_data()
+ */
+void
+box_unpin_data(struct box *box, struct bitpunch_data_source *ds,
+               struct bitpunch_data_pin *pin, int retain)
+{
+    struct box_data_pin *box_pin;
+
+    if (NULL == pin->handle) {
+        return ;
+    }
+    if (retain) {
+        box_pin = new_safe(struct box_data_pin);
+        box_pin->ds = ds;
+        box_pin->pin = *pin;
+        box_pin->next = box->data_pins;
+        box->data_pins = box_pin;
+    } else {
+        bitpunch_data_source_unpin(ds, pin);
+    }
+    pin->handle = NULL;
+}
+
+#define BOX_SIZE_FROM_BUFFER_CHUNK_SIZE (64 * 1024)
+
+/**
+ * @brief compute the size of an item of @ref filter at
+ * [@ref start_offset, @ref end_offset[ of box->ds_in with the
+ * filter's compute_item_size_from_buffer() backend
+ *
+ * Contents are pinned in chunks of doubling size until the backend
+ * finds the end of the item, so that only the contents up to the
+ * item end need to be read, not the whole max span.
+ */
+bitpunch_status_t
+box_compute_item_size_from_buffer(struct box *box,
+                                  struct ast_node_hdl *filter,
+                                  int64_t start_offset, int64_t end_offset,
+                                  int64_t *item_sizep,
+                                  struct browse_state *bst)
+{
+    struct item_backend *b_item;
+    struct bitpunch_data_pin pin;
+    const char *item_data;
+    int64_t max_size;
+    int64_t chunk_size;
+    int64_t item_size;
+    bitpunch_status_t bt_ret;
+
+    b_item = &filter->ndat->u.rexpr_filter.f_instance->b_item;
+    max_size = end_offset - start_offset;
+    chunk_size = MIN(max_size, BOX_SIZE_FROM_BUFFER_CHUNK_SIZE);
+    while (TRUE) {
+        bt_ret = box_pin_data_internal(box, box->ds_in, start_offset,
+                                       chunk_size, &pin, &item_data, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        bt_ret = b_item->compute_item_size_from_buffer(
+            filter, box, item_data, chunk_size, &item_size, bst);
+        box_unpin_data(box, box->ds_in, &pin, FALSE);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        // a size reaching the chunk end may extend further
+        if (item_size < chunk_size || chunk_size == max_size) {
+            *item_sizep = item_size;
+            return BITPUNCH_OK;
+        }
+        chunk_size = MIN(max_size, 2 * chunk_size);
+    }
+    /*NOT REACHED*/
+}
+
+/**
+ * @brief get the offset in @ref ds of data pointed to by @ref data,
+ * if @ref data points to contents of @ref ds pinned by @ref value or
+ * accessible from @ref box
+ *
+ * @return TRUE if found, FALSE otherwise
+ */
+static int
+box_get_pinned_data_offset(struct box *box, const expr_value_t *value,
+                           struct bitpunch_data_source *ds,
+                           const char *data, int64_t *offsetp)
+{
+    struct box_data_pin *box_pin;
+    const char *pin_end;
+
+    if (NULL == ds->backend.pin_range) {
+        if (data >= ds->ds_data && data < ds->ds_data + ds->ds_data_length) {
+            *offsetp = data - ds->ds_data;
+            return TRUE;
+        }
+        return FALSE;
+    }
+    if (expr_value_get_pinned_data_offset(value, ds, data, offsetp)) {
+        return TRUE;
+    }
+    for (box_pin = box->data_pins; NULL != box_pin; box_pin = box_pin->next) {
+        pin_end = box_pin->pin.base
+            + (box_pin->pin.end_offset - box_pin->pin.start_offset);
+        if (box_pin->ds == ds
+            && data >= box_pin->pin.base && data < pin_end) {
+            *offsetp = box_pin->pin.start_offset + (data - box_pin->pin.base);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void
+box_release_data_pins(struct box *box)
+{
+    struct box_data_pin *box_pin;
+
+    while (NULL != box->data_pins) {
+        box_pin = box->data_pins;
+        box->data_pins = box_pin->next;
+        bitpunch_data_source_unpin(box_pin->ds, &box_pin->pin);
+        free(box_pin);
+    }
+}
+
+/*
+ * memoized results of named expressions and attributes
+ */
+
+/** maximum number of boxes visited by box_may_hold_reference() */
+#define BOX_MEMO_MAX_VISITS 64
+
+/**
+ * @brief tell if @ref ref_box may hold a reference on @ref box,
+ * through its chain of parent and scope boxes
+ *
+ * Gives up and returns TRUE after BOX_MEMO_MAX_VISITS visited boxes.
+ */
+static int
+box_may_hold_reference(const struct box *ref_box, const struct box *box,
+                       int *n_visitsp)
+{
+    if (NULL == ref_box) {
+        return FALSE;
+    }
+    if (ref_box == box || ++*n_visitsp > BOX_MEMO_MAX_VISITS) {
+        return TRUE;
+    }
+    return box_may_hold_reference(ref_box->parent_box, box, n_visitsp)
+        || box_may_hold_reference(ref_box->scope, box, n_visitsp);
+}
+
+/**
+ * @brief tell if @ref box may keep a reference on @ref ref_box in its
+ * memo without creating a reference cycle
+ */
+static int
+box_memo_may_reference(struct box *box, const struct box *ref_box)
+{
+    int n_visits = 0;
+
+    return !box_may_hold_reference(ref_box, box, &n_visits);
+}
+
+static int
+box_memo_may_hold_value(struct box *box, const expr_value_t *value)
+{
+    switch (value->type) {
+    case EXPR_VALUE_TYPE_INTEGER:
+    case EXPR_VALUE_TYPE_BOOLEAN:
+    case EXPR_VALUE_TYPE_DATA:
+    case EXPR_VALUE_TYPE_DATA_RANGE:
+        return TRUE;
+    case EXPR_VALUE_TYPE_STRING:
+        return box_memo_may_reference(box, value->string.from_box);
+    case EXPR_VALUE_TYPE_BYTES:
+        return box_memo_may_reference(box, value->bytes.from_box);
+    default:
+        return FALSE;
+    }
+}
+
+static int
+box_memo_may_hold_dpath(struct box *box, const expr_dpath_t *dpath)
+{
+    switch (dpath->type) {
+    case EXPR_DPATH_TYPE_NONE:
+        return TRUE;
+    case EXPR_DPATH_TYPE_ITEM:
+        return box_memo_may_reference(box, dpath->tk->box);
+    case EXPR_DPATH_TYPE_CONTAINER:
+        return box_memo_may_reference(box, dpath->box);
+    default:
+        return FALSE;
+    }
+}
+
+static struct box_memo_entry *
+box_memo_find(struct box *box, const struct named_expr *named_expr)
+{
+    struct box_memo_entry *entry;
+
+    for (entry = box->memo; NULL != entry; entry = entry->next) {
+        if (entry->named_expr == named_expr) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief get the memoized result of @ref named_expr evaluated in
+ * @ref box
+ *
+ * @param[out] valuep if not NULL, a new reference to the memoized
+ * value
+ * @param[out] dpathp if not NULL, a new reference to the memoized
+ * dpath
+ *
+ * @return TRUE if all requested results were memoized, FALSE
+ * otherwise (outputs are then untouched)
+ */
+int
+box_memo_lookup(struct box *box, const struct named_expr *named_expr,
+                expr_value_t *valuep, expr_dpath_t *dpathp)
+{
+    struct box_memo_entry *entry;
+
+    entry = box_memo_find(box, named_expr);
+    if (NULL == entry
+        || (NULL != valuep && EXPR_VALUE_TYPE_UNSET == entry->value.type)
+        || (NULL != dpathp && EXPR_DPATH_TYPE_UNSET == entry->dpath.type)) {
+        return FALSE;
+    }
+    if (NULL != valuep) {
+        *valuep = expr_value_dup(entry->value);
+    }
+    if (NULL != dpathp) {
+        *dpathp = expr_dpath_dup(entry->dpath);
+    }
+    return TRUE;
+}
+
+/**
+ * @brief memoize the result of a pure named expression or attribute
+ * evaluated in @ref box
+ *
+ * The memo keeps its own references to results until @ref box is
+ * freed. Results that may reference @ref box itself (e.g. a dpath to
+ * one of its fields) are not memoized, to avoid reference cycles.
+ */
+void
+box_memo_store(struct box *box, const struct named_expr *named_expr,
+               const expr_value_t *valuep, const expr_dpath_t *dpathp)
+{
+    struct box_memo_entry *entry;
+    int store_value;
+    int store_dpath;
+
+    store_value = (NULL != valuep && box_memo_may_hold_value(box, valuep));
+    store_dpath = (NULL != dpathp && box_memo_may_hold_dpath(box, dpathp));
+    if (!store_value && !store_dpath) {
+        return ;
+    }
+    entry = box_memo_find(box, named_expr);
+    if (NULL == entry) {
+        entry = new_safe(struct box_memo_entry);
+        entry->named_expr = named_expr;
+        entry->next = box->memo;
+        box->memo = entry;
+    }
+    if (store_value && EXPR_VALUE_TYPE_UNSET == entry->value.type) {
+        entry->value = expr_value_dup(*valuep);
+    }
+    if (store_dpath && EXPR_DPATH_TYPE_UNSET == entry->dpath.type) {
+        entry->dpath = expr_dpath_dup(*dpathp);
+    }
+}
+
+static void
+box_memo_clear(struct box *box)
+{
+    struct box_memo_entry *entry;
+
+    while (NULL != box->memo) {
+        entry = box->memo;
+        box->memo = entry->next;
+        expr_value_destroy(entry->value);
+        expr_dpath_destroy(entry->dpath);
+        free(entry);
+    }
+}
 
 static void
 box_free(struct box *box)
@@ -1310,27 +1811,28 @@ box_free(struct box *box)
             break ;
         }
     }
+    box_memo_clear(box);
+    box_release_data_pins(box);
     if (0 != (box->flags & BOX_DATA_SOURCE)) {
         (void)bitpunch_data_source_release(
             (struct bitpunch_data_source *)box->ds_out);
     }
-    free(box);
+    obj_pool_free(&box_pool, &box_pool_cache, box);
 }
 
 void
 box_acquire(struct box *box)
 {
     if (NULL != box) {
-        ++box->use_count;
+        refcount_inc(&box->use_count);
     }
 }
 
 void
 box_delete_non_null(struct box *box)
 {
-    assert(box->use_count > 0);
-    --box->use_count;
-    if (0 == box->use_count) {
+    assert(refcount_read(&box->use_count) > 0);
+    if (0 == refcount_dec(&box->use_count)) {
         box_delete(box->parent_box);
         box_delete(box->scope);
         box_free(box);
@@ -1468,9 +1970,20 @@ tracker_construct(struct tracker *o_tk,
     tracker_goto_nil(o_tk);
 }
 
+static void
+tracker_release_raw_pin(struct tracker *tk)
+{
+    if (NULL != tk->raw_pin_ds) {
+        bitpunch_data_source_unpin(tk->raw_pin_ds, &tk->raw_pin);
+        (void) bitpunch_data_source_release(tk->raw_pin_ds);
+        tk->raw_pin_ds = NULL;
+    }
+}
+
 static void
 tracker_destroy(struct tracker *tk)
 {
+    tracker_release_raw_pin(tk);
     box_delete_non_null(tk->box);
 }
 
@@ -1479,7 +1992,7 @@ tracker_new(struct box *box)
 {
     struct tracker *tk;
 
-    tk = new_safe(struct tracker);
+    tk = tracker_alloc();
     tracker_construct(tk, box);
     return tk;
 }
@@ -1490,6 +2003,7 @@ tracker_set(struct tracker *tk, const struct tracker *src_tk)
     box_acquire(src_tk->box);
     tracker_destroy(tk);
     memcpy(tk, src_tk, sizeof (*tk));
+    tk->raw_pin_ds = NULL;
 }
 
 static struct tracker *
@@ -1497,8 +2011,9 @@ tracker_dup_raw(struct tracker *tk)
 {
     struct tracker *tk_dup;
 
-    tk_dup = dup_safe(tk);
+    tk_dup = memcpy(tracker_alloc(), tk, sizeof (*tk));
     box_acquire(tk_dup->box);
+    tk_dup->raw_pin_ds = NULL;
     return tk_dup;
 }
 
@@ -1516,7 +2031,7 @@ tracker_delete(struct tracker *tk)
 {
     if (NULL != tk) {
         tracker_destroy(tk);
-        free(tk);
+        obj_pool_free(&tracker_pool, &tracker_pool_cache, tk);
     }
 }
 
@@ -1574,7 +2089,7 @@ tracker_fdump(const struct tracker *tk, FILE *out)
     fprintf(out, "\n");
 }
 
-static bitpunch_status_t
+bitpunch_status_t
 tracker_set_item_size(struct tracker *tk, int64_t item_size,
                       struct browse_state *bst)
 {
@@ -1664,7 +2179,7 @@ tracker_create_item_box_internal(struct tracker *tk,
     if (BITPUNCH_OK != bt_ret) {
         goto end;
     }
-    item_box = new_safe(struct box);
+    item_box = box_alloc();
     // it's an item box, so the filter is the item here
     assert(NULL != bst->scope);
     bt_ret = box_construct(item_box, xtk->box, xtk->dpath.item,
@@ -2233,6 +2748,94 @@ box_read_value_internal(struct box *box,
    return bt_ret;
 }
 
+static bitpunch_status_t
+box_read_values_bulk__generic(struct box *box,
+                              int64_t index, int64_t n_items,
+                              int64_t *values, int64_t *n_readp,
+                              struct browse_state *bst)
+{
+    bitpunch_status_t bt_ret;
+    struct tracker *tk;
+    expr_value_t value;
+    int64_t n_read;
+
+    n_read = 0;
+    tk = tracker_new(box);
+    bt_ret = tracker_goto_nth_item_internal(tk, index, bst);
+    while (BITPUNCH_OK == bt_ret && n_read < n_items) {
+        bt_ret = tracker_read_item_value_internal(tk, &value, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            break ;
+        }
+        if (EXPR_VALUE_TYPE_INTEGER != value.type) {
+            bt_ret = bitpunch_error(
+                BITPUNCH_INVALID_PARAM, tk, NULL, bst,
+                "bulk read expects integer values, got '%s'",
+                expr_value_type_str(value.type));
+            expr_value_destroy(value);
+            break ;
+        }
+        values[n_read] = value.integer;
+        ++n_read;
+        bt_ret = tracker_goto_next_item_internal(tk, bst);
+    }
+    tracker_delete(tk);
+    if (BITPUNCH_NO_ITEM == bt_ret) {
+        bt_ret = BITPUNCH_OK;
+    }
+    if (BITPUNCH_OK == bt_ret) {
+        *n_readp = n_read;
+    }
+    return bt_ret;
+}
+
+/**
+ * @brief read integer values of consecutive items of a box
+ *
+ * Reads up to @ref n_items values starting at item @ref index,
+ * stopping earlier if the end of the box is reached. Boxes may
+ * provide a fast path through their read_values_bulk() backend.
+ *
+ * @param[out] values caller-allocated array of @ref n_items values
+ * @param[out] n_readp number of values actually read
+ */
+bitpunch_status_t
+box_read_values_bulk_internal(struct box *box,
+                              int64_t index, int64_t n_items,
+                              int64_t *values, int64_t *n_readp,
+                              struct browse_state *bst)
+{
+    struct filter_instance *f_instance;
+    bitpunch_status_t bt_ret;
+    struct box *scope_storage;
+
+    if (index < 0 || n_items < 0) {
+        return box_error(BITPUNCH_INVALID_PARAM, box, NULL, bst,
+                         "invalid bulk read range");
+    }
+    bt_ret = box_apply_parent_filter_internal(box, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    browse_state_push_scope(bst, box, &scope_storage);
+    f_instance = box->filter->ndat->u.rexpr_filter.f_instance;
+    bt_ret = BITPUNCH_NOT_IMPLEMENTED;
+    if (NULL != f_instance->b_box.read_values_bulk) {
+        bt_ret = f_instance->b_box.read_values_bulk(
+            box, index, n_items, values, n_readp, bst);
+    }
+    if (BITPUNCH_NOT_IMPLEMENTED == bt_ret) {
+        bt_ret = box_read_values_bulk__generic(
+            box, index, n_items, values, n_readp, bst);
+    }
+    browse_state_pop_scope(bst, box, &scope_storage);
+    if (BITPUNCH_OK != bt_ret) {
+        bitpunch_error_add_box_context(
+            box, bst, "when reading item values in bulk");
+    }
+    return bt_ret;
+}
+
 bitpunch_status_t
 box_get_filtered_data_internal(
     struct box *box,
@@ -2692,6 +3295,52 @@ tracker_goto_field_int_recur(struct tracker *tk,
     return BITPUNCH_OK;
 }
 
+static int
+tracker_in_anonymous_field(struct tracker *tk);
+
+/**
+ * @brief jump to the closest field preceding @to_field with an
+ * offset known at compile time
+ *
+ * @return BITPUNCH_NO_ITEM if the filter does not provide such
+ * field, in which case the tracker is left untouched
+ */
+static bitpunch_status_t
+tracker_goto_static_field_start(struct tracker *tk,
+                                const struct field *to_field, int flat,
+                                struct browse_state *bst)
+{
+    struct filter_instance *f_instance;
+    const struct field *start_field;
+    int64_t start_offset;
+    bitpunch_status_t bt_ret;
+
+    if (!flat && NULL != tk->cur.u.field) {
+        // return to base, non-anonymous level
+        while (tracker_in_anonymous_field(tk)) {
+            bt_ret = tracker_return_internal(tk, bst);
+            assert(BITPUNCH_OK == bt_ret);
+        }
+    }
+    f_instance = tk->box->filter->ndat->u.rexpr_filter.f_instance;
+    if (NULL == f_instance->b_tk.get_static_field_start
+        || !f_instance->b_tk.get_static_field_start(
+            tk, to_field, flat, &start_field, &start_offset)) {
+        return BITPUNCH_NO_ITEM;
+    }
+    if (0 != (tk->flags & TRACKER_NEED_ITEM_OFFSET)) {
+        if (NULL != f_instance->b_tk.init_item_offset) {
+            bt_ret = f_instance->b_tk.init_item_offset(tk, bst);
+            if (BITPUNCH_OK != bt_ret) {
+                DBG_TRACKER_CHECK_STATE(tk);
+                return bt_ret;
+            }
+        }
+        tk->item_offset += start_offset;
+    }
+    return tracker_goto_field_int_recur(tk, start_field, flat, bst);
+}
+
 bitpunch_status_t
 tracker_goto_field_internal(struct tracker *tk,
                             const struct field *to_field, int flat,
@@ -2721,7 +3370,14 @@ tracker_goto_field_internal(struct tracker *tk,
     if (reverse_direction) {
         tk->flags ^= TRACKER_REVERSED;
     }
-    bt_ret = tracker_goto_first_field_internal(tk, flat, bst);
+    if (0 == (tk->flags & TRACKER_REVERSED)) {
+        bt_ret = tracker_goto_static_field_start(tk, to_field, flat, bst);
+    } else {
+        bt_ret = BITPUNCH_NO_ITEM;
+    }
+    if (BITPUNCH_NO_ITEM == bt_ret) {
+        bt_ret = tracker_goto_first_field_internal(tk, flat, bst);
+    }
     while (BITPUNCH_OK == bt_ret && tk->cur.u.field != to_field) {
         bt_ret = tracker_goto_next_field_internal(tk, flat, bst);
     }
@@ -3453,7 +4109,6 @@ tracker_compute_item_size_internal(struct tracker *tk,
     bitpunch_status_t bt_ret;
     int64_t max_span_offset;
     struct filter_instance *f_instance;
-    const char *item_data;
 
     bt_ret = tracker_compute_item_filter_internal(tk, bst);
     if (BITPUNCH_OK != bt_ret) {
@@ -3485,10 +4140,8 @@ tracker_compute_item_size_internal(struct tracker *tk,
     }
     f_instance = tk->dpath.item->ndat->u.rexpr_filter.f_instance;
     if (NULL != f_instance->b_item.compute_item_size_from_buffer) {
-        item_data = tk->box->ds_in->ds_data + tk->item_offset;
-        bt_ret = f_instance->b_item.compute_item_size_from_buffer(
-            tk->dpath.item, tk->box,
-            item_data, max_span_offset - tk->item_offset,
+        bt_ret = box_compute_item_size_from_buffer(
+            tk->box, tk->dpath.item, tk->item_offset, max_span_offset,
             item_sizep, bst);
         if (BITPUNCH_OK != bt_ret) {
             goto err;
@@ -3664,6 +4317,12 @@ tracker_get_item_location_internal(struct tracker *tk,
     return BITPUNCH_OK;
 }
 
+/**
+ * @brief read the raw contents of the tracked item
+ *
+ * Contents returned in @ref item_contentsp remain accessible until
+ * the next raw read through @ref tk, or until @ref tk is deleted.
+ */
 bitpunch_status_t
 tracker_read_item_raw_internal(struct tracker *tk,
                                const char **item_contentsp,
@@ -3671,6 +4330,7 @@ tracker_read_item_raw_internal(struct tracker *tk,
                                struct browse_state *bst)
 {
     bitpunch_status_t bt_ret;
+    struct bitpunch_data_pin pin;
 
     bt_ret = tracker_compute_item_location(tk, bst);
     if (BITPUNCH_OK != bt_ret) {
@@ -3683,7 +4343,20 @@ tracker_read_item_raw_internal(struct tracker *tk,
         if (BITPUNCH_OK != bt_ret) {
             return bt_ret;
         }
-        *item_contentsp = tk->box->ds_out->ds_data + tk->item_offset;
+        bt_ret = box_pin_data_internal(tk->box, tk->box->ds_out,
+                                       tk->item_offset, tk->item_size,
+                                       &pin, item_contentsp, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        // contents remain accessible until the next raw read
+        // through this tracker
+        tracker_release_raw_pin(tk);
+        if (NULL != pin.handle) {
+            tk->raw_pin_ds = tk->box->ds_out;
+            bitpunch_data_source_acquire(tk->raw_pin_ds);
+            tk->raw_pin = pin;
+        }
     }
     if (NULL != item_sizep) {
         *item_sizep = tk->item_size;
@@ -3768,6 +4441,133 @@ tracker_read_item_value_internal(struct tracker *tk,
     return bt_ret;
 }
 
+static bitpunch_status_t
+tracker_read_item_record(struct tracker *tk,
+                         struct tracker_item_record *record,
+                         enum tracker_batch_flag flags,
+                         struct browse_state *bst)
+{
+    bitpunch_status_t bt_ret;
+    const struct ast_node_hdl *target;
+
+    if (0 != (flags & TRACKER_BATCH_KEY)) {
+        bt_ret = tracker_get_item_key_multi_internal(
+            tk, &record->key, &record->nth_twin, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+    }
+    if (0 != (flags & TRACKER_BATCH_LOCATION)) {
+        bt_ret = tracker_get_item_location_internal(
+            tk, &record->offset, &record->size, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+    }
+    if (0 != (flags & TRACKER_BATCH_VALUE)) {
+        bt_ret = tracker_compute_item_filter_internal(tk, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        target = ast_node_get_target_filter(tk->dpath.filter);
+        if (ast_node_filter_maps_list(target)
+            || ast_node_filter_maps_object(target)) {
+            bt_ret = tracker_get_filtered_item_box_internal(
+                tk, &record->box, bst);
+        } else {
+            bt_ret = tracker_read_item_value_internal(
+                tk, &record->value, bst);
+        }
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+    }
+    return BITPUNCH_OK;
+}
+
+/**
+ * @brief advance the tracker through the next items of its container,
+ * recording up to @ref max_records of them in one call
+ *
+ * Items are recorded as successive calls to tracker_goto_next_item()
+ * would reach them, the tracker is left on the last recorded item.
+ *
+ * If an error occurs after some items have been recorded, those are
+ * returned and the error is dropped: the tracker being left on the
+ * last recorded item, the next call reports it again. If it occurs
+ * before any item is recorded, the tracker is left where it was.
+ *
+ * @param flags what to record of each item, other record fields are
+ * left unset
+ * @param[out] n_recordsp number of records filled, that must be
+ * released with tracker_item_record_destroy(), even on error
+ *
+ * @return BITPUNCH_OK if at least one item was recorded,
+ * BITPUNCH_NO_ITEM if there was no next item (the tracker is then at
+ * the end of its container), or an error status
+ */
+bitpunch_status_t
+tracker_read_items_batch_internal(struct tracker *tk,
+                                  struct tracker_item_record *records,
+                                  int64_t max_records,
+                                  enum tracker_batch_flag flags,
+                                  int64_t *n_recordsp,
+                                  struct browse_state *bst)
+{
+    bitpunch_status_t bt_ret;
+    struct tracker_item_record *record;
+    int64_t n_records;
+    struct tracker last_tk;
+
+    DBG_TRACKER_DUMP(tk);
+    if (0 != (flags & TRACKER_BATCH_LOCATION) && tracker_is_dangling(tk)) {
+        // maintain item offsets while iterating
+        tk->flags |= TRACKER_NEED_ITEM_OFFSET;
+    }
+    // moving to next items keeps the container box, so a plain copy
+    // of the tracker is enough to restore its position
+    memcpy(&last_tk, tk, sizeof (last_tk));
+    bt_ret = BITPUNCH_OK;
+    n_records = 0;
+    while (n_records < max_records) {
+        bt_ret = tracker_goto_next_item_internal(tk, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            break ;
+        }
+        record = &records[n_records];
+        memset(record, 0, sizeof (*record));
+        record->offset = -1;
+        record->size = -1;
+        bt_ret = tracker_read_item_record(tk, record, flags, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            tracker_item_record_destroy(record);
+            break ;
+        }
+        ++n_records;
+        memcpy(&last_tk, tk, sizeof (last_tk));
+    }
+    *n_recordsp = n_records;
+    if (BITPUNCH_OK == bt_ret
+        || (BITPUNCH_NO_ITEM == bt_ret && 0 == n_records)) {
+        return bt_ret;
+    }
+    assert(last_tk.box == tk->box);
+    memcpy(tk, &last_tk, sizeof (*tk));
+    if (n_records > 0) {
+        browse_state_clear_error(bst);
+        return BITPUNCH_OK;
+    }
+    return bt_ret;
+}
+
+void
+tracker_item_record_destroy(struct tracker_item_record *record)
+{
+    expr_value_destroy(record->key);
+    expr_value_destroy(record->value);
+    box_delete(record->box);
+}
+
 bitpunch_status_t
 tracker_read_item_value_direct_internal(struct tracker *tk,
                                         expr_value_t *valuep,
@@ -3849,10 +4649,16 @@ bitpunch_error_init(struct bitpunch_error *bp_err,
 {
     memset(bp_err, 0, sizeof (*bp_err));
     bp_err->bt_ret = bt_ret;
-    bp_err->error_buf_end = bp_err->error_buf;
-    bp_err->error_buf[0] = '\0';
 }
 
+/**
+ * @brief create a new error object
+ *
+ * Only the message arguments are captured here: formatting the
+ * message is deferred until bitpunch_error_get_reason() is called,
+ * since most errors are handled by callers without looking at it.
+ */
+
 struct bitpunch_error *
 bitpunch_error_new(bitpunch_status_t bt_ret,
                   struct tracker *tk, struct box *box,
@@ -3872,16 +4678,8 @@ bitpunch_error_new(bitpunch_status_t bt_ret,
     }
     bp_err->node = node;
     if (NULL != message_fmt) {
-        bp_err->error_buf_end =
-            bp_err->error_buf +
-            vsnprintf(bp_err->error_buf, sizeof (bp_err->error_buf),
-                      message_fmt, message_args) + 1;
-        if (bp_err->error_buf_end >=
-            bp_err->error_buf + sizeof (bp_err->error_buf))
-            bp_err->error_buf_end =
-                bp_err->error_buf + sizeof (bp_err->error_buf) - 1;
-    }
-    bp_err->reason = bp_err->error_buf;
+        bp_err->reason = lazy_fmt_new(message_fmt, message_args);
+    }
     return bp_err;
 }
 
@@ -3899,9 +4697,12 @@ bitpunch_error_destroy(struct bitpunch_error *bp_err)
         struct bitpunch_error_context_info *ctx_info;
 
         ctx_info = &bp_err->contexts[ctx_i];
+        lazy_fmt_free(ctx_info->message);
         tracker_delete(ctx_info->tk);
         box_delete(ctx_info->box);
     }
+    free(bp_err->contexts);
+    lazy_fmt_free(bp_err->reason);
     free(bp_err->error_info);
     free(bp_err);
 }
@@ -3981,7 +4782,7 @@ bitpunch_error_dump_full(struct bitpunch_error *bp_err, FILE *out)
 
     fprintf(out, "error: %s - %s\n",
             bitpunch_status_pretty(bp_err->bt_ret),
-            bp_err->reason);
+            bitpunch_error_get_reason(bp_err));
     error_dump_context_info(bp_err->tk, bp_err->box, bp_err->node,
                             NULL, NULL, NULL, NULL, out);
     prev_ctx_tk = bp_err->tk;
@@ -3991,7 +4792,7 @@ bitpunch_error_dump_full(struct bitpunch_error *bp_err, FILE *out)
         ctx_info = &bp_err->contexts[i];
         error_dump_context_info(
             ctx_info->tk, ctx_info->box, ctx_info->node,
-            ctx_info->message,
+            bitpunch_error_get_context_message(bp_err, i),
             prev_ctx_tk, prev_ctx_box, prev_ctx_node,
             out);
         prev_ctx_tk = ctx_info->tk;
@@ -4000,6 +4801,37 @@ bitpunch_error_dump_full(struct bitpunch_error *bp_err, FILE *out)
     }
 }
 
+/**
+ * @brief get the formatted reason phrase of an error
+ *
+ * @return the reason phrase, owned by @ref bp_err
+ */
+const char *
+bitpunch_error_get_reason(struct bitpunch_error *bp_err)
+{
+    if (NULL == bp_err->reason) {
+        return "";
+    }
+    return lazy_fmt_get_str(bp_err->reason);
+}
+
+/**
+ * @brief get the formatted message of an error context
+ *
+ * @return the context message owned by @ref bp_err, or NULL if the
+ * context has no message
+ */
+const char *
+bitpunch_error_get_context_message(struct bitpunch_error *bp_err,
+                                   int ctx_i)
+{
+    assert(ctx_i >= 0 && ctx_i < bp_err->n_contexts);
+    if (NULL == bp_err->contexts[ctx_i].message) {
+        return NULL;
+    }
+    return lazy_fmt_get_str(bp_err->contexts[ctx_i].message);
+}
+
 void
 bitpunch_error_attach_user_arg(struct bitpunch_error *bp_err, void *user_arg)
 {
@@ -4080,40 +4912,28 @@ node_error(bitpunch_status_t bt_ret,
     return bt_ret;
 }
 
-static const char *
-bitpunch_error_push_message_internal(
-    struct bitpunch_error *bp_err, const char *fmt, va_list args,
-    int new_message)
-{
-    const char *message;
-
-    if (!new_message && bp_err->error_buf_end > bp_err->error_buf) {
-        // remove last message's "\0"
-        bp_err->error_buf_end -= 1;
-    }
-    message = bp_err->error_buf_end;
-    bp_err->error_buf_end += vsnprintf(
-        bp_err->error_buf_end,
-        bp_err->error_buf + sizeof (bp_err->error_buf)
-        - message, fmt, args) + 1;
-
-    if (bp_err->error_buf_end >
-        bp_err->error_buf + sizeof (bp_err->error_buf)) {
-        bp_err->error_buf_end =
-            bp_err->error_buf + sizeof (bp_err->error_buf);
-    }
-    return message;
-}
-
 void
 bitpunch_error_message_append(struct bitpunch_error *bp_err,
                               const char *message_fmt, ...)
 {
+    struct lazy_fmt **last_messagep;
+    int ctx_i;
     va_list message_args;
 
+    // append to the last message pushed, context or reason
+    last_messagep = &bp_err->reason;
+    for (ctx_i = bp_err->n_contexts - 1; ctx_i >= 0; --ctx_i) {
+        if (NULL != bp_err->contexts[ctx_i].message) {
+            last_messagep = &bp_err->contexts[ctx_i].message;
+            break ;
+        }
+    }
     va_start(message_args, message_fmt);
-    (void) bitpunch_error_push_message_internal(
-        bp_err, message_fmt, message_args, FALSE);
+    if (NULL != *last_messagep) {
+        lazy_fmt_append(*last_messagep, message_fmt, message_args);
+    } else {
+        *last_messagep = lazy_fmt_new(message_fmt, message_args);
+    }
     va_end(message_args);
 }
 
@@ -4160,7 +4980,6 @@ bitpunch_error_item_out_of_bounds(struct tracker *tk,
 {
     struct bitpunch_error *bp_err;
     struct bitpunch_error_info_out_of_bounds *error_info;
-    char item_span_msg[128];
     int64_t out_of_bounds_offset;
 
     DBG_TRACKER_DUMP(tk);
@@ -4169,29 +4988,35 @@ bitpunch_error_item_out_of_bounds(struct tracker *tk,
     if (NULL != error_get_expected(BITPUNCH_OUT_OF_BOUNDS_ERROR, bst)) {
         return BITPUNCH_OUT_OF_BOUNDS_ERROR;
     }
+#define ITEM_OUT_OF_BOUNDS_MSG                                  \
+    "item location out of container box bounds: "               \
+    "box %s space is [%"PRIi64"..%"PRIi64"[, "
+#define ITEM_OUT_OF_BOUNDS_ARGS                                         \
+    box_offset_type_str(box_get_known_end_offset_type(tk->box)),       \
+        tk->box->start_offset_span, box_get_known_end_offset(tk->box)
+
     if (-1 != tk->item_size) {
-        snprintf(item_span_msg, sizeof (item_span_msg),
-                 "item spans [%"PRIi64"..%"PRIi64"[",
-                 tk->item_offset, tk->item_offset + tk->item_size);
         out_of_bounds_offset = tk->item_offset + tk->item_size;
+        (void) bitpunch_error(
+            BITPUNCH_OUT_OF_BOUNDS_ERROR, tk, tk->dpath.item, bst,
+            ITEM_OUT_OF_BOUNDS_MSG "item spans [%"PRIi64"..%"PRIi64"[",
+            ITEM_OUT_OF_BOUNDS_ARGS,
+            tk->item_offset, tk->item_offset + tk->item_size);
     } else if (!tracker_is_dangling(tk)) {
-        snprintf(item_span_msg, sizeof (item_span_msg),
-                 "item spans [%"PRIi64"..[",
-                 tk->item_offset);
         out_of_bounds_offset = tk->item_offset;
+        (void) bitpunch_error(
+            BITPUNCH_OUT_OF_BOUNDS_ERROR, tk, tk->dpath.item, bst,
+            ITEM_OUT_OF_BOUNDS_MSG "item spans [%"PRIi64"..[",
+            ITEM_OUT_OF_BOUNDS_ARGS, tk->item_offset);
     } else {
-        snprintf(item_span_msg, sizeof (item_span_msg),
-                 "last item spans [..%"PRIi64"[",
-                 tk->item_offset);
         out_of_bounds_offset = tk->item_offset;
+        (void) bitpunch_error(
+            BITPUNCH_OUT_OF_BOUNDS_ERROR, tk, tk->dpath.item, bst,
+            ITEM_OUT_OF_BOUNDS_MSG "last item spans [..%"PRIi64"[",
+            ITEM_OUT_OF_BOUNDS_ARGS, tk->item_offset);
     }
-    (void) bitpunch_error(
-        BITPUNCH_OUT_OF_BOUNDS_ERROR, tk, tk->dpath.item, bst,
-        "item location out of container box bounds: "
-        "box %s space is [%"PRIi64"..%"PRIi64"[, %s",
-        box_offset_type_str(box_get_known_end_offset_type(tk->box)),
-        tk->box->start_offset_span, box_get_known_end_offset(tk->box),
-        item_span_msg);
+#undef ITEM_OUT_OF_BOUNDS_MSG
+#undef ITEM_OUT_OF_BOUNDS_ARGS
     bp_err = bst->last_error;
     assert(NULL != bp_err);
     error_info = new_safe(struct bitpunch_error_info_out_of_bounds);
@@ -4219,10 +5044,19 @@ bitpunch_error_add_context_internal(struct tracker *tk,
     if (NULL == bp_err || NULL != error_get_expected(bp_err->bt_ret, bst)) {
         return ;
     }
-    if (bp_err->n_contexts == N_ELEM(bp_err->contexts)) {
+    if (bp_err->n_contexts == BITPUNCH_ERROR_MAX_CONTEXTS) {
         return ;
     }
+    if (bp_err->n_contexts == bp_err->n_alloc_contexts) {
+        bp_err->n_alloc_contexts =
+            (0 == bp_err->n_alloc_contexts ? 4 :
+             2 * bp_err->n_alloc_contexts);
+        bp_err->contexts = realloc_safe(
+            bp_err->contexts,
+            bp_err->n_alloc_contexts * sizeof (*bp_err->contexts));
+    }
     ctx = &bp_err->contexts[bp_err->n_contexts];
+    memset(ctx, 0, sizeof (*ctx));
     ++bp_err->n_contexts;
 
     if (NULL != box) {
@@ -4234,8 +5068,7 @@ bitpunch_error_add_context_internal(struct tracker *tk,
     }
     ctx->node = node;
     if (NULL != context_fmt) {
-        ctx->message = bitpunch_error_push_message_internal(
-            bp_err, context_fmt, context_args, TRUE);
+        ctx->message = lazy_fmt_new(context_fmt, context_args);
     }
 }
 
@@ -4478,6 +5311,43 @@ box_read_value(struct box *box,
         &bst, errp);
 }
 
+bitpunch_status_t
+box_read_values_bulk(struct box *box,
+                     int64_t index, int64_t n_items,
+                     int64_t *values, int64_t *n_readp,
+                     struct bitpunch_error **errp)
+{
+    struct browse_state bst;
+
+    browse_state_init_box(&bst, box);
+    return transmit_error(
+        box_read_values_bulk_internal(box, index, n_items,
+                                      values, n_readp, &bst),
+        &bst, errp);
+}
+
+/**
+ * @brief get a pointer to contents of @ref ds in [offset, offset +
+ * length), accessible as long as @ref box lives
+ */
+bitpunch_status_t
+box_pin_data(struct box *box, struct bitpunch_data_source *ds,
+             int64_t offset, int64_t length, const char **datap,
+             struct bitpunch_error **errp)
+{
+    struct browse_state bst;
+    struct bitpunch_data_pin pin;
+    bitpunch_status_t bt_ret;
+
+    browse_state_init_box(&bst, box);
+    bt_ret = box_pin_data_internal(box, ds, offset, length,
+                                   &pin, datap, &bst);
+    if (BITPUNCH_OK == bt_ret) {
+        box_unpin_data(box, ds, &pin, TRUE);
+    }
+    return transmit_error(bt_ret, &bst, errp);
+}
+
 bitpunch_status_t
 box_compute_offset(struct box *box,
                    enum box_offset_type off_type,
@@ -4835,6 +5705,23 @@ tracker_read_item_value(struct tracker *tk,
         &bst, errp);
 }
 
+bitpunch_status_t
+tracker_read_items_batch(struct tracker *tk,
+                         struct tracker_item_record *records,
+                         int64_t max_records,
+                         enum tracker_batch_flag flags,
+                         int64_t *n_recordsp,
+                         struct bitpunch_error **errp)
+{
+    struct browse_state bst;
+
+    browse_state_init_tracker(&bst, tk);
+    return transmit_error(
+        tracker_read_items_batch_internal(tk, records, max_records, flags,
+                                          n_recordsp, &bst),
+        &bst, errp);
+}
+
 bitpunch_status_t
 tracker_get_filtered_dpath(struct tracker *tk,
                            expr_dpath_t *filtered_dpathp,
@@ -41,9 +41,11 @@
 #include "core/filter.h"
 #include "core/browse_internal.h"
 #include "core/expr_internal.h"
+#include "core/expr_bytecode.h"
 #include "api/bitpunch_api.h"
 #include "filters/composite.h"
 #include "filters/array_slice.h"
+#include "utils/regex.h"
 
 
 expr_dpath_t shared_expr_dpath_none = {
@@ -983,6 +985,7 @@ expr_builtin_fns[] = {
         .eval_fn = expr_eval_builtin_env,
         .min_n_params = 1,
         .max_n_params = 1,
+        .impure = TRUE,
     },
     {
         .builtin_name = "index",
@@ -1092,15 +1095,27 @@ expr_dpath_destroy(expr_dpath_t dpath)
     }
 }
 
+static void
+expr_value_pin_release(struct expr_value_pin *vpin)
+{
+    if (NULL != vpin && 0 == refcount_dec(&vpin->use_count)) {
+        bitpunch_data_source_unpin(vpin->ds, &vpin->pin);
+        (void) bitpunch_data_source_release(vpin->ds);
+        free(vpin);
+    }
+}
+
 void
 expr_value_destroy(expr_value_t value)
 {
     switch (value.type) {
     case EXPR_VALUE_TYPE_BYTES:
         box_delete(value.bytes.from_box);
+        expr_value_pin_release(value.bytes.pin);
         break ;
     case EXPR_VALUE_TYPE_STRING:
         box_delete(value.string.from_box);
+        expr_value_pin_release(value.string.pin);
         break ;
     case EXPR_VALUE_TYPE_DATA:
     case EXPR_VALUE_TYPE_DATA_RANGE:
@@ -1111,6 +1126,32 @@ expr_value_destroy(expr_value_t value)
     }
 }
 
+expr_value_t
+expr_value_dup(expr_value_t src_value)
+{
+    switch (src_value.type) {
+    case EXPR_VALUE_TYPE_BYTES:
+        box_acquire(src_value.bytes.from_box);
+        if (NULL != src_value.bytes.pin) {
+            refcount_inc(&src_value.bytes.pin->use_count);
+        }
+        break ;
+    case EXPR_VALUE_TYPE_STRING:
+        box_acquire(src_value.string.from_box);
+        if (NULL != src_value.string.pin) {
+            refcount_inc(&src_value.string.pin->use_count);
+        }
+        break ;
+    case EXPR_VALUE_TYPE_DATA:
+    case EXPR_VALUE_TYPE_DATA_RANGE:
+        bitpunch_data_source_acquire(src_value.data.ds);
+        break ;
+    default:
+        break ;
+    }
+    return src_value;
+}
+
 expr_dpath_t
 expr_dpath_dup(expr_dpath_t src_dpath)
 {
@@ -1547,6 +1588,77 @@ expr_value_attach_box(expr_value_t *value, struct box *box)
     }
 }
 
+/**
+ * @brief keep data pinned as long as @ref value references it
+ *
+ * The pin is handed over to @ref value if it is a string or bytes
+ * value, released otherwise.
+ */
+void
+expr_value_attach_pin(expr_value_t *value, struct bitpunch_data_source *ds,
+                      struct bitpunch_data_pin *pin)
+{
+    struct expr_value_pin *vpin;
+
+    if (NULL == pin->handle) {
+        return ;
+    }
+    if (EXPR_VALUE_TYPE_STRING != value->type
+        && EXPR_VALUE_TYPE_BYTES != value->type) {
+        bitpunch_data_source_unpin(ds, pin);
+        pin->handle = NULL;
+        return ;
+    }
+    vpin = new_safe(struct expr_value_pin);
+    vpin->use_count = 1;
+    vpin->ds = ds;
+    bitpunch_data_source_acquire(ds);
+    vpin->pin = *pin;
+    pin->handle = NULL;
+    if (EXPR_VALUE_TYPE_STRING == value->type) {
+        expr_value_pin_release(value->string.pin);
+        value->string.pin = vpin;
+    } else {
+        expr_value_pin_release(value->bytes.pin);
+        value->bytes.pin = vpin;
+    }
+}
+
+/**
+ * @brief get the offset in @ref ds of data pointed to by @ref data,
+ * if @ref data points to contents of @ref ds pinned by @ref value
+ *
+ * @return TRUE if found, FALSE otherwise
+ */
+int
+expr_value_get_pinned_data_offset(const expr_value_t *value,
+                                  struct bitpunch_data_source *ds,
+                                  const char *data, int64_t *offsetp)
+{
+    const struct expr_value_pin *vpin;
+    const char *pin_end;
+
+    switch (value->type) {
+    case EXPR_VALUE_TYPE_STRING:
+        vpin = value->string.pin;
+        break ;
+    case EXPR_VALUE_TYPE_BYTES:
+        vpin = value->bytes.pin;
+        break ;
+    default:
+        return FALSE;
+    }
+    if (NULL == vpin || vpin->ds != ds) {
+        return FALSE;
+    }
+    pin_end = vpin->pin.base + (vpin->pin.end_offset - vpin->pin.start_offset);
+    if (data < vpin->pin.base || data >= pin_end) {
+        return FALSE;
+    }
+    *offsetp = vpin->pin.start_offset + (data - vpin->pin.base);
+    return TRUE;
+}
+
 int
 expr_value_cmp_integer(expr_value_t value1, expr_value_t value2)
 {
@@ -1920,6 +2032,39 @@ expr_evaluate_unary_operator(
     return BITPUNCH_OK;
 }
 
+static bitpunch_status_t
+expr_evaluate_match(
+    struct ast_node_hdl *expr,
+    enum expr_evaluate_flag flags,
+    expr_value_t *valuep, expr_dpath_t *dpathp,
+    struct browse_state *bst)
+{
+    expr_value_t subject;
+    bitpunch_status_t bt_ret;
+    int matched;
+
+    if (NULL != valuep) {
+        bt_ret = expr_evaluate_value_internal(
+            expr->ndat->u.rexpr_op.op.operands[0], NULL, &subject, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        if (EXPR_VALUE_TYPE_STRING == subject.type) {
+            matched = regex_match(expr->ndat->u.rexpr_op_match.regex,
+                                  subject.string.str, subject.string.len);
+        } else {
+            matched = regex_match(expr->ndat->u.rexpr_op_match.regex,
+                                  subject.bytes.buf, subject.bytes.len);
+        }
+        expr_value_destroy(subject);
+        *valuep = expr_value_as_boolean(matched);
+    }
+    if (NULL != dpathp) {
+        *dpathp = expr_dpath_none();
+    }
+    return BITPUNCH_OK;
+}
+
 static bitpunch_status_t
 expr_evaluate_sizeof_internal(
     struct ast_node_hdl *expr,
@@ -2049,6 +2194,51 @@ expr_evaluate_fcall(
                             valuep, dpathp, bst);
 }
 
+/**
+ * @brief evaluate a named expression or attribute in @ref scope,
+ * using the scope box memo for pure statements
+ *
+ * An evaluation that turns out to depend on the environment (through
+ * a nested impure statement) sets bst->impure and is not memoized.
+ */
+static bitpunch_status_t
+expr_evaluate_named_expr_in_scope(
+    const struct named_expr *named_expr,
+    struct box *scope,
+    enum expr_evaluate_flag flags,
+    expr_value_t *valuep, expr_dpath_t *dpathp,
+    struct browse_state *bst)
+{
+    bitpunch_status_t bt_ret;
+    int outer_impure;
+
+    if (0 == (named_expr->nstmt.stmt.stmt_flags & NAMED_EXPR_FLAG_PURE)) {
+        bt_ret = expr_evaluate_internal(named_expr->expr, scope, flags,
+                                        valuep, dpathp, bst);
+        // native evaluations (e.g. unit tests) run without a browse state
+        if (NULL != bst) {
+            bst->impure = TRUE;
+        }
+        return bt_ret;
+    }
+    if (0 != flags || NULL == scope || NULL == bst) {
+        return expr_evaluate_internal(named_expr->expr, scope, flags,
+                                      valuep, dpathp, bst);
+    }
+    if (box_memo_lookup(scope, named_expr, valuep, dpathp)) {
+        return BITPUNCH_OK;
+    }
+    outer_impure = bst->impure;
+    bst->impure = FALSE;
+    bt_ret = expr_evaluate_internal(named_expr->expr, scope, flags,
+                                    valuep, dpathp, bst);
+    if (BITPUNCH_OK == bt_ret && !bst->impure) {
+        box_memo_store(scope, named_expr, valuep, dpathp);
+    }
+    bst->impure |= outer_impure;
+    return bt_ret;
+}
+
 static bitpunch_status_t
 expr_evaluate_named_expr(
     struct ast_node_hdl *expr,
@@ -2072,8 +2262,8 @@ expr_evaluate_named_expr(
     if (BITPUNCH_OK != bt_ret) {
         return bt_ret;
     }
-    bt_ret = expr_evaluate_internal(named_expr->expr, member_scope, flags,
-                                    valuep, dpathp, bst);
+    bt_ret = expr_evaluate_named_expr_in_scope(named_expr, member_scope, flags,
+                                               valuep, dpathp, bst);
     box_delete(member_scope);
     return bt_ret;
 }
@@ -2442,6 +2632,35 @@ expr_evaluate_filter_chain(
     return bt_ret;
 }
 
+static bitpunch_status_t
+expr_evaluate_bytecode(
+    struct ast_node_hdl *expr, struct box *scope,
+    expr_value_t *valuep, expr_dpath_t *dpathp,
+    struct browse_state *bst)
+{
+    struct box *scope_storage;
+    bitpunch_status_t bt_ret;
+
+    if (0 == expr->bytecode->n_evals) {
+        bt_ret = expr_bytecode_evaluate(expr->bytecode, valuep, bst);
+    } else {
+        browse_state_push_scope(bst, scope, &scope_storage);
+        bt_ret = expr_bytecode_evaluate(expr->bytecode, valuep, bst);
+        browse_state_pop_scope(bst, scope, &scope_storage);
+    }
+    if (BITPUNCH_OK != bt_ret) {
+        bitpunch_error_add_node_context(
+            expr, bst,
+            "when evaluating expression of type \"%s\"",
+            ast_node_type_str(expr->ndat->type));
+        return bt_ret;
+    }
+    if (NULL != dpathp) {
+        *dpathp = expr_dpath_none();
+    }
+    return BITPUNCH_OK;
+}
+
 bitpunch_status_t
 expr_evaluate_internal(
     struct ast_node_hdl *expr, struct box *scope,
@@ -2452,6 +2671,11 @@ expr_evaluate_internal(
     struct box *scope_storage;
     bitpunch_status_t bt_ret;
 
+    // operators only produce values, dpath requests alone go through
+    // the AST
+    if (NULL != expr->bytecode && NULL != valuep) {
+        return expr_evaluate_bytecode(expr, scope, valuep, dpathp, bst);
+    }
     browse_state_push_scope(bst, scope, &scope_storage);
 
     switch (expr->ndat->type) {
@@ -2484,6 +2708,9 @@ expr_evaluate_internal(
     case AST_NODE_TYPE_REXPR_OP_BWNOT:
         bt_ret = expr_evaluate_unary_operator(expr, flags, valuep, dpathp, bst);
         break ;
+    case AST_NODE_TYPE_REXPR_OP_MATCH:
+        bt_ret = expr_evaluate_match(expr, flags, valuep, dpathp, bst);
+        break ;
     case AST_NODE_TYPE_REXPR_OP_SIZEOF:
         bt_ret = expr_evaluate_sizeof(expr, flags, valuep, dpathp, bst);
         break ;
@@ -2940,11 +3167,10 @@ evaluate_scoped_statement_internal(
     case STATEMENT_TYPE_NAMED_EXPR:
     case STATEMENT_TYPE_ATTRIBUTE:{
         const struct named_expr *named_expr;
-        struct ast_node_hdl *expr;
 
         named_expr = (const struct named_expr *)named_stmt;
-        expr = named_expr->expr;
-        return expr_evaluate_internal(expr, scope, flags, valuep, dpathp, bst);
+        return expr_evaluate_named_expr_in_scope(named_expr, scope, flags,
+                                                 valuep, dpathp, bst);
     }
     case STATEMENT_TYPE_FIELD: {
         struct tracker *tk;
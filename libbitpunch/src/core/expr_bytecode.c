@@ -0,0 +1,943 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "core/ast.h"
+#include "core/parser.h"
+#include PATH_TO_PARSER_TAB_H
+#include "core/browse_internal.h"
+#include "core/expr_internal.h"
+#include "core/expr_bytecode.h"
+
+
+static const char *expr_opcode_names[] = {
+    [EXPR_OPCODE_PUSH] = "push",
+    [EXPR_OPCODE_EVAL_INTEGER] = "eval.integer",
+    [EXPR_OPCODE_EVAL_BOOLEAN] = "eval.boolean",
+    [EXPR_OPCODE_UMINUS] = "uminus",
+    [EXPR_OPCODE_BWNOT] = "bwnot",
+    [EXPR_OPCODE_LNOT] = "lnot",
+    [EXPR_OPCODE_ADD] = "add",
+    [EXPR_OPCODE_ADD_K] = "add.k",
+    [EXPR_OPCODE_SUB] = "sub",
+    [EXPR_OPCODE_SUB_K] = "sub.k",
+    [EXPR_OPCODE_MUL] = "mul",
+    [EXPR_OPCODE_MUL_K] = "mul.k",
+    [EXPR_OPCODE_DIV] = "div",
+    [EXPR_OPCODE_DIV_K] = "div.k",
+    [EXPR_OPCODE_MOD] = "mod",
+    [EXPR_OPCODE_MOD_K] = "mod.k",
+    [EXPR_OPCODE_BWAND] = "bwand",
+    [EXPR_OPCODE_BWAND_K] = "bwand.k",
+    [EXPR_OPCODE_BWOR] = "bwor",
+    [EXPR_OPCODE_BWOR_K] = "bwor.k",
+    [EXPR_OPCODE_BWXOR] = "bwxor",
+    [EXPR_OPCODE_BWXOR_K] = "bwxor.k",
+    [EXPR_OPCODE_LSHIFT] = "lshift",
+    [EXPR_OPCODE_LSHIFT_K] = "lshift.k",
+    [EXPR_OPCODE_RSHIFT] = "rshift",
+    [EXPR_OPCODE_RSHIFT_K] = "rshift.k",
+    [EXPR_OPCODE_EQ] = "eq",
+    [EXPR_OPCODE_EQ_K] = "eq.k",
+    [EXPR_OPCODE_NE] = "ne",
+    [EXPR_OPCODE_NE_K] = "ne.k",
+    [EXPR_OPCODE_LT] = "lt",
+    [EXPR_OPCODE_LT_K] = "lt.k",
+    [EXPR_OPCODE_LE] = "le",
+    [EXPR_OPCODE_LE_K] = "le.k",
+    [EXPR_OPCODE_GT] = "gt",
+    [EXPR_OPCODE_GT_K] = "gt.k",
+    [EXPR_OPCODE_GE] = "ge",
+    [EXPR_OPCODE_GE_K] = "ge.k",
+    [EXPR_OPCODE_LAND] = "land",
+    [EXPR_OPCODE_LAND_K] = "land.k",
+    [EXPR_OPCODE_LOR] = "lor",
+    [EXPR_OPCODE_LOR_K] = "lor.k",
+};
+
+struct expr_bytecode_builder {
+    struct expr_insn insns[EXPR_BYTECODE_MAX_INSNS];
+    int n_insns;
+    int n_evals;
+    /** current evaluation stack depth */
+    int depth;
+};
+
+/**
+ * @brief map an operator node type to its opcode
+ *
+ * @return the opcode, or -1 if the operator has no bytecode
+ * equivalent
+ */
+static int
+expr_bytecode_get_opcode(enum ast_node_type node_type)
+{
+    switch (node_type) {
+    case AST_NODE_TYPE_REXPR_OP_UPLUS:
+        return EXPR_OPCODE_PUSH; /* no-op, never emitted */
+    case AST_NODE_TYPE_REXPR_OP_UMINUS:
+        return EXPR_OPCODE_UMINUS;
+    case AST_NODE_TYPE_REXPR_OP_BWNOT:
+        return EXPR_OPCODE_BWNOT;
+    case AST_NODE_TYPE_REXPR_OP_LNOT:
+        return EXPR_OPCODE_LNOT;
+    case AST_NODE_TYPE_REXPR_OP_ADD:
+        return EXPR_OPCODE_ADD;
+    case AST_NODE_TYPE_REXPR_OP_SUB:
+        return EXPR_OPCODE_SUB;
+    case AST_NODE_TYPE_REXPR_OP_MUL:
+        return EXPR_OPCODE_MUL;
+    case AST_NODE_TYPE_REXPR_OP_DIV:
+        return EXPR_OPCODE_DIV;
+    case AST_NODE_TYPE_REXPR_OP_MOD:
+        return EXPR_OPCODE_MOD;
+    case AST_NODE_TYPE_REXPR_OP_BWAND:
+        return EXPR_OPCODE_BWAND;
+    case AST_NODE_TYPE_REXPR_OP_BWOR:
+        return EXPR_OPCODE_BWOR;
+    case AST_NODE_TYPE_REXPR_OP_BWXOR:
+        return EXPR_OPCODE_BWXOR;
+    case AST_NODE_TYPE_REXPR_OP_LSHIFT:
+        return EXPR_OPCODE_LSHIFT;
+    case AST_NODE_TYPE_REXPR_OP_RSHIFT:
+        return EXPR_OPCODE_RSHIFT;
+    case AST_NODE_TYPE_REXPR_OP_EQ:
+        return EXPR_OPCODE_EQ;
+    case AST_NODE_TYPE_REXPR_OP_NE:
+        return EXPR_OPCODE_NE;
+    case AST_NODE_TYPE_REXPR_OP_LT:
+        return EXPR_OPCODE_LT;
+    case AST_NODE_TYPE_REXPR_OP_LE:
+        return EXPR_OPCODE_LE;
+    case AST_NODE_TYPE_REXPR_OP_GT:
+        return EXPR_OPCODE_GT;
+    case AST_NODE_TYPE_REXPR_OP_GE:
+        return EXPR_OPCODE_GE;
+    case AST_NODE_TYPE_REXPR_OP_LAND:
+        return EXPR_OPCODE_LAND;
+    case AST_NODE_TYPE_REXPR_OP_LOR:
+        return EXPR_OPCODE_LOR;
+    default:
+        return -1;
+    }
+}
+
+static int
+expr_bytecode_is_unary_opcode(enum expr_opcode opcode)
+{
+    return opcode < EXPR_OPCODE_ADD;
+}
+
+/**
+ * @brief get the opcode computing the same result than @ref opcode
+ * with operands swapped
+ *
+ * @return the opcode, or -1 if the operator is not commutative
+ */
+static int
+expr_bytecode_get_swapped_opcode(enum expr_opcode opcode)
+{
+    switch (opcode) {
+    case EXPR_OPCODE_ADD:
+    case EXPR_OPCODE_MUL:
+    case EXPR_OPCODE_BWAND:
+    case EXPR_OPCODE_BWOR:
+    case EXPR_OPCODE_BWXOR:
+    case EXPR_OPCODE_EQ:
+    case EXPR_OPCODE_NE:
+    case EXPR_OPCODE_LAND:
+    case EXPR_OPCODE_LOR:
+        return opcode;
+    case EXPR_OPCODE_LT:
+        return EXPR_OPCODE_GT;
+    case EXPR_OPCODE_LE:
+        return EXPR_OPCODE_GE;
+    case EXPR_OPCODE_GT:
+        return EXPR_OPCODE_LT;
+    case EXPR_OPCODE_GE:
+        return EXPR_OPCODE_LE;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief tell if applying @ref opcode with constant right operand
+ * @ref value returns the left operand unchanged
+ */
+static int
+expr_bytecode_is_identity(enum expr_opcode opcode, int64_t value)
+{
+    switch (opcode) {
+    case EXPR_OPCODE_ADD:
+    case EXPR_OPCODE_SUB:
+    case EXPR_OPCODE_BWOR:
+    case EXPR_OPCODE_BWXOR:
+    case EXPR_OPCODE_LSHIFT:
+    case EXPR_OPCODE_RSHIFT:
+        return 0 == value;
+    case EXPR_OPCODE_MUL:
+    case EXPR_OPCODE_DIV:
+        return 1 == value;
+    default:
+        // boolean operators normalize their result, they are never
+        // an identity
+        return FALSE;
+    }
+}
+
+static enum expr_value_type
+expr_bytecode_get_operand_type(struct ast_node_hdl *operand)
+{
+    return ast_node_get_named_expr_target(operand)
+        ->ndat->u.rexpr.value_type_mask;
+}
+
+/**
+ * @brief tell if @ref node is an operator working on integer or
+ * boolean values only, that can be lowered to bytecode
+ */
+static int
+expr_bytecode_is_scalar_operator(struct ast_node_hdl *node)
+{
+    int opcode;
+    int n_operands;
+    int opd_i;
+    enum expr_value_type opd_type;
+
+    opcode = expr_bytecode_get_opcode(node->ndat->type);
+    if (-1 == opcode || NULL == node->ndat->u.rexpr_op.evaluator) {
+        return FALSE;
+    }
+    n_operands = expr_bytecode_is_unary_opcode(opcode) ? 1 : 2;
+    for (opd_i = 0; opd_i < n_operands; ++opd_i) {
+        opd_type = expr_bytecode_get_operand_type(
+            node->ndat->u.rexpr_op.op.operands[opd_i]);
+        if (EXPR_VALUE_TYPE_INTEGER != opd_type
+            && EXPR_VALUE_TYPE_BOOLEAN != opd_type) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static int
+expr_bytecode_emit(struct expr_bytecode_builder *builder,
+                   enum expr_opcode opcode, int64_t value)
+{
+    struct expr_insn *insn;
+
+    if (builder->n_insns == EXPR_BYTECODE_MAX_INSNS) {
+        return -1;
+    }
+    insn = &builder->insns[builder->n_insns];
+    insn->opcode = opcode;
+    insn->value = value;
+    ++builder->n_insns;
+    return 0;
+}
+
+static int
+expr_bytecode_emit_push(struct expr_bytecode_builder *builder,
+                        enum expr_opcode opcode, int64_t value)
+{
+    if (builder->depth == EXPR_BYTECODE_MAX_DEPTH
+        || -1 == expr_bytecode_emit(builder, opcode, value)) {
+        return -1;
+    }
+    ++builder->depth;
+    return 0;
+}
+
+static int
+expr_bytecode_emit_eval(struct expr_bytecode_builder *builder,
+                        struct ast_node_hdl *node)
+{
+    enum expr_opcode opcode;
+
+    if (EXPR_VALUE_TYPE_BOOLEAN == expr_bytecode_get_operand_type(node)) {
+        opcode = EXPR_OPCODE_EVAL_BOOLEAN;
+    } else {
+        opcode = EXPR_OPCODE_EVAL_INTEGER;
+    }
+    if (-1 == expr_bytecode_emit_push(builder, opcode, 0)) {
+        return -1;
+    }
+    builder->insns[builder->n_insns - 1].node = node;
+    ++builder->n_evals;
+    return 0;
+}
+
+static int
+expr_bytecode_is_const(struct expr_bytecode_builder *builder,
+                       int start, int end)
+{
+    return end - start == 1
+        && EXPR_OPCODE_PUSH == builder->insns[start].opcode;
+}
+
+/**
+ * @brief compute the result of an operator on constant operands with
+ * the same evaluator than the AST path
+ */
+static int64_t
+expr_bytecode_fold(struct ast_node_hdl *node, int n_operands,
+                   const int64_t values[])
+{
+    expr_value_t operand_values[2];
+    expr_value_t res;
+    int opd_i;
+
+    for (opd_i = 0; opd_i < n_operands; ++opd_i) {
+        if (EXPR_VALUE_TYPE_BOOLEAN == expr_bytecode_get_operand_type(
+                node->ndat->u.rexpr_op.op.operands[opd_i])) {
+            operand_values[opd_i] = expr_value_as_boolean(values[opd_i]);
+        } else {
+            operand_values[opd_i] = expr_value_as_integer(values[opd_i]);
+        }
+    }
+    res = node->ndat->u.rexpr_op.evaluator->eval_fn(operand_values);
+    return EXPR_VALUE_TYPE_BOOLEAN == res.type ? res.boolean : res.integer;
+}
+
+static int
+expr_bytecode_emit_node(struct expr_bytecode_builder *builder,
+                        struct ast_node_hdl *node);
+
+static int
+expr_bytecode_emit_operator(struct expr_bytecode_builder *builder,
+                            struct ast_node_hdl *node)
+{
+    enum expr_opcode opcode;
+    int swapped_opcode;
+    int start[2];
+    int64_t values[2];
+    struct ast_node_hdl **operands;
+
+    opcode = expr_bytecode_get_opcode(node->ndat->type);
+    operands = node->ndat->u.rexpr_op.op.operands;
+    start[0] = builder->n_insns;
+    if (-1 == expr_bytecode_emit_node(builder, operands[0])) {
+        return -1;
+    }
+    if (expr_bytecode_is_unary_opcode(opcode)) {
+        if (AST_NODE_TYPE_REXPR_OP_UPLUS == node->ndat->type) {
+            return 0;
+        }
+        if (expr_bytecode_is_const(builder, start[0], builder->n_insns)) {
+            values[0] = builder->insns[start[0]].value;
+            builder->insns[start[0]].value =
+                expr_bytecode_fold(node, 1, values);
+            return 0;
+        }
+        return expr_bytecode_emit(builder, opcode, 0);
+    }
+    start[1] = builder->n_insns;
+    if (-1 == expr_bytecode_emit_node(builder, operands[1])) {
+        return -1;
+    }
+    if (expr_bytecode_is_const(builder, start[1], builder->n_insns)) {
+        values[1] = builder->insns[start[1]].value;
+        if (expr_bytecode_is_const(builder, start[0], start[1])
+            // keep division by zero (and overflowing division) for
+            // run time, like the AST path
+            && !((EXPR_OPCODE_DIV == opcode || EXPR_OPCODE_MOD == opcode)
+                 && (0 == values[1] || -1 == values[1]))) {
+            values[0] = builder->insns[start[0]].value;
+            builder->insns[start[0]].value =
+                expr_bytecode_fold(node, 2, values);
+            --builder->n_insns;
+            --builder->depth;
+            return 0;
+        }
+        --builder->n_insns;
+        --builder->depth;
+        if (expr_bytecode_is_identity(opcode, values[1])) {
+            return 0;
+        }
+        return expr_bytecode_emit(builder, opcode + 1, values[1]);
+    }
+    swapped_opcode = expr_bytecode_get_swapped_opcode(opcode);
+    if (-1 != swapped_opcode
+        && expr_bytecode_is_const(builder, start[0], start[1])) {
+        // constants have no side effect: move it to the right
+        values[0] = builder->insns[start[0]].value;
+        memmove(&builder->insns[start[0]], &builder->insns[start[1]],
+                (builder->n_insns - start[1]) * sizeof (struct expr_insn));
+        --builder->n_insns;
+        --builder->depth;
+        if (expr_bytecode_is_identity(swapped_opcode, values[0])) {
+            return 0;
+        }
+        return expr_bytecode_emit(builder, swapped_opcode + 1, values[0]);
+    }
+    --builder->depth;
+    return expr_bytecode_emit(builder, opcode, 0);
+}
+
+static int
+expr_bytecode_emit_node(struct expr_bytecode_builder *builder,
+                        struct ast_node_hdl *node)
+{
+    struct ast_node_hdl *target;
+    const expr_value_t *value;
+    int n_insns;
+    int n_evals;
+    int depth;
+
+    target = ast_node_get_named_expr_target(node);
+    if (AST_NODE_TYPE_REXPR_NATIVE == target->ndat->type) {
+        value = &target->ndat->u.rexpr_native.value;
+        switch (value->type) {
+        case EXPR_VALUE_TYPE_INTEGER:
+            return expr_bytecode_emit_push(builder, EXPR_OPCODE_PUSH,
+                                           value->integer);
+        case EXPR_VALUE_TYPE_BOOLEAN:
+            return expr_bytecode_emit_push(builder, EXPR_OPCODE_PUSH,
+                                           value->boolean);
+        default:
+            break ;
+        }
+    }
+    if (expr_bytecode_is_scalar_operator(node)) {
+        n_insns = builder->n_insns;
+        n_evals = builder->n_evals;
+        depth = builder->depth;
+        if (0 == expr_bytecode_emit_operator(builder, node)) {
+            return 0;
+        }
+        // too large to be inlined: the operand is evaluated with its
+        // own bytecode
+        builder->n_insns = n_insns;
+        builder->n_evals = n_evals;
+        builder->depth = depth;
+    }
+    return expr_bytecode_emit_eval(builder, node);
+}
+
+/**
+ * @brief lower the operator tree rooted at @ref expr to bytecode
+ *
+ * Must be called once the evaluator of @ref expr is set. Does
+ * nothing if @ref expr is not an integer or boolean operator, in
+ * which case it keeps being evaluated through the AST.
+ */
+void
+expr_bytecode_compile(struct ast_node_hdl *expr)
+{
+    struct expr_bytecode_builder builder;
+    struct expr_bytecode *bytecode;
+
+    if (NULL != expr->bytecode) {
+        expr_bytecode_free(expr->bytecode);
+        expr->bytecode = NULL;
+    }
+    if (!expr_bytecode_is_scalar_operator(expr)) {
+        return ;
+    }
+    memset(&builder, 0, sizeof (builder));
+    if (-1 == expr_bytecode_emit_operator(&builder, expr)) {
+        return ;
+    }
+    assert(1 == builder.depth);
+    bytecode = malloc_safe(sizeof (struct expr_bytecode)
+                           + builder.n_insns * sizeof (struct expr_insn));
+    bytecode->result_type = expr->ndat->u.rexpr_op.evaluator->res_type_mask;
+    bytecode->n_insns = builder.n_insns;
+    bytecode->n_evals = builder.n_evals;
+    memcpy(bytecode->insns, builder.insns,
+           builder.n_insns * sizeof (struct expr_insn));
+    expr->bytecode = bytecode;
+}
+
+void
+expr_bytecode_free(struct expr_bytecode *bytecode)
+{
+    free(bytecode);
+}
+
+#define EXPR_BYTECODE_BINOP(NAME, OP)                           \
+    case EXPR_OPCODE_##NAME:                                    \
+        --sp;                                                   \
+        sp[-1] = (sp[-1] OP sp[0]);                             \
+        break ;                                                 \
+    case EXPR_OPCODE_##NAME##_K:                                \
+        sp[-1] = (sp[-1] OP insn->value);                       \
+        break ;
+
+bitpunch_status_t
+expr_bytecode_evaluate(const struct expr_bytecode *bytecode,
+                       expr_value_t *valuep,
+                       struct browse_state *bst)
+{
+    int64_t stack[EXPR_BYTECODE_MAX_DEPTH];
+    int64_t *sp;
+    const struct expr_insn *insn;
+    const struct expr_insn *end;
+    expr_value_t value;
+    bitpunch_status_t bt_ret;
+
+    sp = stack;
+    end = bytecode->insns + bytecode->n_insns;
+    for (insn = bytecode->insns; insn < end; ++insn) {
+        switch (insn->opcode) {
+        case EXPR_OPCODE_PUSH:
+            *sp++ = insn->value;
+            break ;
+        case EXPR_OPCODE_EVAL_INTEGER:
+            bt_ret = expr_evaluate_value_internal(insn->node, NULL,
+                                                  &value, bst);
+            if (BITPUNCH_OK != bt_ret) {
+                return bt_ret;
+            }
+            *sp++ = value.integer;
+            expr_value_destroy(value);
+            break ;
+        case EXPR_OPCODE_EVAL_BOOLEAN:
+            bt_ret = expr_evaluate_value_internal(insn->node, NULL,
+                                                  &value, bst);
+            if (BITPUNCH_OK != bt_ret) {
+                return bt_ret;
+            }
+            *sp++ = value.boolean;
+            expr_value_destroy(value);
+            break ;
+        case EXPR_OPCODE_UMINUS:
+            sp[-1] = -sp[-1];
+            break ;
+        case EXPR_OPCODE_BWNOT:
+            sp[-1] = ~sp[-1];
+            break ;
+        case EXPR_OPCODE_LNOT:
+            sp[-1] = !sp[-1];
+            break ;
+        EXPR_BYTECODE_BINOP(ADD, +)
+        EXPR_BYTECODE_BINOP(SUB, -)
+        EXPR_BYTECODE_BINOP(MUL, *)
+        EXPR_BYTECODE_BINOP(DIV, /)
+        EXPR_BYTECODE_BINOP(MOD, %)
+        EXPR_BYTECODE_BINOP(BWAND, &)
+        EXPR_BYTECODE_BINOP(BWOR, |)
+        EXPR_BYTECODE_BINOP(BWXOR, ^)
+        EXPR_BYTECODE_BINOP(LSHIFT, <<)
+        EXPR_BYTECODE_BINOP(RSHIFT, >>)
+        EXPR_BYTECODE_BINOP(EQ, ==)
+        EXPR_BYTECODE_BINOP(NE, !=)
+        EXPR_BYTECODE_BINOP(LT, <)
+        EXPR_BYTECODE_BINOP(LE, <=)
+        EXPR_BYTECODE_BINOP(GT, >)
+        EXPR_BYTECODE_BINOP(GE, >=)
+        EXPR_BYTECODE_BINOP(LAND, &&)
+        EXPR_BYTECODE_BINOP(LOR, ||)
+        }
+    }
+    assert(sp == stack + 1);
+    if (EXPR_VALUE_TYPE_BOOLEAN == bytecode->result_type) {
+        *valuep = expr_value_as_boolean(stack[0]);
+    } else {
+        *valuep = expr_value_as_integer(stack[0]);
+    }
+    return BITPUNCH_OK;
+}
+
+#undef EXPR_BYTECODE_BINOP
+
+void
+expr_bytecode_dump(const struct expr_bytecode *bytecode, FILE *out)
+{
+    int i;
+    const struct expr_insn *insn;
+
+    for (i = 0; i < bytecode->n_insns; ++i) {
+        insn = &bytecode->insns[i];
+        fprintf(out, "%3d: %s", i, expr_opcode_names[insn->opcode]);
+        switch (insn->opcode) {
+        case EXPR_OPCODE_EVAL_INTEGER:
+        case EXPR_OPCODE_EVAL_BOOLEAN:
+            fprintf(out, " %s\n", ast_node_type_str(insn->node->ndat->type));
+            break ;
+        case EXPR_OPCODE_PUSH:
+            fprintf(out, " %"PRIi64"\n", insn->value);
+            break ;
+        default:
+            if (!expr_bytecode_is_unary_opcode(insn->opcode)
+                && (insn->opcode - EXPR_OPCODE_ADD) % 2 == 1) {
+                fprintf(out, " %"PRIi64"\n", insn->value);
+            } else {
+                fprintf(out, "\n");
+            }
+            break ;
+        }
+    }
+}
+
+
+#ifndef DISABLE_UTESTS
+
+#include <check.h>
+
+static int64_t test_n_leaf_evals;
+static uint32_t test_rand_state;
+
+static bitpunch_status_t
+test_eval_integer_leaf(void *user_arg,
+                       expr_value_t *valuep, expr_dpath_t *dpathp,
+                       struct browse_state *bst)
+{
+    ++test_n_leaf_evals;
+    if (NULL != valuep) {
+        *valuep = expr_value_as_integer((int64_t)(intptr_t)user_arg);
+    }
+    if (NULL != dpathp) {
+        *dpathp = expr_dpath_none();
+    }
+    return BITPUNCH_OK;
+}
+
+static bitpunch_status_t
+test_eval_boolean_leaf(void *user_arg,
+                       expr_value_t *valuep, expr_dpath_t *dpathp,
+                       struct browse_state *bst)
+{
+    ++test_n_leaf_evals;
+    if (NULL != valuep) {
+        *valuep = expr_value_as_boolean(0 != (intptr_t)user_arg);
+    }
+    if (NULL != dpathp) {
+        *dpathp = expr_dpath_none();
+    }
+    return BITPUNCH_OK;
+}
+
+static int
+test_rand(int n)
+{
+    test_rand_state = test_rand_state * 1103515245 + 12345;
+    return (test_rand_state >> 16) % n;
+}
+
+static struct ast_node_hdl *
+test_native(expr_value_t value)
+{
+    struct ast_node_hdl *node;
+
+    node = ast_node_hdl_create(AST_NODE_TYPE_REXPR_NATIVE, NULL);
+    node->ndat->u.rexpr.value_type_mask = value.type;
+    node->ndat->u.rexpr.dpath_type_mask = EXPR_DPATH_TYPE_NONE;
+    node->ndat->u.rexpr_native.value = value;
+    return node;
+}
+
+static struct ast_node_hdl *
+test_leaf(enum expr_value_type type, int64_t value)
+{
+    struct ast_node_hdl *node;
+    struct extern_func *extern_func;
+
+    node = ast_node_hdl_create(AST_NODE_TYPE_REXPR_EXTERN_FUNC, NULL);
+    node->ndat->u.rexpr.value_type_mask = type;
+    node->ndat->u.rexpr.dpath_type_mask = EXPR_DPATH_TYPE_NONE;
+    extern_func = &node->ndat->u.rexpr_extern_func.extern_func;
+    extern_func->extern_func_fn = EXPR_VALUE_TYPE_BOOLEAN == type ?
+        test_eval_boolean_leaf : test_eval_integer_leaf;
+    extern_func->user_arg = (void *)(intptr_t)value;
+    return node;
+}
+
+static struct ast_node_hdl *
+test_op(enum ast_node_type type,
+        struct ast_node_hdl *opd1, struct ast_node_hdl *opd2)
+{
+    struct ast_node_hdl *node;
+    enum expr_value_type opd_types[2];
+    const struct expr_evaluator *evaluator;
+
+    node = ast_node_hdl_create(type, NULL);
+    node->ndat->u.rexpr_op.op.operands[0] = opd1;
+    node->ndat->u.rexpr_op.op.operands[1] = opd2;
+    opd_types[0] = opd1->ndat->u.rexpr.value_type_mask;
+    opd_types[1] = NULL != opd2 ?
+        opd2->ndat->u.rexpr.value_type_mask : EXPR_VALUE_TYPE_UNSET;
+    evaluator = expr_lookup_evaluator(type, opd_types);
+    ck_assert(NULL != evaluator);
+    node->ndat->u.rexpr_op.evaluator = evaluator;
+    node->ndat->u.rexpr.value_type_mask = evaluator->res_type_mask;
+    node->ndat->u.rexpr.dpath_type_mask = EXPR_DPATH_TYPE_NONE;
+    return node;
+}
+
+static struct ast_node_hdl *
+test_gen_boolean(int depth);
+
+static struct ast_node_hdl *
+test_gen_integer(int depth)
+{
+    static const enum ast_node_type binary_ops[] = {
+        AST_NODE_TYPE_REXPR_OP_ADD,
+        AST_NODE_TYPE_REXPR_OP_SUB,
+        AST_NODE_TYPE_REXPR_OP_MUL,
+        AST_NODE_TYPE_REXPR_OP_BWAND,
+        AST_NODE_TYPE_REXPR_OP_BWOR,
+        AST_NODE_TYPE_REXPR_OP_BWXOR,
+    };
+    static const enum ast_node_type unary_ops[] = {
+        AST_NODE_TYPE_REXPR_OP_UPLUS,
+        AST_NODE_TYPE_REXPR_OP_UMINUS,
+        AST_NODE_TYPE_REXPR_OP_BWNOT,
+    };
+    int64_t divisor;
+
+    if (0 == depth || 0 == test_rand(4)) {
+        if (test_rand(2)) {
+            return test_native(expr_value_as_integer(test_rand(201) - 100));
+        }
+        return test_leaf(EXPR_VALUE_TYPE_INTEGER, test_rand(201) - 100);
+    }
+    switch (test_rand(4)) {
+    case 0:
+    case 1:
+        return test_op(binary_ops[test_rand(N_ELEM(binary_ops))],
+                       test_gen_integer(depth - 1),
+                       test_gen_integer(depth - 1));
+    case 2:
+        switch (test_rand(3)) {
+        case 0:
+            // divide by a non-zero constant
+            divisor = test_rand(9) - 4;
+            return test_op(test_rand(2) ?
+                           AST_NODE_TYPE_REXPR_OP_DIV :
+                           AST_NODE_TYPE_REXPR_OP_MOD,
+                           test_gen_integer(depth - 1),
+                           test_native(expr_value_as_integer(
+                                           0 != divisor ? divisor : 1)));
+        case 1:
+            // shift a non-negative value by a constant
+            return test_op(test_rand(2) ?
+                           AST_NODE_TYPE_REXPR_OP_LSHIFT :
+                           AST_NODE_TYPE_REXPR_OP_RSHIFT,
+                           test_op(AST_NODE_TYPE_REXPR_OP_BWAND,
+                                   test_gen_integer(depth - 1),
+                                   test_native(expr_value_as_integer(0xffff))),
+                           test_native(expr_value_as_integer(test_rand(5))));
+        default:
+            return test_op(unary_ops[test_rand(N_ELEM(unary_ops))],
+                           test_gen_integer(depth - 1), NULL);
+        }
+    default:
+        return test_op(AST_NODE_TYPE_REXPR_OP_ADD,
+                       test_gen_integer(depth - 1),
+                       test_op(AST_NODE_TYPE_REXPR_OP_BWAND,
+                               test_gen_integer(depth - 1),
+                               test_native(expr_value_as_integer(0xff))));
+    }
+}
+
+static struct ast_node_hdl *
+test_gen_boolean(int depth)
+{
+    static const enum ast_node_type cmp_ops[] = {
+        AST_NODE_TYPE_REXPR_OP_EQ,
+        AST_NODE_TYPE_REXPR_OP_NE,
+        AST_NODE_TYPE_REXPR_OP_LT,
+        AST_NODE_TYPE_REXPR_OP_LE,
+        AST_NODE_TYPE_REXPR_OP_GT,
+        AST_NODE_TYPE_REXPR_OP_GE,
+    };
+    static const enum ast_node_type bool_ops[] = {
+        AST_NODE_TYPE_REXPR_OP_LAND,
+        AST_NODE_TYPE_REXPR_OP_LOR,
+        AST_NODE_TYPE_REXPR_OP_EQ,
+        AST_NODE_TYPE_REXPR_OP_NE,
+    };
+
+    if (0 == depth || 0 == test_rand(4)) {
+        if (test_rand(2)) {
+            return test_native(expr_value_as_boolean(test_rand(2)));
+        }
+        return test_leaf(EXPR_VALUE_TYPE_BOOLEAN, test_rand(2));
+    }
+    switch (test_rand(3)) {
+    case 0:
+        return test_op(cmp_ops[test_rand(N_ELEM(cmp_ops))],
+                       test_gen_integer(depth - 1),
+                       test_gen_integer(depth - 1));
+    case 1:
+        return test_op(bool_ops[test_rand(N_ELEM(bool_ops))],
+                       test_gen_boolean(depth - 1),
+                       test_gen_boolean(depth - 1));
+    default:
+        return test_op(AST_NODE_TYPE_REXPR_OP_LNOT,
+                       test_gen_boolean(depth - 1), NULL);
+    }
+}
+
+static void
+test_check_same_result(struct ast_node_hdl *expr)
+{
+    expr_value_t ref_value;
+    expr_value_t value;
+    int64_t ref_n_leaf_evals;
+    bitpunch_status_t bt_ret;
+
+    ck_assert(NULL == expr->bytecode);
+    test_n_leaf_evals = 0;
+    bt_ret = expr_evaluate_value(expr, NULL, NULL, &ref_value, NULL);
+    ck_assert(BITPUNCH_OK == bt_ret);
+    ref_n_leaf_evals = test_n_leaf_evals;
+
+    expr_bytecode_compile(expr);
+    ck_assert(NULL != expr->bytecode);
+    test_n_leaf_evals = 0;
+    bt_ret = expr_evaluate_value(expr, NULL, NULL, &value, NULL);
+    ck_assert(BITPUNCH_OK == bt_ret);
+    // operands are all evaluated, even with constant boolean operands
+    ck_assert(test_n_leaf_evals == ref_n_leaf_evals);
+    ck_assert(value.type == ref_value.type);
+    if (EXPR_VALUE_TYPE_BOOLEAN == value.type) {
+        ck_assert(value.boolean == ref_value.boolean);
+    } else {
+        ck_assert(value.integer == ref_value.integer);
+    }
+}
+
+START_TEST(test_expr_bytecode_random)
+{
+    int i;
+    struct ast_node_hdl *expr;
+
+    test_rand_state = 42;
+    for (i = 0; i < 2000; ++i) {
+        expr = (i % 2) ? test_gen_boolean(5) : test_gen_integer(5);
+        if (!expr_bytecode_is_scalar_operator(expr)) {
+            expr = (i % 2) ?
+                test_op(AST_NODE_TYPE_REXPR_OP_LNOT, expr, NULL) :
+                test_op(AST_NODE_TYPE_REXPR_OP_UMINUS, expr, NULL);
+        }
+        test_check_same_result(expr);
+    }
+}
+END_TEST
+
+START_TEST(test_expr_bytecode_fold)
+{
+    struct ast_node_hdl *expr;
+    const struct expr_bytecode *bytecode;
+
+    // (x + (2 * 3)) * 1 => eval x; add.k 6
+    expr = test_op(
+        AST_NODE_TYPE_REXPR_OP_MUL,
+        test_op(AST_NODE_TYPE_REXPR_OP_ADD,
+                test_leaf(EXPR_VALUE_TYPE_INTEGER, 10),
+                test_op(AST_NODE_TYPE_REXPR_OP_MUL,
+                        test_native(expr_value_as_integer(2)),
+                        test_native(expr_value_as_integer(3)))),
+        test_native(expr_value_as_integer(1)));
+    test_check_same_result(expr);
+    bytecode = expr->bytecode;
+    ck_assert(2 == bytecode->n_insns);
+    ck_assert(EXPR_OPCODE_EVAL_INTEGER == bytecode->insns[0].opcode);
+    ck_assert(EXPR_OPCODE_ADD_K == bytecode->insns[1].opcode);
+    ck_assert(6 == bytecode->insns[1].value);
+
+    // 2 < x => eval x; gt.k 2
+    expr = test_op(AST_NODE_TYPE_REXPR_OP_LT,
+                   test_native(expr_value_as_integer(2)),
+                   test_leaf(EXPR_VALUE_TYPE_INTEGER, 3));
+    test_check_same_result(expr);
+    bytecode = expr->bytecode;
+    ck_assert(2 == bytecode->n_insns);
+    ck_assert(EXPR_OPCODE_GT_K == bytecode->insns[1].opcode);
+
+    // false && x => x is still evaluated
+    expr = test_op(AST_NODE_TYPE_REXPR_OP_LAND,
+                   test_native(expr_value_as_boolean(FALSE)),
+                   test_leaf(EXPR_VALUE_TYPE_BOOLEAN, TRUE));
+    test_check_same_result(expr);
+    bytecode = expr->bytecode;
+    ck_assert(2 == bytecode->n_insns);
+    ck_assert(EXPR_OPCODE_EVAL_BOOLEAN == bytecode->insns[0].opcode);
+    ck_assert(EXPR_OPCODE_LAND_K == bytecode->insns[1].opcode);
+
+    // x / 0 is not folded
+    expr = test_op(AST_NODE_TYPE_REXPR_OP_DIV,
+                   test_native(expr_value_as_integer(1)),
+                   test_native(expr_value_as_integer(0)));
+    expr_bytecode_compile(expr);
+    bytecode = expr->bytecode;
+    ck_assert(2 == bytecode->n_insns);
+    ck_assert(EXPR_OPCODE_DIV_K == bytecode->insns[1].opcode);
+}
+END_TEST
+
+START_TEST(test_expr_bytecode_large)
+{
+    struct ast_node_hdl *expr;
+    int64_t expected;
+    expr_value_t value;
+    bitpunch_status_t bt_ret;
+    int i;
+
+    // operands too large to be inlined keep their own bytecode,
+    // compiled bottom-up as during schema compilation
+    expr = test_leaf(EXPR_VALUE_TYPE_INTEGER, 0);
+    expected = 0;
+    for (i = 1; i <= 200; ++i) {
+        expr = test_op(AST_NODE_TYPE_REXPR_OP_ADD,
+                       test_leaf(EXPR_VALUE_TYPE_INTEGER, i), expr);
+        expr_bytecode_compile(expr);
+        ck_assert(NULL != expr->bytecode);
+        ck_assert(expr->bytecode->n_insns <= EXPR_BYTECODE_MAX_INSNS);
+        expected += i;
+    }
+    test_n_leaf_evals = 0;
+    bt_ret = expr_evaluate_value(expr, NULL, NULL, &value, NULL);
+    ck_assert(BITPUNCH_OK == bt_ret);
+    ck_assert(EXPR_VALUE_TYPE_INTEGER == value.type);
+    ck_assert(expected == value.integer);
+    ck_assert(201 == test_n_leaf_evals);
+}
+END_TEST
+
+void check_expr_bytecode_add_tcases(Suite *s)
+{
+    TCase *tc_expr_bytecode;
+
+    tc_expr_bytecode = tcase_create("expr_bytecode");
+    tcase_add_test(tc_expr_bytecode, test_expr_bytecode_random);
+    tcase_add_test(tc_expr_bytecode, test_expr_bytecode_fold);
+    tcase_add_test(tc_expr_bytecode, test_expr_bytecode_large);
+    suite_add_tcase(s, tc_expr_bytecode);
+}
+
+#endif // #ifndef DISABLE_UTESTS
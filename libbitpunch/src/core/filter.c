@@ -35,6 +35,7 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include "core/debug.h"
 #include "core/filter.h"
@@ -43,12 +44,20 @@
 #include "filters/composite.h"
 #include "filters/byte.h"
 #include "filters/array.h"
+#include "utils/queue.h"
 
 #define MAX_BUILTIN_FILTER_COUNT           256
 
 struct filter_class builtin_filter_class_table[MAX_BUILTIN_FILTER_COUNT];
 int                 builtin_filter_class_count = 0;
 
+/*
+ * Declarations are serialized by builtin_filter_lock, and a new class
+ * is published by a release store of builtin_filter_class_count once
+ * fully constructed, so lookups need not take the lock.
+ */
+static pthread_mutex_t builtin_filter_lock = PTHREAD_MUTEX_INITIALIZER;
+
 
 static struct filter_class *
 builtin_filter_class_new(void)
@@ -59,7 +68,7 @@ builtin_filter_class_new(void)
                          MAX_BUILTIN_FILTER_COUNT);
         return NULL;
     }
-    return &builtin_filter_class_table[builtin_filter_class_count++];
+    return &builtin_filter_class_table[builtin_filter_class_count];
 }
 
 struct filter_class *
@@ -132,8 +141,10 @@ builtin_filter_declare(
     va_list ap;
     int ret;
 
+    pthread_mutex_lock(&builtin_filter_lock);
     filter_cls = builtin_filter_class_new();
     if (NULL == filter_cls) {
+        pthread_mutex_unlock(&builtin_filter_lock);
         return -1;
     }
     va_start(ap, n_attrs);
@@ -144,15 +155,23 @@ builtin_filter_declare(
         filter_instance_compile_func,
         flags, n_attrs, ap);
     va_end(ap);
+    if (0 == ret) {
+        __atomic_store_n(&builtin_filter_class_count,
+                         builtin_filter_class_count + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&builtin_filter_lock);
     return ret;
 }
 
 struct filter_class *
 builtin_filter_lookup(const char *name)
 {
+    int n_classes;
     int i;
 
-    for (i = 0; i < builtin_filter_class_count; ++i) {
+    n_classes = __atomic_load_n(&builtin_filter_class_count,
+                                __ATOMIC_ACQUIRE);
+    for (i = 0; i < n_classes; ++i) {
         if (0 == strcmp(builtin_filter_class_table[i].name, name)) {
             return &builtin_filter_class_table[i];
         }
@@ -280,6 +299,371 @@ filter_class_get_attr(const struct filter_class *filter_cls,
     return NULL; /* not found */
 }
 
+/*
+ * filter output cache
+ *
+ * Data sources output by filters of classes flagged with
+ * FILTER_CLASS_CACHED_OUTPUT (e.g. decompressed blocks) only depend
+ * on the filter node, its attributes and the filtered input bytes.
+ * They are cached by (input data source, input range, filter node,
+ * values of dynamic attributes), so that filtering the same item
+ * again reuses the previous output. Attributes evaluated in the
+ * scope of the filtered item (e.g. a deflate @output_size read from
+ * a header field) are evaluated before the lookup and serialized in
+ * the key, constant attributes are covered by the filter node.
+ * Entries are kept in a LRU list and evicted when the cache exceeds
+ * its entry or byte budget.
+ */
+
+#define FILTER_CACHE_DEFAULT_MAX_ENTRIES 256
+#define FILTER_CACHE_DEFAULT_MAX_BYTES   ((size_t)256 * 1024 * 1024)
+#define FILTER_CACHE_MIN_BUCKETS         64
+#define FILTER_CACHE_MAX_ATTRS_SIZE      128
+
+struct filter_output_key {
+    struct bitpunch_data_source *ds_in;
+    int64_t start_offset;
+    int64_t end_offset;
+    const struct ast_node_hdl *filter;
+    /** serialized values of dynamic attributes, in class declaration
+     * order (see filter_output_key_set_attributes()) */
+    int attrs_size;
+    char attrs[FILTER_CACHE_MAX_ATTRS_SIZE];
+};
+
+struct cached_filter_output {
+    /** holds a reference on key.ds_in, so that its address cannot
+     * be reused by another data source */
+    struct filter_output_key key;
+    struct bitpunch_data_source *ds_out;
+    struct cached_filter_output *hash_next;
+    TAILQ_ENTRY(cached_filter_output) lru;
+};
+
+TAILQ_HEAD(cached_filter_output_list, cached_filter_output);
+
+/*
+ * The filter output cache is shared by all threads and protected by
+ * filter_cache.lock. It may release data sources while locked, hence
+ * it must be taken before the file data source cache lock.
+ */
+static struct filter_cache {
+    pthread_mutex_t lock;
+    struct cached_filter_output **buckets;
+    size_t n_buckets;
+    struct cached_filter_output_list lru;
+    size_t max_entries;
+    size_t max_bytes;
+    struct bitpunch_filter_cache_stats stats;
+} filter_cache = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+void
+filter_cache_global_init(void)
+{
+    filter_cache.n_buckets = FILTER_CACHE_MIN_BUCKETS;
+    filter_cache.buckets = malloc0_safe(
+        filter_cache.n_buckets * sizeof (struct cached_filter_output *));
+    TAILQ_INIT(&filter_cache.lru);
+    filter_cache.max_entries = FILTER_CACHE_DEFAULT_MAX_ENTRIES;
+    filter_cache.max_bytes = FILTER_CACHE_DEFAULT_MAX_BYTES;
+    memset(&filter_cache.stats, 0, sizeof (filter_cache.stats));
+}
+
+static struct cached_filter_output **
+filter_cache_bucket(const struct filter_output_key *key)
+{
+    uint64_t hash;
+    uint64_t attrs_hash;
+    int i;
+
+    attrs_hash = 0xcbf29ce484222325ULL;
+    for (i = 0; i < key->attrs_size; ++i) {
+        attrs_hash = (attrs_hash ^ (unsigned char)key->attrs[i])
+            * 0x100000001b3ULL;
+    }
+    hash = ((uint64_t)(uintptr_t)key->ds_in * 0x9e3779b97f4a7c15ULL)
+        ^ ((uint64_t)key->start_offset * 0xc2b2ae3d27d4eb4fULL)
+        ^ ((uint64_t)key->end_offset * 0x165667b19e3779f9ULL)
+        ^ ((uint64_t)(uintptr_t)key->filter * 0x27d4eb2f165667c5ULL)
+        ^ attrs_hash;
+    hash ^= hash >> 29;
+    return &filter_cache.buckets[hash & (filter_cache.n_buckets - 1)];
+}
+
+static int
+filter_output_key_equals(const struct filter_output_key *key1,
+                         const struct filter_output_key *key2)
+{
+    return key1->ds_in == key2->ds_in
+        && key1->start_offset == key2->start_offset
+        && key1->end_offset == key2->end_offset
+        && key1->filter == key2->filter
+        && key1->attrs_size == key2->attrs_size
+        && 0 == memcmp(key1->attrs, key2->attrs, key1->attrs_size);
+}
+
+static void
+filter_cache_resize(size_t n_buckets)
+{
+    struct cached_filter_output **old_buckets;
+    size_t old_n_buckets;
+    struct cached_filter_output *cfo;
+    struct cached_filter_output **bucket;
+    size_t i;
+
+    old_buckets = filter_cache.buckets;
+    old_n_buckets = filter_cache.n_buckets;
+    filter_cache.n_buckets = n_buckets;
+    filter_cache.buckets = malloc0_safe(
+        n_buckets * sizeof (struct cached_filter_output *));
+    for (i = 0; i < old_n_buckets; ++i) {
+        while (NULL != old_buckets[i]) {
+            cfo = old_buckets[i];
+            old_buckets[i] = cfo->hash_next;
+            bucket = filter_cache_bucket(&cfo->key);
+            cfo->hash_next = *bucket;
+            *bucket = cfo;
+        }
+    }
+    free(old_buckets);
+}
+
+static void
+filter_cache_remove(struct cached_filter_output *cfo)
+{
+    struct cached_filter_output **pcfo;
+
+    pcfo = filter_cache_bucket(&cfo->key);
+    while (*pcfo != cfo) {
+        pcfo = &(*pcfo)->hash_next;
+    }
+    *pcfo = cfo->hash_next;
+    TAILQ_REMOVE(&filter_cache.lru, cfo, lru);
+    --filter_cache.stats.n_entries;
+    filter_cache.stats.n_bytes -= cfo->ds_out->ds_data_length;
+    (void) bitpunch_data_source_release(cfo->ds_out);
+    (void) bitpunch_data_source_release(cfo->key.ds_in);
+    free(cfo);
+}
+
+static void
+filter_cache_enforce_budget(void)
+{
+    while ((filter_cache.stats.n_entries > filter_cache.max_entries
+            || filter_cache.stats.n_bytes > filter_cache.max_bytes)
+           && !TAILQ_EMPTY(&filter_cache.lru)) {
+        filter_cache_remove(
+            TAILQ_LAST(&filter_cache.lru, cached_filter_output_list));
+        ++filter_cache.stats.n_evictions;
+    }
+}
+
+static struct cached_filter_output *
+filter_cache_find(const struct filter_output_key *key)
+{
+    struct cached_filter_output *cfo;
+
+    for (cfo = *filter_cache_bucket(key); NULL != cfo;
+         cfo = cfo->hash_next) {
+        if (filter_output_key_equals(&cfo->key, key)) {
+            return cfo;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief lookup a cached filter output
+ *
+ * @return the cached output data source with a new reference taken
+ * on it (which the caller must release), or NULL if not cached
+ */
+static struct bitpunch_data_source *
+filter_cache_lookup(const struct filter_output_key *key)
+{
+    struct cached_filter_output *cfo;
+    struct bitpunch_data_source *ds_out;
+
+    pthread_mutex_lock(&filter_cache.lock);
+    if (0 == filter_cache.n_buckets) {
+        pthread_mutex_unlock(&filter_cache.lock);
+        return NULL;
+    }
+    cfo = filter_cache_find(key);
+    if (NULL != cfo) {
+        TAILQ_REMOVE(&filter_cache.lru, cfo, lru);
+        TAILQ_INSERT_HEAD(&filter_cache.lru, cfo, lru);
+        ++filter_cache.stats.n_hits;
+        ds_out = cfo->ds_out;
+        // acquire while locked, the entry may be evicted right after
+        bitpunch_data_source_acquire(ds_out);
+    } else {
+        ++filter_cache.stats.n_misses;
+        ds_out = NULL;
+    }
+    pthread_mutex_unlock(&filter_cache.lock);
+    return ds_out;
+}
+
+static void
+filter_cache_insert(const struct filter_output_key *key,
+                    struct bitpunch_data_source *ds_out)
+{
+    struct cached_filter_output *cfo;
+    struct cached_filter_output **bucket;
+
+    pthread_mutex_lock(&filter_cache.lock);
+    if (0 == filter_cache.n_buckets
+        || 0 == filter_cache.max_entries
+        || ds_out->ds_data_length > filter_cache.max_bytes
+        // another thread may have computed the same output meanwhile
+        || NULL != filter_cache_find(key)) {
+        pthread_mutex_unlock(&filter_cache.lock);
+        return ;
+    }
+    if (filter_cache.stats.n_entries >= filter_cache.n_buckets) {
+        filter_cache_resize(filter_cache.n_buckets * 2);
+    }
+    cfo = new_safe(struct cached_filter_output);
+    cfo->key = *key;
+    bitpunch_data_source_acquire(cfo->key.ds_in);
+    cfo->ds_out = ds_out;
+    bitpunch_data_source_acquire(ds_out);
+    bucket = filter_cache_bucket(&cfo->key);
+    cfo->hash_next = *bucket;
+    *bucket = cfo;
+    TAILQ_INSERT_HEAD(&filter_cache.lru, cfo, lru);
+    ++filter_cache.stats.n_entries;
+    filter_cache.stats.n_bytes += ds_out->ds_data_length;
+    filter_cache_enforce_budget();
+    pthread_mutex_unlock(&filter_cache.lock);
+}
+
+void
+filter_cache_global_destroy(void)
+{
+    while (!TAILQ_EMPTY(&filter_cache.lru)) {
+        filter_cache_remove(TAILQ_FIRST(&filter_cache.lru));
+    }
+    free(filter_cache.buckets);
+    filter_cache.buckets = NULL;
+    filter_cache.n_buckets = 0;
+}
+
+/**
+ * @brief set limits of the filter output cache
+ *
+ * Entries are evicted, least recently used first, while the cache
+ * holds more than @ref max_entries outputs or more than @ref
+ * max_bytes bytes of output. Setting @ref max_entries to 0 disables
+ * the cache.
+ */
+void
+bitpunch_set_filter_cache_limits(size_t max_entries, size_t max_bytes)
+{
+    pthread_mutex_lock(&filter_cache.lock);
+    filter_cache.max_entries = max_entries;
+    filter_cache.max_bytes = max_bytes;
+    filter_cache_enforce_budget();
+    pthread_mutex_unlock(&filter_cache.lock);
+}
+
+void
+bitpunch_get_filter_cache_stats(struct bitpunch_filter_cache_stats *statsp)
+{
+    pthread_mutex_lock(&filter_cache.lock);
+    *statsp = filter_cache.stats;
+    pthread_mutex_unlock(&filter_cache.lock);
+}
+
+static int
+filter_output_key_append(struct filter_output_key *key,
+                         const void *data, int64_t size)
+{
+    if (size > FILTER_CACHE_MAX_ATTRS_SIZE - key->attrs_size) {
+        return -1;
+    }
+    memcpy(key->attrs + key->attrs_size, data, size);
+    key->attrs_size += (int)size;
+    return 0;
+}
+
+/**
+ * @brief evaluate dynamic attributes of @ref filter in @ref scope
+ * and serialize their values in @ref key
+ *
+ * Each dynamic attribute declared by the filter class is appended as
+ * its value type (0 if not set in this scope), followed by the size
+ * and bytes of its value.
+ *
+ * @return TRUE if the output can be cached under @ref key, FALSE if
+ * an attribute could not be evaluated or serialized (the filter then
+ * reports evaluation errors itself)
+ */
+static int
+filter_output_key_set_attributes(struct filter_output_key *key,
+                                 struct ast_node_hdl *filter,
+                                 struct box *scope,
+                                 struct browse_state *bst)
+{
+    const struct filter_attr_def *attr_def;
+    bitpunch_status_t bt_ret;
+    expr_value_t value;
+    int32_t value_type;
+    const char *buf;
+    int64_t size;
+    int ret;
+
+    STAILQ_FOREACH(attr_def,
+                   &filter->ndat->u.rexpr_filter.filter_cls->attr_list,
+                   list) {
+        bt_ret = filter_get_constant_attribute(filter, attr_def->name, NULL);
+        if (BITPUNCH_OK == bt_ret || BITPUNCH_NO_ITEM == bt_ret) {
+            continue ;
+        }
+        bt_ret = filter_evaluate_attribute_internal(
+            filter, scope, attr_def->name, 0u, NULL, &value, NULL, bst);
+        if (BITPUNCH_NO_ITEM == bt_ret) {
+            value_type = 0;
+            if (-1 == filter_output_key_append(key, &value_type,
+                                               sizeof (value_type))) {
+                return FALSE;
+            }
+            continue ;
+        }
+        if (BITPUNCH_OK != bt_ret) {
+            browse_state_clear_error(bst);
+            return FALSE;
+        }
+        switch (value.type) {
+        case EXPR_VALUE_TYPE_INTEGER:
+        case EXPR_VALUE_TYPE_BOOLEAN:
+        case EXPR_VALUE_TYPE_STRING:
+        case EXPR_VALUE_TYPE_BYTES:
+            break ;
+        default:
+            expr_value_destroy(value);
+            return FALSE;
+        }
+        value_type = value.type;
+        expr_value_to_hashable(value, &buf, &size);
+        ret = filter_output_key_append(key, &value_type, sizeof (value_type));
+        if (0 == ret) {
+            ret = filter_output_key_append(key, &size, sizeof (size));
+        }
+        if (0 == ret) {
+            ret = filter_output_key_append(key, buf, size);
+        }
+        expr_value_destroy(value);
+        if (-1 == ret) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
 bitpunch_status_t
 filter_instance_read_value(struct ast_node_hdl *filter,
                            struct box *scope,
@@ -291,19 +675,46 @@ filter_instance_read_value(struct ast_node_hdl *filter,
     struct filter_instance *f_instance;
     bitpunch_status_t bt_ret;
     int64_t span_size;
+    struct bitpunch_data_pin pin;
     const char *item_data;
     expr_value_t value;
+    int cached_output;
+    struct filter_output_key cache_key;
+    struct bitpunch_data_source *ds_out;
 
     assert(-1 != item_start_offset);
     assert(NULL != scope->ds_in);
 
     value.type = EXPR_VALUE_TYPE_UNSET;
     f_instance = filter->ndat->u.rexpr_filter.f_instance;
+    cached_output = FALSE;
+    // internal filters (e.g. slices) have no filter class
+    if (NULL != filter->ndat->u.rexpr_filter.filter_cls
+        && 0 != (filter->ndat->u.rexpr_filter.filter_cls->flags
+                 & FILTER_CLASS_CACHED_OUTPUT)) {
+        memset(&cache_key, 0, sizeof (cache_key));
+        cache_key.ds_in = scope->ds_in;
+        cache_key.start_offset = item_start_offset;
+        cache_key.end_offset = item_end_offset;
+        cache_key.filter = filter;
+        cached_output = filter_output_key_set_attributes(
+            &cache_key, filter, scope, bst);
+    }
+    if (cached_output) {
+        ds_out = filter_cache_lookup(&cache_key);
+        if (NULL != ds_out) {
+            value = expr_value_as_data(ds_out);
+            if (NULL != valuep) {
+                *valuep = value;
+            } else {
+                expr_value_destroy(value);
+            }
+            return BITPUNCH_OK;
+        }
+    }
     if (NULL != f_instance->b_item.compute_item_size_from_buffer) {
-        item_data = scope->ds_in->ds_data + item_start_offset;
-        bt_ret = f_instance->b_item.compute_item_size_from_buffer(
-            filter, scope,
-            item_data, item_end_offset - item_start_offset,
+        bt_ret = box_compute_item_size_from_buffer(
+            scope, filter, item_start_offset, item_end_offset,
             &span_size, bst);
     } else if (NULL != f_instance->b_item.compute_item_size) {
         bt_ret = f_instance->b_item.compute_item_size(
@@ -315,10 +726,24 @@ filter_instance_read_value(struct ast_node_hdl *filter,
     }
     if (BITPUNCH_OK == bt_ret) {
         memset(&value, 0, sizeof(value));
-        item_data = scope->ds_in->ds_data + item_start_offset;
-        if (NULL != f_instance->b_item.read_value_from_buffer) {
-            bt_ret = f_instance->b_item.read_value_from_buffer(
-                filter, scope, item_data, span_size, &value, bst);
+        if (NULL != f_instance->b_item.read_value) {
+            bt_ret = f_instance->b_item.read_value(
+                filter, scope, item_start_offset, span_size, &value, bst);
+        } else if (NULL != f_instance->b_item.read_value_from_buffer) {
+            bt_ret = box_pin_data_internal(
+                scope, scope->ds_in, item_start_offset, span_size,
+                &pin, &item_data, bst);
+            if (BITPUNCH_OK == bt_ret) {
+                bt_ret = f_instance->b_item.read_value_from_buffer(
+                    filter, scope, item_data, span_size, &value, bst);
+                // string and bytes values may reference the pinned
+                // data, keep it pinned as long as the value lives
+                if (BITPUNCH_OK == bt_ret) {
+                    expr_value_attach_pin(&value, scope->ds_in, &pin);
+                } else {
+                    box_unpin_data(scope, scope->ds_in, &pin, FALSE);
+                }
+            }
         } else {
             value = expr_value_as_data_range(
                 scope->ds_in, item_start_offset, item_end_offset);
@@ -326,6 +751,9 @@ filter_instance_read_value(struct ast_node_hdl *filter,
         }
     }
     if (BITPUNCH_OK == bt_ret) {
+        if (cached_output && EXPR_VALUE_TYPE_DATA == value.type) {
+            filter_cache_insert(&cache_key, value.data.ds);
+        }
         if (NULL != valuep) {
             *valuep = value;
         } else {
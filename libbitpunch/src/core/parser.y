@@ -50,6 +50,7 @@
 #include "core/ast.h"
 #include "core/expr.h"
 #include "utils/dep_resolver.h"
+#include "utils/intern.h"
 
 #define YYLTYPE struct parser_location
 #define YYLLOC_DEFAULT(Cur, Rhs, N)                             \
@@ -95,6 +96,8 @@
 
     struct statement;
     struct filter_instance;
+    struct expr_bytecode;
+    struct regex;
 
     TAILQ_HEAD(statement_list, statement);
 
@@ -109,10 +112,14 @@
      (var); (var) = STATEMENT_NEXT(stmt_type, var, field))
 
 
+    struct scope_name_table;
+
     struct block_stmt_list {
         struct statement_list *field_list;
         struct statement_list *named_expr_list;
         struct statement_list *attribute_list;
+        /** name lookup table, built on first lookup (see scope.c) */
+        struct scope_name_table *name_table;
     };
 
     typedef expr_value_t
@@ -231,6 +238,7 @@
             AST_NODE_TYPE_OP_MUL,
             AST_NODE_TYPE_OP_DIV,
             AST_NODE_TYPE_OP_MOD,
+            AST_NODE_TYPE_OP_MATCH,
             AST_NODE_TYPE_OP_UPLUS,
             AST_NODE_TYPE_OP_UMINUS,
             AST_NODE_TYPE_OP_LNOT,
@@ -264,6 +272,7 @@
             AST_NODE_TYPE_REXPR_OP_MUL,
             AST_NODE_TYPE_REXPR_OP_DIV,
             AST_NODE_TYPE_REXPR_OP_MOD,
+            AST_NODE_TYPE_REXPR_OP_MATCH,
             AST_NODE_TYPE_REXPR_OP_UPLUS,
             AST_NODE_TYPE_REXPR_OP_UMINUS,
             AST_NODE_TYPE_REXPR_OP_LNOT,
@@ -388,6 +397,10 @@
                 struct op op;
                 const struct expr_evaluator *evaluator;
             } rexpr_op;
+            struct rexpr_op_match {
+                struct rexpr_op rexpr_op; /* inherits */
+                struct regex *regex;
+            } rexpr_op_match;
             struct rexpr_op_subscript_common {
                 struct rexpr rexpr; /* inherits */
                 struct ast_node_hdl *anchor_expr;
@@ -420,6 +433,8 @@
         enum ast_node_flag flags;
         enum resolve_identifiers_tag resolved_tags;
         struct dep_resolver_node dr_node;
+        /** compiled operator expression, see core/expr_bytecode.h */
+        struct expr_bytecode *bytecode;
     };
 
     struct statement {
@@ -436,6 +451,11 @@
     struct named_statement {
         struct statement stmt; // inherits
         char *name;
+        /** next and previous statements of the same type with the
+         * same name in the same block, in declaration order (set when
+         * the block's name table is built) */
+        const struct named_statement *next_homonym;
+        const struct named_statement *prev_homonym;
     };
 
     enum named_statement_flag {
@@ -447,16 +467,26 @@
         struct ast_node_hdl *expr;
     };
 
+    enum named_expr_flag {
+        /** result only depends on the evaluation box (memoizable) */
+        NAMED_EXPR_FLAG_PURE     = (NAMED_STATEMENT_FLAGS_END<<0),
+    };
+
     struct field {
         struct named_statement nstmt; // inherits
         struct ast_node_hdl *filter;
         struct dep_resolver_node dr_node;
+        /** index in the field offset table of the enclosing struct,
+         * valid if FIELD_FLAG_STATIC_OFFSET is set */
+        int static_index;
     };
 
     enum field_flag {
         FIELD_FLAG_HIDDEN        = (NAMED_STATEMENT_FLAGS_END<<0),
         FIELD_FLAG_HEADER        = (NAMED_STATEMENT_FLAGS_END<<1),
         FIELD_FLAG_TRAILER       = (NAMED_STATEMENT_FLAGS_END<<2),
+        /** field offset is known at compile time */
+        FIELD_FLAG_STATIC_OFFSET = (NAMED_STATEMENT_FLAGS_END<<3),
     };
 
     typedef bitpunch_status_t
@@ -476,6 +506,8 @@
         expr_eval_builtin_fn_t eval_fn;
         int min_n_params;
         int max_n_params;
+        /** result depends on the evaluation environment */
+        int impure;
     };
 
     enum semantic_loglevel {
@@ -622,7 +654,7 @@
         if (NULL != loc) {
             attr->nstmt.stmt.loc = *loc;
         }
-        attr->nstmt.name = strdup_safe(attr_name);
+        attr->nstmt.name = (char *)intern_string(attr_name);
         attr->expr = attr_expr;
         TAILQ_INSERT_TAIL(attribute_list, (struct statement *)attr, list);
     }
@@ -654,6 +686,7 @@
 %token <ast_node_type> TOK_LAND "&&"
 %token <ast_node_type> TOK_EQ "=="
 %token <ast_node_type> TOK_NE "!="
+%token <ast_node_type> TOK_MATCH "=~"
 %token <ast_node_type> TOK_GE ">="
 %token <ast_node_type> TOK_LE "<="
 %token <ast_node_type> TOK_LSHIFT "<<"
@@ -668,7 +701,7 @@
 %left  '|'
 %left  '^'
 %left  '&'
-%left  "==" "!="
+%left  "==" "!=" "=~"
 %left  '>' '<' ">=" "<="
 %left  "<<" ">>"
 %left  '+' '-'
@@ -790,6 +823,9 @@ expr:
   | expr "!=" expr {
         $$ = expr_gen_ast_node(AST_NODE_TYPE_OP_NE, $1, $3, &@2);
     }
+  | expr "=~" expr {
+        $$ = expr_gen_ast_node(AST_NODE_TYPE_OP_MATCH, $1, $3, &@2);
+    }
   | expr '>' expr {
         $$ = expr_gen_ast_node(AST_NODE_TYPE_OP_GT, $1, $3, &@2);
     }
@@ -1252,6 +1288,8 @@ ast_node_type_str(enum ast_node_type type)
     case AST_NODE_TYPE_REXPR_OP_DIV: return "operator 'divide'";
     case AST_NODE_TYPE_OP_MOD:
     case AST_NODE_TYPE_REXPR_OP_MOD: return "operator 'modulo'";
+    case AST_NODE_TYPE_OP_MATCH:
+    case AST_NODE_TYPE_REXPR_OP_MATCH: return "operator '=~'";
     case AST_NODE_TYPE_OP_FILTER:
     case AST_NODE_TYPE_REXPR_OP_FILTER: return "operator 'filter'";
     case AST_NODE_TYPE_REXPR_FILTER: return "filter";
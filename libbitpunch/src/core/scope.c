@@ -38,6 +38,419 @@
 #include "core/expr_internal.h"
 #include "core/filter.h"
 #include "core/scope.h"
+#include "utils/intern.h"
+
+
+/*
+ * name tables
+ *
+ * Each block of statements gets a hash table of the names it
+ * declares, built on first lookup, to find statements by name
+ * without walking the statement lists. Statements with the same name
+ * and type are chained in declaration order (next_homonym and
+ * prev_homonym), so iterating over them is a pointer walk.
+ *
+ * Tables of shared schemas are looked up concurrently: they are built
+ * under the compile lock and published with a release store, and are
+ * never modified once published. Resolving anonymous members works
+ * on a copy which replaces the published table, the previous one is
+ * retired and only freed along with its replacement.
+ */
+
+enum scope_statement_index {
+    SCOPE_STATEMENT_INDEX_FIELD = 0,
+    SCOPE_STATEMENT_INDEX_NAMED_EXPR,
+    SCOPE_STATEMENT_INDEX_ATTRIBUTE,
+    SCOPE_N_STATEMENT_TYPES,
+};
+
+struct scope_name_entry {
+    /** name, or NULL for an empty slot */
+    const char *name;
+    uint32_t hash;
+    /** first and last statements with this name, indexed by enum
+     * scope_statement_index */
+    const struct named_statement *first[SCOPE_N_STATEMENT_TYPES];
+    const struct named_statement *last[SCOPE_N_STATEMENT_TYPES];
+    /** named expression or field with this name may be declared in
+     * an anonymous field of constant type */
+    int anonymous_member;
+};
+
+struct scope_name_table {
+    uint32_t n_slots;
+    uint32_t n_names;
+    struct scope_name_entry *slots;
+    /** non-hidden anonymous fields, in declaration order */
+    const struct field **anonymous_fields;
+    int n_anonymous_fields;
+    /** set if an anonymous field has a type only known at browse time */
+    int has_dynamic_anonymous_fields;
+    /** anonymous_member flags have been computed */
+    int anonymous_members_resolved;
+    /** anonymous members of this table are being resolved, to stop
+     * recursion in self-referencing types */
+    int resolving;
+    /** previously published table, replaced by this one */
+    struct scope_name_table *retired;
+};
+
+static enum scope_statement_index
+scope_statement_type_index(enum statement_type stmt_type)
+{
+    switch (stmt_type) {
+    case STATEMENT_TYPE_FIELD:
+        return SCOPE_STATEMENT_INDEX_FIELD;
+    case STATEMENT_TYPE_NAMED_EXPR:
+        return SCOPE_STATEMENT_INDEX_NAMED_EXPR;
+    case STATEMENT_TYPE_ATTRIBUTE:
+        return SCOPE_STATEMENT_INDEX_ATTRIBUTE;
+    default:
+        assert(0);
+    }
+}
+
+static struct scope_name_entry *
+scope_name_table_find_slot(struct scope_name_table *table,
+                           const char *name, uint32_t hash)
+{
+    struct scope_name_entry *entry;
+    uint32_t slot;
+
+    slot = hash & (table->n_slots - 1);
+    while (TRUE) {
+        entry = &table->slots[slot];
+        if (NULL == entry->name
+            || entry->name == name
+            || (entry->hash == hash && 0 == strcmp(entry->name, name))) {
+            return entry;
+        }
+        slot = (slot + 1) & (table->n_slots - 1);
+    }
+}
+
+static struct scope_name_entry *
+scope_name_table_get_entry(struct scope_name_table *table, const char *name)
+{
+    struct scope_name_entry *entry;
+    uint32_t hash;
+
+    hash = intern_hash(name);
+    entry = scope_name_table_find_slot(table, name, hash);
+    if (NULL == entry->name) {
+        entry->name = name;
+        entry->hash = hash;
+        ++table->n_names;
+    }
+    return entry;
+}
+
+static void
+scope_name_table_grow(struct scope_name_table *table)
+{
+    struct scope_name_entry *old_slots;
+    struct scope_name_entry *old_entry;
+    uint32_t old_n_slots;
+
+    old_slots = table->slots;
+    old_n_slots = table->n_slots;
+    table->n_slots = old_n_slots * 2;
+    table->slots = malloc0_safe(table->n_slots * sizeof (*table->slots));
+    for (old_entry = old_slots; old_entry < old_slots + old_n_slots;
+         ++old_entry) {
+        if (NULL != old_entry->name) {
+            *scope_name_table_find_slot(table, old_entry->name,
+                                        old_entry->hash) = *old_entry;
+        }
+    }
+    free(old_slots);
+}
+
+static void
+scope_name_table_add_list(struct scope_name_table *table,
+                          enum statement_type stmt_type,
+                          const struct statement_list *stmt_list)
+{
+    struct statement *stmt;
+    struct named_statement *nstmt;
+    struct scope_name_entry *entry;
+    enum scope_statement_index type_index;
+
+    type_index = scope_statement_type_index(stmt_type);
+    TAILQ_FOREACH(stmt, stmt_list, list) {
+        nstmt = (struct named_statement *)stmt;
+        nstmt->next_homonym = NULL;
+        if (NULL == nstmt->name) {
+            nstmt->prev_homonym = NULL;
+            if (STATEMENT_TYPE_FIELD == stmt_type
+                && 0 == (stmt->stmt_flags & FIELD_FLAG_HIDDEN)) {
+                table->anonymous_fields[table->n_anonymous_fields++] =
+                    (const struct field *)nstmt;
+            }
+            continue ;
+        }
+        entry = scope_name_table_get_entry(table, nstmt->name);
+        nstmt->prev_homonym = entry->last[type_index];
+        if (NULL != entry->last[type_index]) {
+            ((struct named_statement *)entry->last[type_index])
+                ->next_homonym = nstmt;
+        } else {
+            entry->first[type_index] = nstmt;
+        }
+        entry->last[type_index] = nstmt;
+    }
+}
+
+static int
+scope_statement_list_length(const struct statement_list *stmt_list)
+{
+    const struct statement *stmt;
+    int n_stmts = 0;
+
+    TAILQ_FOREACH(stmt, stmt_list, list) {
+        ++n_stmts;
+    }
+    return n_stmts;
+}
+
+static struct scope_name_table *
+scope_name_table_build(const struct block_stmt_list *stmt_lists)
+{
+    struct scope_name_table *table;
+    int n_stmts;
+    int n_fields;
+
+    n_fields = scope_statement_list_length(stmt_lists->field_list);
+    n_stmts = n_fields
+        + scope_statement_list_length(stmt_lists->named_expr_list)
+        + scope_statement_list_length(stmt_lists->attribute_list);
+    table = new_safe(struct scope_name_table);
+    // keep load factor below 1/2
+    table->n_slots = 4;
+    while (table->n_slots < 2 * (uint32_t)n_stmts) {
+        table->n_slots *= 2;
+    }
+    table->slots = malloc0_safe(table->n_slots * sizeof (*table->slots));
+    table->anonymous_fields =
+        malloc_safe((n_fields + 1) * sizeof (*table->anonymous_fields));
+    scope_name_table_add_list(table, STATEMENT_TYPE_FIELD,
+                              stmt_lists->field_list);
+    scope_name_table_add_list(table, STATEMENT_TYPE_NAMED_EXPR,
+                              stmt_lists->named_expr_list);
+    scope_name_table_add_list(table, STATEMENT_TYPE_ATTRIBUTE,
+                              stmt_lists->attribute_list);
+    return table;
+}
+
+static struct scope_name_table *
+scope_name_table_dup(const struct scope_name_table *table)
+{
+    struct scope_name_table *dup;
+
+    dup = new_safe(struct scope_name_table);
+    *dup = *table;
+    dup->slots = malloc_safe(table->n_slots * sizeof (*table->slots));
+    memcpy(dup->slots, table->slots, table->n_slots * sizeof (*table->slots));
+    dup->anonymous_fields = malloc_safe(
+        (table->n_anonymous_fields + 1) * sizeof (*table->anonymous_fields));
+    memcpy(dup->anonymous_fields, table->anonymous_fields,
+           table->n_anonymous_fields * sizeof (*table->anonymous_fields));
+    dup->resolving = FALSE;
+    dup->retired = NULL;
+    return dup;
+}
+
+static void
+scope_name_table_free(struct scope_name_table *table)
+{
+    struct scope_name_table *retired;
+
+    while (NULL != table) {
+        retired = table->retired;
+        free(table->slots);
+        free(table->anonymous_fields);
+        free(table);
+        table = retired;
+    }
+}
+
+static struct scope_name_table *
+scope_get_name_table(const struct block_stmt_list *stmt_lists)
+{
+    struct block_stmt_list *mutable_lists;
+    struct scope_name_table *table;
+
+    table = __atomic_load_n(&stmt_lists->name_table, __ATOMIC_ACQUIRE);
+    if (NULL != table) {
+        return table;
+    }
+    compile_lock();
+    table = stmt_lists->name_table;
+    if (NULL == table) {
+        mutable_lists = (struct block_stmt_list *)stmt_lists;
+        table = scope_name_table_build(stmt_lists);
+        __atomic_store_n(&mutable_lists->name_table, table, __ATOMIC_RELEASE);
+    }
+    compile_unlock();
+    return table;
+}
+
+/**
+ * @brief forget the name table of a block after its statement lists
+ * changed
+ */
+static void
+scope_invalidate_name_table(struct block_stmt_list *stmt_lists)
+{
+    scope_name_table_free(stmt_lists->name_table);
+    stmt_lists->name_table = NULL;
+}
+
+static const struct block_stmt_list *
+scope_get_anonymous_field_const_lists(const struct field *field)
+{
+    const struct ast_node_hdl *filter;
+
+    filter = ast_node_get_as_type(field->filter);
+    if (NULL == filter) {
+        return NULL;
+    }
+    if (AST_NODE_TYPE_FILTER_DEF == filter->ndat->type) {
+        return &filter->ndat->u.scope_def.block_stmt_list;
+    }
+    if (ast_node_is_rexpr_filter(filter)) {
+        return &filter_get_const_scope_def(filter)->block_stmt_list;
+    }
+    return NULL;
+}
+
+static struct scope_name_table *
+scope_get_resolved_name_table(const struct block_stmt_list *stmt_lists);
+
+static void
+scope_name_table_resolve_anonymous_members(struct scope_name_table *table)
+{
+    const struct block_stmt_list *anon_lists;
+    struct scope_name_table *anon_table;
+    const struct scope_name_entry *anon_entry;
+    struct scope_name_entry *entry;
+    const struct scope_name_entry *anon_slots_end;
+    int i;
+
+    for (i = 0; i < table->n_anonymous_fields; ++i) {
+        anon_lists = scope_get_anonymous_field_const_lists(
+            table->anonymous_fields[i]);
+        if (NULL == anon_lists) {
+            table->has_dynamic_anonymous_fields = TRUE;
+            continue ;
+        }
+        anon_table = scope_get_resolved_name_table(anon_lists);
+        if (anon_table->has_dynamic_anonymous_fields) {
+            table->has_dynamic_anonymous_fields = TRUE;
+        }
+        anon_slots_end = anon_table->slots + anon_table->n_slots;
+        for (anon_entry = anon_table->slots; anon_entry < anon_slots_end;
+             ++anon_entry) {
+            if (NULL == anon_entry->name
+                || (NULL == anon_entry->first[SCOPE_STATEMENT_INDEX_FIELD]
+                    && NULL == anon_entry->first[
+                        SCOPE_STATEMENT_INDEX_NAMED_EXPR]
+                    && !anon_entry->anonymous_member)) {
+                continue ;
+            }
+            if (2 * (table->n_names + 1) > table->n_slots) {
+                scope_name_table_grow(table);
+            }
+            entry = scope_name_table_get_entry(table, anon_entry->name);
+            entry->anonymous_member = TRUE;
+        }
+    }
+}
+
+/**
+ * @brief get the name table of a block with anonymous members
+ * resolved
+ *
+ * While a table is being resolved, recursive calls for the same block
+ * (from self-referencing types) get the table not yet resolved.
+ */
+static struct scope_name_table *
+scope_get_resolved_name_table(const struct block_stmt_list *stmt_lists)
+{
+    struct block_stmt_list *mutable_lists;
+    struct scope_name_table *table;
+    struct scope_name_table *resolved;
+
+    table = scope_get_name_table(stmt_lists);
+    if (__atomic_load_n(&table->anonymous_members_resolved,
+                        __ATOMIC_ACQUIRE)) {
+        return table;
+    }
+    compile_lock();
+    table = stmt_lists->name_table;
+    if (!table->anonymous_members_resolved && !table->resolving) {
+        table->resolving = TRUE;
+        resolved = scope_name_table_dup(table);
+        scope_name_table_resolve_anonymous_members(resolved);
+        resolved->anonymous_members_resolved = TRUE;
+        resolved->retired = table;
+        table->resolving = FALSE;
+        mutable_lists = (struct block_stmt_list *)stmt_lists;
+        __atomic_store_n(&mutable_lists->name_table, resolved,
+                         __ATOMIC_RELEASE);
+        table = resolved;
+    }
+    compile_unlock();
+    return table;
+}
+
+/**
+ * @brief lookup a name in the name table of a block
+ *
+ * @return the table entry, or NULL if the block declares no statement
+ * with this name (anonymous members are only reported if
+ * scope_get_resolved_name_table() has been called)
+ */
+static const struct scope_name_entry *
+scope_lookup_name(const struct block_stmt_list *stmt_lists,
+                  const char *identifier)
+{
+    struct scope_name_table *table;
+    const struct scope_name_entry *entry;
+
+    table = scope_get_name_table(stmt_lists);
+    entry = scope_name_table_find_slot(table, identifier,
+                                       intern_hash(identifier));
+    return NULL != entry->name ? entry : NULL;
+}
+
+/**
+ * @brief tell if a named expression or a field with name @ref
+ * identifier may be visible from a block, either declared directly
+ * or in one of its anonymous fields
+ *
+ * This is a quick check: TRUE means that a lookup is needed (e.g. if
+ * the statement is conditional, or the block has an anonymous field
+ * of a type only known at browse time).
+ */
+static int
+scope_name_may_be_visible(const struct block_stmt_list *stmt_lists,
+                          const char *identifier)
+{
+    struct scope_name_table *table;
+    const struct scope_name_entry *entry;
+
+    table = scope_get_resolved_name_table(stmt_lists);
+    if (table->has_dynamic_anonymous_fields) {
+        return TRUE;
+    }
+    entry = scope_name_table_find_slot(table, identifier,
+                                       intern_hash(identifier));
+    return NULL != entry->name
+        && (NULL != entry->first[SCOPE_STATEMENT_INDEX_FIELD]
+            || NULL != entry->first[SCOPE_STATEMENT_INDEX_NAMED_EXPR]
+            || entry->anonymous_member);
+}
 
 
 /*
@@ -50,8 +463,21 @@ scope_iter_statements_advance_internal(
     struct statement_iterator *it,
     const struct statement *stmt)
 {
+    const struct named_statement *nstmt;
     const struct statement *next_stmt;
 
+    nstmt = (const struct named_statement *)stmt;
+    if (NULL != it->identifier
+        && NULL != nstmt->name
+        && (nstmt->name == it->identifier
+            || 0 == strcmp(it->identifier, nstmt->name))) {
+        // follow the chain of statements with the same name
+        if ((it->it_flags & STATEMENT_ITERATOR_FLAG_REVERSE)) {
+            return (const struct statement *)nstmt->prev_homonym;
+        } else {
+            return (const struct statement *)nstmt->next_homonym;
+        }
+    }
     next_stmt = stmt;
     do {
         if ((it->it_flags & STATEMENT_ITERATOR_FLAG_REVERSE)) {
@@ -70,61 +496,51 @@ scope_iter_statements_advance_internal(
 static const struct statement *
 scope_iter_statements_find_first_internal(
     struct statement_iterator *it,
-    const struct statement *stmt)
-{
-    if (NULL == stmt
-        || NULL == it->identifier
-        || (NULL != ((struct named_statement *)stmt)->name
-            && 0 == strcmp(it->identifier,
-                           ((struct named_statement *)stmt)->name))) {
-        return stmt;
-    }
-    return scope_iter_statements_advance_internal(it, stmt);
-}
-
-static void
-scope_iter_start_list_internal(struct statement_iterator *it)
+    enum statement_type stmt_type)
 {
-    if (0 != (it->stmt_remaining & STATEMENT_TYPE_NAMED_EXPR)) {
-        it->next_stmt = scope_iter_statements_find_first_internal(
-            it, TAILQ_FIRST(it->stmt_lists->named_expr_list));
-        it->stmt_remaining &= ~STATEMENT_TYPE_NAMED_EXPR;
-        return ;
-    }
-    if (0 != (it->stmt_remaining & STATEMENT_TYPE_FIELD)) {
-        it->next_stmt = scope_iter_statements_find_first_internal(
-            it, TAILQ_FIRST(it->stmt_lists->field_list));
-        it->stmt_remaining &= ~STATEMENT_TYPE_FIELD;
-        return ;
+    const struct statement_list *stmt_list;
+    const struct scope_name_entry *entry;
+    enum scope_statement_index type_index;
+
+    if (NULL != it->identifier) {
+        entry = scope_lookup_name(it->stmt_lists, it->identifier);
+        if (NULL == entry) {
+            return NULL;
+        }
+        type_index = scope_statement_type_index(stmt_type);
+        if (0 != (it->it_flags & STATEMENT_ITERATOR_FLAG_REVERSE)) {
+            return (const struct statement *)entry->last[type_index];
+        } else {
+            return (const struct statement *)entry->first[type_index];
+        }
     }
-    if (0 != (it->stmt_remaining & STATEMENT_TYPE_ATTRIBUTE)) {
-        it->next_stmt = scope_iter_statements_find_first_internal(
-            it, TAILQ_FIRST(it->stmt_lists->attribute_list));
-        it->stmt_remaining &= ~STATEMENT_TYPE_ATTRIBUTE;
-        return ;
+    stmt_list = block_stmt_lists_get_list(stmt_type, it->stmt_lists);
+    if (0 != (it->it_flags & STATEMENT_ITERATOR_FLAG_REVERSE)) {
+        return TAILQ_LAST(stmt_list, statement_list);
+    } else {
+        return TAILQ_FIRST(stmt_list);
     }
 }
 
 static void
-scope_riter_start_list_internal(struct statement_iterator *it)
+scope_iter_start_list_internal(struct statement_iterator *it)
 {
-    if (0 != (it->stmt_remaining & STATEMENT_TYPE_NAMED_EXPR)) {
-        it->next_stmt = scope_iter_statements_find_first_internal(
-            it, TAILQ_LAST(it->stmt_lists->named_expr_list, statement_list));
-        it->stmt_remaining &= ~STATEMENT_TYPE_NAMED_EXPR;
-        return ;
-    }
-    if (0 != (it->stmt_remaining & STATEMENT_TYPE_FIELD)) {
-        it->next_stmt = scope_iter_statements_find_first_internal(
-            it, TAILQ_LAST(it->stmt_lists->field_list, statement_list));
-        it->stmt_remaining &= ~STATEMENT_TYPE_FIELD;
-        return ;
-    }
-    if (0 != (it->stmt_remaining & STATEMENT_TYPE_ATTRIBUTE)) {
-        it->next_stmt = scope_iter_statements_find_first_internal(
-            it, TAILQ_LAST(it->stmt_lists->attribute_list, statement_list));
-        it->stmt_remaining &= ~STATEMENT_TYPE_ATTRIBUTE;
-        return ;
+    static const enum statement_type stmt_types_by_prio[] = {
+        STATEMENT_TYPE_NAMED_EXPR,
+        STATEMENT_TYPE_FIELD,
+        STATEMENT_TYPE_ATTRIBUTE,
+    };
+    enum statement_type stmt_type;
+    int i;
+
+    for (i = 0; i < N_ELEM(stmt_types_by_prio); ++i) {
+        stmt_type = stmt_types_by_prio[i];
+        if (0 != (it->stmt_remaining & stmt_type)) {
+            it->next_stmt = scope_iter_statements_find_first_internal(
+                it, stmt_type);
+            it->stmt_remaining &= ~stmt_type;
+            return ;
+        }
     }
 }
 
@@ -178,6 +594,10 @@ scope_iter_statements_from(
     memset(&it, 0, sizeof (it));
     it.identifier = identifier;
     it.scope = scope;
+    if (NULL != identifier && NULL != scope_def) {
+        // make sure chains of statements with the same name are set
+        (void) scope_get_name_table(&scope_def->block_stmt_list);
+    }
     it.next_stmt = scope_iter_statements_advance_internal(&it, stmt);
     return it;
 }
@@ -197,7 +617,7 @@ scope_riter_statements(
         it.scope = scope;
         it.stmt_lists = &scope_def->block_stmt_list;
         it.stmt_remaining = stmt_mask;
-        scope_riter_start_list_internal(&it);
+        scope_iter_start_list_internal(&it);
     }
     return it;
 }
@@ -213,6 +633,9 @@ scope_riter_statements_from(
     it.identifier = identifier;
     it.scope = scope;
     it.it_flags = STATEMENT_ITERATOR_FLAG_REVERSE;
+    if (NULL != identifier && NULL != scope_def) {
+        (void) scope_get_name_table(&scope_def->block_stmt_list);
+    }
     it.next_stmt = scope_iter_statements_advance_internal(&it, stmt);
     return it;
 }
@@ -251,11 +674,7 @@ scope_iter_statements_next_internal(
         stmt = scope_iter_statements_advance_internal(it, stmt);
     }
     if (0 != it->stmt_remaining) {
-        if (0 != (it->it_flags & STATEMENT_ITERATOR_FLAG_REVERSE)) {
-            scope_riter_start_list_internal(it);
-        } else {
-            scope_iter_start_list_internal(it);
-        }
+        scope_iter_start_list_internal(it);
         return scope_iter_statements_next_internal(it, stmt_typep, stmtp, bst);
     }
     return BITPUNCH_NO_ITEM;
@@ -296,9 +715,6 @@ scope_lookup_statement_in_anonymous_field_recur(
     // requested name, to avoid creating a filtered box when it's
     // certain there will be no such named statement
 
-    // we may optimize this further in the future (e.g. with a hash
-    // table for identifiers for fast lookup)
-
     field = (const struct field *)stmt;
     bt_ret = expr_evaluate_filter_type_internal(
         field->filter, scope, FILTER_KIND_FILTER, &field_filter_type, bst);
@@ -306,9 +722,8 @@ scope_lookup_statement_in_anonymous_field_recur(
         return bt_ret;
     }
     field_scope_def = filter_get_scope_def(field_filter_type);
-    if (!identifier_is_visible_in_block_stmt_lists(
-            STATEMENT_TYPE_NAMED_EXPR | STATEMENT_TYPE_FIELD,
-            identifier, &field_scope_def->block_stmt_list)) {
+    if (!scope_name_may_be_visible(&field_scope_def->block_stmt_list,
+                                   identifier)) {
         return BITPUNCH_NO_ITEM;
     }
 
@@ -363,9 +778,9 @@ scope_lookup_statement_recur(
     struct box **scopep,
     struct browse_state *bst)
 {
-    struct statement *stmt;
-    struct named_statement *nstmt;
+    const struct scope_name_table *table;
     bitpunch_status_t bt_ret;
+    int i;
 
     bt_ret = scope_get_first_statement_internal(
         scope_def, scope, stmt_mask, identifier,
@@ -382,17 +797,18 @@ scope_lookup_statement_recur(
     }
     // do not recurse anonymous fields to find attributes
     if (identifier[0] != '@') {
+        if (!scope_name_may_be_visible(stmt_lists, identifier)) {
+            return BITPUNCH_NO_ITEM;
+        }
         // recurse in anonymous struct/union fields
-        TAILQ_FOREACH(stmt, stmt_lists->field_list, list) {
-            nstmt = (struct named_statement *)stmt;
-            if (NULL == nstmt->name
-                && !(nstmt->stmt.stmt_flags & FIELD_FLAG_HIDDEN)) {
-                bt_ret = scope_lookup_statement_in_anonymous_field_recur(
-                    scope_def, scope, stmt_mask, identifier, nstmt,
-                    stmt_typep, stmtp, scopep, bst);
-                if (BITPUNCH_NO_ITEM != bt_ret) {
-                    return bt_ret;
-                }
+        table = stmt_lists->name_table;
+        for (i = 0; i < table->n_anonymous_fields; ++i) {
+            bt_ret = scope_lookup_statement_in_anonymous_field_recur(
+                scope_def, scope, stmt_mask, identifier,
+                (const struct named_statement *)table->anonymous_fields[i],
+                stmt_typep, stmtp, scopep, bst);
+            if (BITPUNCH_NO_ITEM != bt_ret) {
+                return bt_ret;
             }
         }
     }
@@ -543,9 +959,24 @@ scope_attach_native_attribute(
 
     attribute_list = scope_def->block_stmt_list.attribute_list;
     attr = new_safe(struct named_expr);
-    attr->nstmt.name = strdup_safe(attr_name);
+    attr->nstmt.name = (char *)intern_string(attr_name);
     attr->expr = ast_node_new_rexpr_native(value);
     TAILQ_INSERT_TAIL(attribute_list, (struct statement *)attr, list);
+    scope_invalidate_name_table(&scope_def->block_stmt_list);
+}
+
+const struct field *
+scope_get_first_declared_field(
+    const struct scope_def *scope_def,
+    const char *name)
+{
+    const struct scope_name_entry *entry;
+
+    entry = scope_lookup_name(&scope_def->block_stmt_list, name);
+    if (NULL == entry) {
+        return NULL;
+    }
+    return (const struct field *)entry->first[SCOPE_STATEMENT_INDEX_FIELD];
 }
 
 struct ast_node_hdl *
@@ -553,32 +984,69 @@ scope_get_first_declared_named_expr(
     const struct scope_def *scope_def,
     const char *name)
 {
-    struct named_expr *named_expr;
+    const struct scope_name_entry *entry;
+    const struct named_expr *named_expr;
 
-    STATEMENT_FOREACH(
-        named_expr, named_expr,
-        scope_def->block_stmt_list.named_expr_list, list) {
-        if (0 == strcmp(named_expr->nstmt.name, name)) {
-            return named_expr->expr;
-        }
+    entry = scope_lookup_name(&scope_def->block_stmt_list, name);
+    if (NULL == entry) {
+        return NULL;
     }
-    return NULL;
+    named_expr = (const struct named_expr *)
+        entry->first[SCOPE_STATEMENT_INDEX_NAMED_EXPR];
+    return NULL != named_expr ? named_expr->expr : NULL;
 }
 struct ast_node_hdl *
 scope_get_first_declared_attribute(
     const struct scope_def *scope_def,
     const char *attr_name)
 {
-    struct named_expr *attr_stmt;
+    const struct scope_name_entry *entry;
+    const struct named_expr *attr_stmt;
 
-    STATEMENT_FOREACH(
-        named_expr, attr_stmt,
-        scope_def->block_stmt_list.attribute_list, list) {
-        if (0 == strcmp(attr_stmt->nstmt.name, attr_name)) {
-            return attr_stmt->expr;
-        }
+    entry = scope_lookup_name(&scope_def->block_stmt_list, attr_name);
+    if (NULL == entry) {
+        return NULL;
     }
-    return NULL;
+    attr_stmt = (const struct named_expr *)
+        entry->first[SCOPE_STATEMENT_INDEX_ATTRIBUTE];
+    return NULL != attr_stmt ? attr_stmt->expr : NULL;
+}
+
+/**
+ * @brief get the value of an attribute if it is known at compile time
+ *
+ * The attribute is constant if its first declaration is
+ * unconditional and its expression has been compiled to a native
+ * value.
+ *
+ * @retval BITPUNCH_OK attribute is constant, value set in *valuep
+ * @retval BITPUNCH_NO_ITEM attribute is not declared
+ * @retval BITPUNCH_NOT_IMPLEMENTED attribute value is dynamic
+ */
+bitpunch_status_t
+scope_get_constant_attribute(
+    const struct scope_def *scope_def,
+    const char *attr_name,
+    expr_value_t *valuep)
+{
+    const struct scope_name_entry *entry;
+    const struct named_expr *attr_stmt;
+
+    entry = scope_lookup_name(&scope_def->block_stmt_list, attr_name);
+    if (NULL == entry
+        || NULL == entry->first[SCOPE_STATEMENT_INDEX_ATTRIBUTE]) {
+        return BITPUNCH_NO_ITEM;
+    }
+    attr_stmt = (const struct named_expr *)
+        entry->first[SCOPE_STATEMENT_INDEX_ATTRIBUTE];
+    if (AST_NODE_TYPE_REXPR_NATIVE != attr_stmt->expr->ndat->type
+        || NULL != attr_stmt->nstmt.stmt.cond) {
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    if (NULL != valuep) {
+        *valuep = attr_stmt->expr->ndat->u.rexpr_native.value;
+    }
+    return BITPUNCH_OK;
 }
 
 void
@@ -590,11 +1058,12 @@ scope_add_named_expr(
     struct named_expr *named_expr;
 
     named_expr = new_safe(struct named_expr);
-    named_expr->nstmt.name = strdup_safe(name);
+    named_expr->nstmt.name = (char *)intern_string(name);
     named_expr->expr = expr;
 
     TAILQ_INSERT_TAIL(scope_def->block_stmt_list.named_expr_list,
                       (struct statement *)named_expr, list);
+    scope_invalidate_name_table(&scope_def->block_stmt_list);
 }
 
 int
@@ -614,6 +1083,7 @@ scope_remove_named_exprs_with_name(
             ++n_removed;
         }
     }
+    scope_invalidate_name_table(&scope_def->block_stmt_list);
     return n_removed;
 }
 
@@ -658,6 +1128,7 @@ scope_remove_all_named_exprs_in_scope(
             }
         }
     }
+    scope_invalidate_name_table(&scope_def->block_stmt_list);
 }
 
 
@@ -825,3 +1296,140 @@ tracker_goto_nil__scope(struct tracker *tk)
 {
     tk->cur = track_path_from_field(NULL);
 }
+
+#ifndef DISABLE_UTESTS
+
+#include <check.h>
+
+static struct named_statement *
+test_scope_add_statement(struct block_stmt_list *stmt_lists,
+                         enum statement_type stmt_type, const char *name)
+{
+    struct named_statement *nstmt;
+
+    if (STATEMENT_TYPE_FIELD == stmt_type) {
+        nstmt = (struct named_statement *)new_safe(struct field);
+    } else {
+        nstmt = (struct named_statement *)new_safe(struct named_expr);
+    }
+    nstmt->name = (NULL != name ? (char *)intern_string(name) : NULL);
+    TAILQ_INSERT_TAIL(
+        (struct statement_list *)block_stmt_lists_get_list(
+            stmt_type, stmt_lists),
+        (struct statement *)nstmt, list);
+    return nstmt;
+}
+
+START_TEST(test_scope_name_table)
+{
+    struct ast_node_hdl *scope_node;
+    struct scope_def *scope_def;
+    struct named_statement *stmts[6];
+    struct statement_iterator it;
+    const struct statement *stmt;
+    enum statement_type stmt_type;
+    struct browse_state bst;
+    char name[16];
+    int i;
+
+    ck_assert(intern_string("foo") == intern_string("foo"));
+    ck_assert(intern_string("foo") != intern_string("bar"));
+    // force the intern table to grow
+    for (i = 0; i < 1000; ++i) {
+        sprintf(name, "name%d", i);
+        ck_assert(0 == strcmp(intern_string(name), name));
+    }
+    ck_assert(intern_string("name42") == intern_string("name42"));
+
+    browse_state_init(&bst);
+    scope_node = ast_node_hdl_create_scope(NULL);
+    scope_def = &scope_node->ndat->u.scope_def;
+    stmts[0] = test_scope_add_statement(&scope_def->block_stmt_list,
+                                        STATEMENT_TYPE_FIELD, "a");
+    stmts[1] = test_scope_add_statement(&scope_def->block_stmt_list,
+                                        STATEMENT_TYPE_FIELD, NULL);
+    stmts[2] = test_scope_add_statement(&scope_def->block_stmt_list,
+                                        STATEMENT_TYPE_FIELD, "a");
+    stmts[3] = test_scope_add_statement(&scope_def->block_stmt_list,
+                                        STATEMENT_TYPE_NAMED_EXPR, "a");
+    stmts[4] = test_scope_add_statement(&scope_def->block_stmt_list,
+                                        STATEMENT_TYPE_ATTRIBUTE, "@a");
+    stmts[5] = test_scope_add_statement(&scope_def->block_stmt_list,
+                                        STATEMENT_TYPE_FIELD, "b");
+
+    // named expressions come first, then fields in declaration order
+    it = scope_iter_statements(scope_def, NULL,
+                               STATEMENT_TYPE_NAMED_EXPR |
+                               STATEMENT_TYPE_FIELD, "a");
+    ck_assert(BITPUNCH_OK == scope_iter_statements_next_internal(
+                  &it, &stmt_type, &stmt, &bst));
+    ck_assert(stmt == (struct statement *)stmts[3]);
+    ck_assert(STATEMENT_TYPE_NAMED_EXPR == stmt_type);
+    ck_assert(BITPUNCH_OK == scope_iter_statements_next_internal(
+                  &it, &stmt_type, &stmt, &bst));
+    ck_assert(stmt == (struct statement *)stmts[0]);
+    ck_assert(STATEMENT_TYPE_FIELD == stmt_type);
+    ck_assert(BITPUNCH_OK == scope_iter_statements_next_internal(
+                  &it, NULL, &stmt, &bst));
+    ck_assert(stmt == (struct statement *)stmts[2]);
+    ck_assert(BITPUNCH_NO_ITEM == scope_iter_statements_next_internal(
+                  &it, NULL, &stmt, &bst));
+
+    it = scope_riter_statements(scope_def, NULL,
+                                STATEMENT_TYPE_FIELD, "a");
+    ck_assert(BITPUNCH_OK == scope_iter_statements_next_internal(
+                  &it, NULL, &stmt, &bst));
+    ck_assert(stmt == (struct statement *)stmts[2]);
+    ck_assert(BITPUNCH_OK == scope_iter_statements_next_internal(
+                  &it, NULL, &stmt, &bst));
+    ck_assert(stmt == (struct statement *)stmts[0]);
+    ck_assert(BITPUNCH_NO_ITEM == scope_iter_statements_next_internal(
+                  &it, NULL, &stmt, &bst));
+
+    // identifiers need not be interned
+    strcpy(name, "@a");
+    ck_assert(scope_get_first_declared_attribute(scope_def, name)
+              == ((struct named_expr *)stmts[4])->expr);
+    it = scope_iter_statements(scope_def, NULL,
+                               STATEMENT_TYPE_ATTRIBUTE, name);
+    ck_assert(BITPUNCH_OK == scope_iter_statements_next_internal(
+                  &it, NULL, &stmt, &bst));
+    ck_assert(stmt == (struct statement *)stmts[4]);
+
+    it = scope_iter_statements(scope_def, NULL,
+                               STATEMENT_TYPE_FIELD, "c");
+    ck_assert(BITPUNCH_NO_ITEM == scope_iter_statements_next_internal(
+                  &it, NULL, &stmt, &bst));
+
+    // table is rebuilt when statements are added
+    ck_assert(NULL == scope_get_first_declared_named_expr(scope_def, "b"));
+    scope_add_named_expr(scope_def, "b", NULL);
+    ck_assert(NULL != scope_lookup_name(&scope_def->block_stmt_list, "b"));
+    ck_assert(1 == scope_remove_named_exprs_with_name(scope_def, "b"));
+    ck_assert(NULL == scope_lookup_name(
+                  &scope_def->block_stmt_list, "b")
+              ->first[SCOPE_STATEMENT_INDEX_NAMED_EXPR]);
+
+    // unconditional iteration over all fields still walks the lists
+    it = scope_iter_statements(scope_def, NULL, STATEMENT_TYPE_FIELD, NULL);
+    for (i = 0; i < 4; ++i) {
+        ck_assert(BITPUNCH_OK == scope_iter_statements_next_internal(
+                      &it, NULL, &stmt, &bst));
+    }
+    ck_assert(stmt == (struct statement *)stmts[5]);
+    ck_assert(BITPUNCH_NO_ITEM == scope_iter_statements_next_internal(
+                  &it, NULL, &stmt, &bst));
+    browse_state_cleanup(&bst);
+}
+END_TEST
+
+void check_scope_add_tcases(Suite *s)
+{
+    TCase *tc_scope;
+
+    tc_scope = tcase_create("core:scope");
+    tcase_add_test(tc_scope, test_scope_name_table);
+    suite_add_tcase(s, tc_scope);
+}
+
+#endif // #ifndef DISABLE_UTESTS
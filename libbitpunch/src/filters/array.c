@@ -41,6 +41,11 @@
 #include "filters/byte_array.h"
 #include "filters/array_slice.h"
 #include "filters/byte_slice.h"
+#include "filters/integer.h"
+#include "filters/varint.h"
+
+#define ARRAY_BULK_CHUNK_SIZE (256 * 1024)
+#define ARRAY_BULK_SKIP_N_ITEMS 1024
 
 static struct filter_instance *
 array_filter_instance_build(struct ast_node_hdl *filter)
@@ -491,6 +496,376 @@ box_get_n_items__array_slack_const_item_size(struct box *box,
     return BITPUNCH_OK;
 }
 
+/**
+ * @brief locate the first item of a bulk read, and get the filter
+ * reading its value
+ *
+ * @param[in,out] n_itemsp number of items to read, clamped to the
+ * number of items of @ref box from @ref index, set to 0 when there is
+ * nothing to read
+ *
+ * @retval BITPUNCH_NOT_IMPLEMENTED items cannot be decoded directly
+ * from the array data (no error is raised)
+ */
+static bitpunch_status_t
+box_read_values_bulk_locate(struct box *box,
+                            int64_t index, int64_t *n_itemsp,
+                            int64_t *item_offsetp, int64_t *item_sizep,
+                            struct ast_node_hdl **filter_typep,
+                            struct browse_state *bst)
+{
+    bitpunch_status_t bt_ret;
+    int64_t box_n_items;
+    struct tracker *tk;
+    expr_dpath_t filtered_dpath;
+
+    bt_ret = box_get_n_items_internal(box, &box_n_items, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    if (index >= box_n_items || 0 == *n_itemsp) {
+        *n_itemsp = 0;
+        return BITPUNCH_OK;
+    }
+    *n_itemsp = MIN(*n_itemsp, box_n_items - index);
+
+    bt_ret = track_box_contents_internal(box, &tk, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    if (0 != (tk->flags & TRACKER_REVERSED)) {
+        tracker_delete(tk);
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    bt_ret = tracker_goto_nth_item_internal(tk, index, bst);
+    if (BITPUNCH_OK == bt_ret) {
+        bt_ret = tracker_get_filtered_dpath_internal(tk, &filtered_dpath, bst);
+    }
+    tracker_delete(tk);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    if (EXPR_DPATH_TYPE_ITEM != filtered_dpath.type
+        || filtered_dpath.tk->box != box) {
+        expr_dpath_destroy(filtered_dpath);
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    bt_ret = tracker_get_item_location_internal(
+        filtered_dpath.tk, item_offsetp, item_sizep, bst);
+    if (BITPUNCH_OK == bt_ret) {
+        bt_ret = expr_evaluate_filter_type_internal(
+            filtered_dpath.tk->dpath.filter, box, FILTER_KIND_FILTER,
+            filter_typep, bst);
+    }
+    expr_dpath_destroy(filtered_dpath);
+    if (BITPUNCH_OK == bt_ret) {
+        bt_ret = box_apply_filter_internal(box, bst);
+    }
+    if (BITPUNCH_OK == bt_ret) {
+        bt_ret = box_compute_used_size(box, bst);
+    }
+    return bt_ret;
+}
+
+/**
+ * @brief decode consecutive integer items in one pass
+ *
+ * Items have a constant size so they are packed contiguously. When
+ * their value filter can be applied directly on the array data (no
+ * intermediate data filter) and is an integer filter with constant
+ * attributes, decode them all at once, otherwise let the caller read
+ * them one by one by returning BITPUNCH_NOT_IMPLEMENTED.
+ */
+static bitpunch_status_t
+box_read_values_bulk__array_const_item_size(struct box *box,
+                                            int64_t index, int64_t n_items,
+                                            int64_t *values,
+                                            int64_t *n_readp,
+                                            struct browse_state *bst)
+{
+    bitpunch_status_t bt_ret;
+    struct ast_node_hdl *filter_type;
+    int64_t item_offset;
+    int64_t item_size;
+    int64_t chunk_n_items;
+    int64_t n_read;
+    struct bitpunch_data_pin pin;
+    const char *item_data;
+
+    bt_ret = box_read_values_bulk_locate(box, index, &n_items,
+                                         &item_offset, &item_size,
+                                         &filter_type, bst);
+    if (BITPUNCH_OK != bt_ret || 0 == n_items) {
+        *n_readp = 0;
+        return bt_ret;
+    }
+    if (item_offset + n_items * item_size > box->end_offset_used
+        || item_offset + n_items * item_size
+        > (int64_t)box->ds_in->ds_data_length) {
+        // let the generic path report the out of bounds error
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    // decode by chunks to bound the amount of data pinned at once
+    chunk_n_items = MAX(ARRAY_BULK_CHUNK_SIZE / item_size, 1);
+    for (n_read = 0; n_read < n_items; n_read += chunk_n_items) {
+        chunk_n_items = MIN(chunk_n_items, n_items - n_read);
+        bt_ret = box_pin_data_internal(
+            box, box->ds_in, item_offset + n_read * item_size,
+            chunk_n_items * item_size, &pin, &item_data, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        bt_ret = integer_read_bulk(filter_type, item_data, item_size,
+                                   chunk_n_items, values + n_read);
+        box_unpin_data(box, box->ds_in, &pin, FALSE);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+    }
+    *n_readp = n_items;
+    return BITPUNCH_OK;
+}
+
+/**
+ * @brief decode the varint items of a slack array as a run
+ *
+ * The item count and end offset of a slack array are only known once
+ * all its items are located. Rather than walking them with a
+ * tracker, decode the slack space as a run of varints, which gives
+ * them, and keep the values of items [@ref index, @ref index +
+ * @ref n_items[ on the way. Decoding stops after those items when the
+ * item count is already known.
+ *
+ * @param[out] n_readp if not NULL, number of values read
+ *
+ * @retval BITPUNCH_NOT_IMPLEMENTED the array is not a slack array of
+ * plain varint items, or its slack space does not end with a complete
+ * varint: the caller shall use the generic path (no error is raised)
+ */
+static bitpunch_status_t
+box_decode_run__array_slack_varint(struct box *box,
+                                   int64_t index, int64_t n_items,
+                                   int64_t *values, int64_t *n_readp,
+                                   struct browse_state *bst)
+{
+    struct filter_instance_array *array;
+    struct array_state_generic *array_state;
+    bitpunch_status_t bt_ret;
+    struct ast_node_hdl *item_type;
+    struct ast_node_hdl *filter_type;
+    int64_t skipped[ARRAY_BULK_SKIP_N_ITEMS];
+    struct bitpunch_data_pin pin;
+    const char *chunk_data;
+    int64_t offset;
+    int64_t end_offset;
+    int64_t chunk_size;
+    size_t chunk_n_bytes;
+    size_t n_bytes;
+    int64_t item_index;
+    int64_t n_wanted;
+    int64_t *dest;
+    int64_t n_read;
+    int count_known;
+
+    array = (struct filter_instance_array *)
+        box->filter->ndat->u.rexpr_filter.f_instance;
+    array_state = box_array_state(box);
+    if (NULL != array->item_count || 0 != (box->flags & BOX_RALIGN)) {
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    // items must be read directly by their filter
+    bt_ret = expr_evaluate_filter_type_internal(
+        array->item_type, box, FILTER_KIND_ITEM, &item_type, bst);
+    if (BITPUNCH_OK == bt_ret) {
+        bt_ret = expr_evaluate_filter_type_internal(
+            array->item_type, box, FILTER_KIND_FILTER, &filter_type, bst);
+    }
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    if (item_type != filter_type) {
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    bt_ret = box_compute_max_span_size(box, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    count_known = (-1 != array_state->n_items);
+    if (count_known) {
+        n_items = MAX(MIN(n_items, array_state->n_items - index), 0);
+        if (0 == n_items) {
+            if (NULL != n_readp) {
+                *n_readp = 0;
+            }
+            return BITPUNCH_OK;
+        }
+    }
+    offset = box->start_offset_max_span;
+    end_offset = MIN(box->end_offset_max_span,
+                     (int64_t)box->ds_in->ds_data_length);
+    item_index = 0;
+    bt_ret = BITPUNCH_OK;
+    while (offset < end_offset
+           && !(count_known && item_index >= index + n_items)) {
+        // decode by chunks to bound the amount of data pinned at once
+        chunk_size = MIN(end_offset - offset, ARRAY_BULK_CHUNK_SIZE);
+        bt_ret = box_pin_data_internal(box, box->ds_in, offset,
+                                       chunk_size, &pin, &chunk_data, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        chunk_n_bytes = 0;
+        while (chunk_n_bytes < (size_t)chunk_size) {
+            // values outside the requested range are only counted
+            if (item_index < index) {
+                n_wanted = MIN(index - item_index, ARRAY_BULK_SKIP_N_ITEMS);
+                dest = skipped;
+            } else if (item_index < index + n_items) {
+                n_wanted = index + n_items - item_index;
+                dest = values + (item_index - index);
+            } else if (!count_known) {
+                n_wanted = ARRAY_BULK_SKIP_N_ITEMS;
+                dest = skipped;
+            } else {
+                break ;
+            }
+            bt_ret = varint_read_bulk(
+                filter_type, chunk_data + chunk_n_bytes,
+                chunk_size - chunk_n_bytes, n_wanted, dest,
+                &n_read, &n_bytes);
+            if (BITPUNCH_OK != bt_ret || 0 == n_read) {
+                break ;
+            }
+            item_index += n_read;
+            chunk_n_bytes += n_bytes;
+        }
+        box_unpin_data(box, box->ds_in, &pin, FALSE);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        if (0 == chunk_n_bytes) {
+            // invalid or truncated item, let the generic path report
+            // the error
+            return BITPUNCH_NOT_IMPLEMENTED;
+        }
+        offset += chunk_n_bytes;
+    }
+    if (!count_known) {
+        if (offset != box->end_offset_max_span) {
+            return BITPUNCH_NOT_IMPLEMENTED;
+        }
+        array_state->n_items = item_index;
+        bt_ret = box_set_end_offset(box, offset, BOX_END_OFFSET_SPAN, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+    }
+    if (NULL != n_readp) {
+        *n_readp = MAX(MIN(n_items, item_index - index), 0);
+    }
+    return BITPUNCH_OK;
+}
+
+static bitpunch_status_t
+box_get_n_items__array_slack_varint(struct box *box, int64_t *item_countp,
+                                    struct browse_state *bst)
+{
+    struct array_state_generic *array_state;
+    bitpunch_status_t bt_ret;
+
+    DBG_BOX_DUMP(box);
+    array_state = box_array_state(box);
+    if (-1 == array_state->n_items) {
+        bt_ret = box_decode_run__array_slack_varint(box, 0, 0, NULL, NULL,
+                                                    bst);
+        if (BITPUNCH_NOT_IMPLEMENTED == bt_ret) {
+            bt_ret = box_compute_n_items_by_iteration(box, bst);
+        }
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+    }
+    if (NULL != item_countp) {
+        *item_countp = array_state->n_items;
+    }
+    return BITPUNCH_OK;
+}
+
+/**
+ * @brief decode consecutive varint items in one pass
+ *
+ * Items of variable size are packed contiguously, when their value
+ * filter applies directly on the array data and is a varint filter
+ * with a constant endianness, decode them as a run of varints,
+ * otherwise let the caller read them one by one by returning
+ * BITPUNCH_NOT_IMPLEMENTED.
+ */
+static bitpunch_status_t
+box_read_values_bulk__array_var_item_size(struct box *box,
+                                          int64_t index, int64_t n_items,
+                                          int64_t *values,
+                                          int64_t *n_readp,
+                                          struct browse_state *bst)
+{
+    bitpunch_status_t bt_ret;
+    struct ast_node_hdl *filter_type;
+    int64_t item_offset;
+    int64_t item_size;
+    int64_t end_offset;
+    int64_t chunk_size;
+    int64_t chunk_n_read;
+    size_t chunk_n_bytes;
+    int64_t n_read;
+    struct bitpunch_data_pin pin;
+    const char *item_data;
+
+    bt_ret = box_decode_run__array_slack_varint(
+        box, index, n_items, values, n_readp, bst);
+    if (BITPUNCH_NOT_IMPLEMENTED != bt_ret) {
+        return bt_ret;
+    }
+    bt_ret = box_read_values_bulk_locate(box, index, &n_items,
+                                         &item_offset, &item_size,
+                                         &filter_type, bst);
+    if (BITPUNCH_OK != bt_ret || 0 == n_items) {
+        *n_readp = 0;
+        return bt_ret;
+    }
+    end_offset = MIN(box->end_offset_used,
+                     (int64_t)box->ds_in->ds_data_length);
+    n_read = 0;
+    while (n_read < n_items) {
+        // decode by chunks to bound the amount of data pinned at
+        // once, a chunk ends before the first varint crossing its end
+        chunk_size = MIN(end_offset - item_offset, ARRAY_BULK_CHUNK_SIZE);
+        if (chunk_size <= 0) {
+            // let the generic path report the out of bounds error
+            return BITPUNCH_NOT_IMPLEMENTED;
+        }
+        bt_ret = box_pin_data_internal(box, box->ds_in, item_offset,
+                                       chunk_size, &pin, &item_data, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        bt_ret = varint_read_bulk(filter_type, item_data, chunk_size,
+                                  n_items - n_read, values + n_read,
+                                  &chunk_n_read, &chunk_n_bytes);
+        box_unpin_data(box, box->ds_in, &pin, FALSE);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        if (0 == chunk_n_read) {
+            // invalid or truncated item, let the generic path report
+            // the error
+            return BITPUNCH_NOT_IMPLEMENTED;
+        }
+        n_read += chunk_n_read;
+        item_offset += chunk_n_bytes;
+    }
+    *n_readp = n_items;
+    return BITPUNCH_OK;
+}
+
 
 bitpunch_status_t
 tracker_get_item_key__array_generic(struct tracker *tk,
@@ -527,6 +902,10 @@ tracker_lookup_current_twin_index(struct tracker *tk,
     struct tracker *xtk;
 
     DBG_TRACKER_DUMP(tk);
+    bt_ret = tracker_index_cache_load_sidecar(tk, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
     bt_ret = tracker_index_cache_lookup_current_twin_index(tk, item_key,
                                                            in_slice_path,
                                                            nth_twinp, bst);
@@ -677,6 +1056,14 @@ tracker_goto_first_item__array_non_slack(
     return BITPUNCH_OK;
 }
 
+/**
+ * @brief end the slack array at the current item if not even a
+ * minimum-size item fits in the slack space left
+ *
+ * No error object is built to detect the end of the array. An item
+ * starting in the slack space but overflowing it is reported as out
+ * of bounds when its size is computed.
+ */
 static bitpunch_status_t
 tracker_check_if_last_item__array_slack(
     struct tracker *tk, struct browse_state *bst)
@@ -870,6 +1257,16 @@ tracker_goto_nth_item__array_var_item_size(
     bitpunch_status_t bt_ret;
 
     DBG_TRACKER_DUMP(tk);
+    bt_ret = tracker_index_cache_load_sidecar(tk, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    if (-1 == box_array_state(tk->box)->n_items) {
+        bt_ret = tracker_index_cache_prescan(tk, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+    }
     xtk = tracker_dup(tk);
     cache = box_array_cache(xtk->box);
     if (index < cache->last_cached_index) {
@@ -1058,6 +1455,10 @@ tracker_goto_next_item_with_key__indexed_array_internal(
     const struct ast_node_hdl *node;
  
     DBG_TRACKER_DUMP(tk);
+    bt_ret = tracker_index_cache_load_sidecar(tk, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
     cache = box_array_cache(tk->box);
     assert(index_cache_exists(cache));
 
@@ -1123,6 +1524,10 @@ tracker_goto_nth_item_with_key__indexed_array_internal(
     DBG_TRACKER_DUMP(tk);
     //TODO use from_index and end_index
 
+    bt_ret = tracker_index_cache_load_sidecar(tk, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
     bt_ret = tracker_index_cache_goto_twin(
         tk, item_key, nth_twin,
         track_path_from_array_slice(from_index, end_index),
@@ -1297,9 +1702,23 @@ compile_node_backends__box__array(struct ast_node_hdl *item)
     } else if (0 == (item_type->ndat->u.item.flags
                      & ITEMFLAG_IS_SPAN_SIZE_VARIABLE)) {
         b_box->get_n_items = box_get_n_items__array_slack_const_item_size;
+    } else if (AST_NODE_TYPE_REXPR_FILTER == item_type->ndat->type) {
+        // item sizes given by the item filter itself (e.g. varint)
+        b_box->get_n_items = box_get_n_items__array_slack_varint;
     } else {
         b_box->get_n_items = box_get_n_items__by_iteration;
     }
+    if (0 == (item_type->flags & ASTFLAG_CONTAINS_LAST_ATTR)) {
+        if (0 == (item_type->ndat->u.item.flags
+                  & ITEMFLAG_IS_SPAN_SIZE_VARIABLE)) {
+            b_box->read_values_bulk =
+                box_read_values_bulk__array_const_item_size;
+        } else if (AST_NODE_TYPE_REXPR_FILTER == item_type->ndat->type) {
+            // item sizes given by the item filter itself (e.g. varint)
+            b_box->read_values_bulk =
+                box_read_values_bulk__array_var_item_size;
+        }
+    }
 }
 
 static void
@@ -29,14 +29,41 @@
  * DAMAGE.
  */
 
+#define _GNU_SOURCE
 #include <assert.h>
+#include <stdio.h>
 
 #include "utils/bloom.h"
+#include "utils/sidecar.h"
 #include "core/expr_internal.h"
+#include "core/browse_internal.h"
 #include "core/debug.h"
+#include "api/bitpunch_api.h"
 #include "filters/array_index_cache.h"
 #include "filters/array.h"
 
+#define ARRAY_INDEX_MAGIC   "BPARRIDX"
+#define ARRAY_INDEX_VERSION 1
+
+/** do not persist caches of arrays with fewer marks than this */
+#define ARRAY_INDEX_SIDECAR_MIN_N_MARKS 16
+
+enum array_index_file_flag {
+    ARRAY_INDEX_FILE_HAS_MARK_OFFSETS = (1u<<0),
+    ARRAY_INDEX_FILE_HAS_KEY_CACHE    = (1u<<1),
+};
+
+struct array_index_file_header {
+    char magic[8];
+    uint32_t version;
+    int32_t log2_n_keys_per_mark;
+    uint32_t flags;
+    uint32_t reserved;
+    int64_t last_cached_index;
+    /** relative to the offset of the first item */
+    int64_t last_cached_item_offset;
+};
+
 static bitpunch_status_t
 mark_offsets_repo_should_exist(struct ast_node_hdl *filter, struct box *scope,
                                int *should_existp,
@@ -166,9 +193,245 @@ array_index_cache_init(struct array_cache *cache, struct box *scope,
     return BITPUNCH_OK;
 }
 
+static uint32_t
+array_index_file_flags(struct array_cache *cache)
+{
+    return ((mark_offsets_repo_exists(cache) ?
+             ARRAY_INDEX_FILE_HAS_MARK_OFFSETS : 0u) |
+            (index_cache_exists(cache) ?
+             ARRAY_INDEX_FILE_HAS_KEY_CACHE : 0u));
+}
+
+static void
+array_index_cache_save_sidecar(struct array_cache *cache)
+{
+    struct sidecar_writer writer;
+    struct array_index_file_header header;
+    struct index_cache_mark_offset *mark_offset;
+    int64_t n_marks;
+    int64_t rel_offset;
+
+    n_marks = array_get_index_mark(cache, cache->last_cached_index) + 1;
+    if (n_marks < ARRAY_INDEX_SIDECAR_MIN_N_MARKS
+        || -1 == sidecar_create("array", cache->sidecar_key, &writer)) {
+        return ;
+    }
+    memset(&header, 0, sizeof (header));
+    memcpy(header.magic, ARRAY_INDEX_MAGIC, sizeof (header.magic));
+    header.version = ARRAY_INDEX_VERSION;
+    header.log2_n_keys_per_mark = cache->cache_log2_n_keys_per_mark;
+    header.flags = array_index_file_flags(cache);
+    header.last_cached_index = cache->last_cached_index;
+    header.last_cached_item_offset =
+        cache->last_cached_item_offset - cache->sidecar_base_offset;
+    if (1 != fwrite(&header, sizeof (header), 1, writer.file)) {
+        sidecar_abort(&writer);
+        return ;
+    }
+    if (mark_offsets_repo_exists(cache)) {
+        assert(ARRAY_SIZE(&cache->mark_offsets) == n_marks);
+        ARRAY_FOREACH(&cache->mark_offsets, mark_offset) {
+            rel_offset = mark_offset->item_offset
+                - cache->sidecar_base_offset;
+            if (1 != fwrite(&rel_offset, sizeof (rel_offset), 1,
+                            writer.file)) {
+                sidecar_abort(&writer);
+                return ;
+            }
+        }
+    }
+    if (index_cache_exists(cache)) {
+        assert(bloom_book_get_n_marks(cache->cache_by_key) == n_marks);
+        if (-1 == bloom_book_save(cache->cache_by_key, writer.file)) {
+            sidecar_abort(&writer);
+            return ;
+        }
+    }
+    (void) sidecar_commit(&writer);
+}
+
+/**
+ * @brief read a sidecar index into an empty cache
+ *
+ * @retval 0 the cache now holds the sidecar contents
+ * @retval -1 stale or corrupted sidecar, the cache is left empty
+ */
+static int
+array_index_cache_read_sidecar(struct array_cache *cache,
+                               struct ast_node_hdl *item_type,
+                               int64_t data_length, FILE *file)
+{
+    struct array_index_file_header header;
+    struct index_cache_mark_offset mark_offset;
+    struct bloom_book *book;
+    int64_t *rel_offsets;
+    int64_t n_marks;
+    int64_t mark;
+
+    if (1 != fread(&header, sizeof (header), 1, file)
+        || 0 != memcmp(header.magic, ARRAY_INDEX_MAGIC,
+                       sizeof (header.magic))
+        || ARRAY_INDEX_VERSION != header.version
+        || cache->cache_log2_n_keys_per_mark != header.log2_n_keys_per_mark
+        || array_index_file_flags(cache) != header.flags
+        || header.last_cached_index < 0
+        || header.last_cached_item_offset < 0
+        || (cache->sidecar_base_offset + header.last_cached_item_offset
+            > data_length)) {
+        return -1;
+    }
+    n_marks = array_get_index_mark(cache, header.last_cached_index) + 1;
+    rel_offsets = NULL;
+    if (mark_offsets_repo_exists(cache)) {
+        rel_offsets = new_n_safe(int64_t, n_marks);
+        if (n_marks != (int64_t)fread(rel_offsets, sizeof (int64_t),
+                                      n_marks, file)) {
+            free(rel_offsets);
+            return -1;
+        }
+        for (mark = 0; mark < n_marks; ++mark) {
+            if (rel_offsets[mark] < (0 == mark ? 0 : rel_offsets[mark - 1])
+                || rel_offsets[mark] > header.last_cached_item_offset) {
+                free(rel_offsets);
+                return -1;
+            }
+        }
+    }
+    book = NULL;
+    if (index_cache_exists(cache)) {
+        book = bloom_book_load(file);
+        if (NULL == book || bloom_book_get_n_marks(book) != n_marks) {
+            if (NULL != book) {
+                bloom_book_destroy(book);
+            }
+            free(rel_offsets);
+            return -1;
+        }
+        destroy_index_cache_by_key(cache);
+        cache->cache_by_key = book;
+    }
+    if (NULL != rel_offsets) {
+        for (mark = 0; mark < n_marks; ++mark) {
+            mark_offset.item_offset =
+                cache->sidecar_base_offset + rel_offsets[mark];
+            ARRAY_PUSH(&cache->mark_offsets, mark_offset);
+        }
+        free(rel_offsets);
+    }
+    cache->last_cached_index = header.last_cached_index;
+    cache->last_cached_item = item_type;
+    cache->last_cached_item_offset =
+        cache->sidecar_base_offset + header.last_cached_item_offset;
+    return 0;
+}
+
+/**
+ * @brief hash of the schema source text and of the array location
+ * in it, so that sidecars get rebuilt when the schema changes
+ */
+static uint64_t
+array_schema_hash(const struct ast_node_hdl *filter)
+{
+    const struct parser_ctx *parser_ctx;
+    uint64_t hash;
+    size_t i;
+
+    parser_ctx = filter->loc.parser_ctx;
+    hash = 0xcbf29ce484222325ULL; // FNV-1a
+    for (i = 0; i < parser_ctx->parser_data_length; ++i) {
+        hash ^= (uint8_t)parser_ctx->parser_data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= (uint64_t)filter->loc.start_offset;
+    hash *= 0x100000001b3ULL;
+    return hash;
+}
+
+/**
+ * @brief load the index cache of the tracked array from its sidecar
+ * index file, on first access
+ *
+ * When sidecars are enabled (see bitpunch_set_index_dir()), caches
+ * of arrays from data sources with a stable identity are keyed by
+ * that identity, the schema and the array offset. A saved cache is
+ * loaded before anything else gets cached, so that browsing starts
+ * from the saved marks, and the cache is saved again when destroyed
+ * if it grew in the meantime.
+ */
+bitpunch_status_t
+tracker_index_cache_load_sidecar(struct tracker *tk,
+                                 struct browse_state *bst)
+{
+    struct array_cache *cache;
+    struct filter_instance_array *array;
+    struct ast_node_hdl *item_type;
+    struct tracker *xtk;
+    char *ds_key;
+    FILE *file;
+    bitpunch_status_t bt_ret;
+
+    cache = box_array_cache(tk->box);
+    if (ARRAY_CACHE_SIDECAR_UNKNOWN != cache->sidecar_state) {
+        return BITPUNCH_OK;
+    }
+    cache->sidecar_state = ARRAY_CACHE_SIDECAR_DISABLED;
+    if (!sidecar_enabled()
+        || 0 != (tk->box->flags & BOX_RALIGN)
+        || (!mark_offsets_repo_exists(cache) && !index_cache_exists(cache))
+        || NULL == tk->box->filter->loc.parser_ctx) {
+        return BITPUNCH_OK;
+    }
+    xtk = tracker_dup(tk);
+    xtk->flags &= ~TRACKER_REVERSED;
+    bt_ret = tracker_set_item_offset_at_box(xtk, xtk->box, bst);
+    cache->sidecar_base_offset = xtk->item_offset;
+    tracker_delete(xtk);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    ds_key = bitpunch_data_source_get_index_key(tk->box->ds_out);
+    if (NULL == ds_key) {
+        return BITPUNCH_OK;
+    }
+    if (-1 == asprintf(&cache->sidecar_key, "%s-%016"PRIx64"-%"PRIx64,
+                       ds_key, array_schema_hash(tk->box->filter),
+                       cache->sidecar_base_offset)) {
+        cache->sidecar_key = NULL;
+        free(ds_key);
+        return BITPUNCH_OK;
+    }
+    free(ds_key);
+    cache->sidecar_state = ARRAY_CACHE_SIDECAR_ENABLED;
+    if (-1 == cache->last_cached_index) {
+        array = (struct filter_instance_array *)
+            tk->box->filter->ndat->u.rexpr_filter.f_instance;
+        bt_ret = expr_evaluate_filter_type_internal(
+            array->item_type, tk->box, FILTER_KIND_ITEM, &item_type, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        file = sidecar_open("array", cache->sidecar_key);
+        if (NULL != file) {
+            // stale or corrupted sidecars get rewritten when the
+            // cache is destroyed
+            (void) array_index_cache_read_sidecar(
+                cache, item_type, (int64_t)tk->box->ds_out->ds_data_length,
+                file);
+            (void) fclose(file);
+        }
+    }
+    cache->sidecar_saved_index = cache->last_cached_index;
+    return BITPUNCH_OK;
+}
+
 void
 array_index_cache_destroy(struct array_cache *cache)
 {
+    if (ARRAY_CACHE_SIDECAR_ENABLED == cache->sidecar_state
+        && cache->last_cached_index > cache->sidecar_saved_index) {
+        array_index_cache_save_sidecar(cache);
+    }
+    free(cache->sidecar_key);
     if (index_cache_exists(cache)) {
         destroy_index_cache_by_key(cache);
     }
@@ -188,28 +451,50 @@ tracker_index_cache_add_item(struct tracker *tk, expr_value_t item_key,
     cache = box_array_cache(tk->box);
     assert(tk->cur.u.array.index == cache->last_cached_index + 1);
 
-    if (index_cache_exists(cache)) {
-        if (array_index_is_marked(cache, tk->cur.u.array.index)) {
-            mark = (int64_t)bloom_book_add_mark(cache->cache_by_key);
-            if (mark_offsets_repo_exists(cache)) {
-                array_add_mark_offset(cache, mark, tk->item_offset);
-            }
-        }
-        expr_value_to_hashable(item_key, &key_buf, &key_len);
-        bloom_book_insert_word(cache->cache_by_key, key_buf, key_len);
-    } else {
-        if (mark_offsets_repo_exists(cache)
-            && array_index_is_marked(cache, tk->cur.u.array.index)) {
-            mark = array_get_index_mark(cache, tk->cur.u.array.index);
+    if (!index_cache_exists(cache)) {
+        array_index_cache_add_item_offset(cache, tk->dpath.item,
+                                          tk->cur.u.array.index,
+                                          tk->item_offset);
+        return BITPUNCH_OK;
+    }
+    if (array_index_is_marked(cache, tk->cur.u.array.index)) {
+        mark = (int64_t)bloom_book_add_mark(cache->cache_by_key);
+        if (mark_offsets_repo_exists(cache)) {
             array_add_mark_offset(cache, mark, tk->item_offset);
         }
     }
+    expr_value_to_hashable(item_key, &key_buf, &key_len);
+    bloom_book_insert_word(cache->cache_by_key, key_buf, key_len);
     cache->last_cached_index = tk->cur.u.array.index;
     cache->last_cached_item = tk->dpath.item;
     cache->last_cached_item_offset = tk->item_offset;
     return BITPUNCH_OK;
 }
 
+/**
+ * @brief add the next item to a cache of item offsets without key
+ * index
+ */
+void
+array_index_cache_add_item_offset(struct array_cache *cache,
+                                  struct ast_node_hdl *item,
+                                  int64_t index, int64_t item_offset)
+{
+    int64_t mark;
+
+    assert(!index_cache_exists(cache));
+    assert(index == cache->last_cached_index + 1);
+
+    if (mark_offsets_repo_exists(cache)
+        && array_index_is_marked(cache, index)) {
+        mark = array_get_index_mark(cache, index);
+        array_add_mark_offset(cache, mark, item_offset);
+    }
+    cache->last_cached_index = index;
+    cache->last_cached_item = item;
+    cache->last_cached_item_offset = item_offset;
+}
+
 
 /**
  * @brief Lookup items twins which key match @ref item_key, return an
@@ -0,0 +1,537 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Parallel pre-scan of slack arrays of variable-size items
+ *
+ * Finding the offset of the Nth item of such arrays requires parsing
+ * all previous items, which can take long on very large arrays. When
+ * the item type declares a "@sync" attribute (a constant byte pattern
+ * each item starts with, like "OggS" for Ogg pages), the array
+ * contents are split in chunks parsed concurrently by worker
+ * threads, each starting at the first occurrence of the sync pattern
+ * in its chunk.
+ *
+ * Because the sync pattern may also occur inside item payloads, a
+ * worker may start in the middle of an item: results are stitched
+ * back in order, and only kept once the chain of items parsed from
+ * the array start reaches an offset where a worker started or went
+ * through, which guarantees the resulting index cache is identical
+ * to what a sequential scan would have built. Divergent chains are
+ * re-parsed sequentially until they meet again.
+ *
+ * Boxes are confined to the thread browsing them, so each worker
+ * browses its own copy of the array box, its ancestors and scopes
+ * (see box_dup_chain()) over the shared data source, and reports
+ * item offsets in memory. The calling thread waits for all workers before
+ * stitching their results in its own array box cache.
+ */
+
+#define _GNU_SOURCE
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "core/expr_internal.h"
+#include "core/browse_internal.h"
+#include "core/filter.h"
+#include "core/debug.h"
+#include "api/bitpunch_api.h"
+#include "filters/array_index_cache.h"
+#include "filters/array.h"
+
+#define ARRAY_PRESCAN_MAX_WORKERS            64
+#define ARRAY_PRESCAN_DEFAULT_MIN_ARRAY_SIZE (64 * 1024 * 1024)
+#define ARRAY_PRESCAN_SEARCH_WINDOW          (1024 * 1024)
+
+static int prescan_n_workers;
+static int64_t prescan_min_array_size = ARRAY_PRESCAN_DEFAULT_MIN_ARRAY_SIZE;
+
+enum array_prescan_worker_status {
+    /** worker did not report, e.g. its boxes could not be copied */
+    ARRAY_PRESCAN_WORKER_LOST = 0,
+    /** no sync point in the worker's chunk */
+    ARRAY_PRESCAN_WORKER_NO_SYNC,
+    /** reached the next worker's start offset */
+    ARRAY_PRESCAN_WORKER_AT_LIMIT,
+    /** reached the end of the array */
+    ARRAY_PRESCAN_WORKER_AT_END,
+    /** parsing error */
+    ARRAY_PRESCAN_WORKER_FAILED,
+};
+
+struct array_prescan;
+
+/**
+ * @brief worker report, read once the worker thread is joined
+ */
+struct array_prescan_report {
+    struct array_prescan *prescan;
+    pthread_t thread;
+    enum array_prescan_worker_status status;
+    /** offset of the first item parsed */
+    int64_t start_offset;
+    /** item offsets parsed, sorted */
+    int64_t *offsets;
+    int64_t n_items;
+    int64_t max_items;
+    /** offset of the first item at or after the limit */
+    int64_t stop_offset;
+};
+
+struct array_prescan {
+    struct tracker *tk;
+    struct array_cache *cache;
+    struct ast_node_hdl *item_type;
+    const char *sync;
+    int64_t sync_len;
+    int64_t base_offset;
+    int64_t end_offset;
+    int n_workers;
+    struct array_prescan_report reports[ARRAY_PRESCAN_MAX_WORKERS];
+    /** next item to add to the cache */
+    int64_t next_index;
+    /** item offsets of the worker being stitched, sorted */
+    const int64_t *offsets;
+    int64_t n_offsets;
+    /** index in @ref offsets where the sequential chain met them */
+    int64_t meet_index;
+};
+
+typedef int (*array_prescan_item_cb_t)(struct array_prescan *prescan,
+                                       void *arg, int64_t item_offset);
+
+/**
+ * @brief enable parallel pre-scan of large slack arrays
+ *
+ * See bitpunch_set_array_prescan()
+ */
+void
+array_prescan_set_config(int n_workers, int64_t min_array_size)
+{
+    if (n_workers > ARRAY_PRESCAN_MAX_WORKERS) {
+        n_workers = ARRAY_PRESCAN_MAX_WORKERS;
+    }
+    prescan_n_workers = (n_workers > 1 ? n_workers : 0);
+    prescan_min_array_size = (min_array_size >= 0 ? min_array_size :
+                              ARRAY_PRESCAN_DEFAULT_MIN_ARRAY_SIZE);
+}
+
+static int
+array_prescan_get_sync(struct ast_node_hdl *item_type,
+                       const char **syncp, int64_t *sync_lenp)
+{
+    expr_value_t sync;
+
+    if (AST_NODE_TYPE_REXPR_FILTER != item_type->ndat->type
+        || NULL == filter_get_const_scope_def(item_type)
+        || BITPUNCH_OK != filter_get_constant_attribute(item_type, "@sync",
+                                                        &sync)) {
+        return FALSE;
+    }
+    switch (sync.type) {
+    case EXPR_VALUE_TYPE_STRING:
+        *syncp = sync.string.str;
+        *sync_lenp = sync.string.len;
+        break ;
+    case EXPR_VALUE_TYPE_BYTES:
+        *syncp = sync.bytes.buf;
+        *sync_lenp = sync.bytes.len;
+        break ;
+    default:
+        return FALSE;
+    }
+    return *sync_lenp > 0;
+}
+
+/**
+ * @brief find the first occurrence of the sync pattern in [@ref
+ * from, end of array)
+ *
+ * @return the offset found, or -1 if none
+ */
+static int64_t
+array_prescan_find_sync(struct array_prescan *prescan, int64_t from)
+{
+    struct bitpunch_data_source *ds;
+    struct bitpunch_data_pin pin;
+    const char *data;
+    const char *match;
+    int64_t window_size;
+
+    ds = prescan->tk->box->ds_out;
+    while (from + prescan->sync_len <= prescan->end_offset) {
+        // windows overlap by the pattern length minus one byte to
+        // catch matches across window boundaries
+        window_size = MIN(ARRAY_PRESCAN_SEARCH_WINDOW + prescan->sync_len - 1,
+                          prescan->end_offset - from);
+        if (-1 == bitpunch_data_source_pin_range(ds, from, window_size,
+                                                 &pin, &data)) {
+            return -1;
+        }
+        match = memmem(data, window_size, prescan->sync, prescan->sync_len);
+        bitpunch_data_source_unpin(ds, &pin);
+        if (NULL != match) {
+            return from + (match - data);
+        }
+        from += window_size - prescan->sync_len + 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief parse items of @ref tk's array sequentially from @ref
+ * item_offset
+ *
+ * @ref item_cb is called with each item offset below @ref
+ * limit_offset, parsing stops when it returns non-zero.
+ *
+ * @param[out] stop_offsetp offset of the item where parsing stopped
+ *
+ * @retval BITPUNCH_OK stopped by the limit or by @ref item_cb
+ * @retval BITPUNCH_NO_ITEM reached the end of the array
+ */
+static bitpunch_status_t
+array_prescan_walk(struct array_prescan *prescan, struct tracker *tk,
+                   int64_t index, int64_t item_offset, int64_t limit_offset,
+                   array_prescan_item_cb_t item_cb, void *cb_arg,
+                   int64_t *stop_offsetp,
+                   struct browse_state *bst)
+{
+    struct filter_instance_array *array;
+    struct tracker *xtk;
+    bitpunch_status_t bt_ret;
+
+    array = (struct filter_instance_array *)
+        tk->box->filter->ndat->u.rexpr_filter.f_instance;
+    xtk = tracker_dup(tk);
+    xtk->flags &= ~TRACKER_REVERSED;
+    tracker_set_dangling(xtk);
+    xtk->flags |= TRACKER_NEED_ITEM_OFFSET;
+    xtk->dpath.filter = array->item_type;
+    xtk->dpath.item = prescan->item_type;
+    xtk->cur = track_path_from_array_index(index);
+    xtk->item_offset = item_offset;
+    while (TRUE) {
+        if (xtk->item_offset >= limit_offset
+            || 0 != item_cb(prescan, cb_arg, xtk->item_offset)) {
+            *stop_offsetp = xtk->item_offset;
+            bt_ret = BITPUNCH_OK;
+            break ;
+        }
+        bt_ret = tracker_goto_next_item_internal(xtk, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            *stop_offsetp = -1;
+            break ;
+        }
+    }
+    tracker_delete(xtk);
+    return bt_ret;
+}
+
+static int
+array_prescan_worker_item_cb(struct array_prescan *prescan,
+                             void *arg, int64_t item_offset)
+{
+    struct array_prescan_report *report;
+
+    report = arg;
+    if (report->n_items == report->max_items) {
+        report->max_items = MAX(2 * report->max_items, 1024);
+        report->offsets = realloc_safe(
+            report->offsets, report->max_items * sizeof (int64_t));
+    }
+    report->offsets[report->n_items] = item_offset;
+    ++report->n_items;
+    return 0;
+}
+
+static void
+array_prescan_run_worker(struct array_prescan_report *report,
+                         struct tracker *tk, struct browse_state *bst)
+{
+    struct array_prescan *prescan;
+    int worker;
+    int64_t chunk_size;
+    int64_t start_offset;
+    int64_t limit_offset;
+    bitpunch_status_t bt_ret;
+
+    prescan = report->prescan;
+    worker = report - prescan->reports;
+    chunk_size = (prescan->end_offset - prescan->base_offset)
+        / prescan->n_workers;
+    if (0 == worker) {
+        start_offset = prescan->base_offset;
+    } else {
+        start_offset = array_prescan_find_sync(
+            prescan, prescan->base_offset + worker * chunk_size);
+        if (-1 == start_offset) {
+            report->status = ARRAY_PRESCAN_WORKER_NO_SYNC;
+            return ;
+        }
+    }
+    limit_offset = -1;
+    if (worker < prescan->n_workers - 1) {
+        // same computation as the next worker's start offset
+        limit_offset = array_prescan_find_sync(
+            prescan, prescan->base_offset + (worker + 1) * chunk_size);
+    }
+    if (-1 == limit_offset) {
+        limit_offset = INT64_MAX;
+    }
+    report->start_offset = start_offset;
+    bt_ret = array_prescan_walk(prescan, tk, 0, start_offset, limit_offset,
+                                array_prescan_worker_item_cb, report,
+                                &report->stop_offset, bst);
+    switch (bt_ret) {
+    case BITPUNCH_OK:
+        report->status = (INT64_MAX == limit_offset ?
+                          ARRAY_PRESCAN_WORKER_FAILED :
+                          ARRAY_PRESCAN_WORKER_AT_LIMIT);
+        break ;
+    case BITPUNCH_NO_ITEM:
+        report->status = ARRAY_PRESCAN_WORKER_AT_END;
+        break ;
+    default:
+        report->status = ARRAY_PRESCAN_WORKER_FAILED;
+        break ;
+    }
+}
+
+static void *
+array_prescan_worker_main(void *arg)
+{
+    struct array_prescan_report *report;
+    struct browse_state bst;
+    struct box *array_box;
+    struct tracker *tk;
+
+    report = arg;
+    browse_state_init_box(&bst, report->prescan->tk->box);
+    array_box = box_dup_chain(report->prescan->tk->box, &bst);
+    if (NULL != array_box) {
+        browse_state_cleanup(&bst);
+        browse_state_init_box(&bst, array_box);
+        (void) track_box_contents_internal(array_box, &tk, &bst);
+        box_delete_non_null(array_box);
+        array_prescan_run_worker(report, tk, &bst);
+        tracker_delete(tk);
+    }
+    browse_state_cleanup(&bst);
+    return NULL;
+}
+
+static void
+array_prescan_add_item(struct array_prescan *prescan, int64_t item_offset)
+{
+    array_index_cache_add_item_offset(prescan->cache, prescan->item_type,
+                                      prescan->next_index, item_offset);
+    ++prescan->next_index;
+}
+
+static int
+array_prescan_resync_item_cb(struct array_prescan *prescan,
+                             void *arg, int64_t item_offset)
+{
+    int64_t lo, hi, mid;
+
+    lo = 0;
+    hi = prescan->n_offsets;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (prescan->offsets[mid] < item_offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < prescan->n_offsets && prescan->offsets[lo] == item_offset) {
+        prescan->meet_index = lo;
+        return 1;
+    }
+    array_prescan_add_item(prescan, item_offset);
+    return 0;
+}
+
+/**
+ * @brief add worker results to the index cache, in order
+ *
+ * Stops at the first result that cannot be validated, the cache then
+ * holds a valid prefix that sequential browsing completes.
+ */
+static void
+array_prescan_stitch(struct array_prescan *prescan,
+                     struct browse_state *bst)
+{
+    struct array_prescan_report *report;
+    int64_t next_offset;
+    int64_t limit_offset;
+    int64_t i;
+    int worker;
+    bitpunch_status_t bt_ret;
+
+    next_offset = prescan->base_offset;
+    for (worker = 0; worker < prescan->n_workers; ++worker) {
+        report = &prescan->reports[worker];
+        if (ARRAY_PRESCAN_WORKER_NO_SYNC == report->status) {
+            continue ;
+        }
+        if (ARRAY_PRESCAN_WORKER_LOST == report->status) {
+            return ;
+        }
+        prescan->offsets = report->offsets;
+        prescan->n_offsets = report->n_items;
+        prescan->meet_index = 0;
+        if (report->start_offset != next_offset) {
+            // the worker started inside an item: parse sequentially
+            // until meeting one of its item offsets
+            prescan->meet_index = -1;
+            limit_offset = (ARRAY_PRESCAN_WORKER_AT_LIMIT == report->status ?
+                            report->stop_offset : INT64_MAX);
+            bt_ret = array_prescan_walk(
+                prescan, prescan->tk,
+                prescan->next_index, next_offset, limit_offset,
+                array_prescan_resync_item_cb, NULL, &next_offset, bst);
+            if (BITPUNCH_OK != bt_ret) {
+                return ;
+            }
+            if (-1 == prescan->meet_index) {
+                // passed the worker's chunk without meeting
+                continue ;
+            }
+        }
+        for (i = prescan->meet_index; i < prescan->n_offsets; ++i) {
+            array_prescan_add_item(prescan, prescan->offsets[i]);
+        }
+        if (ARRAY_PRESCAN_WORKER_AT_LIMIT != report->status) {
+            return ;
+        }
+        next_offset = report->stop_offset;
+    }
+}
+
+static void
+array_prescan_run(struct array_prescan *prescan, struct browse_state *bst)
+{
+    struct array_prescan_report *report;
+    int worker;
+    int n_started;
+
+    n_started = 0;
+    for (worker = 0; worker < prescan->n_workers; ++worker) {
+        report = &prescan->reports[worker];
+        report->prescan = prescan;
+        if (0 != pthread_create(&report->thread, NULL,
+                                array_prescan_worker_main, report)) {
+            break ;
+        }
+        ++n_started;
+    }
+    for (worker = 0; worker < n_started; ++worker) {
+        (void) pthread_join(prescan->reports[worker].thread, NULL);
+    }
+    if (n_started == prescan->n_workers) {
+        array_prescan_stitch(prescan, bst);
+    }
+    for (worker = 0; worker < n_started; ++worker) {
+        free(prescan->reports[worker].offsets);
+    }
+}
+
+/**
+ * @brief pre-scan the array in parallel if enabled and worthwhile
+ *
+ * Fills the offsets index cache of an empty slack array of
+ * variable-size items whose item type has a constant "@sync"
+ * attribute. Item parsing must not depend on the item index.
+ */
+bitpunch_status_t
+tracker_index_cache_prescan(struct tracker *tk, struct browse_state *bst)
+{
+    struct filter_instance_array *array;
+    struct array_prescan prescan;
+    struct tracker *xtk;
+    bitpunch_status_t bt_ret;
+
+    if (0 == prescan_n_workers) {
+        return BITPUNCH_OK;
+    }
+    memset(&prescan, 0, sizeof (prescan));
+    prescan.cache = box_array_cache(tk->box);
+    if (-1 != prescan.cache->last_cached_index
+        || !prescan.cache->mark_offsets_exists
+        || index_cache_exists(prescan.cache)
+        || 0 != (tk->box->flags & BOX_RALIGN)) {
+        return BITPUNCH_OK;
+    }
+    array = (struct filter_instance_array *)
+        tk->box->filter->ndat->u.rexpr_filter.f_instance;
+    bt_ret = expr_evaluate_filter_type_internal(
+        array->item_type, tk->box, FILTER_KIND_ITEM, &prescan.item_type, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    if (!array_prescan_get_sync(prescan.item_type,
+                                &prescan.sync, &prescan.sync_len)) {
+        return BITPUNCH_OK;
+    }
+    bt_ret = box_compute_slack_size(tk->box, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    xtk = tracker_dup(tk);
+    xtk->flags &= ~TRACKER_REVERSED;
+    bt_ret = tracker_set_item_offset_at_box(xtk, xtk->box, bst);
+    prescan.base_offset = xtk->item_offset;
+    tracker_delete(xtk);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    prescan.end_offset = box_get_known_end_offset_mask(
+        tk->box, (BOX_END_OFFSET_SPAN |
+                  BOX_END_OFFSET_MAX_SPAN |
+                  BOX_END_OFFSET_SLACK));
+    if (-1 == prescan.end_offset
+        || prescan.end_offset - prescan.base_offset < prescan_min_array_size
+        || prescan.end_offset - prescan.base_offset < prescan_n_workers
+        || prescan.end_offset - prescan.base_offset
+        < ast_node_get_min_span_size(prescan.item_type)) {
+        return BITPUNCH_OK;
+    }
+    prescan.tk = tk;
+    prescan.n_workers = prescan_n_workers;
+    array_prescan_run(&prescan, bst);
+    return BITPUNCH_OK;
+}
@@ -129,7 +129,7 @@ box_new_slice_box(struct tracker *slice_start,
     } else {
         slice_start_offset_span = slice_start->box->start_offset_span;
     }
-    slice_box = new_safe(struct box);
+    slice_box = box_alloc();
     bt_ret = box_construct(slice_box,
                            slice_start->box, slice_filter,
                            slice_start->box->scope,
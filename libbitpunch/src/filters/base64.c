@@ -32,13 +32,31 @@
 #define _DEFAULT_SOURCE
 #define _GNU_SOURCE
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "core/filter.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define BASE64_X86
+# include <immintrin.h>
+#endif
+
 #define DECODED_BUFFER_MAX_SIZE (100*1024*1024)
 
+/** inputs larger than this are decoded on demand */
+#define BASE64_LAZY_MIN_SIZE (1024*1024)
+
+/** amount of input decoded at once by on-demand decoding (must be a
+ * multiple of 4) */
+#define BASE64_CHUNK_IN_SIZE (64*1024)
+#define BASE64_CHUNK_OUT_SIZE (BASE64_CHUNK_IN_SIZE / 4 * 3)
+
 /* lookup table indexed by ascii value of each base64-encoded char */
 static const char lookup[256] = {
     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
@@ -61,25 +79,17 @@ static const char lookup[256] = {
     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
 };
 
-static int64_t
-base64_decode(const char *encoded, size_t encoded_size,
-              char *decoded)
+typedef int (*base64_decode_quads_func_t)(const unsigned char *in,
+                                          size_t n_quads,
+                                          unsigned char *out);
+
+static int
+base64_decode_quads__scalar(const unsigned char *in, size_t n_quads,
+                            unsigned char *out)
 {
-    const unsigned char *in;
-    unsigned char *out;
     unsigned int decoded_quad;
-    const unsigned char *encoded_end;
 
-    in = (const unsigned char *)encoded;
-    out = (unsigned char *)decoded;
-    if ((encoded_size % 4) != 0) {
-        return -1;
-    }
-    if (0 == encoded_size) {
-        return 0;
-    }
-    encoded_end = (const unsigned char *)encoded + encoded_size - 4;
-    while (in < encoded_end) {
+    while (n_quads > 0) {
         decoded_quad = ((unsigned int)lookup[*in++] << 18);
         decoded_quad |= ((unsigned int)lookup[*in++] << 12);
         decoded_quad |= ((unsigned int)lookup[*in++] << 6);
@@ -94,7 +104,172 @@ base64_decode(const char *encoded, size_t encoded_size,
         *out++ = ((decoded_quad >> 16) & 0xff);
         *out++ = ((decoded_quad >> 8) & 0xff);
         *out++ = decoded_quad & 0xff;
+        --n_quads;
+    }
+    return 0;
+}
+
+#ifdef BASE64_X86
+
+/*
+ * SIMD kernels, after "Faster Base64 Encoding and Decoding Using AVX2
+ * Instructions" (Muła, Lemire): input chars are validated and
+ * translated to 6-bit values with nibble-indexed lookups, then packed
+ * into bytes with multiply-add instructions.
+ *
+ * Each vector store writes a few bytes past the decoded block, so
+ * kernels stop while enough quads remain to be decoded after it, and
+ * leave them to the scalar loop. This way nothing is ever written
+ * past the decoded output.
+ */
+
+#define BASE64_LUT_LO                                                   \
+    0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,                     \
+    0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+#define BASE64_LUT_HI                                                   \
+    0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,                     \
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+#define BASE64_LUT_ROLL                                                 \
+    0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+#define BASE64_PACK                                                     \
+    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+
+__attribute__((target("sse4.1,ssse3")))
+static int
+base64_decode_quads__sse41(const unsigned char *in, size_t n_quads,
+                           unsigned char *out)
+{
+    const __m128i lut_lo = _mm_setr_epi8(BASE64_LUT_LO);
+    const __m128i lut_hi = _mm_setr_epi8(BASE64_LUT_HI);
+    const __m128i lut_roll = _mm_setr_epi8(BASE64_LUT_ROLL);
+    const __m128i pack = _mm_setr_epi8(BASE64_PACK);
+    const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+    const __m128i slash = _mm_set1_epi8('/');
+    __m128i str, hi_nibbles, lo_nibbles, roll;
+
+    // 4 quads per block, 12 bytes output with 16-byte stores
+    while (n_quads >= 4 + 2) {
+        str = _mm_loadu_si128((const __m128i *)in);
+        hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), nibble_mask);
+        lo_nibbles = _mm_and_si128(str, nibble_mask);
+        if (!_mm_testz_si128(_mm_shuffle_epi8(lut_lo, lo_nibbles),
+                             _mm_shuffle_epi8(lut_hi, hi_nibbles))) {
+            return -1;
+        }
+        roll = _mm_shuffle_epi8(
+            lut_roll,
+            _mm_add_epi8(_mm_cmpeq_epi8(str, slash), hi_nibbles));
+        str = _mm_add_epi8(str, roll);
+        str = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+        str = _mm_madd_epi16(str, _mm_set1_epi32(0x00011000));
+        str = _mm_shuffle_epi8(str, pack);
+        _mm_storeu_si128((__m128i *)out, str);
+        in += 16;
+        out += 12;
+        n_quads -= 4;
+    }
+    return base64_decode_quads__scalar(in, n_quads, out);
+}
+
+__attribute__((target("avx2")))
+static int
+base64_decode_quads__avx2(const unsigned char *in, size_t n_quads,
+                          unsigned char *out)
+{
+    const __m256i lut_lo = _mm256_setr_epi8(BASE64_LUT_LO, BASE64_LUT_LO);
+    const __m256i lut_hi = _mm256_setr_epi8(BASE64_LUT_HI, BASE64_LUT_HI);
+    const __m256i lut_roll = _mm256_setr_epi8(BASE64_LUT_ROLL,
+                                              BASE64_LUT_ROLL);
+    const __m256i pack = _mm256_setr_epi8(BASE64_PACK, BASE64_PACK);
+    const __m256i pack_lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+    const __m256i slash = _mm256_set1_epi8('/');
+    __m256i str, hi_nibbles, lo_nibbles, roll;
+
+    // 8 quads per block, 24 bytes output with 32-byte stores
+    while (n_quads >= 8 + 3) {
+        str = _mm256_loadu_si256((const __m256i *)in);
+        hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4),
+                                      nibble_mask);
+        lo_nibbles = _mm256_and_si256(str, nibble_mask);
+        if (!_mm256_testz_si256(_mm256_shuffle_epi8(lut_lo, lo_nibbles),
+                                _mm256_shuffle_epi8(lut_hi, hi_nibbles))) {
+            return -1;
+        }
+        roll = _mm256_shuffle_epi8(
+            lut_roll,
+            _mm256_add_epi8(_mm256_cmpeq_epi8(str, slash), hi_nibbles));
+        str = _mm256_add_epi8(str, roll);
+        str = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        str = _mm256_madd_epi16(str, _mm256_set1_epi32(0x00011000));
+        str = _mm256_shuffle_epi8(str, pack);
+        str = _mm256_permutevar8x32_epi32(str, pack_lanes);
+        _mm256_storeu_si256((__m256i *)out, str);
+        in += 32;
+        out += 24;
+        n_quads -= 8;
+    }
+    return base64_decode_quads__sse41(in, n_quads, out);
+}
+
+#endif // BASE64_X86
+
+static base64_decode_quads_func_t
+base64_select_decode_func(void)
+{
+#ifdef BASE64_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return base64_decode_quads__avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")
+        && __builtin_cpu_supports("ssse3")) {
+        return base64_decode_quads__sse41;
+    }
+#endif
+    return base64_decode_quads__scalar;
+}
+
+/**
+ * @brief decode full base64 quads (without padding)
+ *
+ * @retval 0 success, @ref n_quads * 3 bytes written to @ref out
+ * @retval -1 invalid base64 input
+ */
+static int
+base64_decode_quads(const char *in, size_t n_quads, char *out)
+{
+    static base64_decode_quads_func_t decode_func = NULL;
+
+    if (unlikely(NULL == decode_func)) {
+        decode_func = base64_select_decode_func();
+    }
+    return decode_func((const unsigned char *)in, n_quads,
+                       (unsigned char *)out);
+}
+
+static int64_t
+base64_decode(const char *encoded, size_t encoded_size,
+              char *decoded)
+{
+    const unsigned char *in;
+    unsigned char *out;
+    unsigned int decoded_quad;
+    size_t n_quads;
+
+    if ((encoded_size % 4) != 0) {
+        return -1;
+    }
+    if (0 == encoded_size) {
+        return 0;
+    }
+    // all quads but the last one, that may be padded
+    n_quads = encoded_size / 4 - 1;
+    if (-1 == base64_decode_quads(encoded, n_quads, decoded)) {
+        return -1;
     }
+    in = (const unsigned char *)encoded + n_quads * 4;
+    out = (unsigned char *)decoded + n_quads * 3;
     decoded_quad = ((unsigned int)lookup[*in++] << 18);
     decoded_quad |= ((unsigned int)lookup[*in++] << 12);
     *out++ = (decoded_quad >> 16) & 0xff;
@@ -114,6 +289,249 @@ base64_decode(const char *encoded, size_t encoded_size,
     return (char *)out - decoded;
 }
 
+/**
+ * @brief data source decoding large base64 inputs on demand
+ *
+ * Contents are decoded by chunks when first accessed, into an address
+ * range reserved for the whole decoded size, whose pages only get
+ * allocated when decoded data is written to them.
+ */
+struct base64_data_source {
+    struct bitpunch_data_source ds; /* inherits */
+    /** serializes decoding, as the data source may be shared
+     * between threads through the filter output cache */
+    pthread_mutex_t lock;
+    /** data source of the encoded input */
+    struct bitpunch_data_source *ds_in;
+    int64_t in_offset;      /**< [ds_in] start offset of encoded data */
+    int64_t in_size;
+    char *output;
+    int64_t n_chunks;
+    /** one flag per chunk, set once decoded */
+    char *decoded_chunks;
+    int failed;
+    char error[256];
+};
+
+static int
+base64_data_source_error(struct base64_data_source *bds,
+                         const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static int
+base64_data_source_error(struct base64_data_source *bds,
+                         const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(bds->error, sizeof (bds->error), fmt, ap);
+    va_end(ap);
+    bds->failed = TRUE;
+    return -1;
+}
+
+static int
+base64_data_source_decode_chunk(struct base64_data_source *bds,
+                                int64_t chunk)
+{
+    int64_t chunk_in_offset;
+    int64_t chunk_in_size;
+    struct bitpunch_data_pin pin;
+    const char *in_data;
+    char *out;
+    int ret;
+
+    chunk_in_offset = chunk * BASE64_CHUNK_IN_SIZE;
+    chunk_in_size = MIN(BASE64_CHUNK_IN_SIZE,
+                        bds->in_size - chunk_in_offset);
+    if (-1 == bitpunch_data_source_pin_range(
+            bds->ds_in, bds->in_offset + chunk_in_offset, chunk_in_size,
+            &pin, &in_data)) {
+        return base64_data_source_error(
+            bds, "error reading base64 input at offset %"PRIi64,
+            bds->in_offset + chunk_in_offset);
+    }
+    out = bds->output + chunk * BASE64_CHUNK_OUT_SIZE;
+    if (chunk == bds->n_chunks - 1) {
+        // last chunk may be padded
+        ret = (-1 == base64_decode(in_data, chunk_in_size, out) ? -1 : 0);
+    } else {
+        ret = base64_decode_quads(in_data, chunk_in_size / 4, out);
+    }
+    bitpunch_data_source_unpin(bds->ds_in, &pin);
+    if (-1 == ret) {
+        return base64_data_source_error(
+            bds, "invalid base64 input in range [%"PRIi64"..%"PRIi64"[",
+            bds->in_offset + chunk_in_offset,
+            bds->in_offset + chunk_in_offset + chunk_in_size);
+    }
+    bds->decoded_chunks[chunk] = TRUE;
+    return 0;
+}
+
+/**
+ * @brief decode output range [@ref start_offset, @ref end_offset[
+ * if not decoded yet
+ */
+static int
+base64_data_source_decode(struct base64_data_source *bds,
+                          int64_t start_offset, int64_t end_offset)
+{
+    int64_t chunk;
+
+    if (bds->failed) {
+        return -1;
+    }
+    for (chunk = start_offset / BASE64_CHUNK_OUT_SIZE;
+         chunk * BASE64_CHUNK_OUT_SIZE < end_offset; ++chunk) {
+        if (!bds->decoded_chunks[chunk]
+            && -1 == base64_data_source_decode_chunk(bds, chunk)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int
+base64_data_source_pin_range(struct bitpunch_data_source *ds,
+                             int64_t offset, int64_t length,
+                             struct bitpunch_data_pin *pin)
+{
+    struct base64_data_source *bds;
+
+    bds = (struct base64_data_source *)ds;
+    pthread_mutex_lock(&bds->lock);
+    if (-1 == base64_data_source_decode(bds, offset, offset + length)) {
+        fprintf(stderr, "Unable to decode base64 data: %s\n", bds->error);
+        pthread_mutex_unlock(&bds->lock);
+        return -1;
+    }
+    pthread_mutex_unlock(&bds->lock);
+    // decoded data is never discarded, no need for a pin handle
+    pin->base = bds->output + offset;
+    pin->start_offset = offset;
+    pin->end_offset = offset + length;
+    pin->handle = NULL;
+    return 0;
+}
+
+static int
+base64_data_source_read_range(struct bitpunch_data_source *ds,
+                              int64_t offset, int64_t length, char *buf)
+{
+    struct base64_data_source *bds;
+
+    bds = (struct base64_data_source *)ds;
+    pthread_mutex_lock(&bds->lock);
+    if (-1 == base64_data_source_decode(bds, offset, offset + length)) {
+        fprintf(stderr, "Unable to decode base64 data: %s\n", bds->error);
+        pthread_mutex_unlock(&bds->lock);
+        return -1;
+    }
+    memcpy(buf, bds->output + offset, length);
+    pthread_mutex_unlock(&bds->lock);
+    return 0;
+}
+
+static void
+base64_data_source_unpin(struct bitpunch_data_source *ds,
+                         struct bitpunch_data_pin *pin)
+{
+}
+
+static int
+base64_data_source_close(struct bitpunch_data_source *ds)
+{
+    struct base64_data_source *bds;
+
+    bds = (struct base64_data_source *)ds;
+    if (NULL != bds->output) {
+        (void) munmap(bds->output, bds->ds.ds_data_length);
+    }
+    free(bds->decoded_chunks);
+    pthread_mutex_destroy(&bds->lock);
+    return bitpunch_data_source_release(bds->ds_in);
+}
+
+/**
+ * @brief open a data source decoding base64 input on demand
+ *
+ * The first and last chunks are decoded right away, so that a bad
+ * input size or padding, or an invalid start, get reported upfront.
+ * Invalid characters in other chunks are reported when they get
+ * accessed.
+ *
+ * @return the data source, or NULL with @ref error set
+ */
+static struct bitpunch_data_source *
+base64_data_source_open(struct bitpunch_data_source *ds_in,
+                        int64_t in_offset, int64_t in_size,
+                        char *error, size_t error_size)
+{
+    struct base64_data_source *bds;
+    const char *in_data;
+    struct bitpunch_data_pin pin;
+    int64_t decoded_size;
+
+    if (0 != in_size % 4) {
+        snprintf(error, error_size, "invalid base64 input");
+        return NULL;
+    }
+    decoded_size = in_size / 4 * 3;
+    if (in_size > 0) {
+        if (-1 == bitpunch_data_source_pin_range(
+                ds_in, in_offset + in_size - 2, 2, &pin, &in_data)) {
+            snprintf(error, error_size,
+                     "error reading base64 input at offset %"PRIi64,
+                     in_offset + in_size - 2);
+            return NULL;
+        }
+        if ('=' == in_data[1]) {
+            decoded_size -= ('=' == in_data[0] ? 2 : 1);
+        }
+        bitpunch_data_source_unpin(ds_in, &pin);
+    }
+    bds = new_safe(struct base64_data_source);
+    pthread_mutex_init(&bds->lock, NULL);
+    bds->ds.use_count = 1;
+    bds->ds.backend.close = base64_data_source_close;
+    bds->ds.backend.read_range = base64_data_source_read_range;
+    bds->ds.backend.pin_range = base64_data_source_pin_range;
+    bds->ds.backend.unpin = base64_data_source_unpin;
+    bds->ds.ds_data_length = (size_t)decoded_size;
+    bds->ds_in = ds_in;
+    bitpunch_data_source_acquire(ds_in);
+    bds->in_offset = in_offset;
+    bds->in_size = in_size;
+    bds->n_chunks = (in_size + BASE64_CHUNK_IN_SIZE - 1)
+        / BASE64_CHUNK_IN_SIZE;
+    bds->decoded_chunks = malloc0_safe(MAX(bds->n_chunks, 1));
+    if (decoded_size > 0) {
+        bds->output = mmap(NULL, (size_t)decoded_size,
+                           PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                           -1, 0);
+        if (MAP_FAILED == bds->output) {
+            bds->output = NULL;
+            snprintf(error, error_size,
+                     "unable to reserve %"PRIi64" bytes for decoded "
+                     "data: %s", decoded_size, strerror(errno));
+            (void) bitpunch_data_source_release(&bds->ds);
+            return NULL;
+        }
+    }
+    if (bds->n_chunks > 0
+        && (-1 == base64_data_source_decode_chunk(bds, 0)
+            || -1 == base64_data_source_decode_chunk(
+                bds, bds->n_chunks - 1))) {
+        snprintf(error, error_size, "%s", bds->error);
+        (void) bitpunch_data_source_release(&bds->ds);
+        return NULL;
+    }
+    return &bds->ds;
+}
+
 static bitpunch_status_t
 base64_read(
     struct ast_node_hdl *filter,
@@ -135,6 +553,7 @@ base64_read(
     bitpunch_buffer_new(&ds, decoded_max_length);
     ds->ds_data_length = base64_decode(buffer, buffer_size, ds->ds_data);
     if (-1 == ds->ds_data_length) {
+        (void) bitpunch_data_source_release(ds);
         // TODO add precision regarding the error
         return node_error(BITPUNCH_DATA_ERROR, filter, bst,
                           "invalid base64 input");
@@ -143,12 +562,49 @@ base64_read(
     return BITPUNCH_OK;
 }
 
+static bitpunch_status_t
+base64_read_value(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    int64_t item_offset,
+    int64_t item_size,
+    expr_value_t *valuep,
+    struct browse_state *bst)
+{
+    bitpunch_status_t bt_ret;
+    struct bitpunch_data_pin pin;
+    const char *item_data;
+    struct bitpunch_data_source *ds;
+    char error[256];
+
+    if (item_size <= BASE64_LAZY_MIN_SIZE) {
+        bt_ret = box_pin_data_internal(scope, scope->ds_in,
+                                       item_offset, item_size,
+                                       &pin, &item_data, bst);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        bt_ret = base64_read(filter, scope, item_data, item_size,
+                             valuep, bst);
+        box_unpin_data(scope, scope->ds_in, &pin, FALSE);
+        return bt_ret;
+    }
+    ds = base64_data_source_open(scope->ds_in, item_offset, item_size,
+                                 error, sizeof (error));
+    if (NULL == ds) {
+        return node_error(BITPUNCH_DATA_ERROR, filter, bst, "%s", error);
+    }
+    *valuep = expr_value_as_data(ds);
+    return BITPUNCH_OK;
+}
+
 static struct filter_instance *
 base64_filter_instance_build(struct ast_node_hdl *filter)
 {
     struct filter_instance *f_instance;
 
     f_instance = new_safe(struct filter_instance);
+    f_instance->b_item.read_value = base64_read_value;
     f_instance->b_item.read_value_from_buffer = base64_read;
     return f_instance;
 }
@@ -161,7 +617,7 @@ builtin_filter_declare_base64(void)
     ret = builtin_filter_declare("base64",
                                EXPR_VALUE_TYPE_BYTES,
                                base64_filter_instance_build, NULL,
-                               0u,
+                               FILTER_CLASS_CACHED_OUTPUT,
                                0);
     assert(0 == ret);
 }
@@ -235,12 +691,167 @@ START_TEST(test_filter_base64)
 }
 END_TEST
 
+static size_t
+base64_encode_test_data(const unsigned char *data, size_t size, char *out)
+{
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i;
+    char *p;
+    unsigned int triple;
+
+    p = out;
+    for (i = 0; i < size; i += 3) {
+        triple = data[i] << 16;
+        if (i + 1 < size) {
+            triple |= data[i + 1] << 8;
+        }
+        if (i + 2 < size) {
+            triple |= data[i + 2];
+        }
+        *p++ = alphabet[(triple >> 18) & 0x3f];
+        *p++ = alphabet[(triple >> 12) & 0x3f];
+        *p++ = (i + 1 < size ? alphabet[(triple >> 6) & 0x3f] : '=');
+        *p++ = (i + 2 < size ? alphabet[triple & 0x3f] : '=');
+    }
+    return p - out;
+}
+
+START_TEST(test_filter_base64_kernels)
+{
+    static const char invalid_chars[] = { '=', '*', ' ', '\0', '\x80' };
+    base64_decode_quads_func_t decode_funcs[3];
+    int n_decode_funcs;
+    unsigned char data[300];
+    char encoded[400];
+    char expected[300];
+    char decoded[300 + 4];
+    size_t n_quads;
+    size_t pos;
+    int i;
+    int f;
+
+    n_decode_funcs = 0;
+    decode_funcs[n_decode_funcs++] = base64_decode_quads__scalar;
+#ifdef BASE64_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")
+        && __builtin_cpu_supports("ssse3")) {
+        decode_funcs[n_decode_funcs++] = base64_decode_quads__sse41;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        decode_funcs[n_decode_funcs++] = base64_decode_quads__avx2;
+    }
+#endif
+    for (i = 0; i < sizeof (data); ++i) {
+        data[i] = (unsigned char)(i * 97 + 13);
+    }
+    (void) base64_encode_test_data(data, sizeof (data), encoded);
+
+    // all kernels shall match the scalar implementation, for all
+    // counts (to test the remainder loops)
+    for (n_quads = 0; n_quads <= sizeof (data) / 3; ++n_quads) {
+        ck_assert(0 == base64_decode_quads__scalar(
+                      (const unsigned char *)encoded, n_quads,
+                      (unsigned char *)expected));
+        ck_assert(0 == memcmp(expected, data, n_quads * 3));
+        for (f = 1; f < n_decode_funcs; ++f) {
+            memset(decoded, 0xaa, sizeof (decoded));
+            ck_assert(0 == decode_funcs[f](
+                          (const unsigned char *)encoded, n_quads,
+                          (unsigned char *)decoded));
+            ck_assert(0 == memcmp(decoded, expected, n_quads * 3));
+            // nothing written past the decoded output
+            ck_assert((unsigned char)decoded[n_quads * 3] == 0xaa);
+        }
+    }
+    // an invalid char at any position is reported by all kernels
+    n_quads = sizeof (data) / 3;
+    for (pos = 0; pos < n_quads * 4; ++pos) {
+        for (i = 0; i < N_ELEM(invalid_chars); ++i) {
+            char saved;
+
+            saved = encoded[pos];
+            encoded[pos] = invalid_chars[i];
+            for (f = 0; f < n_decode_funcs; ++f) {
+                ck_assert(-1 == decode_funcs[f](
+                              (const unsigned char *)encoded, n_quads,
+                              (unsigned char *)decoded));
+            }
+            encoded[pos] = saved;
+        }
+    }
+}
+END_TEST
+
+START_TEST(test_filter_base64_lazy)
+{
+    static const int64_t data_size = 3 * BASE64_CHUNK_OUT_SIZE + 1000;
+    unsigned char *data;
+    char *encoded;
+    size_t encoded_size;
+    struct bitpunch_data_source *ds_in;
+    struct bitpunch_data_source *ds;
+    struct bitpunch_data_pin pin;
+    const char *decoded;
+    char *buf;
+    char error[256];
+    int64_t i;
+
+    data = malloc_safe(data_size);
+    for (i = 0; i < data_size; ++i) {
+        data[i] = (unsigned char)(i * 31 + (i >> 8));
+    }
+    encoded = malloc_safe(data_size / 3 * 4 + 8);
+    encoded_size = base64_encode_test_data(data, data_size, encoded);
+    bitpunch_data_source_create_from_memory(&ds_in, encoded, encoded_size,
+                                            FALSE);
+
+    ds = base64_data_source_open(ds_in, 0, encoded_size,
+                                 error, sizeof (error));
+    ck_assert(NULL != ds);
+    ck_assert(ds->ds_data_length == data_size);
+    ck_assert(0 == bitpunch_data_source_pin_range(
+                  ds, 2 * BASE64_CHUNK_OUT_SIZE - 10, 20, &pin, &decoded));
+    ck_assert(0 == memcmp(decoded, data + 2 * BASE64_CHUNK_OUT_SIZE - 10,
+                          20));
+    bitpunch_data_source_unpin(ds, &pin);
+    buf = malloc_safe(data_size);
+    ck_assert(0 == bitpunch_data_source_read_range(ds, 0, data_size, buf));
+    ck_assert(0 == memcmp(buf, data, data_size));
+    (void) bitpunch_data_source_release(ds);
+
+    // invalid chars in middle chunks are reported when accessed
+    encoded[BASE64_CHUNK_IN_SIZE + 100] = '*';
+    ds = base64_data_source_open(ds_in, 0, encoded_size,
+                                 error, sizeof (error));
+    ck_assert(NULL != ds);
+    ck_assert(0 == bitpunch_data_source_read_range(ds, 0, 100, buf));
+    ck_assert(-1 == bitpunch_data_source_read_range(
+                  ds, BASE64_CHUNK_OUT_SIZE, 100, buf));
+    (void) bitpunch_data_source_release(ds);
+    // invalid first chunk or padding are reported upfront
+    ck_assert(NULL == base64_data_source_open(ds_in, 0, encoded_size - 1,
+                                              error, sizeof (error)));
+    encoded[0] = '*';
+    ck_assert(NULL == base64_data_source_open(ds_in, 0, encoded_size,
+                                              error, sizeof (error)));
+
+    (void) bitpunch_data_source_release(ds_in);
+    free(buf);
+    free(encoded);
+    free(data);
+}
+END_TEST
+
 void check_filter_base64_add_tcases(Suite *s)
 {
     TCase *tc_filter_base64;
 
     tc_filter_base64 = tcase_create("filter:base64");
     tcase_add_test(tc_filter_base64, test_filter_base64);
+    tcase_add_test(tc_filter_base64, test_filter_base64_kernels);
+    tcase_add_test(tc_filter_base64, test_filter_base64_lazy);
     suite_add_tcase(s, tc_filter_base64);
 }
 
@@ -85,6 +85,77 @@ compile_type_composite(struct ast_node_hdl *item,
     return 0;
 }
 
+/**
+ * @brief build the table of struct fields located at a static offset
+ *
+ * Unconditional fields of constant size starting from the first
+ * field have an offset known at compile time, as well as the first
+ * unconditional field following them. Browsing to those fields can
+ * then jump directly to their offset, and sizes of intermediate
+ * fields need not be computed.
+ */
+static int
+compile_static_field_offsets(struct filter_instance_composite *composite,
+                             const struct statement_list *field_list)
+{
+    struct field *field;
+    struct ast_node_hdl_array field_items;
+    const struct ast_node_hdl *field_item;
+    int n_fields;
+    int64_t offset;
+    int is_static_size;
+    bitpunch_status_t bt_ret;
+
+    n_fields = 0;
+    STATEMENT_FOREACH(field, field, field_list, list) {
+        ++n_fields;
+    }
+    composite->static_fields =
+        new_n_safe(const struct field *, MAX(n_fields, 1));
+    composite->static_offsets = new_n_safe(int64_t, MAX(n_fields, 1));
+    composite->n_static_fields = 0;
+    composite->n_named_static_fields = -1;
+    offset = 0;
+    STATEMENT_FOREACH(field, field, field_list, list) {
+        if (NULL != field->nstmt.stmt.cond) {
+            break ;
+        }
+        bt_ret = ast_node_filter_get_items(field->filter, &field_items);
+        if (BITPUNCH_OK != bt_ret) {
+            return -1;
+        }
+        field_item = ARRAY_ITEM(&field_items, 0);
+        is_static_size =
+            1 == ARRAY_SIZE(&field_items)
+            && 0 == (field_item->ndat->u.item.flags
+                     & (ITEMFLAG_IS_SPAN_SIZE_VARIABLE |
+                        ITEMFLAG_USES_SLACK |
+                        ITEMFLAG_SPREADS_SLACK |
+                        ITEMFLAG_CONDITIONALLY_SPREADS_SLACK |
+                        ITEMFLAG_FILLS_SLACK |
+                        ITEMFLAG_CONDITIONALLY_FILLS_SLACK));
+        ast_node_hdl_array_destroy(&field_items);
+        if (-1 == composite->n_named_static_fields
+            && NULL == field->nstmt.name
+            && 0 == (field->nstmt.stmt.stmt_flags & FIELD_FLAG_HIDDEN)) {
+            composite->n_named_static_fields = composite->n_static_fields;
+        }
+        field->nstmt.stmt.stmt_flags |= FIELD_FLAG_STATIC_OFFSET;
+        field->static_index = composite->n_static_fields;
+        composite->static_fields[composite->n_static_fields] = field;
+        composite->static_offsets[composite->n_static_fields] = offset;
+        ++composite->n_static_fields;
+        if (!is_static_size) {
+            break ;
+        }
+        offset += field_item->ndat->u.item.min_span_size;
+    }
+    if (-1 == composite->n_named_static_fields) {
+        composite->n_named_static_fields = composite->n_static_fields;
+    }
+    return 0;
+}
+
 static int
 compile_span_size_composite(struct ast_node_hdl *item,
                             struct filter_instance_composite *composite,
@@ -276,6 +347,10 @@ compile_span_size_composite(struct ast_node_hdl *item,
             field->nstmt.stmt.stmt_flags |= field_flags;
         }
     }
+    if (COMPOSITE_TYPE_STRUCT == composite->type
+        && -1 == compile_static_field_offsets(composite, field_list)) {
+        return -1;
+    }
     min_span_size = MAX(hard_min_span_size, user_min_span_size);
     if (NULL != max_span_expr) {
         assert(EXPR_VALUE_TYPE_INTEGER
@@ -502,6 +577,90 @@ compile_node_backends__box__composite(struct ast_node_hdl *item)
 
 
 
+static int
+composite_get_static_field_index(
+    const struct filter_instance_composite *composite,
+    const struct field *field)
+{
+    if (NULL == field
+        || 0 == (field->nstmt.stmt.stmt_flags & FIELD_FLAG_STATIC_OFFSET)
+        || field->static_index >= composite->n_static_fields
+        || composite->static_fields[field->static_index] != field) {
+        // not a static field of this struct
+        return -1;
+    }
+    return field->static_index;
+}
+
+static int
+tracker_get_static_field_start__composite(struct tracker *tk,
+                                          const struct field *to_field,
+                                          int flat,
+                                          const struct field **start_fieldp,
+                                          int64_t *start_offsetp)
+{
+    struct filter_instance_composite *composite;
+    int static_index;
+
+    composite = (struct filter_instance_composite *)
+        tk->box->filter->ndat->u.rexpr_filter.f_instance;
+    static_index = composite_get_static_field_index(composite, to_field);
+    if (-1 == static_index) {
+        // start browsing from the last field with a static offset
+        // that does not need to be entered
+        static_index = flat ?
+            composite->n_static_fields - 1 :
+            MIN(composite->n_named_static_fields,
+                composite->n_static_fields - 1);
+        if (static_index <= 0) {
+            return FALSE;
+        }
+    }
+    *start_fieldp = composite->static_fields[static_index];
+    *start_offsetp = composite->static_offsets[static_index];
+    return TRUE;
+}
+
+static bitpunch_status_t
+tracker_goto_nth_item_with_key__composite(
+    struct tracker *tk, expr_value_t item_key, int nth_twin,
+    struct browse_state *bst)
+{
+    struct filter_instance_composite *composite;
+    const struct field *field;
+    char name[64];
+    int static_index;
+
+    DBG_TRACKER_DUMP(tk);
+    composite = (struct filter_instance_composite *)
+        tk->box->filter->ndat->u.rexpr_filter.f_instance;
+    if (0 == nth_twin && EXPR_VALUE_TYPE_STRING == item_key.type
+        && item_key.string.len < sizeof (name)
+        && composite->n_named_static_fields > 0) {
+        memcpy(name, item_key.string.str, item_key.string.len);
+        name[item_key.string.len] = '\0';
+        field = scope_get_first_declared_field(
+            filter_get_scope_def(tk->box->filter), name);
+        static_index = composite_get_static_field_index(composite, field);
+        if (-1 != static_index
+            && static_index < composite->n_named_static_fields) {
+            // no anonymous field can declare the same name before it
+            return tracker_goto_field_internal(tk, field, FALSE, bst);
+        }
+    }
+    return tracker_goto_nth_item_with_key__scope(tk, item_key, nth_twin, bst);
+}
+
+static bitpunch_status_t
+tracker_goto_named_item__composite(struct tracker *tk, const char *name,
+                                   struct browse_state *bst)
+{
+    expr_value_t key;
+
+    key = expr_value_as_string(name);
+    return tracker_goto_nth_item_with_key__composite(tk, key, 0, bst);
+}
+
 static bitpunch_status_t
 tracker_init_item_offset__composite(struct tracker *tk,
                                     struct browse_state *bst)
@@ -523,8 +682,22 @@ tracker_advance_item_offset__composite(struct tracker *tk,
     if (COMPOSITE_TYPE_STRUCT == composite->type) {
         int reversed;
         int64_t item_size;
+        int static_index;
 
         reversed = (0 != (tk->flags & TRACKER_REVERSED));
+        static_index = composite_get_static_field_index(composite,
+                                                        tk->cur.u.field);
+        if (!reversed && -1 != static_index
+            && static_index + 1 < composite->n_static_fields) {
+            // constant-size field: no need to compute its filter
+            bt_ret = tracker_set_item_size(
+                tk, composite->static_offsets[static_index + 1]
+                - composite->static_offsets[static_index], bst);
+            if (BITPUNCH_OK == bt_ret) {
+                tk->item_offset += tk->item_size;
+            }
+            return bt_ret;
+        }
         bt_ret = tracker_get_item_size_internal(tk, &item_size, bst);
         if (BITPUNCH_OK != bt_ret) {
             DBG_TRACKER_CHECK_STATE(tk);
@@ -554,12 +727,13 @@ compile_node_backends__tracker__composite(struct ast_node_hdl *item)
     b_tk->goto_first_item = tracker_goto_first_item__scope;
     b_tk->goto_next_item = tracker_goto_next_item__scope;
     b_tk->goto_nth_item = tracker_goto_nth_item__scope;
-    b_tk->goto_named_item = tracker_goto_named_item__scope;
+    b_tk->goto_named_item = tracker_goto_named_item__composite;
     b_tk->goto_next_key_match = tracker_goto_next_key_match__scope;
     b_tk->goto_next_item_with_key =
         tracker_goto_next_item_with_key__scope;
     b_tk->goto_nth_item_with_key =
-        tracker_goto_nth_item_with_key__scope;
+        tracker_goto_nth_item_with_key__composite;
+    b_tk->get_static_field_start = tracker_get_static_field_start__composite;
     b_tk->goto_end_path = tracker_goto_end_path__scope;
     b_tk->goto_nil = tracker_goto_nil__scope;
 }
@@ -608,13 +782,15 @@ builtin_filter_declare_struct(void)
                                struct_filter_instance_build,
                                composite_filter_instance_compile,
                                FILTER_CLASS_MAPS_OBJECT,
-                               5,
+                               6,
                                "@span", EXPR_VALUE_TYPE_INTEGER, 0,
                                "@minspan", EXPR_VALUE_TYPE_INTEGER, 0,
                                "@maxspan", EXPR_VALUE_TYPE_INTEGER, 0,
                                "@key", (EXPR_VALUE_TYPE_INTEGER |
                                         EXPR_VALUE_TYPE_STRING), 0,
-                               "@last", EXPR_VALUE_TYPE_BOOLEAN, 0);
+                               "@last", EXPR_VALUE_TYPE_BOOLEAN, 0,
+                               "@sync", (EXPR_VALUE_TYPE_STRING |
+                                         EXPR_VALUE_TYPE_BYTES), 0);
     assert(0 == ret);
 }
 
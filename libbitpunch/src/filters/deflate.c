@@ -32,28 +32,693 @@
 #define _DEFAULT_SOURCE
 #define _GNU_SOURCE
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <assert.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 #include <zlib.h>
 
 #include "core/filter.h"
+#include "utils/dynarray.h"
+#include "utils/sidecar.h"
 
 #define INFLATED_MAX_SIZE (1024 * 1024 * 1024)
 
+/** minimum amount of output inflated at once */
+#define INFLATE_OUTPUT_STEP (64 * 1024)
+
+/** maximum amount of input pinned at once */
+#define INFLATE_INPUT_CHUNK_SIZE (64 * 1024)
+
+/** maximum distance of back-references in a deflate stream */
+#define INFLATE_WINDOW_SIZE (32 * 1024)
+
+/** default amount of output between two checkpoints */
+#define INFLATE_DEFAULT_CHECKPOINT_SPAN (4 * 1024 * 1024)
+
+#define DEFLATE_INDEX_MAGIC "BPDFLIDX"
+#define DEFLATE_INDEX_VERSION 1
+
+/**
+ * @brief point in a deflate stream where inflate can resume
+ *
+ * Checkpoints are taken at deflate block boundaries, where only the
+ * window of previous output and the unused bits of the last input
+ * byte are needed to carry on (the technique used by zran.c in the
+ * zlib examples).
+ */
+struct inflate_checkpoint {
+    int64_t out_offset;
+    /** offset of the next input byte, relative to the start of
+     * compressed data */
+    int64_t in_offset;
+    /** number of unused bits in the input byte before in_offset */
+    int bits;
+    int window_size;
+    /** last window_size bytes of output before out_offset */
+    unsigned char *window;
+};
+
+ARRAY_HEAD(inflate_checkpoint_array, struct inflate_checkpoint);
+
+/**
+ * @brief contiguous range of inflated output, and the stream that
+ * keeps extending it
+ */
+struct inflate_extent {
+    struct inflate_extent *next;
+    int64_t out_start;
+    int64_t out_end;
+    int64_t in_offset;      /**< [ds_in] next input offset to inflate */
+    /** output offset of the last checkpoint taken by this extent */
+    int64_t last_checkpoint;
+    /** inflate stream, NULL once the end of stream is reached */
+    z_stream *zs;
+};
+
+/**
+ * @brief data source inflating a deflate stream on demand
+ *
+ * Contents are inflated into an address range reserved for the whole
+ * output size, whose pages only get allocated when inflated data is
+ * written to them.
+ *
+ * Inflated output starts as a single extent growing from the start
+ * of the stream. When checkpoints are available (loaded from a
+ * sidecar file), reading far ahead starts a new extent from the
+ * nearest preceding checkpoint instead, which gets merged with the
+ * following extent once it reaches it.
+ */
+struct inflate_data_source {
+    struct bitpunch_data_source ds; /* inherits */
+    /** serializes inflating, as the data source may be shared
+     * between threads through the filter output cache */
+    pthread_mutex_t lock;
+    /** data source of the compressed stream */
+    struct bitpunch_data_source *ds_in;
+    int64_t in_start_offset; /**< [ds_in] start offset of compressed data */
+    int64_t in_end_offset;   /**< [ds_in] end offset of compressed data */
+    char *output;
+    /** extents of inflated output sorted by offset, the first one
+     * always starts at offset 0 */
+    struct inflate_extent *extents;
+    /** output span between checkpoints, 0 if not indexed */
+    int64_t checkpoint_span;
+    /** checkpoints sorted by output offset */
+    struct inflate_checkpoint_array checkpoints;
+    /** set when checkpoints cover the whole stream */
+    int checkpoints_complete;
+    /** sidecar key identifying the compressed contents, or NULL */
+    char *index_key;
+    int failed;
+    char error[256];
+};
+
+struct deflate_index_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t n_checkpoints;
+    int64_t in_size;
+    int64_t out_size;
+    int64_t checkpoint_span;
+};
+
+struct deflate_index_entry {
+    int64_t out_offset;
+    int64_t in_offset;
+    int32_t bits;
+    int32_t window_size;
+};
+
+static int
+inflate_data_source_error(struct inflate_data_source *ids,
+                          const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static int
+inflate_data_source_error(struct inflate_data_source *ids,
+                          const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(ids->error, sizeof (ids->error), fmt, ap);
+    va_end(ap);
+    ids->failed = TRUE;
+    return -1;
+}
+
+static void
+inflate_extent_end_stream(struct inflate_extent *x)
+{
+    if (NULL != x->zs) {
+        inflateEnd(x->zs);
+        free(x->zs);
+        x->zs = NULL;
+    }
+}
+
+static void
+inflate_extent_free(struct inflate_extent *x)
+{
+    inflate_extent_end_stream(x);
+    free(x);
+}
+
+/**
+ * @brief merge extent @ref x with the next extent, that it just
+ * reached
+ *
+ * The merged extent keeps going with the stream of the next extent.
+ */
+static void
+inflate_extent_merge_next(struct inflate_extent *x)
+{
+    struct inflate_extent *next;
+
+    next = x->next;
+    assert(x->out_end == next->out_start);
+    inflate_extent_end_stream(x);
+    x->out_end = next->out_end;
+    x->in_offset = next->in_offset;
+    x->last_checkpoint = next->last_checkpoint;
+    x->zs = next->zs;
+    x->next = next->next;
+    free(next);
+}
+
+static void
+inflate_data_source_free_checkpoints(struct inflate_data_source *ids)
+{
+    struct inflate_checkpoint *cp;
+
+    if (NULL == ids->checkpoints.data) {
+        return ;
+    }
+    ARRAY_FOREACH(&ids->checkpoints, cp) {
+        free(cp->window);
+    }
+    ARRAY_DESTROY(&ids->checkpoints);
+    memset(&ids->checkpoints, 0, sizeof (ids->checkpoints));
+}
+
+static void
+inflate_data_source_add_checkpoint(struct inflate_data_source *ids,
+                                   struct inflate_extent *x)
+{
+    struct inflate_checkpoint cp;
+
+    cp.out_offset = x->out_end;
+    cp.in_offset = x->in_offset - ids->in_start_offset;
+    cp.bits = x->zs->data_type & 7;
+    cp.window_size = (int)MIN(x->out_end, INFLATE_WINDOW_SIZE);
+    cp.window = malloc_safe(cp.window_size);
+    memcpy(cp.window, ids->output + x->out_end - cp.window_size,
+           cp.window_size);
+    ARRAY_PUSH(&ids->checkpoints, cp);
+    x->last_checkpoint = x->out_end;
+}
+
+/**
+ * @brief find the last checkpoint at or before output @ref offset
+ */
+static const struct inflate_checkpoint *
+inflate_data_source_lookup_checkpoint(struct inflate_data_source *ids,
+                                      int64_t offset)
+{
+    size_t lo, hi, mid;
+
+    lo = 0;
+    hi = ARRAY_SIZE(&ids->checkpoints);
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (ARRAY_ITEM(&ids->checkpoints, mid).out_offset <= offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo > 0 ? &ARRAY_ITEM(&ids->checkpoints, lo - 1) : NULL;
+}
+
+static void
+inflate_data_source_save_index(struct inflate_data_source *ids)
+{
+    struct sidecar_writer writer;
+    struct deflate_index_header header;
+    struct deflate_index_entry entry;
+    struct inflate_checkpoint *cp;
+
+    if (NULL == ids->index_key
+        || -1 == sidecar_create("deflate", ids->index_key, &writer)) {
+        return ;
+    }
+    memset(&header, 0, sizeof (header));
+    memcpy(header.magic, DEFLATE_INDEX_MAGIC, sizeof (header.magic));
+    header.version = DEFLATE_INDEX_VERSION;
+    header.n_checkpoints = (uint32_t)ARRAY_SIZE(&ids->checkpoints);
+    header.in_size = ids->in_end_offset - ids->in_start_offset;
+    header.out_size = (int64_t)ids->ds.ds_data_length;
+    header.checkpoint_span = ids->checkpoint_span;
+    if (1 != fwrite(&header, sizeof (header), 1, writer.file)) {
+        sidecar_abort(&writer);
+        return ;
+    }
+    if (NULL != ids->checkpoints.data) {
+        ARRAY_FOREACH(&ids->checkpoints, cp) {
+            memset(&entry, 0, sizeof (entry));
+            entry.out_offset = cp->out_offset;
+            entry.in_offset = cp->in_offset;
+            entry.bits = cp->bits;
+            entry.window_size = cp->window_size;
+            if (1 != fwrite(&entry, sizeof (entry), 1, writer.file)
+                || 1 != fwrite(cp->window, cp->window_size, 1,
+                               writer.file)) {
+                sidecar_abort(&writer);
+                return ;
+            }
+        }
+    }
+    (void) sidecar_commit(&writer);
+}
+
+static int
+inflate_data_source_read_index(struct inflate_data_source *ids, FILE *file)
+{
+    struct deflate_index_header header;
+    struct deflate_index_entry entry;
+    struct inflate_checkpoint cp;
+    int64_t in_size;
+    int64_t out_size;
+    int64_t last_out_offset;
+    uint32_t i;
+
+    in_size = ids->in_end_offset - ids->in_start_offset;
+    out_size = (int64_t)ids->ds.ds_data_length;
+    if (1 != fread(&header, sizeof (header), 1, file)
+        || 0 != memcmp(header.magic, DEFLATE_INDEX_MAGIC,
+                       sizeof (header.magic))
+        || DEFLATE_INDEX_VERSION != header.version
+        || in_size != header.in_size
+        || out_size != header.out_size) {
+        return -1;
+    }
+    last_out_offset = 0;
+    for (i = 0; i < header.n_checkpoints; ++i) {
+        if (1 != fread(&entry, sizeof (entry), 1, file)
+            || entry.out_offset <= last_out_offset
+            || entry.out_offset > out_size
+            || entry.in_offset <= 0 || entry.in_offset > in_size
+            || entry.bits < 0 || entry.bits > 7
+            || entry.window_size !=
+            MIN(entry.out_offset, INFLATE_WINDOW_SIZE)) {
+            return -1;
+        }
+        cp.out_offset = entry.out_offset;
+        cp.in_offset = entry.in_offset;
+        cp.bits = entry.bits;
+        cp.window_size = entry.window_size;
+        cp.window = malloc_safe(cp.window_size);
+        if (1 != fread(cp.window, cp.window_size, 1, file)) {
+            free(cp.window);
+            return -1;
+        }
+        ARRAY_PUSH(&ids->checkpoints, cp);
+        last_out_offset = entry.out_offset;
+    }
+    return 0;
+}
+
+/**
+ * @brief load checkpoints saved by a previous session, if any
+ */
+static void
+inflate_data_source_load_index(struct inflate_data_source *ids)
+{
+    FILE *file;
+
+    file = sidecar_open("deflate", ids->index_key);
+    if (NULL == file) {
+        return ;
+    }
+    if (0 == inflate_data_source_read_index(ids, file)) {
+        ids->checkpoints_complete = TRUE;
+    } else {
+        // stale or corrupted index, it will be rebuilt
+        inflate_data_source_free_checkpoints(ids);
+    }
+    (void) fclose(file);
+}
+
+/**
+ * @brief compute the sidecar key of the compressed contents
+ *
+ * The key is made of the index key of the input data source and the
+ * compressed range and inflated size, so that the compressed data
+ * does not need to be read for it. Input data sources without an
+ * index key (e.g. in memory) get no sidecar.
+ */
+static int
+inflate_data_source_compute_index_key(struct inflate_data_source *ids)
+{
+    char *ds_key;
+
+    ds_key = bitpunch_data_source_get_index_key(ids->ds_in);
+    if (NULL == ds_key) {
+        return -1;
+    }
+    if (-1 == asprintf(&ids->index_key, "%s-%"PRIx64"-%"PRIx64"-%"PRIx64,
+                       ds_key, ids->in_start_offset,
+                       ids->in_end_offset - ids->in_start_offset,
+                       (int64_t)ids->ds.ds_data_length)) {
+        ids->index_key = NULL;
+        free(ds_key);
+        return -1;
+    }
+    free(ds_key);
+    return 0;
+}
+
+static struct inflate_extent *
+inflate_extent_new(struct inflate_data_source *ids)
+{
+    struct inflate_extent *x;
+    int zret;
+
+    x = new_safe(struct inflate_extent);
+    x->zs = new_safe(z_stream);
+    // set windowBits to a negative value to request raw (headerless)
+    // inflate, and 2^15 as a higher bound to be compatible with any
+    // window size used during compression
+    zret = inflateInit2(x->zs, -15);
+    if (Z_OK != zret) {
+        (void) inflate_data_source_error(
+            ids, "error from inflateInit(): %s (%d)",
+            NULL != x->zs->msg ? x->zs->msg : "", zret);
+        free(x->zs);
+        free(x);
+        return NULL;
+    }
+    return x;
+}
+
+/**
+ * @brief start a new extent after @ref prev, resuming inflate from
+ * checkpoint @ref cp
+ */
+static struct inflate_extent *
+inflate_extent_new_from_checkpoint(struct inflate_data_source *ids,
+                                   struct inflate_extent *prev,
+                                   const struct inflate_checkpoint *cp)
+{
+    struct inflate_extent *x;
+    unsigned char byte;
+    int64_t window_start;
+
+    x = inflate_extent_new(ids);
+    if (NULL == x) {
+        return NULL;
+    }
+    x->in_offset = ids->in_start_offset + cp->in_offset;
+    if (cp->bits > 0) {
+        if (-1 == bitpunch_data_source_read_range(
+                ids->ds_in, x->in_offset - 1, 1, (char *)&byte)) {
+            (void) inflate_data_source_error(
+                ids, "error reading compressed data at offset %"PRIi64,
+                x->in_offset - 1);
+            inflate_extent_free(x);
+            return NULL;
+        }
+        (void) inflatePrime(x->zs, cp->bits, byte >> (8 - cp->bits));
+    }
+    (void) inflateSetDictionary(x->zs, cp->window, cp->window_size);
+    // the window is inflated output as well
+    window_start = MAX(cp->out_offset - cp->window_size, prev->out_end);
+    memcpy(ids->output + window_start,
+           cp->window + cp->window_size - (cp->out_offset - window_start),
+           cp->out_offset - window_start);
+    x->out_start = window_start;
+    x->out_end = cp->out_offset;
+    x->last_checkpoint = cp->out_offset;
+    x->next = prev->next;
+    prev->next = x;
+    return x;
+}
+
+/**
+ * @brief extend extent @ref x up to @ref end_offset of output
+ *
+ * When the whole output gets inflated, also check that the stream
+ * ends exactly there.
+ */
+static int
+inflate_extent_fill(struct inflate_data_source *ids,
+                    struct inflate_extent *x, int64_t end_offset)
+{
+    int64_t output_size;
+    int64_t limit;
+    int64_t in_length;
+    struct bitpunch_data_pin pin;
+    const char *in_data;
+    char overflow_byte;
+    int record_checkpoints;
+    int zret;
+
+    output_size = (int64_t)ids->ds.ds_data_length;
+    record_checkpoints = (0 != ids->checkpoint_span
+                          && !ids->checkpoints_complete
+                          && 0 == x->out_start);
+    while (TRUE) {
+        while (NULL != x->next && x->out_end == x->next->out_start) {
+            inflate_extent_merge_next(x);
+        }
+        if (NULL == x->zs
+            || (x->out_end >= end_offset && x->out_end != output_size)) {
+            break ;
+        }
+        limit = (NULL != x->next ? x->next->out_start : output_size);
+        in_length = MIN(INFLATE_INPUT_CHUNK_SIZE,
+                        ids->in_end_offset - x->in_offset);
+        if (-1 == bitpunch_data_source_pin_range(
+                ids->ds_in, x->in_offset, in_length, &pin, &in_data)) {
+            return inflate_data_source_error(
+                ids, "error reading compressed data at offset %"PRIi64,
+                x->in_offset);
+        }
+        x->zs->next_in = (z_const Bytef *)in_data;
+        x->zs->avail_in = (uInt)in_length;
+        if (x->out_end < limit) {
+            x->zs->next_out = (Bytef *)ids->output + x->out_end;
+            x->zs->avail_out = (uInt)
+                MIN(limit - x->out_end,
+                    MAX(end_offset - x->out_end, INFLATE_OUTPUT_STEP));
+        } else {
+            // output is complete, only check that the stream ends
+            x->zs->next_out = (Bytef *)&overflow_byte;
+            x->zs->avail_out = 1;
+        }
+        // Z_BLOCK returns at the end of each deflate block, so that
+        // checkpoints can be taken there
+        zret = inflate(x->zs, record_checkpoints ? Z_BLOCK : Z_NO_FLUSH);
+        x->in_offset += in_length - x->zs->avail_in;
+        bitpunch_data_source_unpin(ids->ds_in, &pin);
+        if (x->out_end < limit) {
+            x->out_end = (char *)x->zs->next_out - ids->output;
+        } else if (0 == x->zs->avail_out) {
+            return inflate_data_source_error(
+                ids, "inflated data is larger than output size "
+                "(%"PRIi64" bytes)", output_size);
+        }
+        switch (zret) {
+        case Z_OK:
+            if (record_checkpoints
+                && 0 != (x->zs->data_type & 128)
+                && 0 == (x->zs->data_type & 64)
+                && x->out_end - x->last_checkpoint >= ids->checkpoint_span) {
+                inflate_data_source_add_checkpoint(ids, x);
+            }
+            break ;
+        case Z_STREAM_END:
+            if (x->out_end != output_size) {
+                return inflate_data_source_error(
+                    ids, "inflate() did not fill the output buffer: "
+                    "%"PRIi64" bytes left (with %"PRIi64" input bytes "
+                    "unread)", output_size - x->out_end,
+                    ids->in_end_offset - x->in_offset);
+            }
+            inflate_extent_end_stream(x);
+            if (record_checkpoints) {
+                ids->checkpoints_complete = TRUE;
+                inflate_data_source_save_index(ids);
+            }
+            break ;
+        case Z_BUF_ERROR:
+            return inflate_data_source_error(
+                ids, "truncated compressed data (%"PRIi64" bytes "
+                "inflated out of %"PRIi64")",
+                x->out_end, output_size);
+        default:
+            return inflate_data_source_error(
+                ids, "error from inflate(): %s (%d)",
+                NULL != x->zs->msg ? x->zs->msg : "", zret);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief make output range [@ref start_offset, @ref end_offset[
+ * available
+ *
+ * @param[out] extentp extent containing the range
+ */
+static int
+inflate_data_source_fill(struct inflate_data_source *ids,
+                         int64_t start_offset, int64_t end_offset,
+                         struct inflate_extent **extentp)
+{
+    struct inflate_extent *x;
+    const struct inflate_checkpoint *cp;
+    int64_t output_size;
+
+    if (ids->failed) {
+        return -1;
+    }
+    output_size = (int64_t)ids->ds.ds_data_length;
+    while (TRUE) {
+        x = ids->extents;
+        while (NULL != x->next && x->next->out_start <= start_offset) {
+            x = x->next;
+        }
+        if (x->out_end >= end_offset
+            && (NULL == x->zs || x->out_end != output_size)) {
+            *extentp = x;
+            return 0;
+        }
+        cp = inflate_data_source_lookup_checkpoint(ids, start_offset);
+        if (NULL != cp && cp->out_offset > x->out_end) {
+            // resuming from the checkpoint is closer than going on
+            // from the end of the current extent
+            x = inflate_extent_new_from_checkpoint(ids, x, cp);
+            if (NULL == x) {
+                return -1;
+            }
+        }
+        if (-1 == inflate_extent_fill(ids, x, end_offset)) {
+            return -1;
+        }
+    }
+    /*NOT REACHED*/
+}
+
+static int
+inflate_data_source_pin_range(struct bitpunch_data_source *ds,
+                              int64_t offset, int64_t length,
+                              struct bitpunch_data_pin *pin)
+{
+    struct inflate_data_source *ids;
+    struct inflate_extent *x;
+    int64_t out_start;
+    int64_t out_end;
+
+    ids = (struct inflate_data_source *)ds;
+    pthread_mutex_lock(&ids->lock);
+    if (-1 == inflate_data_source_fill(ids, offset, offset + length, &x)) {
+        fprintf(stderr, "Unable to inflate data: %s\n", ids->error);
+        pthread_mutex_unlock(&ids->lock);
+        return -1;
+    }
+    // the extent may be merged and freed by another thread once
+    // unlocked, but the output it covers stays inflated
+    out_start = x->out_start;
+    out_end = x->out_end;
+    pthread_mutex_unlock(&ids->lock);
+    // inflated data is never discarded, no need for a pin handle
+    pin->base = ids->output + out_start;
+    pin->start_offset = out_start;
+    pin->end_offset = out_end;
+    pin->handle = NULL;
+    return 0;
+}
+
+static int
+inflate_data_source_read_range(struct bitpunch_data_source *ds,
+                               int64_t offset, int64_t length, char *buf)
+{
+    struct inflate_data_source *ids;
+    struct inflate_extent *x;
+
+    ids = (struct inflate_data_source *)ds;
+    pthread_mutex_lock(&ids->lock);
+    if (-1 == inflate_data_source_fill(ids, offset, offset + length, &x)) {
+        fprintf(stderr, "Unable to inflate data: %s\n", ids->error);
+        pthread_mutex_unlock(&ids->lock);
+        return -1;
+    }
+    memcpy(buf, ids->output + offset, length);
+    pthread_mutex_unlock(&ids->lock);
+    return 0;
+}
+
+static void
+inflate_data_source_unpin(struct bitpunch_data_source *ds,
+                          struct bitpunch_data_pin *pin)
+{
+}
+
+static char *
+inflate_data_source_get_index_key(struct bitpunch_data_source *ds)
+{
+    struct inflate_data_source *ids;
+    char *key;
+
+    ids = (struct inflate_data_source *)ds;
+    if (NULL == ids->index_key
+        || -1 == asprintf(&key, "deflate-%s", ids->index_key)) {
+        return NULL;
+    }
+    return key;
+}
+
+static int
+inflate_data_source_close(struct bitpunch_data_source *ds)
+{
+    struct inflate_data_source *ids;
+    struct inflate_extent *x;
+
+    ids = (struct inflate_data_source *)ds;
+    while (NULL != ids->extents) {
+        x = ids->extents;
+        ids->extents = x->next;
+        inflate_extent_free(x);
+    }
+    inflate_data_source_free_checkpoints(ids);
+    free(ids->index_key);
+    if (NULL != ids->output) {
+        (void) munmap(ids->output, ids->ds.ds_data_length);
+    }
+    pthread_mutex_destroy(&ids->lock);
+    return bitpunch_data_source_release(ids->ds_in);
+}
+
 static bitpunch_status_t
 deflate_read(
     struct ast_node_hdl *filter,
     struct box *scope,
-    const char *buffer, size_t buffer_size,
+    int64_t item_offset,
+    int64_t item_size,
     expr_value_t *valuep,
     struct browse_state *bst)
 {
     bitpunch_status_t bt_ret;
-    int zret;
-    z_stream zs;
     expr_value_t attr_value;
     int64_t inflated_size;
-    struct bitpunch_data_source *inflated;
+    int64_t checkpoint_span;
+    struct inflate_data_source *ids;
+    struct inflate_extent *x;
 
     bt_ret = filter_evaluate_attribute_internal(
         filter, scope, "@output_size", 0u, NULL, &attr_value, NULL, bst);
@@ -67,42 +732,72 @@ deflate_read(
                           "inflated size too large (%zu bytes, max %d)",
                           inflated_size, INFLATED_MAX_SIZE);
     }
-    zs.next_in = (z_const Bytef *)buffer;
-    zs.avail_in = (uLong)buffer_size;
-    zs.zalloc = Z_NULL;
-    zs.zfree = Z_NULL;
-    zs.opaque = Z_NULL;
+    bt_ret = filter_evaluate_attribute_internal(
+        filter, scope, "@checkpoint_span", 0u, NULL, &attr_value, NULL, bst);
+    if (BITPUNCH_OK == bt_ret) {
+        checkpoint_span = attr_value.integer;
+        if (checkpoint_span < 0) {
+            return node_error(BITPUNCH_DATA_ERROR, filter, bst,
+                              "invalid checkpoint span (%"PRIi64")",
+                              checkpoint_span);
+        }
+    } else if (BITPUNCH_NO_ITEM == bt_ret) {
+        checkpoint_span = INFLATE_DEFAULT_CHECKPOINT_SPAN;
+    } else {
+        return bt_ret;
+    }
+    ids = new_safe(struct inflate_data_source);
+    pthread_mutex_init(&ids->lock, NULL);
+    ids->ds.use_count = 1;
+    ids->ds.backend.close = inflate_data_source_close;
+    ids->ds.backend.get_index_key = inflate_data_source_get_index_key;
+    ids->ds.backend.read_range = inflate_data_source_read_range;
+    ids->ds.backend.pin_range = inflate_data_source_pin_range;
+    ids->ds.backend.unpin = inflate_data_source_unpin;
+    ids->ds.ds_data_length = (size_t)inflated_size;
+    ids->ds_in = scope->ds_in;
+    bitpunch_data_source_acquire(ids->ds_in);
+    ids->in_start_offset = item_offset;
+    ids->in_end_offset = item_offset + item_size;
 
-    // set windowBits to a negative value to request raw (headerless)
-    // inflate, and 2^15 as a higher bound to be compatible with any
-    // window size used during compression
-    zret = inflateInit2(&zs, -15);
-    if (Z_OK != zret) {
-        return node_error(BITPUNCH_DATA_ERROR, filter, bst,
-                          "error from inflateInit(): %s (%d)",
-                          zs.msg, zret);
-    }
-    bitpunch_buffer_new(&inflated, inflated_size);
-    zs.next_out = (Bytef *)inflated->ds_data;
-    zs.avail_out = (uInt)inflated_size;
-    zret = inflate(&zs, Z_FINISH);
-    if (Z_STREAM_END != zret) {
-        node_error(BITPUNCH_DATA_ERROR, filter, bst,
-                   "error from inflate(): %s (%d)",
-                   zs.msg, zret);
-        inflateEnd(&zs);
+    ids->extents = inflate_extent_new(ids);
+    if (NULL == ids->extents) {
+        node_error(BITPUNCH_DATA_ERROR, filter, bst, "%s", ids->error);
+        (void) bitpunch_data_source_release(&ids->ds);
         return BITPUNCH_DATA_ERROR;
     }
-    if (zs.avail_out != 0) {
-        node_error(BITPUNCH_DATA_ERROR, filter, bst,
-                   "inflate() did not fill the output buffer: "
-                   "%u bytes left (with %u input bytes unread)",
-                   zs.avail_out, zs.avail_in);
-        inflateEnd(&zs);
+    ids->extents->in_offset = item_offset;
+    if (inflated_size > 0) {
+        ids->output = mmap(NULL, (size_t)inflated_size,
+                           PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                           -1, 0);
+        if (MAP_FAILED == ids->output) {
+            ids->output = NULL;
+            node_error(BITPUNCH_DATA_ERROR, filter, bst,
+                       "unable to reserve %"PRIi64" bytes for inflated "
+                       "data: %s", inflated_size, strerror(errno));
+            (void) bitpunch_data_source_release(&ids->ds);
+            return BITPUNCH_DATA_ERROR;
+        }
+    }
+    // checkpoints are only worth keeping when they can be reused by
+    // later sessions through a sidecar index
+    if (checkpoint_span > 0 && inflated_size > checkpoint_span
+        && sidecar_enabled()
+        && 0 == inflate_data_source_compute_index_key(ids)) {
+        ids->checkpoint_span = checkpoint_span;
+        inflate_data_source_load_index(ids);
+    }
+    // inflate the beginning of the stream now, so that invalid
+    // streams get reported when reading the filtered value
+    if (-1 == inflate_data_source_fill(
+            ids, 0, MIN(inflated_size, INFLATE_OUTPUT_STEP), &x)) {
+        node_error(BITPUNCH_DATA_ERROR, filter, bst, "%s", ids->error);
+        (void) bitpunch_data_source_release(&ids->ds);
         return BITPUNCH_DATA_ERROR;
     }
-    inflateEnd(&zs);
-    *valuep = expr_value_as_data(inflated);
+    *valuep = expr_value_as_data(&ids->ds);
     return BITPUNCH_OK;
 }
 
@@ -112,7 +807,7 @@ deflate_filter_instance_build(struct ast_node_hdl *filter)
     struct filter_instance *f_instance;
 
     f_instance = new_safe(struct filter_instance);
-    f_instance->b_item.read_value_from_buffer = deflate_read;
+    f_instance->b_item.read_value = deflate_read;
     return f_instance;
 }
 
@@ -124,9 +819,11 @@ builtin_filter_declare_deflate(void)
     ret = builtin_filter_declare("deflate",
                                EXPR_VALUE_TYPE_BYTES,
                                deflate_filter_instance_build, NULL,
-                               0u,
-                               1,
+                               FILTER_CLASS_CACHED_OUTPUT,
+                               2,
                                "@output_size", EXPR_VALUE_TYPE_INTEGER,
-                               FILTER_ATTR_MANDATORY);
+                               FILTER_ATTR_MANDATORY,
+                               "@checkpoint_span", EXPR_VALUE_TYPE_INTEGER,
+                               0);
     assert(0 == ret);
 }
@@ -34,6 +34,9 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <endian.h>
 
 #include "core/filter.h"
 #include "core/print.h"
@@ -98,59 +101,112 @@ node_error_with_data_context(
     return BITPUNCH_DATA_ERROR;
 }
 
+/*
+ * SWAR kernels
+ *
+ * Eight characters are loaded in a little-endian 64-bit word (first
+ * character in the lowest byte), validated and converted at once for
+ * the common bases. A word containing any character that is not a
+ * digit of the base is left to the byte-by-byte loop, which reports
+ * the exact error.
+ */
+
+#define SWAR_ONES           0x0101010101010101ull
+#define SWAR_HIGH_BITS      0x8080808080808080ull
+#define SWAR_LOW_NIBBLES    0x0f0f0f0f0f0f0f0full
+#define SWAR_SPLAT(c)       (SWAR_ONES * (uint8_t)(c))
+
+/**
+ * @brief set the high bit of each byte of @ref word (all bytes below
+ * 0x80) that is in [@ref lo, @ref hi]
+ */
+static inline uint64_t
+swar_in_range(uint64_t word, uint8_t lo, uint8_t hi)
+{
+    return ((word + SWAR_SPLAT(0x80 - lo))
+            & (SWAR_SPLAT(0x80 + hi) - word) & SWAR_HIGH_BITS);
+}
+
+/**
+ * @brief combine eight digits (one per byte, most significant first)
+ * of a power-of-two base 2^@ref shift
+ */
+static inline uint64_t
+swar_combine_pow2(uint64_t digits, int shift)
+{
+    digits = ((digits << shift) + (digits >> 8)) & 0x00ff00ff00ff00ffull;
+    digits = (((digits << (2 * shift)) + (digits >> 16))
+              & 0x0000ffff0000ffffull);
+    return ((digits << (4 * shift)) + (digits >> 32)) & 0xffffffffull;
+}
+
+static inline int64_t
+swar_parse8__base8(uint64_t word)
+{
+    if ((word & SWAR_SPLAT(0xf8)) != SWAR_SPLAT('0')) {
+        return -1;
+    }
+    return swar_combine_pow2(word - SWAR_SPLAT('0'), 3);
+}
+
+static inline int64_t
+swar_parse8__base10(uint64_t word)
+{
+    uint64_t digits;
+
+    if (((word & SWAR_SPLAT(0xf0))
+         | (((word + SWAR_SPLAT(0x06)) & SWAR_SPLAT(0xf0)) >> 4))
+        != SWAR_SPLAT(0x33)) {
+        return -1;
+    }
+    digits = word - SWAR_SPLAT('0');
+    digits = (digits * 10) + (digits >> 8);
+    return (((digits & 0x000000ff000000ffull)
+             * (100 + (1000000ull << 32))
+             + ((digits >> 16) & 0x000000ff000000ffull)
+             * (1 + (10000ull << 32))) >> 32);
+}
+
+static inline int64_t
+swar_parse8__base16(uint64_t word)
+{
+    uint64_t is_digit;
+    uint64_t is_letter;
+
+    if (0 != (word & SWAR_HIGH_BITS)) {
+        return -1;
+    }
+    is_digit = swar_in_range(word, '0', '9');
+    is_letter = swar_in_range(word | SWAR_SPLAT(0x20), 'a', 'f');
+    if ((is_digit | is_letter) != SWAR_HIGH_BITS) {
+        return -1;
+    }
+    // '0'-'9' map to their low nibble, 'a'-'f' and 'A'-'F' to their
+    // low nibble plus 9
+    return swar_combine_pow2(
+        (word & SWAR_LOW_NIBBLES) + (is_letter >> 7) * 9, 4);
+}
+
+/**
+ * @brief parse the digits of a non-empty formatted integer
+ */
 static bitpunch_status_t
-formatted_integer_read(
+formatted_integer_parse(
     struct ast_node_hdl *filter,
-    struct box *scope,
     const char *buffer, size_t buffer_size,
+    int base, int _signed,
     expr_value_t *valuep,
     struct browse_state *bst)
 {
     static const char *preamble = "invalid formatted integer";
-    bitpunch_status_t bt_ret;
-    expr_value_t attr_value;
-    int base;
     int64_t parsed_value;
-    int64_t prev_parsed_value;
+    int64_t block_value;
+    int64_t base_pow8;
     int lookup_value;
     const unsigned char *in;
     const unsigned char *end;
-    int _signed;
     int negative;
 
-    // we're not using strtoll() because that would involve using a
-    // temporary null-terminated buffer, and strtoll() is too lax
-    // regarding validity checks for our purpose: basically the buffer
-    // has to represent a valid formatted number in its entirety.
-
-    bt_ret = filter_evaluate_attribute_internal(
-        filter, scope, "@base", 0u, NULL, &attr_value, NULL, bst);
-    if (BITPUNCH_OK == bt_ret) {
-        base = attr_value.integer;
-    } else if (BITPUNCH_NO_ITEM == bt_ret) {
-        base = 10;
-    } else {
-        return bt_ret;
-    }
-    bt_ret = filter_evaluate_attribute_internal(
-        filter, scope, "@signed", 0u, NULL, &attr_value, NULL, bst);
-    if (BITPUNCH_OK == bt_ret) {
-        _signed = attr_value.boolean;
-    } else if (BITPUNCH_NO_ITEM == bt_ret) {
-        _signed = TRUE;
-    } else {
-        return bt_ret;
-    }
-    if (0 == buffer_size) {
-        bt_ret = filter_evaluate_attribute_internal(
-            filter, scope, "@empty_value", 0u, NULL, valuep, NULL, bst);
-        if (BITPUNCH_NO_ITEM != bt_ret) {
-            return bt_ret;
-        }
-        return node_error_with_data_context(
-            filter, bst, buffer, buffer_size,
-            "%s: empty buffer", preamble);
-    }
     negative = FALSE;
     in = (const unsigned char *)buffer;
     end = in + buffer_size;
@@ -188,7 +244,49 @@ formatted_integer_read(
 
   parse:
     parsed_value = 0;
-    for (; in < end; ++in) {
+    switch (base) {
+    case 8:
+        base_pow8 = 1ll << 24;
+        break ;
+    case 10:
+        base_pow8 = 100000000ll;
+        break ;
+    case 16:
+        base_pow8 = 1ll << 32;
+        break ;
+    default:
+        base_pow8 = 0;
+        break ;
+    }
+    while (in < end) {
+        if (0 != base_pow8 && end - in >= 8) {
+            uint64_t word;
+
+            memcpy(&word, in, sizeof (word));
+            word = le64toh(word);
+            switch (base) {
+            case 8:
+                block_value = swar_parse8__base8(word);
+                break ;
+            case 10:
+                block_value = swar_parse8__base10(word);
+                break ;
+            default: /* 16 */
+                block_value = swar_parse8__base16(word);
+                break ;
+            }
+            if (-1 != block_value) {
+                if (__builtin_mul_overflow(parsed_value, base_pow8,
+                                           &parsed_value)
+                    || __builtin_add_overflow(parsed_value, block_value,
+                                              &parsed_value)) {
+                    goto overflow;
+                }
+                in += 8;
+                continue ;
+            }
+            // fall back to the byte-by-byte loop for this word
+        }
         lookup_value = lookup[*in];
         switch (lookup_value) {
         case PLUS_SIGN:
@@ -205,23 +303,116 @@ formatted_integer_read(
                 filter, bst, buffer, buffer_size,
                 "%s: digit not in base %d", preamble, base);
         }
-        prev_parsed_value = parsed_value;
-        parsed_value *= base;
-        parsed_value += lookup_value;
-        if (parsed_value < prev_parsed_value) {
-            return node_error_with_data_context(
-                filter, bst, buffer, buffer_size,
-                "unsupported formatted integer: "
-                "overflows a 64-bit signed integer value");
+        if (__builtin_mul_overflow(parsed_value, base, &parsed_value)
+            || __builtin_add_overflow(parsed_value, lookup_value,
+                                      &parsed_value)) {
+            goto overflow;
         }
+        ++in;
     }
     valuep->type = EXPR_VALUE_TYPE_INTEGER;
     valuep->integer = negative ? -parsed_value : parsed_value;
     return BITPUNCH_OK;
+
+  overflow:
+    return node_error_with_data_context(
+        filter, bst, buffer, buffer_size,
+        "unsupported formatted integer: "
+        "overflows a 64-bit signed integer value");
+}
+
+static bitpunch_status_t
+formatted_integer_read(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *buffer, size_t buffer_size,
+    expr_value_t *valuep,
+    struct browse_state *bst)
+{
+    static const char *preamble = "invalid formatted integer";
+    bitpunch_status_t bt_ret;
+    expr_value_t attr_value;
+    int base;
+    int _signed;
+
+    // we're not using strtoll() because that would involve using a
+    // temporary null-terminated buffer, and strtoll() is too lax
+    // regarding validity checks for our purpose: basically the buffer
+    // has to represent a valid formatted number in its entirety.
+
+    bt_ret = filter_evaluate_attribute_internal(
+        filter, scope, "@base", 0u, NULL, &attr_value, NULL, bst);
+    if (BITPUNCH_OK == bt_ret) {
+        base = attr_value.integer;
+    } else if (BITPUNCH_NO_ITEM == bt_ret) {
+        base = 10;
+    } else {
+        return bt_ret;
+    }
+    bt_ret = filter_evaluate_attribute_internal(
+        filter, scope, "@signed", 0u, NULL, &attr_value, NULL, bst);
+    if (BITPUNCH_OK == bt_ret) {
+        _signed = attr_value.boolean;
+    } else if (BITPUNCH_NO_ITEM == bt_ret) {
+        _signed = TRUE;
+    } else {
+        return bt_ret;
+    }
+    if (0 == buffer_size) {
+        bt_ret = filter_evaluate_attribute_internal(
+            filter, scope, "@empty_value", 0u, NULL, valuep, NULL, bst);
+        if (BITPUNCH_NO_ITEM != bt_ret) {
+            return bt_ret;
+        }
+        return node_error_with_data_context(
+            filter, bst, buffer, buffer_size,
+            "%s: empty buffer", preamble);
+    }
+    return formatted_integer_parse(filter, buffer, buffer_size,
+                                   base, _signed, valuep, bst);
+}
+
+/**
+ * @brief formatted_integer filter instance with @base, @signed and
+ * @empty_value known at compile time
+ */
+struct formatted_integer_constant_attributes {
+    struct filter_instance p; /* inherits */
+    int base;
+    int _signed;
+    int has_empty_value;
+    int64_t empty_value;
+};
+
+static bitpunch_status_t
+formatted_integer_read_constant_attributes(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *buffer, size_t buffer_size,
+    expr_value_t *valuep,
+    struct browse_state *bst)
+{
+    struct formatted_integer_constant_attributes *f_instance;
+
+    f_instance = (struct formatted_integer_constant_attributes *)
+        filter->ndat->u.rexpr_filter.f_instance;
+    if (0 == buffer_size) {
+        if (f_instance->has_empty_value) {
+            valuep->type = EXPR_VALUE_TYPE_INTEGER;
+            valuep->integer = f_instance->empty_value;
+            return BITPUNCH_OK;
+        }
+        return node_error_with_data_context(
+            filter, bst, buffer, buffer_size,
+            "invalid formatted integer: empty buffer");
+    }
+    return formatted_integer_parse(filter, buffer, buffer_size,
+                                   f_instance->base, f_instance->_signed,
+                                   valuep, bst);
 }
 
 static struct filter_instance *
-formatted_integer_filter_instance_build(struct ast_node_hdl *filter)
+formatted_integer_build_generic(void)
 {
     struct filter_instance *f_instance;
 
@@ -230,6 +421,44 @@ formatted_integer_filter_instance_build(struct ast_node_hdl *filter)
     return f_instance;
 }
 
+static struct filter_instance *
+formatted_integer_filter_instance_build(struct ast_node_hdl *filter)
+{
+    struct formatted_integer_constant_attributes *f_instance;
+    bitpunch_status_t bt_ret;
+    expr_value_t base_value;
+    expr_value_t signed_value;
+    expr_value_t empty_value;
+
+    bt_ret = filter_get_constant_attribute(filter, "@base", &base_value);
+    if (BITPUNCH_NO_ITEM == bt_ret) {
+        base_value = expr_value_as_integer(10);
+    } else if (BITPUNCH_OK != bt_ret) {
+        return formatted_integer_build_generic();
+    }
+    bt_ret = filter_get_constant_attribute(filter, "@signed", &signed_value);
+    if (BITPUNCH_NO_ITEM == bt_ret) {
+        signed_value = expr_value_as_boolean(TRUE);
+    } else if (BITPUNCH_OK != bt_ret) {
+        return formatted_integer_build_generic();
+    }
+    bt_ret = filter_get_constant_attribute(filter, "@empty_value",
+                                           &empty_value);
+    if (BITPUNCH_OK != bt_ret && BITPUNCH_NO_ITEM != bt_ret) {
+        return formatted_integer_build_generic();
+    }
+    f_instance = new_safe(struct formatted_integer_constant_attributes);
+    f_instance->base = base_value.integer;
+    f_instance->_signed = signed_value.boolean;
+    if (BITPUNCH_OK == bt_ret) {
+        f_instance->has_empty_value = TRUE;
+        f_instance->empty_value = empty_value.integer;
+    }
+    f_instance->p.b_item.read_value_from_buffer =
+        formatted_integer_read_constant_attributes;
+    return (struct filter_instance *)f_instance;
+}
+
 void
 builtin_filter_declare_formatted_integer(void)
 {
@@ -261,7 +490,10 @@ formatted_integer_read_test(expr_value_t *resultp,
 {
     struct filter_class *filter_cls;
     struct ast_node_hdl *filter;
+    struct filter_instance *f_instance;
     bitpunch_status_t bt_ret;
+    bitpunch_status_t bt_ret_constant;
+    expr_value_t result_constant;
 
     filter_cls = builtin_filter_lookup("formatted_integer");
     assert(NULL != filter_cls);
@@ -282,14 +514,70 @@ formatted_integer_read_test(expr_value_t *resultp,
     }
     bt_ret = formatted_integer_read(filter, NULL,
                                     buffer, strlen(buffer), resultp, NULL);
+
+    // attributes are now constant: the rebuilt instance must agree
+    // with the generic one
+    f_instance = formatted_integer_filter_instance_build(filter);
+    ck_assert_ptr_ne(f_instance, NULL);
+    ck_assert(f_instance->b_item.read_value_from_buffer
+              == formatted_integer_read_constant_attributes);
+    filter->ndat->u.rexpr_filter.f_instance = f_instance;
+    bt_ret_constant = f_instance->b_item.read_value_from_buffer(
+        filter, NULL, buffer, strlen(buffer), &result_constant, NULL);
+    ck_assert_int_eq(bt_ret_constant, bt_ret);
+
     if (BITPUNCH_OK == bt_ret) {
         ck_assert_int_eq(resultp->type, EXPR_VALUE_TYPE_INTEGER);
+        ck_assert_int_eq(result_constant.type, EXPR_VALUE_TYPE_INTEGER);
+        ck_assert_int_eq(result_constant.integer, resultp->integer);
         return 0;
     }
     ck_assert_int_eq(bt_ret, BITPUNCH_DATA_ERROR);
     return -1;
 }
 
+/**
+ * @brief digit-by-digit reference: 0 and value in *valuep if valid,
+ * -1 otherwise
+ */
+static int
+formatted_integer_reference(const char *buffer, int base, int64_t *valuep)
+{
+    const char *in;
+    __int128 value;
+    int negative;
+    int digit;
+
+    negative = FALSE;
+    for (in = buffer; '+' == *in || '-' == *in; ++in) {
+        negative ^= ('-' == *in);
+    }
+    if ('\0' == *in) {
+        return -1;
+    }
+    value = 0;
+    for (; '\0' != *in; ++in) {
+        if (*in >= '0' && *in <= '9') {
+            digit = *in - '0';
+        } else if (*in >= 'a' && *in <= 'f') {
+            digit = *in - 'a' + 10;
+        } else if (*in >= 'A' && *in <= 'F') {
+            digit = *in - 'A' + 10;
+        } else {
+            return -1;
+        }
+        if (digit >= base) {
+            return -1;
+        }
+        value = value * base + digit;
+        if (value > INT64_MAX) {
+            return -1;
+        }
+    }
+    *valuep = (int64_t)(negative ? -value : value);
+    return 0;
+}
+
 START_TEST(test_formatted_integer)
 {
     int ret;
@@ -374,12 +662,75 @@ START_TEST(test_formatted_integer)
 }
 END_TEST
 
+START_TEST(test_formatted_integer_swar)
+{
+    static const char *inputs[] = {
+        "12345670", "77777777", "012345670123",
+        "777777777777777777777", "1000000000000000000000",
+        "0000000000000000000000000000000777",
+        "12345678", "98765432", "00000000", "99999999",
+        "1234567890123456", "9223372036854775807",
+        "9223372036854775808", "-9223372036854775807",
+        "20496382304121724020", "18446744073709551616",
+        "99999999999999999999", "00000000000000000000009",
+        "123456789abcdef0", "DEADBEEFdeadbeef", "7fffffffffffffff",
+        "8000000000000000", "0000000000000000ffffffff",
+        "12345:78", "1234567/", "1234567@", "1234567G", "1234567g",
+        "123456`8", "1234 678", "12345678 ", "+12345678",
+        "--12345678", "1234567-8", "abcdefgh", "ABCDEFGH",
+        "1234567\x80", "\xb1\xb2\xb3\xb4\xb5\xb6\xb7\xb8",
+    };
+    static const int bases[] = { 2, 8, 10, 12, 16 };
+    static const char charset[] = "0123456789abcdefABCDEF+-:/@G ";
+    char random_input[40];
+    expr_value_t result;
+    int64_t expected;
+    int i, j, k, len;
+    int ret;
+
+    for (i = 0; i < N_ELEM(inputs); ++i) {
+        for (j = 0; j < N_ELEM(bases); ++j) {
+            ret = formatted_integer_read_test(&result, inputs[i],
+                                              bases[j], -1, -1);
+            ck_assert_int_eq(
+                ret, formatted_integer_reference(inputs[i], bases[j],
+                                                 &expected));
+            if (0 == ret) {
+                ck_assert_int_eq(result.integer, expected);
+            }
+        }
+    }
+    srandom(42);
+    for (i = 0; i < 2000; ++i) {
+        len = 1 + random() % (sizeof (random_input) - 1);
+        for (k = 0; k < len; ++k) {
+            // mostly digits so that a good share of inputs is valid
+            random_input[k] = (0 == random() % 64 ?
+                               charset[random() % (sizeof (charset) - 1)] :
+                               '0' + random() % 8);
+        }
+        random_input[len] = '\0';
+        for (j = 0; j < N_ELEM(bases); ++j) {
+            ret = formatted_integer_read_test(&result, random_input,
+                                              bases[j], -1, -1);
+            ck_assert_int_eq(
+                ret, formatted_integer_reference(random_input, bases[j],
+                                                 &expected));
+            if (0 == ret) {
+                ck_assert_int_eq(result.integer, expected);
+            }
+        }
+    }
+}
+END_TEST
+
 void check_formatted_integer_add_tcases(Suite *s)
 {
     TCase *tc_formatted_integer;
 
     tc_formatted_integer = tcase_create("formatted_integer");
     tcase_add_test(tc_formatted_integer, test_formatted_integer);
+    tcase_add_test(tc_formatted_integer, test_formatted_integer_swar);
     suite_add_tcase(s, tc_formatted_integer);
 }
 
@@ -36,6 +36,7 @@
 #include <stdint.h>
 #include <endian.h>
 
+#include "utils/int_decode.h"
 #include "filters/integer.h"
 
 enum endian str2endian(struct expr_value_string string)
@@ -56,172 +57,72 @@ enum endian str2endian(struct expr_value_string string)
 #define htole8(nb) (nb)
 
 
-#if 0 // optimized code that sets the ad-hoc function depending on the
-      // source, keep for later
+typedef int64_t (*binary_integer_read_func_t)(const char *buffer);
 
-#define GEN_RW_FUNCS(NBITS, ENDIAN_STR, SIGN)                           \
-    static int                                                          \
+#define GEN_READ_FUNC(NBITS, ENDIAN_STR, SIGN)                          \
+    static int64_t                                                      \
     binary_integer_read_##SIGN##int##NBITS##_##ENDIAN_STR(              \
-        expr_value_t *read_value,                                  \
-        const char *data, size_t span_size,                             \
-        const struct ast_node_hdl *attr_values)                            \
+        const char *buffer)                                             \
     {                                                                   \
-        read_value->integer = (int64_t)(SIGN##int##NBITS##_t)ENDIAN_STR##NBITS##toh(*(uint##NBITS##_t *)data); \
-        return 0;                                                       \
-    }                                                                   \
-                                                                        \
-    static int                                                          \
-    binary_integer_write_##SIGN##int##NBITS##_##ENDIAN_STR(             \
-        const expr_value_t *write_value,                           \
-        char *data, size_t span_size,                                   \
-        const struct ast_node_hdl *attr_values)                            \
-    {                                                                   \
-        *((uint##NBITS##_t *)data) = hto##ENDIAN_STR##NBITS((uint##NBITS##_t)write_value->integer); \
-        return 0;                                                       \
+        return (int64_t)(SIGN##int##NBITS##_t)ENDIAN_STR##NBITS##toh(*(uint##NBITS##_t *)buffer); \
     }
 
-#define GEN_RW_FUNCS_2(NBITS, ENDIAN_STR)       \
-    GEN_RW_FUNCS(NBITS, ENDIAN_STR, )           \
-    GEN_RW_FUNCS(NBITS, ENDIAN_STR, u)
+#define GEN_READ_FUNCS_2(NBITS, ENDIAN_STR)     \
+    GEN_READ_FUNC(NBITS, ENDIAN_STR, )          \
+    GEN_READ_FUNC(NBITS, ENDIAN_STR, u)
 
-#define GEN_RW_FUNCS_1(NBITS)                   \
-    GEN_RW_FUNCS_2(NBITS, be)                   \
-    GEN_RW_FUNCS_2(NBITS, le)
+#define GEN_READ_FUNCS_1(NBITS)                 \
+    GEN_READ_FUNCS_2(NBITS, be)                 \
+    GEN_READ_FUNCS_2(NBITS, le)
 
-#define GEN_ALL_RW_FUNCS                        \
-    GEN_RW_FUNCS_1(8)                           \
-    GEN_RW_FUNCS_1(16)                          \
-    GEN_RW_FUNCS_1(32)                          \
-    GEN_RW_FUNCS_1(64)
+GEN_READ_FUNCS_1(8)
+GEN_READ_FUNCS_1(16)
+GEN_READ_FUNCS_1(32)
+GEN_READ_FUNCS_1(64)
 
-GEN_ALL_RW_FUNCS
+#define READ_FUNC_TABLE(ENDIAN_STR, SIGN) {                             \
+        [1] = binary_integer_read_##SIGN##int8_##ENDIAN_STR,            \
+        [2] = binary_integer_read_##SIGN##int16_##ENDIAN_STR,           \
+        [4] = binary_integer_read_##SIGN##int32_##ENDIAN_STR,           \
+        [8] = binary_integer_read_##SIGN##int64_##ENDIAN_STR,           \
+    }
 
+/**
+ * @brief read functions indexed by [signed][endian][byte size]
+ *
+ * Unsupported sizes have a NULL entry.
+ */
+static const binary_integer_read_func_t
+binary_integer_read_funcs[2][2][sizeof (int64_t) + 1] = {
+    [0] = {
+        [ENDIAN_BIG] = READ_FUNC_TABLE(be, u),
+        [ENDIAN_LITTLE] = READ_FUNC_TABLE(le, u),
+    },
+    [1] = {
+        [ENDIAN_BIG] = READ_FUNC_TABLE(be, ),
+        [ENDIAN_LITTLE] = READ_FUNC_TABLE(le, ),
+    },
+};
 
-static int
-binary_integer_filter_instance_build(struct ast_node_hdl *filter,
-                           const struct ast_node_hdl *data_source,
-                           const struct ast_node_hdl *attr_values,
-                           struct compile_ctx *ctx)
+/**
+ * @brief read functions indexed by [signed][byte size] when @endian
+ * is missing (only single bytes can be read)
+ */
+static const binary_integer_read_func_t
+binary_integer_read_funcs_no_endian[2][sizeof (int64_t) + 1] = {
+    [0] = { [1] = binary_integer_read_uint8_be },
+    [1] = { [1] = binary_integer_read_int8_be },
+};
+
+static enum endian
+resolve_native_endian(enum endian endian)
 {
-    struct ast_node_hdl *size_value;
-    struct ast_node_hdl *endian_value;
-    int64_t size;
-    int _signed;
-    enum endian endian;
-    filter_read_func_t read_func;
-    filter_write_func_t write_func;
-
-    assert(attr_values[REF_SIGNED].ndat->u.rexpr.value_type
-           == EXPR_VALUE_TYPE_BOOLEAN);
-    assert(attr_values[REF_ENDIAN].ndat->u.rexpr.value_type
-           == EXPR_VALUE_TYPE_STRING ||
-           attr_values[REF_ENDIAN].ndat->u.rexpr.value_type
-           == EXPR_VALUE_TYPE_UNSET);
-    assert(NULL != data_source);
-
-    switch (data_source->ndat->type) {
-    case AST_NODE_TYPE_BYTE_ARRAY:
-        size_value = ast_node_get_named_expr_target(
-            data_source->ndat->u.byte_array.size);
-        if (NULL != size_value) {
-            if (-1 == compile_expr(size_value, ctx, TRUE)) {
-                return -1;
-            }
-            assert(ast_node_is_rexpr(size_value));
-        }
-        if (NULL == size_value
-            || AST_NODE_TYPE_REXPR_NATIVE != size_value->ndat->type) {
-            semantic_error(
-                SEMANTIC_LOGLEVEL_ERROR, &filter->loc,
-                "integer filter only supports fixed-sized "
-                "byte arrays");
-            return -1;
-        }
-        assert(EXPR_VALUE_TYPE_INTEGER == size_value->ndat->u.rexpr.value_type);
-        size = size_value->ndat->u.rexpr_native.value.integer;
-        break ;
-
-    case AST_NODE_TYPE_BYTE:
-        size = 1;
-        break ;
-
-    default:
-        semantic_error(
-            SEMANTIC_LOGLEVEL_ERROR, &filter->loc,
-            "integer filter can only interpret byte or byte array "
-            "types, not %s",
-            ast_node_type_str(data_source->ndat->type));
-        return -1;
-    }
-    _signed = ast_node_get_named_expr_target(
-        (struct ast_node_hdl *)&attr_values[REF_SIGNED])
-        ->ndat->u.rexpr_native.value.boolean;
-    endian_value = ast_node_get_named_expr_target(
-        (struct ast_node_hdl *)&attr_values[REF_ENDIAN]);
-    if (endian_value->ndat->u.rexpr.value_type == EXPR_VALUE_TYPE_UNSET) {
-        endian = ENDIAN_DEFAULT;
-    } else {
-        endian = str2endian(endian_value->ndat->u.rexpr_native.value.string);
-        if (endian == ENDIAN_BAD) {
-            semantic_error(
-                SEMANTIC_LOGLEVEL_ERROR, &attr_values[REF_ENDIAN].loc,
-                "bad endian value \"%.*s\": "
-                "must be \"big\", \"little\" or \"native\"",
-                (int)attr_values[REF_ENDIAN].ndat->u.string.len,
-                attr_values[REF_ENDIAN].ndat->u.string.str);
-            return -1;
-        }
-    }
     if (endian == ENDIAN_NATIVE) {
-        if (is_little_endian()) {
-            endian = ENDIAN_LITTLE;
-        } else {
-            endian = ENDIAN_BIG;
-        }
-    }
-    assert(endian == ENDIAN_BIG || endian == ENDIAN_LITTLE);
-
-#define SET_RW_FUNCS_3(NBITS, ENDIAN_STR, SIGN) do {                   \
-    read_func = binary_integer_read_##SIGN##int##NBITS##_##ENDIAN_STR; \
-    write_func = binary_integer_write_##SIGN##int##NBITS##_##ENDIAN_STR; \
-} while (0)
-
-#define SET_RW_FUNCS_2(NBITS, ENDIAN, ENDIAN_STR)       \
-    case ENDIAN:                                        \
-        if (_signed) {                                  \
-            SET_RW_FUNCS_3(NBITS, ENDIAN_STR, );        \
-        } else {                                        \
-            SET_RW_FUNCS_3(NBITS, ENDIAN_STR, u);       \
-        }                                               \
-        break
-
-#define SET_RW_FUNCS_1(NBITS)                           \
-    case NBITS / NBBY:                                  \
-        switch (endian) {                               \
-            SET_RW_FUNCS_2(NBITS, ENDIAN_BIG, be);      \
-            SET_RW_FUNCS_2(NBITS, ENDIAN_LITTLE, le);   \
-        default: assert(0);                             \
-        }                                               \
-        break
-
-    switch (size) {
-        SET_RW_FUNCS_1(8);
-        SET_RW_FUNCS_1(16);
-        SET_RW_FUNCS_1(32);
-        SET_RW_FUNCS_1(64);
-    default:
-        semantic_error(SEMANTIC_LOGLEVEL_ERROR, &size_value->loc,
-                       "size %"PRIi64" not supported by integer filter",
-                       size);
-        return -1;
+        return is_little_endian() ? ENDIAN_LITTLE : ENDIAN_BIG;
     }
-    filter->ndat->u.rexpr_filter.read_func = read_func;
-    filter->ndat->u.rexpr_filter.write_func = write_func;
-    return 0;
+    return endian;
 }
 
-#else
-
 /**
  * @brief return endian attribute value
  *
@@ -255,14 +156,45 @@ integer_read_endian_attribute(
             "must be \"big\", \"little\" or \"native\"",
             (int)attr_value.string.len, attr_value.string.str);
     }
-    if (endian == ENDIAN_NATIVE) {
-        if (is_little_endian()) {
-            endian = ENDIAN_LITTLE;
-        } else {
-            endian = ENDIAN_BIG;
+    *endianp = resolve_native_endian(endian);
+    return BITPUNCH_OK;
+}
+
+static bitpunch_status_t
+binary_integer_read_with_attributes(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *buffer, size_t buffer_size,
+    int _signed, enum endian endian,
+    expr_value_t *valuep,
+    struct browse_state *bst)
+{
+    binary_integer_read_func_t read_func;
+
+    if (endian == ENDIAN_BAD) {
+        // endian attribute is missing
+        if (buffer_size > 1) {
+            return box_error(
+                BITPUNCH_INVALID_PARAM, scope, filter, bst,
+                "missing endian value: "
+                "mandatory for source larger than one byte (got %zu)",
+                buffer_size);
         }
+        endian = ENDIAN_BIG;
+    }
+    assert(endian == ENDIAN_BIG || endian == ENDIAN_LITTLE);
+
+    read_func = (buffer_size < N_ELEM(binary_integer_read_funcs[0][0]) ?
+                 binary_integer_read_funcs[!!_signed][endian][buffer_size] :
+                 NULL);
+    if (NULL == read_func) {
+        return node_error(
+            BITPUNCH_NOT_IMPLEMENTED, filter, bst,
+            "size %"PRIi64" not supported by integer filter",
+            buffer_size);
     }
-    *endianp = endian;
+    valuep->type = EXPR_VALUE_TYPE_INTEGER;
+    valuep->integer = read_func(buffer);
     return BITPUNCH_OK;
 }
 
@@ -290,58 +222,114 @@ binary_integer_read_generic(
 
     bt_ret = integer_read_endian_attribute(filter, scope, &endian, bst);
     if (BITPUNCH_NO_ITEM == bt_ret) {
-        if (buffer_size > 1) {
-            return box_error(
-                BITPUNCH_INVALID_PARAM, scope, filter, bst,
-                "missing endian value: "
-                "mandatory for source larger than one byte (got %zu)",
-                buffer_size);
-        }
-        endian = ENDIAN_BIG;
+        endian = ENDIAN_BAD;
     } else if (BITPUNCH_OK != bt_ret) {
         return bt_ret;
     }
-    assert(endian == ENDIAN_BIG || endian == ENDIAN_LITTLE);
+    return binary_integer_read_with_attributes(
+        filter, scope, buffer, buffer_size, _signed, endian, valuep, bst);
+}
 
-#define READ_BRANCH_3(NBITS, ENDIAN_STR, SIGN) do {                     \
-        valuep->integer = (int64_t)(SIGN##int##NBITS##_t)ENDIAN_STR##NBITS##toh(*(uint##NBITS##_t *)buffer); \
-    } while (0)
-
-#define READ_BRANCH_2(NBITS, ENDIAN, ENDIAN_STR)        \
-    case ENDIAN:                                        \
-        if (_signed) {                                  \
-            READ_BRANCH_3(NBITS, ENDIAN_STR, );         \
-        } else {                                        \
-            READ_BRANCH_3(NBITS, ENDIAN_STR, u);        \
-        }                                               \
-        break
-
-#define READ_BRANCH_1(NBITS)                            \
-    case NBITS / NBBY:                                  \
-        switch (endian) {                               \
-            READ_BRANCH_2(NBITS, ENDIAN_BIG, be);       \
-            READ_BRANCH_2(NBITS, ENDIAN_LITTLE, le);    \
-        default: assert(0);                             \
-        }                                               \
-        break
+/**
+ * @brief integer filter instance with @signed and @endian known at
+ * compile time
+ *
+ * Since the same filter may be shared by items of different sizes
+ * (e.g. "let u = integer { ... }; u8: byte <> u; u32: [4] byte <> u;"),
+ * the read function is selected from the buffer size in a table
+ * resolved once at build time.
+ */
+struct binary_integer_constant_attributes {
+    struct filter_instance p; /* inherits */
+    const binary_integer_read_func_t *read_funcs; /* indexed by size */
+    int _signed;
+    enum endian endian; /* ENDIAN_BAD when @endian is missing */
+};
 
-    valuep->type = EXPR_VALUE_TYPE_INTEGER;
-    switch (buffer_size) {
-        READ_BRANCH_1(8);
-        READ_BRANCH_1(16);
-        READ_BRANCH_1(32);
-        READ_BRANCH_1(64);
-    default:
-        return node_error(
-            BITPUNCH_NOT_IMPLEMENTED, filter, bst,
-            "size %"PRIi64" not supported by integer filter",
-            buffer_size);
+static bitpunch_status_t
+binary_integer_read_constant_attributes(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *buffer, size_t buffer_size,
+    expr_value_t *valuep,
+    struct browse_state *bst)
+{
+    struct binary_integer_constant_attributes *f_instance;
+    binary_integer_read_func_t read_func;
+
+    f_instance = (struct binary_integer_constant_attributes *)
+        filter->ndat->u.rexpr_filter.f_instance;
+    if (likely(buffer_size < N_ELEM(binary_integer_read_funcs[0][0]))) {
+        read_func = f_instance->read_funcs[buffer_size];
+        if (likely(NULL != read_func)) {
+            valuep->type = EXPR_VALUE_TYPE_INTEGER;
+            valuep->integer = read_func(buffer);
+            return BITPUNCH_OK;
+        }
+    }
+    // slow path for errors
+    return binary_integer_read_with_attributes(
+        filter, scope, buffer, buffer_size,
+        f_instance->_signed, f_instance->endian, valuep, bst);
+}
+
+static struct filter_instance *
+binary_integer_build_constant_attributes(int _signed, enum endian endian)
+{
+    struct binary_integer_constant_attributes *f_instance;
+
+    f_instance = new_safe(struct binary_integer_constant_attributes);
+    f_instance->_signed = _signed;
+    f_instance->endian = endian;
+    if (endian == ENDIAN_BAD) {
+        // only single bytes can be read without endianness
+        f_instance->read_funcs =
+            binary_integer_read_funcs_no_endian[!!_signed];
+    } else {
+        f_instance->read_funcs = binary_integer_read_funcs[!!_signed][endian];
     }
+    f_instance->p.b_item.read_value_from_buffer =
+        binary_integer_read_constant_attributes;
+    return (struct filter_instance *)f_instance;
+}
+
+/**
+ * @brief decode an array of packed integers all read by @ref filter
+ *
+ * @retval BITPUNCH_OK values decoded
+ * @retval BITPUNCH_NOT_IMPLEMENTED @ref filter is not an integer
+ * filter with constant attributes supporting @ref item_size: the
+ * caller shall read values one by one (no error is raised)
+ */
+bitpunch_status_t
+integer_read_bulk(struct ast_node_hdl *filter,
+                  const char *buffer, size_t item_size,
+                  int64_t n_items, int64_t *values)
+{
+    struct binary_integer_constant_attributes *f_instance;
+    int swap_bytes;
+
+    if (AST_NODE_TYPE_REXPR_FILTER != filter->ndat->type) {
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    f_instance = (struct binary_integer_constant_attributes *)
+        filter->ndat->u.rexpr_filter.f_instance;
+    if (f_instance->p.b_item.read_value_from_buffer
+        != binary_integer_read_constant_attributes
+        || item_size >= N_ELEM(binary_integer_read_funcs[0][0])
+        || NULL == f_instance->read_funcs[item_size]) {
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    swap_bytes = (item_size > 1
+                  && (ENDIAN_LITTLE == f_instance->endian)
+                  != is_little_endian());
+    int_decode_array(buffer, item_size, f_instance->_signed, swap_bytes,
+                     n_items, values);
     return BITPUNCH_OK;
 }
 
 static struct filter_instance *
-binary_integer_filter_instance_build(struct ast_node_hdl *filter)
+binary_integer_build_generic(void)
 {
     struct filter_instance *f_instance;
 
@@ -350,7 +338,44 @@ binary_integer_filter_instance_build(struct ast_node_hdl *filter)
     return f_instance;
 }
 
-#endif // optimized code
+static struct filter_instance *
+binary_integer_filter_instance_build(struct ast_node_hdl *filter)
+{
+    bitpunch_status_t bt_ret;
+    expr_value_t attr_value;
+    int _signed;
+    enum endian endian;
+
+    bt_ret = filter_get_constant_attribute(filter, "@signed", &attr_value);
+    if (BITPUNCH_OK != bt_ret) {
+        // dynamic value, or missing mandatory attribute reported at
+        // read time
+        return binary_integer_build_generic();
+    }
+    _signed = attr_value.boolean;
+
+    bt_ret = filter_get_constant_attribute(filter, "@endian", &attr_value);
+    switch (bt_ret) {
+    case BITPUNCH_OK:
+        endian = str2endian(attr_value.string);
+        if (endian == ENDIAN_BAD) {
+            semantic_error(
+                SEMANTIC_LOGLEVEL_ERROR, &filter->loc,
+                "bad endian value \"%.*s\": "
+                "must be \"big\", \"little\" or \"native\"",
+                (int)attr_value.string.len, attr_value.string.str);
+            return NULL;
+        }
+        endian = resolve_native_endian(endian);
+        break ;
+    case BITPUNCH_NO_ITEM:
+        endian = ENDIAN_BAD;
+        break ;
+    default:
+        return binary_integer_build_generic();
+    }
+    return binary_integer_build_constant_attributes(_signed, endian);
+}
 
 void
 builtin_filter_declare_binary_integer(void)
@@ -69,6 +69,7 @@ snappy_read(
     snappy_ret = snappy_uncompress(buffer, buffer_size,
                                    (char *)ds->ds_data, &ds->ds_data_length);
     if (SNAPPY_OK != snappy_ret) {
+        (void) bitpunch_data_source_release(ds);
         return node_error(BITPUNCH_DATA_ERROR, filter, bst,
                           "error from snappy_uncompress() -> %d",
                           snappy_ret);
@@ -95,7 +96,7 @@ builtin_filter_declare_snappy(void)
     ret = builtin_filter_declare("snappy",
                                EXPR_VALUE_TYPE_BYTES,
                                snappy_filter_instance_build, NULL,
-                               0u,
+                               FILTER_CLASS_CACHED_OUTPUT,
                                0);
     assert(0 == ret);
 }
@@ -35,6 +35,8 @@
 #include <assert.h>
 
 #include "core/filter.h"
+#include "utils/str_search.h"
+#include "utils/regex.h"
 
 static bitpunch_status_t
 string_read_no_boundary(
@@ -127,6 +129,209 @@ string_build_single_char_constant_boundary(char boundary)
 }
 
 
+struct string_multi_char_constant_boundary {
+    struct filter_instance p; /* inherits */
+    struct str_searcher searcher;
+};
+
+static bitpunch_status_t
+compute_item_size__string__multi_char_constant_boundary(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *buffer, size_t buffer_size,
+    int64_t *item_sizep,
+    struct browse_state *bst)
+{
+    struct string_multi_char_constant_boundary *f_instance;
+    const char *end;
+
+    f_instance = (struct string_multi_char_constant_boundary *)
+        filter->ndat->u.rexpr_filter.f_instance;
+    end = str_searcher_find(&f_instance->searcher, buffer, buffer_size);
+    if (NULL != end) {
+        *item_sizep = end - buffer + f_instance->searcher.needle_size;
+    } else {
+        *item_sizep = buffer_size;
+    }
+    return BITPUNCH_OK;
+}
+
+static bitpunch_status_t
+string_read_multi_char_constant_boundary(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *buffer, size_t buffer_size,
+    expr_value_t *valuep,
+    struct browse_state *bst)
+{
+    struct string_multi_char_constant_boundary *f_instance;
+    size_t boundary_size;
+
+    f_instance = (struct string_multi_char_constant_boundary *)
+        filter->ndat->u.rexpr_filter.f_instance;
+    boundary_size = f_instance->searcher.needle_size;
+    valuep->type = EXPR_VALUE_TYPE_STRING;
+    valuep->string.str = (char *)buffer;
+    if (buffer_size >= boundary_size
+        && 0 == memcmp(buffer + buffer_size - boundary_size,
+                       f_instance->searcher.needle, boundary_size)) {
+        valuep->string.len = buffer_size - boundary_size;
+    } else {
+        valuep->string.len = buffer_size;
+    }
+    return BITPUNCH_OK;
+}
+
+/**
+ * @param boundary must outlive the filter instance (e.g. a constant
+ * in the AST)
+ */
+static struct filter_instance *
+string_build_multi_char_constant_boundary(struct expr_value_string boundary)
+{
+    struct string_multi_char_constant_boundary *f_instance;
+
+    f_instance = new_safe(struct string_multi_char_constant_boundary);
+    str_searcher_init(&f_instance->searcher, boundary.str, boundary.len);
+    f_instance->p.b_item.compute_item_size_from_buffer =
+        compute_item_size__string__multi_char_constant_boundary;
+    f_instance->p.b_item.read_value_from_buffer =
+        string_read_multi_char_constant_boundary;
+    return (struct filter_instance *)f_instance;
+}
+
+
+struct string_regex_boundary {
+    struct filter_instance p; /* inherits */
+    struct regex *regex;
+};
+
+static bitpunch_status_t
+compute_item_size__string__regex_boundary(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *buffer, size_t buffer_size,
+    int64_t *item_sizep,
+    struct browse_state *bst)
+{
+    struct string_regex_boundary *f_instance;
+    size_t start;
+    size_t end;
+    int truncated;
+
+    f_instance = (struct string_regex_boundary *)
+        filter->ndat->u.rexpr_filter.f_instance;
+    // a match that may extend further leaves the size undecided
+    if (regex_search(f_instance->regex, buffer, buffer_size,
+                     &start, &end, &truncated) && !truncated) {
+        *item_sizep = end;
+    } else {
+        *item_sizep = buffer_size;
+    }
+    return BITPUNCH_OK;
+}
+
+static bitpunch_status_t
+string_read_regex_boundary(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *buffer, size_t buffer_size,
+    expr_value_t *valuep,
+    struct browse_state *bst)
+{
+    struct string_regex_boundary *f_instance;
+    size_t start;
+    size_t end;
+
+    f_instance = (struct string_regex_boundary *)
+        filter->ndat->u.rexpr_filter.f_instance;
+    valuep->type = EXPR_VALUE_TYPE_STRING;
+    valuep->string.str = (char *)buffer;
+    // the item ends with the first match, if any
+    if (regex_search(f_instance->regex, buffer, buffer_size,
+                     &start, &end, NULL)
+        && end == buffer_size) {
+        valuep->string.len = start;
+    } else {
+        valuep->string.len = buffer_size;
+    }
+    return BITPUNCH_OK;
+}
+
+static struct filter_instance *
+string_build_regex_boundary(struct ast_node_hdl *filter,
+                            struct named_expr *attr)
+{
+    struct string_regex_boundary *f_instance;
+    struct expr_value_string pattern;
+    struct regex *regex;
+    const char *errmsg;
+
+    if (AST_NODE_TYPE_REXPR_NATIVE != attr->expr->ndat->type
+        || NULL != attr->nstmt.stmt.cond) {
+        semantic_error(SEMANTIC_LOGLEVEL_ERROR, &attr->nstmt.stmt.loc,
+                       "@boundary_regex must be a constant string");
+        return NULL;
+    }
+    pattern = attr->expr->ndat->u.rexpr_native.value.string;
+    regex = regex_compile(pattern.str, pattern.len, &errmsg);
+    if (NULL == regex) {
+        semantic_error(SEMANTIC_LOGLEVEL_ERROR, &attr->nstmt.stmt.loc,
+                       "invalid @boundary_regex: %s", errmsg);
+        return NULL;
+    }
+    if (regex_matches_empty(regex)) {
+        semantic_error(SEMANTIC_LOGLEVEL_ERROR, &attr->nstmt.stmt.loc,
+                       "@boundary_regex must not match an empty string");
+        regex_free(regex);
+        return NULL;
+    }
+    f_instance = new_safe(struct string_regex_boundary);
+    f_instance->regex = regex;
+    f_instance->p.b_item.compute_item_size_from_buffer =
+        compute_item_size__string__regex_boundary;
+    f_instance->p.b_item.read_value_from_buffer =
+        string_read_regex_boundary;
+    return (struct filter_instance *)f_instance;
+}
+
+/**
+ * @brief last searcher compiled for a dynamic boundary
+ *
+ * Dynamic boundaries usually keep the same value across items, so the
+ * searcher compiled for the last boundary value is reused when it
+ * matches. The cache is per thread since compiled schemas may be
+ * shared between threads. Boundaries larger than
+ * STRING_BOUNDARY_CACHE_MAX_SIZE are searched with memmem().
+ */
+#define STRING_BOUNDARY_CACHE_MAX_SIZE 64
+
+struct string_boundary_cache {
+    struct str_searcher searcher;
+    char boundary[STRING_BOUNDARY_CACHE_MAX_SIZE];
+};
+
+static __thread struct string_boundary_cache string_boundary_cache;
+
+static const char *
+string_find_dynamic_boundary(const char *buffer, size_t buffer_size,
+                             struct expr_value_string boundary)
+{
+    struct string_boundary_cache *cache;
+
+    if (boundary.len > STRING_BOUNDARY_CACHE_MAX_SIZE) {
+        return memmem(buffer, buffer_size, boundary.str, boundary.len);
+    }
+    cache = &string_boundary_cache;
+    if (cache->searcher.needle != cache->boundary
+        || cache->searcher.needle_size != boundary.len
+        || 0 != memcmp(cache->boundary, boundary.str, boundary.len)) {
+        memcpy(cache->boundary, boundary.str, boundary.len);
+        str_searcher_init(&cache->searcher, cache->boundary, boundary.len);
+    }
+    return str_searcher_find(&cache->searcher, buffer, buffer_size);
+}
+
 static bitpunch_status_t
 compute_item_size__string__generic(
     struct ast_node_hdl *filter,
@@ -142,8 +347,8 @@ compute_item_size__string__generic(
     bt_ret = filter_evaluate_attribute_internal(
         filter, scope, "@boundary", 0u, NULL, &attr_value, NULL, bst);
     if (BITPUNCH_OK == bt_ret) {
-        end = memmem(buffer, buffer_size,
-                     attr_value.string.str, attr_value.string.len);
+        end = string_find_dynamic_boundary(buffer, buffer_size,
+                                           attr_value.string);
         if (NULL != end) {
             *item_sizep = end - buffer + attr_value.string.len;
             expr_value_destroy(attr_value);
@@ -208,31 +413,51 @@ string_filter_instance_build(struct ast_node_hdl *filter)
 {
     const struct block_stmt_list *stmt_lists;
     struct named_expr *attr;
+    struct named_expr *boundary_attr;
+    struct named_expr *regex_attr;
     struct expr_value_string boundary;
 
     stmt_lists = &filter_get_scope_def(filter)->block_stmt_list;
+    boundary_attr = NULL;
+    regex_attr = NULL;
     STATEMENT_FOREACH(named_expr, attr, stmt_lists->attribute_list, list) {
         if (0 == strcmp(attr->nstmt.name, "@boundary")) {
-            filter->ndat->u.item.flags &= ~ITEMFLAG_FILLS_SLACK;
-            if (AST_NODE_TYPE_REXPR_NATIVE == attr->expr->ndat->type
-                && NULL == attr->nstmt.stmt.cond) {
-                boundary = attr->expr->ndat->u.rexpr_native.value.string;
-                switch (boundary.len) {
-                case 0:
-                    return string_build_no_boundary();
-                case 1:
-                    return string_build_single_char_constant_boundary(
-                        boundary.str[0]);
-                default:
-                    /* two or more characters boundary: use generic
-                     * implementation */
-                    return string_build_generic();
-                }
-            } else {
-                /* dynamic boundary: use generic implementation */
-                return string_build_generic();
+            if (NULL == boundary_attr) {
+                boundary_attr = attr;
+            }
+        } else if (0 == strcmp(attr->nstmt.name, "@boundary_regex")) {
+            regex_attr = attr;
+        }
+    }
+    if (NULL != regex_attr) {
+        if (NULL != boundary_attr) {
+            semantic_error(SEMANTIC_LOGLEVEL_ERROR, &filter->loc,
+                           "@boundary and @boundary_regex cannot be both "
+                           "set on a string");
+            return NULL;
+        }
+        filter->ndat->u.item.flags &= ~ITEMFLAG_FILLS_SLACK;
+        return string_build_regex_boundary(filter, regex_attr);
+    }
+    if (NULL != boundary_attr) {
+        attr = boundary_attr;
+        filter->ndat->u.item.flags &= ~ITEMFLAG_FILLS_SLACK;
+        if (AST_NODE_TYPE_REXPR_NATIVE == attr->expr->ndat->type
+            && NULL == attr->nstmt.stmt.cond) {
+            boundary = attr->expr->ndat->u.rexpr_native.value.string;
+            switch (boundary.len) {
+            case 0:
+                return string_build_no_boundary();
+            case 1:
+                return string_build_single_char_constant_boundary(
+                    boundary.str[0]);
+            default:
+                return string_build_multi_char_constant_boundary(
+                    boundary);
             }
-            break ;
+        } else {
+            /* dynamic boundary: use generic implementation */
+            return string_build_generic();
         }
     }
     return string_build_no_boundary();
@@ -243,12 +468,12 @@ builtin_filter_declare_string(void)
 {
     int ret;
 
-    //TODO add regex boundary support
     ret = builtin_filter_declare("string",
                                EXPR_VALUE_TYPE_STRING,
                                string_filter_instance_build, NULL,
                                0u,
-                               1,
-                               "@boundary", EXPR_VALUE_TYPE_STRING, 0);
+                               2,
+                               "@boundary", EXPR_VALUE_TYPE_STRING, 0,
+                               "@boundary_regex", EXPR_VALUE_TYPE_STRING, 0);
     assert(0 == ret);
 }
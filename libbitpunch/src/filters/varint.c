@@ -38,7 +38,18 @@
 #include <endian.h>
 
 #include "core/filter.h"
+#include "utils/int_decode.h"
 #include "filters/integer.h"
+#include "filters/varint.h"
+
+/**
+ * @brief varint filter instance with @endian, @signed and @zigzag
+ * known at compile time
+ */
+struct varint_constant_attributes {
+    struct filter_instance p; /* inherits */
+    int flags; /* enum varint_flag mask */
+};
 
 static bitpunch_status_t
 compute_item_size__varint(
@@ -48,73 +59,51 @@ compute_item_size__varint(
     int64_t *item_sizep,
     struct browse_state *bst)
 {
-    size_t bytepos;
+    size_t size;
 
-    for (bytepos = 0; bytepos < buffer_size; ++bytepos) {
-        if (!(buffer[bytepos] & 0x80)) {
-            *item_sizep = bytepos + 1;
-            return BITPUNCH_OK;
-        }
+    size = varint_get_size(buffer, buffer_size);
+    if (0 == size) {
+        // invalid varint
+        // FIXME add context
+        return BITPUNCH_DATA_ERROR;
     }
-    // invalid varint
-    // FIXME add context
-    return BITPUNCH_DATA_ERROR;
+    *item_sizep = size;
+    return BITPUNCH_OK;
 }
 
 static bitpunch_status_t
-varint_read__little_endian(
-    const char *buffer, size_t buffer_size, int64_t *valuep)
+varint_read_with_flags(
+    const char *buffer, size_t buffer_size, int flags, int64_t *valuep)
 {
-    const unsigned char *ubuffer = (const unsigned char *)buffer;
-    size_t bytepos;
-    size_t cur_shift;
-    uint64_t rawvalue;
-
-    rawvalue = 0;
-    cur_shift = 0;
-    for (bytepos = 0; bytepos < buffer_size; ++bytepos) {
-        rawvalue |= ((uint64_t)ubuffer[bytepos] & 0x7f) << cur_shift;
-        if (!(ubuffer[bytepos] & 0x80)) {
-            break ;
-        }
-        cur_shift += 7;
-    }
-    if (bytepos == buffer_size) {
+    if (0 == varint_decode(buffer, buffer_size, flags, valuep)) {
         // invalid varint
         // FIXME add context
         return BITPUNCH_DATA_ERROR;
     }
-    // zigzag encoding
-    //value = (rawvalue & 1) ? -((rawvalue + 1) / 2) : (rawvalue / 2);
-    *valuep = rawvalue;
     return BITPUNCH_OK;
 }
 
 static bitpunch_status_t
-varint_read__big_endian(
-    const char *buffer, size_t buffer_size, int64_t *valuep)
+varint_read_boolean_attribute(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *attr_name,
+    int *valuep,
+    struct browse_state *bst)
 {
-    const unsigned char *ubuffer = (const unsigned char *)buffer;
-    size_t bytepos;
-    uint64_t rawvalue;
-
-    rawvalue = 0;
-    for (bytepos = 0; bytepos < buffer_size; ++bytepos) {
-        rawvalue <<= 7;
-        rawvalue |= ((uint64_t)ubuffer[bytepos] & 0x7f);
-        if (!(ubuffer[bytepos] & 0x80)) {
-            break ;
-        }
+    bitpunch_status_t bt_ret;
+    expr_value_t attr_value;
+
+    bt_ret = filter_evaluate_attribute_internal(
+        filter, scope, attr_name, 0u, NULL, &attr_value, NULL, bst);
+    if (BITPUNCH_NO_ITEM == bt_ret) {
+        *valuep = FALSE;
+        return BITPUNCH_OK;
     }
-    if (bytepos == buffer_size) {
-        // invalid varint
-        // FIXME add context
-        return BITPUNCH_DATA_ERROR;
+    if (BITPUNCH_OK == bt_ret) {
+        *valuep = attr_value.boolean;
     }
-    // zigzag encoding
-    //value = (rawvalue & 1) ? -((rawvalue + 1) / 2) : (rawvalue / 2);
-    *valuep = rawvalue;
-    return BITPUNCH_OK;
+    return bt_ret;
 }
 
 static bitpunch_status_t
@@ -127,6 +116,9 @@ varint_read(
 {
     bitpunch_status_t bt_ret;
     enum endian endian;
+    int _signed;
+    int zigzag;
+    int flags;
     int64_t value;
 
     bt_ret = integer_read_endian_attribute(filter, scope, &endian, bst);
@@ -136,11 +128,25 @@ varint_read(
     } else if (BITPUNCH_OK != bt_ret) {
         return bt_ret;
     }
-    if (ENDIAN_BIG == endian) {
-        bt_ret = varint_read__big_endian(buffer, buffer_size, &value);
-    } else {
-        bt_ret = varint_read__little_endian(buffer, buffer_size, &value);
+    bt_ret = varint_read_boolean_attribute(filter, scope, "@signed",
+                                           &_signed, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    bt_ret = varint_read_boolean_attribute(filter, scope, "@zigzag",
+                                           &zigzag, bst);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    if (_signed && zigzag) {
+        return node_error(
+            BITPUNCH_INVALID_PARAM, filter, bst,
+            "@signed and @zigzag cannot be both set on a varint");
     }
+    flags = ((ENDIAN_BIG == endian ? VARINT_FLAG_BIG_ENDIAN : 0) |
+             (_signed ? VARINT_FLAG_SIGN_EXTEND : 0) |
+             (zigzag ? VARINT_FLAG_ZIGZAG : 0));
+    bt_ret = varint_read_with_flags(buffer, buffer_size, flags, &value);
     if (BITPUNCH_OK == bt_ret) {
         valuep->type = EXPR_VALUE_TYPE_INTEGER;
         valuep->integer = value;
@@ -148,15 +154,145 @@ varint_read(
     return bt_ret;
 }
 
+static bitpunch_status_t
+varint_read_constant_attributes(
+    struct ast_node_hdl *filter,
+    struct box *scope,
+    const char *buffer, size_t buffer_size,
+    expr_value_t *valuep,
+    struct browse_state *bst)
+{
+    struct varint_constant_attributes *f_instance;
+    int64_t value;
+
+    f_instance = (struct varint_constant_attributes *)
+        filter->ndat->u.rexpr_filter.f_instance;
+    if (0 == varint_decode(buffer, buffer_size, f_instance->flags, &value)) {
+        // invalid varint
+        // FIXME add context
+        return BITPUNCH_DATA_ERROR;
+    }
+    valuep->type = EXPR_VALUE_TYPE_INTEGER;
+    valuep->integer = value;
+    return BITPUNCH_OK;
+}
+
+/**
+ * @brief decode a run of consecutive varints all read by @ref filter
+ *
+ * Decoding stops after @ref n_items varints, or before the first
+ * varint not complete in @ref buffer.
+ *
+ * @param[out] n_readp number of varints decoded
+ * @param[out] n_bytesp number of bytes decoded
+ *
+ * @retval BITPUNCH_OK values decoded
+ * @retval BITPUNCH_NOT_IMPLEMENTED @ref filter is not a varint filter
+ * with constant attributes: the caller shall read values one by one
+ * (no error is raised)
+ */
+bitpunch_status_t
+varint_read_bulk(struct ast_node_hdl *filter,
+                 const char *buffer, size_t buffer_size,
+                 int64_t n_items, int64_t *values,
+                 int64_t *n_readp, size_t *n_bytesp)
+{
+    struct varint_constant_attributes *f_instance;
+
+    if (AST_NODE_TYPE_REXPR_FILTER != filter->ndat->type) {
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    f_instance = (struct varint_constant_attributes *)
+        filter->ndat->u.rexpr_filter.f_instance;
+    if (f_instance->p.b_item.read_value_from_buffer
+        != varint_read_constant_attributes) {
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+    *n_readp = varint_decode_run(buffer, buffer_size, f_instance->flags,
+                                 n_items, values, NULL, n_bytesp);
+    return BITPUNCH_OK;
+}
+
+/**
+ * @brief get a boolean attribute if constant
+ *
+ * @retval BITPUNCH_OK attribute is constant or missing (then FALSE)
+ * @retval BITPUNCH_NOT_IMPLEMENTED attribute is dynamic
+ */
+static bitpunch_status_t
+varint_get_constant_boolean_attribute(
+    struct ast_node_hdl *filter, const char *attr_name, int *valuep)
+{
+    bitpunch_status_t bt_ret;
+    expr_value_t attr_value;
+
+    bt_ret = filter_get_constant_attribute(filter, attr_name, &attr_value);
+    switch (bt_ret) {
+    case BITPUNCH_OK:
+        *valuep = attr_value.boolean;
+        return BITPUNCH_OK;
+    case BITPUNCH_NO_ITEM:
+        *valuep = FALSE;
+        return BITPUNCH_OK;
+    default:
+        return BITPUNCH_NOT_IMPLEMENTED;
+    }
+}
+
 static struct filter_instance *
 varint_filter_instance_build(struct ast_node_hdl *filter)
 {
     struct filter_instance *f_instance;
+    struct varint_constant_attributes *f_constant;
+    bitpunch_status_t bt_ret;
+    expr_value_t attr_value;
+    enum endian endian;
+    int _signed;
+    int zigzag;
 
-    f_instance = new_safe(struct filter_instance);
+    bt_ret = filter_get_constant_attribute(filter, "@endian", &attr_value);
+    switch (bt_ret) {
+    case BITPUNCH_OK:
+        endian = str2endian(attr_value.string);
+        if (ENDIAN_NATIVE == endian) {
+            endian = is_little_endian() ? ENDIAN_LITTLE : ENDIAN_BIG;
+        }
+        break ;
+    case BITPUNCH_NO_ITEM:
+        // default to google's varint convention
+        endian = ENDIAN_LITTLE;
+        break ;
+    default:
+        endian = ENDIAN_BAD;
+        break ;
+    }
+    if (ENDIAN_BAD != endian
+        && BITPUNCH_OK == varint_get_constant_boolean_attribute(
+            filter, "@signed", &_signed)
+        && BITPUNCH_OK == varint_get_constant_boolean_attribute(
+            filter, "@zigzag", &zigzag)) {
+        if (_signed && zigzag) {
+            semantic_error(
+                SEMANTIC_LOGLEVEL_ERROR, &filter->loc,
+                "@signed and @zigzag cannot be both set on a varint");
+            return NULL;
+        }
+        f_constant = new_safe(struct varint_constant_attributes);
+        f_constant->flags =
+            ((ENDIAN_BIG == endian ? VARINT_FLAG_BIG_ENDIAN : 0) |
+             (_signed ? VARINT_FLAG_SIGN_EXTEND : 0) |
+             (zigzag ? VARINT_FLAG_ZIGZAG : 0));
+        f_constant->p.b_item.read_value_from_buffer =
+            varint_read_constant_attributes;
+        f_instance = (struct filter_instance *)f_constant;
+    } else {
+        // dynamic or invalid attributes, resolved or reported at
+        // read time
+        f_instance = new_safe(struct filter_instance);
+        f_instance->b_item.read_value_from_buffer = varint_read;
+    }
     f_instance->b_item.compute_item_size_from_buffer =
         compute_item_size__varint;
-    f_instance->b_item.read_value_from_buffer = varint_read;
     return f_instance;
 }
 
@@ -169,8 +305,10 @@ builtin_filter_declare_varint(void)
                                EXPR_VALUE_TYPE_INTEGER,
                                varint_filter_instance_build, NULL,
                                0u,
-                               1,
-                               "@endian", EXPR_VALUE_TYPE_STRING, 0);
+                               3,
+                               "@endian", EXPR_VALUE_TYPE_STRING, 0,
+                               "@signed", EXPR_VALUE_TYPE_BOOLEAN, 0,
+                               "@zigzag", EXPR_VALUE_TYPE_BOOLEAN, 0);
     assert(0 == ret);
 }
 
@@ -183,6 +321,7 @@ builtin_filter_declare_varint(void)
 
 struct varint_testcase {
     enum endian endian;
+    int sign_flags;
     const char *buffer;
     size_t buffer_size;
     int64_t expected_value;
@@ -249,6 +388,36 @@ START_TEST(test_filter_varint)
             .endian = ENDIAN_BIG,
             TCASE_STR("\xc0\xd2\x93\xb2\x82\x77"),
             .expected_value = 2221075628407ll,
+        }, {
+            .endian = ENDIAN_LITTLE,
+            .sign_flags = VARINT_FLAG_ZIGZAG,
+            TCASE_STR("\x01"),
+            .expected_value = -1,
+        }, {
+            .endian = ENDIAN_BIG,
+            .sign_flags = VARINT_FLAG_ZIGZAG,
+            TCASE_STR("\x80\x01"),
+            .expected_value = -1,
+        }, {
+            .endian = ENDIAN_LITTLE,
+            .sign_flags = VARINT_FLAG_ZIGZAG,
+            TCASE_STR("\x80\x03"),
+            .expected_value = 192,
+        }, {
+            .endian = ENDIAN_LITTLE,
+            .sign_flags = VARINT_FLAG_SIGN_EXTEND,
+            TCASE_STR("\x42"),
+            .expected_value = -62,
+        }, {
+            .endian = ENDIAN_BIG,
+            .sign_flags = VARINT_FLAG_SIGN_EXTEND,
+            TCASE_STR("\x80\x03"),
+            .expected_value = 3,
+        }, {
+            .endian = ENDIAN_LITTLE,
+            .sign_flags = VARINT_FLAG_SIGN_EXTEND,
+            TCASE_STR("\xc0\xbb\x78"),
+            .expected_value = -123456,
         },
     };
     struct varint_testcase *tc;
@@ -258,13 +427,10 @@ START_TEST(test_filter_varint)
 
     for (i = 0; i < N_ELEM(testcases); ++i) {
         tc = &testcases[i];
-        if (ENDIAN_LITTLE == tc->endian) {
-            bt_ret = varint_read__little_endian(
-                tc->buffer, tc->buffer_size, &value);
-        } else {
-            bt_ret = varint_read__big_endian(
-                tc->buffer, tc->buffer_size, &value);
-        }
+        bt_ret = varint_read_with_flags(
+            tc->buffer, tc->buffer_size,
+            (ENDIAN_BIG == tc->endian ? VARINT_FLAG_BIG_ENDIAN : 0)
+            | tc->sign_flags, &value);
         ck_assert_int_eq(bt_ret, BITPUNCH_OK);
         ck_assert_int_eq(value, tc->expected_value);
     }
@@ -35,6 +35,7 @@
 #include <stddef.h>
 #include <check.h>
 #include <stdio.h>
+#include <unistd.h>
 
 #include "utils/bloom.h"
 #include "utils/queue.h"
@@ -423,6 +424,81 @@ bloom_book_lookup_word_get_next_candidate(struct bloom_book *book,
     return bloom_book_get_cookie_mark(book, cookie);
 }
 
+bloom_book_mark_t
+bloom_book_get_n_marks(const struct bloom_book *book)
+{
+    return book->n_pages * N_MARKS_PER_PAGE
+        - (N_MARKS_PER_PAGE - 1 - book->cur_page_mark);
+}
+
+struct bloom_book_file_header {
+    int32_t n_pages;
+    int32_t cur_page_mark;
+};
+
+/**
+ * @brief write the contents of @ref book to @ref file
+ *
+ * @retval 0 success
+ * @retval -1 write error
+ */
+int
+bloom_book_save(const struct bloom_book *book, FILE *file)
+{
+    struct bloom_book_file_header header;
+    struct bloom_book_page *pagep;
+
+    memset(&header, 0, sizeof (header));
+    header.n_pages = book->n_pages;
+    header.cur_page_mark = book->cur_page_mark;
+    if (1 != fwrite(&header, sizeof (header), 1, file)) {
+        return -1;
+    }
+    for (pagep = book->pages;
+         pagep < book->pages + book->n_pages; ++pagep) {
+        if (1 != fwrite(pagep->blooms,
+                        N_PAGE_LEVELS * N_BLOOMS_PER_PAGE_LEVEL
+                        * sizeof(bloom_t), 1, file)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief read a book written by bloom_book_save() from @ref file
+ *
+ * @return the new book, or NULL if the contents are invalid
+ */
+struct bloom_book *
+bloom_book_load(FILE *file)
+{
+    struct bloom_book_file_header header;
+    struct bloom_book *book;
+
+    if (1 != fread(&header, sizeof (header), 1, file)
+        || header.n_pages < 0
+        || header.cur_page_mark < 0
+        || header.cur_page_mark >= (int32_t)N_MARKS_PER_PAGE
+        || (0 == header.n_pages
+            && header.cur_page_mark != (int32_t)N_MARKS_PER_PAGE - 1)) {
+        return NULL;
+    }
+    book = bloom_book_create();
+    while (book->n_pages < header.n_pages) {
+        book->cur_page_mark = N_MARKS_PER_PAGE - 1;
+        (void) bloom_book_add_mark(book);
+        if (1 != fread(book->pages[book->n_pages - 1].blooms,
+                       N_PAGE_LEVELS * N_BLOOMS_PER_PAGE_LEVEL
+                       * sizeof(bloom_t), 1, file)) {
+            bloom_book_destroy(book);
+            return NULL;
+        }
+    }
+    book->cur_page_mark = header.cur_page_mark;
+    return book;
+}
+
 
 //TESTS
 
@@ -485,6 +561,70 @@ START_TEST(test_index_simple)
 }
 END_TEST
 
+START_TEST(test_index_save_load)
+{
+    struct bloom_book *book;
+    struct bloom_book *loaded;
+    struct bloom_book_cookie cookie;
+    bloom_book_mark_t mark;
+    char word_buf[16];
+    FILE *file;
+    int i;
+
+    book = bloom_book_create();
+    for (i = 0; i < 1000; ++i) {
+        if (0 == i % 8) {
+            mark = bloom_book_add_mark(book);
+            ck_assert_int_eq(mark, i / 8);
+        }
+        snprintf(word_buf, sizeof (word_buf), "word%d", i);
+        bloom_book_insert_word(book, word_buf, strlen(word_buf));
+    }
+    ck_assert_int_eq(bloom_book_get_n_marks(book), 125);
+
+    file = tmpfile();
+    ck_assert(NULL != file);
+    ck_assert_int_eq(bloom_book_save(book, file), 0);
+    rewind(file);
+    loaded = bloom_book_load(file);
+    ck_assert(NULL != loaded);
+    ck_assert_int_eq(bloom_book_get_n_marks(loaded), 125);
+    for (i = 0; i < 1000; i += 37) {
+        snprintf(word_buf, sizeof (word_buf), "word%d", i);
+        bloom_book_lookup_word(loaded, word_buf, strlen(word_buf), &cookie);
+        do {
+            mark = bloom_book_lookup_word_get_next_candidate(loaded, &cookie);
+            ck_assert_int_ne(mark, BLOOM_BOOK_MARK_NONE);
+        } while (mark != i / 8);
+    }
+    // loaded book keeps growing from the last mark
+    mark = bloom_book_add_mark(loaded);
+    ck_assert_int_eq(mark, 125);
+    bloom_book_destroy(loaded);
+
+    // truncated contents are rejected
+    rewind(file);
+    ck_assert(0 == ftruncate(fileno(file), 16));
+    ck_assert(NULL == bloom_book_load(file));
+    fclose(file);
+
+    file = tmpfile();
+    ck_assert(NULL != file);
+    bloom_book_destroy(book);
+    book = bloom_book_create();
+    ck_assert_int_eq(bloom_book_get_n_marks(book), 0);
+    ck_assert_int_eq(bloom_book_save(book, file), 0);
+    rewind(file);
+    loaded = bloom_book_load(file);
+    ck_assert(NULL != loaded);
+    ck_assert_int_eq(bloom_book_get_n_marks(loaded), 0);
+    ck_assert_int_eq(bloom_book_add_mark(loaded), 0);
+    bloom_book_destroy(loaded);
+    bloom_book_destroy(book);
+    fclose(file);
+}
+END_TEST
+
 #ifdef ENABLE_LENGTHY_TESTS
 START_TEST(test_index_100K)
 {
@@ -566,6 +706,7 @@ void check_index_add_tcases(Suite *s)
     tc_index = tcase_create("index");
     tcase_set_timeout(tc_index, 30);
     tcase_add_test(tc_index, test_index_simple);
+    tcase_add_test(tc_index, test_index_save_load);
 #ifdef ENABLE_LENGTHY_TESTS
     tcase_add_test(tc_index, test_index_100K);
 #endif
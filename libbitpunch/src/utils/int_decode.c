@@ -0,0 +1,798 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+#define _DEFAULT_SOURCE
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <endian.h>
+
+#include "utils/int_decode.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define INT_DECODE_X86
+# include <immintrin.h>
+#endif
+
+typedef void (*int_decode_func_t)(const char *buffer, size_t item_size,
+                                  int _signed, int swap_bytes,
+                                  int64_t n_items, int64_t *values);
+
+#define bswap8(nb) (nb)
+#define bswap16(nb) __builtin_bswap16(nb)
+#define bswap32(nb) __builtin_bswap32(nb)
+#define bswap64(nb) __builtin_bswap64(nb)
+
+#define DECODE_SCALAR_CASE(NBITS)                                       \
+    case NBITS / NBBY:                                                  \
+        for (i = 0; i < n_items; ++i) {                                 \
+            uint##NBITS##_t raw;                                        \
+                                                                        \
+            memcpy(&raw, buffer + i * (NBITS / NBBY), NBITS / NBBY);    \
+            if (swap_bytes) {                                           \
+                raw = bswap##NBITS(raw);                                \
+            }                                                           \
+            values[i] = (_signed ?                                      \
+                         (int64_t)(int##NBITS##_t)raw : (int64_t)raw);  \
+        }                                                               \
+        break
+
+static void
+int_decode_array__scalar(const char *buffer, size_t item_size,
+                         int _signed, int swap_bytes,
+                         int64_t n_items, int64_t *values)
+{
+    int64_t i;
+
+    switch (item_size) {
+        DECODE_SCALAR_CASE(8);
+        DECODE_SCALAR_CASE(16);
+        DECODE_SCALAR_CASE(32);
+        DECODE_SCALAR_CASE(64);
+    default:
+        assert(0);
+    }
+}
+
+#ifdef INT_DECODE_X86
+
+/*
+ * SIMD kernels: byte-swap with a shuffle when needed, then widen to
+ * 64 bits with the sign or zero extension instructions. Remaining
+ * items (less than one vector) are decoded with the scalar loop.
+ */
+
+__attribute__((target("sse4.1,ssse3")))
+static void
+int_decode_array__sse41(const char *buffer, size_t item_size,
+                        int _signed, int swap_bytes,
+                        int64_t n_items, int64_t *values)
+{
+    const __m128i bswap16_mask = _mm_setr_epi8(
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    const __m128i bswap32_mask = _mm_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m128i bswap64_mask = _mm_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    int64_t i;
+    __m128i in;
+    uint16_t raw16;
+    uint32_t raw32;
+
+    // two 64-bit output values per iteration
+    i = 0;
+    switch (item_size) {
+    case 1:
+        for (; i + 2 <= n_items; i += 2) {
+            memcpy(&raw16, buffer + i, sizeof (raw16));
+            in = _mm_cvtsi32_si128(raw16);
+            in = _signed ? _mm_cvtepi8_epi64(in) : _mm_cvtepu8_epi64(in);
+            _mm_storeu_si128((__m128i *)(values + i), in);
+        }
+        break ;
+    case 2:
+        for (; i + 2 <= n_items; i += 2) {
+            memcpy(&raw32, buffer + i * 2, sizeof (raw32));
+            in = _mm_cvtsi32_si128(raw32);
+            if (swap_bytes) {
+                in = _mm_shuffle_epi8(in, bswap16_mask);
+            }
+            in = _signed ? _mm_cvtepi16_epi64(in) : _mm_cvtepu16_epi64(in);
+            _mm_storeu_si128((__m128i *)(values + i), in);
+        }
+        break ;
+    case 4:
+        for (; i + 2 <= n_items; i += 2) {
+            in = _mm_loadl_epi64((const __m128i *)(buffer + i * 4));
+            if (swap_bytes) {
+                in = _mm_shuffle_epi8(in, bswap32_mask);
+            }
+            in = _signed ? _mm_cvtepi32_epi64(in) : _mm_cvtepu32_epi64(in);
+            _mm_storeu_si128((__m128i *)(values + i), in);
+        }
+        break ;
+    case 8:
+        for (; i + 2 <= n_items; i += 2) {
+            in = _mm_loadu_si128((const __m128i *)(buffer + i * 8));
+            if (swap_bytes) {
+                in = _mm_shuffle_epi8(in, bswap64_mask);
+            }
+            _mm_storeu_si128((__m128i *)(values + i), in);
+        }
+        break ;
+    default:
+        assert(0);
+    }
+    int_decode_array__scalar(buffer + i * item_size, item_size,
+                             _signed, swap_bytes,
+                             n_items - i, values + i);
+}
+
+__attribute__((target("avx2")))
+static void
+int_decode_array__avx2(const char *buffer, size_t item_size,
+                       int _signed, int swap_bytes,
+                       int64_t n_items, int64_t *values)
+{
+    const __m128i bswap16_mask = _mm_setr_epi8(
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    const __m128i bswap32_mask = _mm_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256i bswap64_mask = _mm256_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    int64_t i;
+    __m128i in;
+    __m256i out;
+    uint32_t raw32;
+
+    // four 64-bit output values per iteration
+    i = 0;
+    switch (item_size) {
+    case 1:
+        for (; i + 4 <= n_items; i += 4) {
+            memcpy(&raw32, buffer + i, sizeof (raw32));
+            in = _mm_cvtsi32_si128(raw32);
+            out = _signed ? _mm256_cvtepi8_epi64(in) : _mm256_cvtepu8_epi64(in);
+            _mm256_storeu_si256((__m256i *)(values + i), out);
+        }
+        break ;
+    case 2:
+        for (; i + 4 <= n_items; i += 4) {
+            in = _mm_loadl_epi64((const __m128i *)(buffer + i * 2));
+            if (swap_bytes) {
+                in = _mm_shuffle_epi8(in, bswap16_mask);
+            }
+            out = (_signed ?
+                   _mm256_cvtepi16_epi64(in) : _mm256_cvtepu16_epi64(in));
+            _mm256_storeu_si256((__m256i *)(values + i), out);
+        }
+        break ;
+    case 4:
+        for (; i + 4 <= n_items; i += 4) {
+            in = _mm_loadu_si128((const __m128i *)(buffer + i * 4));
+            if (swap_bytes) {
+                in = _mm_shuffle_epi8(in, bswap32_mask);
+            }
+            out = (_signed ?
+                   _mm256_cvtepi32_epi64(in) : _mm256_cvtepu32_epi64(in));
+            _mm256_storeu_si256((__m256i *)(values + i), out);
+        }
+        break ;
+    case 8:
+        for (; i + 4 <= n_items; i += 4) {
+            out = _mm256_loadu_si256((const __m256i *)(buffer + i * 8));
+            if (swap_bytes) {
+                out = _mm256_shuffle_epi8(out, bswap64_mask);
+            }
+            _mm256_storeu_si256((__m256i *)(values + i), out);
+        }
+        break ;
+    default:
+        assert(0);
+    }
+    int_decode_array__scalar(buffer + i * item_size, item_size,
+                             _signed, swap_bytes,
+                             n_items - i, values + i);
+}
+
+#endif // INT_DECODE_X86
+
+static int_decode_func_t
+int_decode_select_func(void)
+{
+#ifdef INT_DECODE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return int_decode_array__avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")
+        && __builtin_cpu_supports("ssse3")) {
+        return int_decode_array__sse41;
+    }
+#endif
+    return int_decode_array__scalar;
+}
+
+void
+int_decode_array(const char *buffer, size_t item_size,
+                 int _signed, int swap_bytes,
+                 int64_t n_items, int64_t *values)
+{
+    static int_decode_func_t decode_func = NULL;
+
+    assert(1 == item_size || 2 == item_size
+           || 4 == item_size || 8 == item_size);
+    if (unlikely(NULL == decode_func)) {
+        decode_func = int_decode_select_func();
+    }
+    decode_func(buffer, item_size, _signed, swap_bytes, n_items, values);
+}
+
+
+/*
+ * varints
+ *
+ * The next 8 bytes are loaded in a little-endian 64-bit word: the
+ * varint size is given by the position of the first byte with a
+ * clear continuation bit, and its value by packing the 7-bit payloads
+ * of the bytes up to this one. Longer varints (more than 56 bits of
+ * payload) take a byte-by-byte path.
+ */
+
+#define VARINT_CONT_BITS    0x8080808080808080ull
+#define VARINT_PAYLOAD_BITS 0x7f7f7f7f7f7f7f7full
+
+typedef int64_t (*varint_decode_run_func_t)(
+    const char *buffer, size_t buffer_size, int flags,
+    int64_t n_items, int64_t *values, int64_t *sizes, size_t *n_bytesp);
+
+static inline uint64_t
+varint_load_word(const char *buffer, size_t buffer_size)
+{
+    uint64_t word;
+
+    if (likely(buffer_size >= sizeof (word))) {
+        memcpy(&word, buffer, sizeof (word));
+    } else {
+        // missing bytes read as terminal bytes, the caller checks
+        // the varint size against the buffer size
+        word = 0;
+        memcpy(&word, buffer, buffer_size);
+    }
+    return le64toh(word);
+}
+
+/**
+ * @brief pack the 7-bit payloads of a little-endian word's bytes
+ */
+static inline uint64_t
+varint_pack__swar(uint64_t word)
+{
+    uint64_t x;
+
+    x = word & VARINT_PAYLOAD_BITS;
+    x = ((x & 0x7f007f007f007f00ull) >> 1) | (x & 0x007f007f007f007full);
+    x = ((x & 0x3fff00003fff0000ull) >> 2) | (x & 0x00003fff00003fffull);
+    x = ((x & 0x0fffffff00000000ull) >> 4) | (x & 0x000000000fffffffull);
+    return x;
+}
+
+static size_t
+varint_decode_long(const char *buffer, size_t buffer_size, int big_endian,
+                   uint64_t *valuep)
+{
+    const unsigned char *ubuffer = (const unsigned char *)buffer;
+    size_t bytepos;
+    size_t cur_shift;
+    uint64_t rawvalue;
+
+    rawvalue = 0;
+    cur_shift = 0;
+    for (bytepos = 0; bytepos < buffer_size; ++bytepos) {
+        if (big_endian) {
+            rawvalue = (rawvalue << 7) | (ubuffer[bytepos] & 0x7f);
+        } else if (cur_shift < 64) {
+            rawvalue |= ((uint64_t)ubuffer[bytepos] & 0x7f) << cur_shift;
+            cur_shift += 7;
+        }
+        if (!(ubuffer[bytepos] & 0x80)) {
+            *valuep = rawvalue;
+            return bytepos + 1;
+        }
+    }
+    return 0;
+}
+
+typedef uint64_t (*varint_pack_func_t)(uint64_t word);
+
+/**
+ * @brief decode one varint, @ref pack being constant once inlined
+ *
+ * @return size in bytes of the varint, or 0 if incomplete
+ */
+static inline __attribute__((always_inline)) size_t
+varint_decode_one(const char *buffer, size_t buffer_size, int big_endian,
+                  varint_pack_func_t pack, uint64_t *valuep)
+{
+    uint64_t word;
+    uint64_t word2;
+    uint64_t stop;
+    size_t size;
+
+    word = varint_load_word(buffer, buffer_size);
+    stop = ~word & VARINT_CONT_BITS;
+    if (likely(0 != stop)) {
+        size = (__builtin_ctzll(stop) >> 3) + 1;
+        if (unlikely(size > buffer_size)) {
+            return 0;
+        }
+        // keep bytes up to the terminal byte
+        word &= stop ^ (stop - 1);
+        if (big_endian) {
+            word = __builtin_bswap64(word) >> (64 - 8 * size);
+        }
+        *valuep = pack(word);
+        return size;
+    }
+    if (!big_endian && buffer_size >= 16) {
+        // 9 or 10 bytes varints (up to 64-bit values)
+        word2 = varint_load_word(buffer + 8, buffer_size - 8);
+        stop = ~word2 & VARINT_CONT_BITS & 0x8080;
+        if (likely(0 != stop)) {
+            word2 &= stop ^ (stop - 1);
+            *valuep = pack(word) | (pack(word2) << 56);
+            return 8 + (__builtin_ctzll(stop) >> 3) + 1;
+        }
+    }
+    return varint_decode_long(buffer, buffer_size, big_endian, valuep);
+}
+
+/**
+ * @brief apply the signedness flags to a raw varint value of @ref
+ * size bytes
+ */
+static inline __attribute__((always_inline)) int64_t
+varint_sign(uint64_t rawvalue, size_t size, int flags)
+{
+    int shift;
+
+    if (flags & VARINT_FLAG_ZIGZAG) {
+        return (int64_t)((rawvalue >> 1) ^ -(rawvalue & 1));
+    }
+    if ((flags & VARINT_FLAG_SIGN_EXTEND) && size < 10) {
+        shift = 64 - 7 * size;
+        return (int64_t)(rawvalue << shift) >> shift;
+    }
+    return (int64_t)rawvalue;
+}
+
+static inline __attribute__((always_inline)) int64_t
+varint_decode_run_inline(const char *buffer, size_t buffer_size,
+                         int flags, varint_pack_func_t pack,
+                         int64_t n_items, int64_t *values, int64_t *sizes,
+                         size_t *n_bytesp)
+{
+    int big_endian = !!(flags & VARINT_FLAG_BIG_ENDIAN);
+    const unsigned char *ubuffer = (const unsigned char *)buffer;
+    size_t pos;
+    int64_t i;
+    int k;
+    uint64_t rawvalue;
+    size_t size;
+
+    pos = 0;
+    i = 0;
+    while (i < n_items && pos < buffer_size) {
+        if (buffer_size - pos >= 8 && i + 8 <= n_items) {
+            uint64_t word;
+
+            memcpy(&word, buffer + pos, sizeof (word));
+            if (0 == (word & VARINT_CONT_BITS)) {
+                // eight single-byte varints
+                if (flags & (VARINT_FLAG_ZIGZAG |
+                             VARINT_FLAG_SIGN_EXTEND)) {
+                    for (k = 0; k < 8; ++k) {
+                        values[i + k] = varint_sign(ubuffer[pos + k],
+                                                    1, flags);
+                    }
+                } else {
+                    for (k = 0; k < 8; ++k) {
+                        values[i + k] = ubuffer[pos + k];
+                    }
+                }
+                if (NULL != sizes) {
+                    for (k = 0; k < 8; ++k) {
+                        sizes[i + k] = 1;
+                    }
+                }
+                i += 8;
+                pos += 8;
+                continue ;
+            }
+        }
+        size = varint_decode_one(buffer + pos, buffer_size - pos,
+                                 big_endian, pack, &rawvalue);
+        if (0 == size) {
+            break ;
+        }
+        values[i] = varint_sign(rawvalue, size, flags);
+        if (NULL != sizes) {
+            sizes[i] = size;
+        }
+        ++i;
+        pos += size;
+    }
+    *n_bytesp = pos;
+    return i;
+}
+
+static int64_t
+varint_decode_run__swar(const char *buffer, size_t buffer_size,
+                        int flags,
+                        int64_t n_items, int64_t *values, int64_t *sizes,
+                        size_t *n_bytesp)
+{
+    return varint_decode_run_inline(buffer, buffer_size, flags,
+                                    varint_pack__swar,
+                                    n_items, values, sizes, n_bytesp);
+}
+
+#ifdef INT_DECODE_X86
+
+__attribute__((target("bmi2")))
+static inline uint64_t
+varint_pack__bmi2(uint64_t word)
+{
+    return _pext_u64(word, VARINT_PAYLOAD_BITS);
+}
+
+__attribute__((target("bmi2")))
+static int64_t
+varint_decode_run__bmi2(const char *buffer, size_t buffer_size,
+                        int flags,
+                        int64_t n_items, int64_t *values, int64_t *sizes,
+                        size_t *n_bytesp)
+{
+    return varint_decode_run_inline(buffer, buffer_size, flags,
+                                    varint_pack__bmi2,
+                                    n_items, values, sizes, n_bytesp);
+}
+
+#endif // INT_DECODE_X86
+
+static varint_decode_run_func_t
+varint_decode_select_func(void)
+{
+#ifdef INT_DECODE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("bmi2")) {
+        return varint_decode_run__bmi2;
+    }
+#endif
+    return varint_decode_run__swar;
+}
+
+size_t
+varint_get_size(const char *buffer, size_t buffer_size)
+{
+    uint64_t stop;
+    size_t size;
+    uint64_t rawvalue;
+
+    if (0 == buffer_size) {
+        return 0;
+    }
+    stop = ~varint_load_word(buffer, buffer_size) & VARINT_CONT_BITS;
+    if (likely(0 != stop)) {
+        size = (__builtin_ctzll(stop) >> 3) + 1;
+        return size <= buffer_size ? size : 0;
+    }
+    return varint_decode_long(buffer, buffer_size, FALSE, &rawvalue);
+}
+
+size_t
+varint_decode(const char *buffer, size_t buffer_size, int flags,
+              int64_t *valuep)
+{
+    uint64_t rawvalue;
+    size_t size;
+
+    if (0 == buffer_size) {
+        return 0;
+    }
+    size = varint_decode_one(buffer, buffer_size,
+                             !!(flags & VARINT_FLAG_BIG_ENDIAN),
+                             varint_pack__swar, &rawvalue);
+    if (0 != size) {
+        *valuep = varint_sign(rawvalue, size, flags);
+    }
+    return size;
+}
+
+int64_t
+varint_decode_run(const char *buffer, size_t buffer_size, int flags,
+                  int64_t n_items, int64_t *values, int64_t *sizes,
+                  size_t *n_bytesp)
+{
+    static varint_decode_run_func_t decode_func = NULL;
+
+    if (unlikely(NULL == decode_func)) {
+        decode_func = varint_decode_select_func();
+    }
+    return decode_func(buffer, buffer_size, flags,
+                       n_items, values, sizes, n_bytesp);
+}
+
+
+#ifndef DISABLE_UTESTS
+
+#include <check.h>
+
+START_TEST(test_int_decode_array)
+{
+    static const char buffer[] =
+        "\x01\x80\xff\x7f\x00\xfe\x12\x34\x56\x78\x9a\xbc\xde\xf0"
+        "\x80\x00\x00\x00\x00\x00\x00\x01\xff\xff\xff\xff\xff\xff"
+        "\xff\xfe\x0f\xed\xcb\xa9\x87\x65\x43\x21\x11\x22\x33\x44"
+        "\x55\x66\x77\x88\x99\xaa\xbb\xcc\xdd\xee\xff\x00\x01\x02";
+    int_decode_func_t decode_funcs[3];
+    int n_decode_funcs;
+    size_t item_size;
+    int _signed;
+    int swap_bytes;
+    int64_t n_items;
+    int64_t expected[sizeof (buffer)];
+    int64_t values[sizeof (buffer)];
+    int f;
+
+    n_decode_funcs = 0;
+    decode_funcs[n_decode_funcs++] = int_decode_array__scalar;
+#ifdef INT_DECODE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")
+        && __builtin_cpu_supports("ssse3")) {
+        decode_funcs[n_decode_funcs++] = int_decode_array__sse41;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        decode_funcs[n_decode_funcs++] = int_decode_array__avx2;
+    }
+#endif
+
+    // known values
+    int_decode_array(buffer, 1, TRUE, FALSE, 3, values);
+    ck_assert_int_eq(values[0], 1);
+    ck_assert_int_eq(values[1], -128);
+    ck_assert_int_eq(values[2], -1);
+    int_decode_array(buffer, 2, FALSE, !is_little_endian(), 2, values);
+    ck_assert_int_eq(values[0], 0x8001);
+    ck_assert_int_eq(values[1], 0x7fff);
+    int_decode_array(buffer + 14, 8, TRUE, is_little_endian(), 2, values);
+    ck_assert_int_eq(values[0], INT64_MIN + 1);
+    ck_assert_int_eq(values[1], -2);
+
+    // all kernels shall match the scalar implementation, for all
+    // counts (to test the remainder loops)
+    for (item_size = 1; item_size <= 8; item_size *= 2) {
+        for (_signed = 0; _signed <= 1; ++_signed) {
+            for (swap_bytes = 0; swap_bytes <= 1; ++swap_bytes) {
+                for (n_items = 0; n_items <= (sizeof (buffer) - 1) / item_size;
+                     ++n_items) {
+                    int_decode_array__scalar(buffer, item_size,
+                                             _signed, swap_bytes,
+                                             n_items, expected);
+                    for (f = 1; f < n_decode_funcs; ++f) {
+                        memset(values, 0, sizeof (values));
+                        decode_funcs[f](buffer, item_size,
+                                        _signed, swap_bytes,
+                                        n_items, values);
+                        ck_assert(0 == memcmp(values, expected,
+                                              n_items * sizeof (int64_t)));
+                    }
+                }
+            }
+        }
+    }
+}
+END_TEST
+
+static size_t
+varint_encode_test(uint64_t value, int big_endian, char *buffer)
+{
+    size_t size;
+    size_t i;
+
+    size = 0;
+    do {
+        buffer[size++] = (value & 0x7f) | 0x80;
+        value >>= 7;
+    } while (0 != value);
+    buffer[size - 1] &= 0x7f;
+    if (big_endian) {
+        for (i = 0; i < size / 2; ++i) {
+            SWAP(&buffer[i], &buffer[size - 1 - i]);
+        }
+        for (i = 0; i < size; ++i) {
+            buffer[i] |= 0x80;
+        }
+        buffer[size - 1] &= 0x7f;
+    }
+    return size;
+}
+
+START_TEST(test_varint_decode_run)
+{
+    static const uint64_t test_values[] = {
+        0, 1, 0x7f, 0x80, 0x3fff, 0x4000, 300, 0x1fffff, 0x200000,
+        0xfffffffull, 0x7ffffffffull, 0x800000000ull,
+        0xffffffffffffffull, 0x100000000000000ull,
+        0x7fffffffffffffffull, 0xffffffffffffffffull,
+    };
+    varint_decode_run_func_t decode_funcs[2];
+    int n_decode_funcs;
+    char buffer[16 * 10 + 8];
+    size_t expected_sizes[32];
+    int64_t values[32];
+    int64_t sizes[32];
+    size_t buffer_size;
+    size_t n_bytes;
+    int64_t n_decoded;
+    int big_endian;
+    int n_values;
+    int f;
+    int i;
+
+    n_decode_funcs = 0;
+    decode_funcs[n_decode_funcs++] = varint_decode_run__swar;
+#ifdef INT_DECODE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("bmi2")) {
+        decode_funcs[n_decode_funcs++] = varint_decode_run__bmi2;
+    }
+#endif
+    // known encodings
+    ck_assert_int_eq(varint_decode("\xac\x02", 2, 0, &values[0]), 2);
+    ck_assert_int_eq(values[0], 300);
+    ck_assert_int_eq(varint_decode("\x82\x2c", 2, VARINT_FLAG_BIG_ENDIAN, &values[0]), 2);
+    ck_assert_int_eq(values[0], 300);
+    ck_assert_int_eq(varint_get_size("\xac\x02\x01", 3), 2);
+    // incomplete varints
+    ck_assert_int_eq(varint_decode("\xac\x82", 2, 0, &values[0]), 0);
+    ck_assert_int_eq(varint_get_size("\xac\x82", 2), 0);
+    ck_assert_int_eq(varint_get_size("", 0), 0);
+    // signed varints
+    ck_assert_int_eq(varint_decode("\x03", 1, VARINT_FLAG_ZIGZAG,
+                                   &values[0]), 1);
+    ck_assert_int_eq(values[0], -2);
+    ck_assert_int_eq(varint_decode("\xac\x02", 2, VARINT_FLAG_ZIGZAG,
+                                   &values[0]), 2);
+    ck_assert_int_eq(values[0], 150);
+    ck_assert_int_eq(varint_decode("\xff\xff\xff\xff\xff"
+                                   "\xff\xff\xff\xff\x01", 10,
+                                   VARINT_FLAG_ZIGZAG, &values[0]), 10);
+    ck_assert(values[0] == INT64_MIN);
+    ck_assert_int_eq(varint_decode("\x7f", 1, VARINT_FLAG_SIGN_EXTEND,
+                                   &values[0]), 1);
+    ck_assert_int_eq(values[0], -1);
+    ck_assert_int_eq(varint_decode("\x3f", 1, VARINT_FLAG_SIGN_EXTEND,
+                                   &values[0]), 1);
+    ck_assert_int_eq(values[0], 63);
+    ck_assert_int_eq(varint_decode("\x80\x7f", 2, VARINT_FLAG_SIGN_EXTEND,
+                                   &values[0]), 2);
+    ck_assert_int_eq(values[0], -128);
+    ck_assert_int_eq(varint_decode("\xff\x00", 2,
+                                   VARINT_FLAG_SIGN_EXTEND |
+                                   VARINT_FLAG_BIG_ENDIAN, &values[0]), 2);
+    ck_assert_int_eq(values[0], -128);
+    ck_assert_int_eq(varint_decode("\xff\xff\xff\xff\xff"
+                                   "\xff\xff\xff\xff\x01", 10,
+                                   VARINT_FLAG_SIGN_EXTEND, &values[0]), 10);
+    ck_assert_int_eq(values[0], -1);
+    // signed runs of single-byte varints
+    for (i = 0; i < 16; ++i) {
+        buffer[i] = i * 8 + 3;
+    }
+    for (f = 0; f < n_decode_funcs; ++f) {
+        n_decoded = decode_funcs[f](buffer, 16, VARINT_FLAG_ZIGZAG,
+                                    16, values, NULL, &n_bytes);
+        ck_assert_int_eq(n_decoded, 16);
+        for (i = 0; i < 16; ++i) {
+            ck_assert_int_eq(values[i], -(i * 4 + 2));
+        }
+        n_decoded = decode_funcs[f](buffer, 16, VARINT_FLAG_SIGN_EXTEND,
+                                    16, values, NULL, &n_bytes);
+        ck_assert_int_eq(n_decoded, 16);
+        for (i = 0; i < 16; ++i) {
+            ck_assert_int_eq(values[i], i < 8 ? i * 8 + 3 : i * 8 + 3 - 128);
+        }
+    }
+
+    for (big_endian = 0; big_endian <= 1; ++big_endian) {
+        // runs of multi-byte varints
+        buffer_size = 0;
+        n_values = N_ELEM(test_values);
+        for (i = 0; i < n_values; ++i) {
+            expected_sizes[i] = varint_encode_test(
+                test_values[i], big_endian, buffer + buffer_size);
+            buffer_size += expected_sizes[i];
+        }
+        for (f = 0; f < n_decode_funcs; ++f) {
+            n_decoded = decode_funcs[f](buffer, buffer_size, big_endian,
+                                        n_values, values, sizes, &n_bytes);
+            ck_assert_int_eq(n_decoded, n_values);
+            ck_assert_int_eq(n_bytes, buffer_size);
+            for (i = 0; i < n_values; ++i) {
+                ck_assert(values[i] == (int64_t)test_values[i]);
+                ck_assert_int_eq(sizes[i], expected_sizes[i]);
+            }
+            // stops before the last incomplete varint
+            n_decoded = decode_funcs[f](buffer, buffer_size - 1, big_endian,
+                                        n_values, values, NULL, &n_bytes);
+            ck_assert_int_eq(n_decoded, n_values - 1);
+            ck_assert_int_eq(n_bytes,
+                             buffer_size - expected_sizes[n_values - 1]);
+        }
+        // runs of single-byte varints mixed with longer ones
+        buffer_size = 0;
+        for (i = 0; i < 20; ++i) {
+            expected_sizes[i] = varint_encode_test(
+                i == 9 ? 1000 : i, big_endian, buffer + buffer_size);
+            buffer_size += expected_sizes[i];
+        }
+        for (f = 0; f < n_decode_funcs; ++f) {
+            n_decoded = decode_funcs[f](buffer, buffer_size, big_endian,
+                                        20, values, sizes, &n_bytes);
+            ck_assert_int_eq(n_decoded, 20);
+            ck_assert_int_eq(n_bytes, buffer_size);
+            for (i = 0; i < 20; ++i) {
+                ck_assert_int_eq(values[i], i == 9 ? 1000 : i);
+                ck_assert_int_eq(sizes[i], expected_sizes[i]);
+            }
+            n_decoded = decode_funcs[f](buffer, buffer_size, big_endian,
+                                        5, values, NULL, &n_bytes);
+            ck_assert_int_eq(n_decoded, 5);
+            ck_assert_int_eq(n_bytes, 5);
+        }
+    }
+}
+END_TEST
+
+void check_int_decode_add_tcases(Suite *s)
+{
+    TCase *tc_int_decode;
+
+    tc_int_decode = tcase_create("utils:int_decode");
+    tcase_add_test(tc_int_decode, test_int_decode_array);
+    tcase_add_test(tc_int_decode, test_varint_decode_run);
+    suite_add_tcase(s, tc_int_decode);
+}
+
+#endif // #ifndef DISABLE_UTESTS
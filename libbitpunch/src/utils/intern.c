@@ -0,0 +1,121 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "utils/port.h"
+#include "utils/intern.h"
+
+#define INTERN_INITIAL_N_SLOTS 256
+
+static const char **intern_slots;
+static uint32_t intern_n_slots;
+static uint32_t intern_n_strings;
+static pthread_mutex_t intern_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief hash a string (FNV-1a)
+ */
+uint32_t
+intern_hash(const char *str)
+{
+    uint32_t hash = 2166136261u;
+
+    while ('\0' != *str) {
+        hash = (hash ^ (unsigned char)*str) * 16777619u;
+        ++str;
+    }
+    return hash;
+}
+
+static const char **
+intern_find_slot(const char **slots, uint32_t n_slots,
+                 const char *str, uint32_t hash)
+{
+    uint32_t slot;
+
+    slot = hash & (n_slots - 1);
+    while (NULL != slots[slot] && 0 != strcmp(slots[slot], str)) {
+        slot = (slot + 1) & (n_slots - 1);
+    }
+    return &slots[slot];
+}
+
+static void
+intern_grow(void)
+{
+    const char **new_slots;
+    uint32_t new_n_slots;
+    uint32_t i;
+
+    new_n_slots = (0 == intern_n_slots ?
+                   INTERN_INITIAL_N_SLOTS : intern_n_slots * 2);
+    new_slots = malloc0_safe(new_n_slots * sizeof (*new_slots));
+    for (i = 0; i < intern_n_slots; ++i) {
+        if (NULL != intern_slots[i]) {
+            *intern_find_slot(new_slots, new_n_slots, intern_slots[i],
+                              intern_hash(intern_slots[i]))
+                = intern_slots[i];
+        }
+    }
+    free(intern_slots);
+    intern_slots = new_slots;
+    intern_n_slots = new_n_slots;
+}
+
+/**
+ * @brief get the interned copy of a string
+ *
+ * @return a string equal to @ref str, which address is the same for
+ * all equal strings and remains valid until the process exits
+ */
+const char *
+intern_string(const char *str)
+{
+    const char **slotp;
+    const char *interned;
+
+    pthread_mutex_lock(&intern_lock);
+    if (2 * (intern_n_strings + 1) > intern_n_slots) {
+        intern_grow();
+    }
+    slotp = intern_find_slot(intern_slots, intern_n_slots,
+                             str, intern_hash(str));
+    if (NULL == *slotp) {
+        *slotp = strdup_safe(str);
+        ++intern_n_strings;
+    }
+    interned = *slotp;
+    pthread_mutex_unlock(&intern_lock);
+    return interned;
+}
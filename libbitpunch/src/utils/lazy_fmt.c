@@ -0,0 +1,705 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief lazily formatted printf-style messages
+ *
+ * Each conversion specification of the format string is parsed once
+ * when the message is created, to pull its arguments off the va_list
+ * with their promoted type. Formatting then replays each specification
+ * with printf, so the output is identical to formatting eagerly.
+ *
+ * Formats with conversions not handled here (e.g. positional
+ * arguments or wide characters) are formatted right away instead.
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include "utils/port.h"
+#include "utils/lazy_fmt.h"
+
+#define LAZY_FMT_MAX_SPEC_LEN 32
+
+enum lazy_fmt_arg_type {
+    LAZY_FMT_ARG_INT,
+    LAZY_FMT_ARG_LONG,
+    LAZY_FMT_ARG_LLONG,
+    LAZY_FMT_ARG_SIZE,
+    LAZY_FMT_ARG_INTMAX,
+    LAZY_FMT_ARG_PTRDIFF,
+    LAZY_FMT_ARG_DOUBLE,
+    LAZY_FMT_ARG_LDOUBLE,
+    LAZY_FMT_ARG_PTR,
+    LAZY_FMT_ARG_STR,
+};
+
+struct lazy_fmt_arg {
+    enum lazy_fmt_arg_type type;
+    union {
+        int i;
+        long l;
+        long long ll;
+        size_t z;
+        intmax_t j;
+        ptrdiff_t t;
+        double d;
+        long double ld;
+        const void *p;
+        const char *s;
+    } u;
+};
+
+/** parsed conversion specification (other than "%%") */
+struct lazy_fmt_spec {
+    /** number of '*' width/precision arguments */
+    int n_stars;
+    /** index of the '*' argument giving the precision, or -1 */
+    int star_precision;
+    /** literal precision, or -1 if none or given by '*' */
+    int precision;
+    enum lazy_fmt_arg_type type;
+};
+
+struct lazy_fmt {
+    /** next appended message */
+    struct lazy_fmt *next;
+    /** formatted message of the whole chain, once asked for */
+    char *str;
+    /** copy of the format string, or NULL if formatted eagerly */
+    const char *fmt;
+    /** eagerly formatted text if fmt is NULL */
+    const char *text;
+    int n_args;
+    struct lazy_fmt_arg args[];
+};
+
+/**
+ * @brief parse the conversion specification starting after '%'
+ *
+ * @return pointer past the specification, or NULL if not supported
+ */
+static const char *
+lazy_fmt_parse_spec(const char *p, struct lazy_fmt_spec *spec)
+{
+    const char *start;
+    enum { LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL,
+           LEN_Z, LEN_J, LEN_T, LEN_LD } len;
+
+    start = p;
+    spec->n_stars = 0;
+    spec->star_precision = -1;
+    spec->precision = -1;
+    while (NULL != strchr("-+ #0'", *p) && '\0' != *p) {
+        ++p;
+    }
+    if ('*' == *p) {
+        ++spec->n_stars;
+        ++p;
+    } else {
+        while (*p >= '0' && *p <= '9') {
+            ++p;
+        }
+    }
+    if ('.' == *p) {
+        ++p;
+        if ('*' == *p) {
+            spec->star_precision = spec->n_stars;
+            ++spec->n_stars;
+            ++p;
+        } else {
+            spec->precision = 0;
+            while (*p >= '0' && *p <= '9') {
+                spec->precision = spec->precision * 10 + (*p - '0');
+                ++p;
+            }
+        }
+    }
+    len = LEN_NONE;
+    switch (*p) {
+    case 'h':
+        len = ('h' == p[1] ? LEN_HH : LEN_H);
+        break ;
+    case 'l':
+        len = ('l' == p[1] ? LEN_LL : LEN_L);
+        break ;
+    case 'q':
+        len = LEN_LL;
+        break ;
+    case 'z':
+        len = LEN_Z;
+        break ;
+    case 'j':
+        len = LEN_J;
+        break ;
+    case 't':
+        len = LEN_T;
+        break ;
+    case 'L':
+        len = LEN_LD;
+        break ;
+    default:
+        break ;
+    }
+    if (LEN_HH == len || LEN_LL == len) {
+        if ('q' != *p) {
+            ++p;
+        }
+        ++p;
+    } else if (LEN_NONE != len) {
+        ++p;
+    }
+    switch (*p) {
+    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+        switch (len) {
+        case LEN_NONE: case LEN_HH: case LEN_H:
+            spec->type = LAZY_FMT_ARG_INT;
+            break ;
+        case LEN_L:
+            spec->type = LAZY_FMT_ARG_LONG;
+            break ;
+        case LEN_LL:
+            spec->type = LAZY_FMT_ARG_LLONG;
+            break ;
+        case LEN_Z:
+            spec->type = LAZY_FMT_ARG_SIZE;
+            break ;
+        case LEN_J:
+            spec->type = LAZY_FMT_ARG_INTMAX;
+            break ;
+        case LEN_T:
+            spec->type = LAZY_FMT_ARG_PTRDIFF;
+            break ;
+        default:
+            return NULL;
+        }
+        break ;
+    case 'f': case 'F': case 'e': case 'E':
+    case 'g': case 'G': case 'a': case 'A':
+        if (LEN_LD == len) {
+            spec->type = LAZY_FMT_ARG_LDOUBLE;
+        } else if (LEN_NONE == len || LEN_L == len) {
+            spec->type = LAZY_FMT_ARG_DOUBLE;
+        } else {
+            return NULL;
+        }
+        break ;
+    case 'c':
+        if (LEN_NONE != len) {
+            return NULL;
+        }
+        spec->type = LAZY_FMT_ARG_INT;
+        break ;
+    case 's':
+        if (LEN_NONE != len) {
+            return NULL;
+        }
+        spec->type = LAZY_FMT_ARG_STR;
+        break ;
+    case 'p':
+        if (LEN_NONE != len) {
+            return NULL;
+        }
+        spec->type = LAZY_FMT_ARG_PTR;
+        break ;
+    default:
+        return NULL;
+    }
+    ++p;
+    if (p - start + 1 >= LAZY_FMT_MAX_SPEC_LEN) {
+        return NULL;
+    }
+    return p;
+}
+
+static void
+lazy_fmt_fetch_arg(struct lazy_fmt_arg *arg, enum lazy_fmt_arg_type type,
+                   va_list *args)
+{
+    arg->type = type;
+    switch (type) {
+    case LAZY_FMT_ARG_INT:
+        arg->u.i = va_arg(*args, int);
+        break ;
+    case LAZY_FMT_ARG_LONG:
+        arg->u.l = va_arg(*args, long);
+        break ;
+    case LAZY_FMT_ARG_LLONG:
+        arg->u.ll = va_arg(*args, long long);
+        break ;
+    case LAZY_FMT_ARG_SIZE:
+        arg->u.z = va_arg(*args, size_t);
+        break ;
+    case LAZY_FMT_ARG_INTMAX:
+        arg->u.j = va_arg(*args, intmax_t);
+        break ;
+    case LAZY_FMT_ARG_PTRDIFF:
+        arg->u.t = va_arg(*args, ptrdiff_t);
+        break ;
+    case LAZY_FMT_ARG_DOUBLE:
+        arg->u.d = va_arg(*args, double);
+        break ;
+    case LAZY_FMT_ARG_LDOUBLE:
+        arg->u.ld = va_arg(*args, long double);
+        break ;
+    case LAZY_FMT_ARG_PTR:
+        arg->u.p = va_arg(*args, const void *);
+        break ;
+    case LAZY_FMT_ARG_STR:
+        arg->u.s = va_arg(*args, const char *);
+        break ;
+    }
+}
+
+/**
+ * @brief length of a string argument as printed with the given
+ * precision (which may not be NUL-terminated past it)
+ */
+static size_t
+lazy_fmt_str_arg_len(const char *str, int precision)
+{
+    if (NULL == str) {
+        return 0;
+    }
+    if (precision >= 0) {
+        return strnlen(str, precision);
+    }
+    return strlen(str);
+}
+
+/**
+ * @brief walk the conversion specifications of @ref fmt, fetching
+ * their arguments
+ *
+ * @param[out] out_args if not NULL, where to store the arguments
+ * (strings still pointing to caller's memory)
+ * @param[out] n_argsp number of arguments
+ * @param[out] str_sizep total size needed to copy string arguments
+ *
+ * @return 0 on success, -1 if @ref fmt has unsupported conversions
+ */
+static int
+lazy_fmt_scan(const char *fmt, va_list *args,
+              struct lazy_fmt_arg *out_args,
+              int *n_argsp, size_t *str_sizep)
+{
+    const char *p;
+    struct lazy_fmt_spec spec;
+    struct lazy_fmt_arg arg;
+    int n_args;
+    size_t str_size;
+    int precision;
+    int i;
+
+    n_args = 0;
+    str_size = 0;
+    p = fmt;
+    while (NULL != (p = strchr(p, '%'))) {
+        if ('%' == p[1]) {
+            p += 2;
+            continue ;
+        }
+        p = lazy_fmt_parse_spec(p + 1, &spec);
+        if (NULL == p) {
+            return -1;
+        }
+        precision = spec.precision;
+        for (i = 0; i < spec.n_stars; ++i) {
+            lazy_fmt_fetch_arg(&arg, LAZY_FMT_ARG_INT, args);
+            if (i == spec.star_precision) {
+                precision = arg.u.i;
+            }
+            if (NULL != out_args) {
+                out_args[n_args] = arg;
+            }
+            ++n_args;
+        }
+        lazy_fmt_fetch_arg(&arg, spec.type, args);
+        if (LAZY_FMT_ARG_STR == spec.type && NULL != arg.u.s) {
+            str_size += lazy_fmt_str_arg_len(arg.u.s, precision) + 1;
+        }
+        if (NULL != out_args) {
+            out_args[n_args] = arg;
+        }
+        ++n_args;
+    }
+    *n_argsp = n_args;
+    *str_sizep = str_size;
+    return 0;
+}
+
+static struct lazy_fmt *
+lazy_fmt_new_eager(const char *fmt, va_list args)
+{
+    struct lazy_fmt *msg;
+    int len;
+    va_list args_copy;
+
+    va_copy(args_copy, args);
+    len = vsnprintf(NULL, 0, fmt, args_copy);
+    va_end(args_copy);
+    if (len < 0) {
+        len = 0;
+    }
+    msg = malloc_safe(sizeof (*msg) + len + 1);
+    memset(msg, 0, sizeof (*msg));
+    vsnprintf((char *)(msg + 1), len + 1, fmt, args);
+    msg->text = (char *)(msg + 1);
+    return msg;
+}
+
+/**
+ * @brief capture a printf-style message without formatting it
+ *
+ * @ref fmt and string arguments are copied, other arguments are
+ * captured by value (pointers printed with %p are not dereferenced).
+ */
+struct lazy_fmt *
+lazy_fmt_new(const char *fmt, va_list args)
+{
+    struct lazy_fmt *msg;
+    va_list args_copy;
+    int n_args;
+    size_t str_size;
+    size_t fmt_size;
+    char *storage;
+    int arg_i;
+    int precision;
+    struct lazy_fmt_spec spec;
+    const char *p;
+    int i;
+
+    va_copy(args_copy, args);
+    if (-1 == lazy_fmt_scan(fmt, &args_copy, NULL, &n_args, &str_size)) {
+        va_end(args_copy);
+        return lazy_fmt_new_eager(fmt, args);
+    }
+    va_end(args_copy);
+    fmt_size = strlen(fmt) + 1;
+    msg = malloc_safe(sizeof (*msg) + n_args * sizeof (struct lazy_fmt_arg)
+                      + fmt_size + str_size);
+    msg->next = NULL;
+    msg->str = NULL;
+    msg->text = NULL;
+    msg->n_args = n_args;
+    va_copy(args_copy, args);
+    (void) lazy_fmt_scan(fmt, &args_copy, msg->args, &n_args, &str_size);
+    va_end(args_copy);
+    storage = (char *)&msg->args[n_args];
+    memcpy(storage, fmt, fmt_size);
+    msg->fmt = storage;
+    storage += fmt_size;
+
+    // copy string arguments, bounded by their precision
+    arg_i = 0;
+    p = msg->fmt;
+    while (NULL != (p = strchr(p, '%'))) {
+        if ('%' == p[1]) {
+            p += 2;
+            continue ;
+        }
+        p = lazy_fmt_parse_spec(p + 1, &spec);
+        assert(NULL != p);
+        precision = spec.precision;
+        for (i = 0; i < spec.n_stars; ++i) {
+            if (i == spec.star_precision) {
+                precision = msg->args[arg_i].u.i;
+            }
+            ++arg_i;
+        }
+        if (LAZY_FMT_ARG_STR == spec.type && NULL != msg->args[arg_i].u.s) {
+            size_t len;
+
+            len = lazy_fmt_str_arg_len(msg->args[arg_i].u.s, precision);
+            memcpy(storage, msg->args[arg_i].u.s, len);
+            storage[len] = '\0';
+            msg->args[arg_i].u.s = storage;
+            storage += len + 1;
+        }
+        ++arg_i;
+    }
+    assert(arg_i == n_args);
+    return msg;
+}
+
+/**
+ * @brief append a printf-style message to @ref msg
+ */
+void
+lazy_fmt_append(struct lazy_fmt *msg, const char *fmt, va_list args)
+{
+    struct lazy_fmt *last;
+
+    for (last = msg; NULL != last->next; last = last->next)
+        ;
+    last->next = lazy_fmt_new(fmt, args);
+    free(msg->str);
+    msg->str = NULL;
+}
+
+static void
+lazy_fmt_print_spec(FILE *stream, const char *spec,
+                    int n_stars, const struct lazy_fmt_arg *args)
+{
+    const struct lazy_fmt_arg *arg;
+
+    arg = &args[n_stars];
+
+#define LAZY_FMT_PRINT(VALUE) do {                                      \
+        switch (n_stars) {                                              \
+        case 0:                                                         \
+            fprintf(stream, spec, VALUE);                               \
+            break ;                                                     \
+        case 1:                                                         \
+            fprintf(stream, spec, args[0].u.i, VALUE);                  \
+            break ;                                                     \
+        default:                                                        \
+            fprintf(stream, spec, args[0].u.i, args[1].u.i, VALUE);     \
+            break ;                                                     \
+        }                                                               \
+    } while (0)
+
+    switch (arg->type) {
+    case LAZY_FMT_ARG_INT:
+        LAZY_FMT_PRINT(arg->u.i);
+        break ;
+    case LAZY_FMT_ARG_LONG:
+        LAZY_FMT_PRINT(arg->u.l);
+        break ;
+    case LAZY_FMT_ARG_LLONG:
+        LAZY_FMT_PRINT(arg->u.ll);
+        break ;
+    case LAZY_FMT_ARG_SIZE:
+        LAZY_FMT_PRINT(arg->u.z);
+        break ;
+    case LAZY_FMT_ARG_INTMAX:
+        LAZY_FMT_PRINT(arg->u.j);
+        break ;
+    case LAZY_FMT_ARG_PTRDIFF:
+        LAZY_FMT_PRINT(arg->u.t);
+        break ;
+    case LAZY_FMT_ARG_DOUBLE:
+        LAZY_FMT_PRINT(arg->u.d);
+        break ;
+    case LAZY_FMT_ARG_LDOUBLE:
+        LAZY_FMT_PRINT(arg->u.ld);
+        break ;
+    case LAZY_FMT_ARG_PTR:
+        LAZY_FMT_PRINT(arg->u.p);
+        break ;
+    case LAZY_FMT_ARG_STR:
+        LAZY_FMT_PRINT(arg->u.s);
+        break ;
+    }
+#undef LAZY_FMT_PRINT
+}
+
+static void
+lazy_fmt_print(FILE *stream, const struct lazy_fmt *msg)
+{
+    const char *p;
+    const char *next;
+    const char *end;
+    struct lazy_fmt_spec spec;
+    char spec_buf[LAZY_FMT_MAX_SPEC_LEN];
+    int arg_i;
+
+    if (NULL == msg->fmt) {
+        fputs(msg->text, stream);
+        return ;
+    }
+    arg_i = 0;
+    p = msg->fmt;
+    while (NULL != (next = strchr(p, '%'))) {
+        fwrite(p, 1, next - p, stream);
+        if ('%' == next[1]) {
+            fputc('%', stream);
+            p = next + 2;
+            continue ;
+        }
+        end = lazy_fmt_parse_spec(next + 1, &spec);
+        assert(NULL != end);
+        memcpy(spec_buf, next, end - next);
+        spec_buf[end - next] = '\0';
+        lazy_fmt_print_spec(stream, spec_buf, spec.n_stars,
+                            &msg->args[arg_i]);
+        arg_i += spec.n_stars + 1;
+        p = end;
+    }
+    fputs(p, stream);
+}
+
+/**
+ * @brief get the formatted message, including appended messages
+ *
+ * The result is owned by @ref msg and stays valid until @ref msg is
+ * appended to or freed.
+ */
+const char *
+lazy_fmt_get_str(struct lazy_fmt *msg)
+{
+    FILE *stream;
+    size_t size;
+    const struct lazy_fmt *iter;
+
+    if (NULL != msg->str) {
+        return msg->str;
+    }
+    if (NULL == msg->next && NULL == msg->fmt) {
+        return msg->text;
+    }
+    stream = open_memstream(&msg->str, &size);
+    if (NULL == stream) {
+        return "";
+    }
+    for (iter = msg; NULL != iter; iter = iter->next) {
+        lazy_fmt_print(stream, iter);
+    }
+    fclose(stream);
+    return msg->str;
+}
+
+void
+lazy_fmt_free(struct lazy_fmt *msg)
+{
+    struct lazy_fmt *next;
+
+    if (NULL != msg) {
+        free(msg->str);
+    }
+    while (NULL != msg) {
+        next = msg->next;
+        free(msg);
+        msg = next;
+    }
+}
+
+#ifndef DISABLE_UTESTS
+
+#include <check.h>
+
+static struct lazy_fmt *
+lazy_fmt_new_test(const char *fmt, ...)
+{
+    struct lazy_fmt *msg;
+    va_list ap;
+
+    va_start(ap, fmt);
+    msg = lazy_fmt_new(fmt, ap);
+    va_end(ap);
+    return msg;
+}
+
+static void
+lazy_fmt_append_test(struct lazy_fmt *msg, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    lazy_fmt_append(msg, fmt, ap);
+    va_end(ap);
+}
+
+START_TEST(test_lazy_fmt)
+{
+    struct lazy_fmt *msg;
+    char fmt[64];
+    char str[16];
+    char expected[256];
+    int dummy;
+
+    // format and string arguments are copied
+    strcpy(fmt, "[%s|%.*s|%5.2s|%-4s]");
+    strcpy(str, "abcdef");
+    msg = lazy_fmt_new_test(fmt, str, 3, "xyz\xff", "ghi", (char *)NULL);
+    snprintf(expected, sizeof (expected), fmt,
+             str, 3, "xyz\xff", "ghi", (char *)NULL);
+    memset(fmt, 'X', sizeof (fmt) - 1);
+    memset(str, 'X', sizeof (str) - 1);
+    ck_assert_str_eq(lazy_fmt_get_str(msg), expected);
+    lazy_fmt_free(msg);
+
+    msg = lazy_fmt_new_test(
+        "%d %i %u %x %X %o %c %% %ld %lld %"PRIi64" %08"PRIx64
+        " %zu %3d %-*d %*.*d %hhd %hd %jd %td",
+        -1, 42, 3000000000U, 0xbeef, 0xbeef, 0644, 'c', -5L, -6LL,
+        (int64_t)-7, (uint64_t)0xabc, (size_t)12, 7, 5, 8, 6, 4, 9,
+        300, 70000, (intmax_t)-10, (ptrdiff_t)11);
+    snprintf(expected, sizeof (expected),
+             "%d %i %u %x %X %o %c %% %ld %lld %"PRIi64" %08"PRIx64
+             " %zu %3d %-*d %*.*d %hhd %hd %jd %td",
+             -1, 42, 3000000000U, 0xbeef, 0xbeef, 0644, 'c', -5L, -6LL,
+             (int64_t)-7, (uint64_t)0xabc, (size_t)12, 7, 5, 8, 6, 4, 9,
+             300, 70000, (intmax_t)-10, (ptrdiff_t)11);
+    ck_assert_str_eq(lazy_fmt_get_str(msg), expected);
+    lazy_fmt_free(msg);
+
+    msg = lazy_fmt_new_test("%le %.1f %g %Lf %p",
+                            1.5e10, 2.25, 0.1, (long double)3.5, &dummy);
+    snprintf(expected, sizeof (expected), "%le %.1f %g %Lf %p",
+             1.5e10, 2.25, 0.1, (long double)3.5, &dummy);
+    ck_assert_str_eq(lazy_fmt_get_str(msg), expected);
+    lazy_fmt_free(msg);
+
+    // positional arguments are formatted eagerly
+    msg = lazy_fmt_new_test("%2$s %1$d", 1, "two");
+    ck_assert_str_eq(lazy_fmt_get_str(msg), "two 1");
+
+    // appended messages
+    lazy_fmt_append_test(msg, " %s=%d", "three", 3);
+    ck_assert_str_eq(lazy_fmt_get_str(msg), "two 1 three=3");
+    lazy_fmt_append_test(msg, "%s", "!");
+    ck_assert_str_eq(lazy_fmt_get_str(msg), "two 1 three=3!");
+    lazy_fmt_free(msg);
+
+    msg = lazy_fmt_new_test("no argument");
+    ck_assert_str_eq(lazy_fmt_get_str(msg), "no argument");
+    lazy_fmt_free(msg);
+}
+END_TEST
+
+void check_lazy_fmt_add_tcases(Suite *s)
+{
+    TCase *tc_lazy_fmt;
+
+    tc_lazy_fmt = tcase_create("utils:lazy_fmt");
+    tcase_add_test(tc_lazy_fmt, test_lazy_fmt);
+    suite_add_tcase(s, tc_lazy_fmt);
+}
+
+#endif // #ifndef DISABLE_UTESTS
@@ -0,0 +1,219 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "utils/port.h"
+#include "utils/obj_pool.h"
+
+struct obj_pool_slab {
+    struct obj_pool_slab *next;
+};
+
+#define OBJ_POOL_SLAB_HEADER_SIZE                                       \
+    ((sizeof (struct obj_pool_slab) + OBJ_POOL_ALIGN - 1)               \
+     & ~(size_t)(OBJ_POOL_ALIGN - 1))
+
+/* the value of this key is the list of caches of the current thread,
+ * retired when the thread exits */
+static pthread_key_t obj_pool_thread_key;
+static pthread_once_t obj_pool_thread_key_once = PTHREAD_ONCE_INIT;
+
+
+static void
+obj_pool_stats_add(struct obj_pool_stats *sum,
+                   const struct obj_pool_stats *stats)
+{
+    sum->n_allocs += __atomic_load_n(&stats->n_allocs, __ATOMIC_RELAXED);
+    sum->n_reuses += __atomic_load_n(&stats->n_reuses, __ATOMIC_RELAXED);
+    sum->n_frees += __atomic_load_n(&stats->n_frees, __ATOMIC_RELAXED);
+    sum->n_slabs += __atomic_load_n(&stats->n_slabs, __ATOMIC_RELAXED);
+    sum->n_bytes += __atomic_load_n(&stats->n_bytes, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief hand the free objects of an exiting thread's cache over to
+ * its pool, then free the cache
+ */
+static void
+obj_pool_cache_retire(struct obj_pool_cache *cache)
+{
+    struct obj_pool *pool;
+    struct obj_pool_cache **pcache;
+    void **tailp;
+    void *obj;
+
+    pool = cache->pool;
+    pthread_mutex_lock(&pool->lock);
+    while (cache->bump < cache->bump_end) {
+        obj = cache->bump;
+        *(void **)obj = cache->free_list;
+        cache->free_list = obj;
+        cache->bump += pool->obj_size;
+    }
+    if (NULL != cache->free_list) {
+        tailp = &cache->free_list;
+        while (NULL != *tailp) {
+            tailp = (void **)*tailp;
+        }
+        *tailp = pool->orphans;
+        pool->orphans = cache->free_list;
+    }
+    obj_pool_stats_add(&pool->retired_stats, &cache->stats);
+    for (pcache = &pool->caches; *pcache != cache;
+         pcache = &(*pcache)->pool_next)
+        ;
+    *pcache = cache->pool_next;
+    pthread_mutex_unlock(&pool->lock);
+    free(cache);
+}
+
+static void
+obj_pool_thread_exit(void *arg)
+{
+    struct obj_pool_cache *cache;
+    struct obj_pool_cache *next_cache;
+
+    for (cache = arg; NULL != cache; cache = next_cache) {
+        next_cache = cache->thread_next;
+        obj_pool_cache_retire(cache);
+    }
+}
+
+static void
+obj_pool_thread_key_create(void)
+{
+    (void) pthread_key_create(&obj_pool_thread_key, obj_pool_thread_exit);
+}
+
+struct obj_pool_cache *
+obj_pool_cache_create(struct obj_pool *pool, struct obj_pool_cache **cachep)
+{
+    struct obj_pool_cache *cache;
+
+    cache = new_safe(struct obj_pool_cache);
+    cache->pool = pool;
+    pthread_once(&obj_pool_thread_key_once, obj_pool_thread_key_create);
+    cache->thread_next = pthread_getspecific(obj_pool_thread_key);
+    (void) pthread_setspecific(obj_pool_thread_key, cache);
+
+    pthread_mutex_lock(&pool->lock);
+    cache->pool_next = pool->caches;
+    pool->caches = cache;
+    pthread_mutex_unlock(&pool->lock);
+    *cachep = cache;
+    return cache;
+}
+
+/**
+ * @brief get a new object when the cache of the current thread is
+ * empty
+ *
+ * Objects left by exited threads are reused first, otherwise a new
+ * slab is allocated, which remaining objects are handed out next by
+ * the cache.
+ */
+void *
+obj_pool_refill(struct obj_pool *pool, struct obj_pool_cache *cache)
+{
+    struct obj_pool_slab *slab;
+    size_t slab_size;
+    char *obj;
+
+    pthread_mutex_lock(&pool->lock);
+    if (NULL != pool->orphans) {
+        obj = pool->orphans;
+        cache->free_list = *(void **)obj;
+        pool->orphans = NULL;
+        pthread_mutex_unlock(&pool->lock);
+        OBJ_POOL_STAT_INC(cache, n_reuses);
+        return obj;
+    }
+    slab_size = OBJ_POOL_SLAB_HEADER_SIZE
+        + pool->n_objs_per_slab * pool->obj_size;
+    slab = malloc_safe(slab_size);
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pthread_mutex_unlock(&pool->lock);
+
+    obj = (char *)slab + OBJ_POOL_SLAB_HEADER_SIZE;
+    cache->bump = obj + pool->obj_size;
+    cache->bump_end = (char *)slab + slab_size;
+    OBJ_POOL_STAT_INC(cache, n_slabs);
+    __atomic_store_n(&cache->stats.n_bytes,
+                     cache->stats.n_bytes + slab_size, __ATOMIC_RELAXED);
+    return obj;
+}
+
+void
+obj_pool_get_stats(struct obj_pool *pool, struct obj_pool_stats *statsp)
+{
+    struct obj_pool_cache *cache;
+
+    pthread_mutex_lock(&pool->lock);
+    *statsp = pool->retired_stats;
+    for (cache = pool->caches; NULL != cache; cache = cache->pool_next) {
+        obj_pool_stats_add(statsp, &cache->stats);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief release all slabs of a pool
+ *
+ * All objects of the pool must have been freed, and no other thread
+ * may use the pool concurrently. The pool remains usable afterwards.
+ */
+void
+obj_pool_destroy(struct obj_pool *pool)
+{
+    struct obj_pool_slab *slab;
+    struct obj_pool_cache *cache;
+
+    pthread_mutex_lock(&pool->lock);
+    while (NULL != pool->slabs) {
+        slab = pool->slabs;
+        pool->slabs = slab->next;
+        free(slab);
+    }
+    pool->orphans = NULL;
+    for (cache = pool->caches; NULL != cache; cache = cache->pool_next) {
+        cache->free_list = NULL;
+        cache->bump = NULL;
+        cache->bump_end = NULL;
+        // slabs are gone, only keep allocation counters
+        cache->stats.n_bytes = 0;
+    }
+    pool->retired_stats.n_bytes = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,1337 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "utils/regex.h"
+
+/** maximum number of NFA states of a compiled pattern */
+#define REGEX_MAX_NFA_STATES    10000
+/** maximum count in a "{m,n}" quantifier */
+#define REGEX_MAX_REPEAT        1000
+/** maximum nesting of groups */
+#define REGEX_MAX_DEPTH         256
+/** memory budget of each lazy DFA, its cache is flushed when full */
+#define REGEX_DFA_MAX_MEM_SIZE  (512 * 1024)
+#define REGEX_DFA_N_BUCKETS     512
+
+struct re_byteset {
+    uint64_t bits[4];
+};
+
+static inline void
+re_byteset_add(struct re_byteset *set, unsigned char c)
+{
+    set->bits[c >> 6] |= 1ull << (c & 63);
+}
+
+static inline int
+re_byteset_test(const struct re_byteset *set, unsigned char c)
+{
+    return 0 != (set->bits[c >> 6] & (1ull << (c & 63)));
+}
+
+static void
+re_byteset_add_range(struct re_byteset *set, int first, int last)
+{
+    int c;
+
+    for (c = first; c <= last; ++c) {
+        re_byteset_add(set, c);
+    }
+}
+
+static void
+re_byteset_invert(struct re_byteset *set)
+{
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        set->bits[i] = ~set->bits[i];
+    }
+}
+
+static void
+re_byteset_merge(struct re_byteset *set, const struct re_byteset *other)
+{
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        set->bits[i] |= other->bits[i];
+    }
+}
+
+
+/*
+ * parse tree
+ */
+
+enum re_node_type {
+    RE_NODE_EMPTY,
+    RE_NODE_SET,
+    RE_NODE_CONCAT,
+    RE_NODE_ALT,
+    RE_NODE_REPEAT,
+};
+
+struct re_node {
+    enum re_node_type type;
+    /** CONCAT and ALT operands, REPEAT operand in left */
+    struct re_node *left;
+    struct re_node *right;
+    /** REPEAT bounds, max is -1 if unbounded */
+    int min;
+    int max;
+    /** SET bytes */
+    struct re_byteset set;
+    /** SET index in the compiled regex, -1 until compiled */
+    int set_index;
+    /** list of all allocated nodes */
+    struct re_node *alloc_next;
+};
+
+struct re_parser {
+    const unsigned char *p;
+    const unsigned char *end;
+    const char *errmsg;
+    int depth;
+    /** an alternation is not enclosed in a group */
+    int top_level_alt;
+    struct re_node *nodes;
+};
+
+static struct re_node *
+re_node_new(struct re_parser *ps, enum re_node_type type)
+{
+    struct re_node *node;
+
+    node = new_safe(struct re_node);
+    node->type = type;
+    node->set_index = -1;
+    node->alloc_next = ps->nodes;
+    ps->nodes = node;
+    return node;
+}
+
+static struct re_node *
+re_node_new_binary(struct re_parser *ps, enum re_node_type type,
+                   struct re_node *left, struct re_node *right)
+{
+    struct re_node *node;
+
+    node = re_node_new(ps, type);
+    node->left = left;
+    node->right = right;
+    return node;
+}
+
+static void
+re_parser_free_nodes(struct re_parser *ps)
+{
+    struct re_node *node;
+    struct re_node *next;
+
+    for (node = ps->nodes; NULL != node; node = next) {
+        next = node->alloc_next;
+        free(node);
+    }
+    ps->nodes = NULL;
+}
+
+static struct re_node *
+re_parse_error(struct re_parser *ps, const char *errmsg)
+{
+    ps->errmsg = errmsg;
+    return NULL;
+}
+
+static int
+re_hex_digit(int c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static int
+re_is_alnum(int c)
+{
+    return ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')
+            || (c >= 'A' && c <= 'Z'));
+}
+
+/**
+ * @brief parse an escape sequence after its backslash
+ *
+ * @return the escaped byte, -1 if the escape is a class (stored in
+ * @ref set), -2 on error
+ */
+static int
+re_parse_escape(struct re_parser *ps, struct re_byteset *set)
+{
+    int c;
+    int hi;
+    int lo;
+    int negate;
+
+    if (ps->p == ps->end) {
+        ps->errmsg = "trailing backslash";
+        return -2;
+    }
+    c = *ps->p++;
+    negate = FALSE;
+    memset(set, 0, sizeof (*set));
+    switch (c) {
+    case 'D':
+        negate = TRUE;
+        /*FALLTHROUGH*/
+    case 'd':
+        re_byteset_add_range(set, '0', '9');
+        break ;
+    case 'W':
+        negate = TRUE;
+        /*FALLTHROUGH*/
+    case 'w':
+        re_byteset_add_range(set, '0', '9');
+        re_byteset_add_range(set, 'a', 'z');
+        re_byteset_add_range(set, 'A', 'Z');
+        re_byteset_add(set, '_');
+        break ;
+    case 'S':
+        negate = TRUE;
+        /*FALLTHROUGH*/
+    case 's':
+        re_byteset_add(set, ' ');
+        re_byteset_add_range(set, '\t', '\r');
+        break ;
+    case 'n':
+        return '\n';
+    case 'r':
+        return '\r';
+    case 't':
+        return '\t';
+    case 'f':
+        return '\f';
+    case 'v':
+        return '\v';
+    case '0':
+        return '\0';
+    case 'x':
+        if (ps->end - ps->p < 2
+            || -1 == (hi = re_hex_digit(ps->p[0]))
+            || -1 == (lo = re_hex_digit(ps->p[1]))) {
+            ps->errmsg = "\\x must be followed by two hexadecimal digits";
+            return -2;
+        }
+        ps->p += 2;
+        return (hi << 4) | lo;
+    default:
+        if (re_is_alnum(c)) {
+            ps->errmsg = "unknown escape sequence";
+            return -2;
+        }
+        return c;
+    }
+    if (negate) {
+        re_byteset_invert(set);
+    }
+    return -1;
+}
+
+static struct re_node *
+re_parse_class(struct re_parser *ps)
+{
+    struct re_node *node;
+    struct re_byteset escape_set;
+    int negate;
+    int first;
+    int lo;
+    int hi;
+
+    node = re_node_new(ps, RE_NODE_SET);
+    negate = FALSE;
+    if (ps->p < ps->end && '^' == *ps->p) {
+        negate = TRUE;
+        ++ps->p;
+    }
+    first = TRUE;
+    for (;;) {
+        if (ps->p == ps->end) {
+            return re_parse_error(ps, "missing ']'");
+        }
+        if (']' == *ps->p && !first) {
+            ++ps->p;
+            break ;
+        }
+        first = FALSE;
+        lo = *ps->p++;
+        if ('\\' == lo) {
+            lo = re_parse_escape(ps, &escape_set);
+            if (-2 == lo) {
+                return NULL;
+            }
+            if (-1 == lo) {
+                re_byteset_merge(&node->set, &escape_set);
+                continue ;
+            }
+        }
+        if (ps->end - ps->p >= 2 && '-' == ps->p[0] && ']' != ps->p[1]) {
+            ++ps->p;
+            hi = *ps->p++;
+            if ('\\' == hi) {
+                hi = re_parse_escape(ps, &escape_set);
+                if (-2 == hi) {
+                    return NULL;
+                }
+                if (-1 == hi) {
+                    return re_parse_error(ps, "bad range in bracket class");
+                }
+            }
+            if (hi < lo) {
+                return re_parse_error(ps, "bad range in bracket class");
+            }
+            re_byteset_add_range(&node->set, lo, hi);
+        } else {
+            re_byteset_add(&node->set, lo);
+        }
+    }
+    if (negate) {
+        re_byteset_invert(&node->set);
+    }
+    return node;
+}
+
+static struct re_node *
+re_parse_alt(struct re_parser *ps);
+
+static struct re_node *
+re_parse_atom(struct re_parser *ps)
+{
+    struct re_node *node;
+    int c;
+
+    c = *ps->p++;
+    switch (c) {
+    case '(':
+        if (++ps->depth > REGEX_MAX_DEPTH) {
+            return re_parse_error(ps, "too many nested groups");
+        }
+        if (ps->end - ps->p >= 2 && '?' == ps->p[0] && ':' == ps->p[1]) {
+            ps->p += 2;
+        }
+        node = re_parse_alt(ps);
+        if (NULL == node) {
+            return NULL;
+        }
+        if (ps->p == ps->end || ')' != *ps->p) {
+            return re_parse_error(ps, "missing ')'");
+        }
+        ++ps->p;
+        --ps->depth;
+        return node;
+    case '[':
+        return re_parse_class(ps);
+    case '.':
+        node = re_node_new(ps, RE_NODE_SET);
+        re_byteset_add(&node->set, '\n');
+        re_byteset_invert(&node->set);
+        return node;
+    case '\\':
+        node = re_node_new(ps, RE_NODE_SET);
+        c = re_parse_escape(ps, &node->set);
+        if (-2 == c) {
+            return NULL;
+        }
+        if (c >= 0) {
+            re_byteset_add(&node->set, c);
+        }
+        return node;
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+        return re_parse_error(ps, "quantifier has nothing to repeat");
+    case '^':
+    case '$':
+        return re_parse_error(
+            ps, "anchors are only supported at start and end of pattern");
+    default:
+        node = re_node_new(ps, RE_NODE_SET);
+        re_byteset_add(&node->set, c);
+        return node;
+    }
+}
+
+static int
+re_parse_count(struct re_parser *ps)
+{
+    int count;
+
+    if (ps->p == ps->end || *ps->p < '0' || *ps->p > '9') {
+        return -1;
+    }
+    count = 0;
+    while (ps->p < ps->end && *ps->p >= '0' && *ps->p <= '9') {
+        count = count * 10 + (*ps->p++ - '0');
+        if (count > REGEX_MAX_REPEAT) {
+            return -2;
+        }
+    }
+    return count;
+}
+
+static struct re_node *
+re_parse_repeat(struct re_parser *ps)
+{
+    struct re_node *node;
+    struct re_node *repeat;
+    int min;
+    int max;
+
+    node = re_parse_atom(ps);
+    if (NULL == node) {
+        return NULL;
+    }
+    while (ps->p < ps->end) {
+        switch (*ps->p) {
+        case '*':
+            min = 0;
+            max = -1;
+            ++ps->p;
+            break ;
+        case '+':
+            min = 1;
+            max = -1;
+            ++ps->p;
+            break ;
+        case '?':
+            min = 0;
+            max = 1;
+            ++ps->p;
+            break ;
+        case '{':
+            ++ps->p;
+            min = re_parse_count(ps);
+            if (min < 0) {
+                return re_parse_error(
+                    ps, min == -2 ? "repeat count too large" :
+                    "bad repeat count");
+            }
+            max = min;
+            if (ps->p < ps->end && ',' == *ps->p) {
+                ++ps->p;
+                if (ps->p < ps->end && '}' == *ps->p) {
+                    max = -1;
+                } else {
+                    max = re_parse_count(ps);
+                    if (max < 0) {
+                        return re_parse_error(
+                            ps, max == -2 ? "repeat count too large" :
+                            "bad repeat count");
+                    }
+                    if (max < min) {
+                        return re_parse_error(ps, "bad repeat count");
+                    }
+                }
+            }
+            if (ps->p == ps->end || '}' != *ps->p) {
+                return re_parse_error(ps, "missing '}'");
+            }
+            ++ps->p;
+            break ;
+        default:
+            return node;
+        }
+        repeat = re_node_new(ps, RE_NODE_REPEAT);
+        repeat->left = node;
+        repeat->min = min;
+        repeat->max = max;
+        node = repeat;
+    }
+    return node;
+}
+
+static struct re_node *
+re_parse_concat(struct re_parser *ps)
+{
+    struct re_node *node;
+    struct re_node *repeat;
+
+    node = re_node_new(ps, RE_NODE_EMPTY);
+    while (ps->p < ps->end && '|' != *ps->p && ')' != *ps->p) {
+        repeat = re_parse_repeat(ps);
+        if (NULL == repeat) {
+            return NULL;
+        }
+        if (RE_NODE_EMPTY == node->type) {
+            node = repeat;
+        } else {
+            node = re_node_new_binary(ps, RE_NODE_CONCAT, node, repeat);
+        }
+    }
+    return node;
+}
+
+static struct re_node *
+re_parse_alt(struct re_parser *ps)
+{
+    struct re_node *node;
+    struct re_node *right;
+
+    node = re_parse_concat(ps);
+    if (NULL == node) {
+        return NULL;
+    }
+    while (ps->p < ps->end && '|' == *ps->p) {
+        ++ps->p;
+        if (0 == ps->depth) {
+            ps->top_level_alt = TRUE;
+        }
+        right = re_parse_concat(ps);
+        if (NULL == right) {
+            return NULL;
+        }
+        node = re_node_new_binary(ps, RE_NODE_ALT, node, right);
+    }
+    return node;
+}
+
+
+/*
+ * NFA (Thompson construction, built backwards from the match state)
+ */
+
+enum re_nfa_state_type {
+    RE_NFA_SET,
+    RE_NFA_SPLIT,
+    RE_NFA_MATCH,
+};
+
+struct re_nfa_state {
+    enum re_nfa_state_type type;
+    int out;
+    int out1;      /* SPLIT only */
+    int set_index; /* SET only */
+};
+
+struct re_nfa {
+    struct re_nfa_state *states;
+    int n_states;
+    int start;
+};
+
+/*
+ * lazy DFA
+ */
+
+struct re_dfa_state {
+    struct re_dfa_state *hash_next;
+    uint32_t hash;
+    int is_match;
+    /** sorted SET and MATCH NFA states, none for the dead state */
+    int n_nfa_states;
+    int *nfa_states;
+    /** transitions per byte class, NULL if not computed yet */
+    struct re_dfa_state *next[];
+};
+
+struct re_dfa {
+    const struct re_nfa *nfa;
+    /** add the NFA start state after each byte (unanchored search) */
+    int unanchored;
+    struct re_dfa_state *buckets[REGEX_DFA_N_BUCKETS];
+    struct re_dfa_state *start;
+    size_t mem_size;
+};
+
+struct regex {
+    struct re_byteset *sets;
+    int n_sets;
+    int n_classes;
+    unsigned char class_of[256];
+    unsigned char class_rep[256];
+    struct re_nfa nfa;
+    /** NFA of the reversed pattern */
+    struct re_nfa rev_nfa;
+    int anchored_start;
+    int anchored_end;
+    int matches_empty;
+    /** finds the end of the first match */
+    struct re_dfa dfa_search;
+    /** finds the start of a match from its end */
+    struct re_dfa dfa_reverse;
+    /** extends a match from its start */
+    struct re_dfa dfa_forward;
+    pthread_mutex_t lock;
+    /* scratch space for DFA state construction (sparse set) */
+    int *stack;
+    int *sparse;
+    int *dense;
+    int n_dense;
+    int *list;
+};
+
+struct re_builder {
+    struct regex *regex;
+    struct re_nfa *nfa;
+    int reverse;
+    int n_max_states;
+};
+
+static int
+re_nfa_add(struct re_builder *b, enum re_nfa_state_type type,
+           int out, int out1, int set_index)
+{
+    struct re_nfa *nfa;
+    struct re_nfa_state *state;
+
+    nfa = b->nfa;
+    if (nfa->n_states == REGEX_MAX_NFA_STATES) {
+        return -1;
+    }
+    if (nfa->n_states == b->n_max_states) {
+        b->n_max_states = (0 == b->n_max_states ? 16 :
+                           MIN(2 * b->n_max_states, REGEX_MAX_NFA_STATES));
+        nfa->states = realloc_safe(
+            nfa->states, b->n_max_states * sizeof (*nfa->states));
+    }
+    state = &nfa->states[nfa->n_states];
+    state->type = type;
+    state->out = out;
+    state->out1 = out1;
+    state->set_index = set_index;
+    return nfa->n_states++;
+}
+
+/**
+ * @brief build the NFA states of @ref node, continuing to @ref next
+ *
+ * @return the entry state, or -1 if the NFA is too large
+ */
+static int
+re_nfa_build(struct re_builder *b, struct re_node *node, int next)
+{
+    struct regex *regex;
+    int first;
+    int body;
+    int split;
+    int cur;
+    int i;
+
+    switch (node->type) {
+    case RE_NODE_EMPTY:
+        return next;
+    case RE_NODE_SET:
+        regex = b->regex;
+        if (-1 == node->set_index) {
+            regex->sets = realloc_safe(
+                regex->sets, (regex->n_sets + 1) * sizeof (*regex->sets));
+            regex->sets[regex->n_sets] = node->set;
+            node->set_index = regex->n_sets++;
+        }
+        return re_nfa_add(b, RE_NFA_SET, next, -1, node->set_index);
+    case RE_NODE_CONCAT:
+        if (b->reverse) {
+            first = re_nfa_build(b, node->left, next);
+            return -1 == first ? -1 : re_nfa_build(b, node->right, first);
+        }
+        first = re_nfa_build(b, node->right, next);
+        return -1 == first ? -1 : re_nfa_build(b, node->left, first);
+    case RE_NODE_ALT:
+        first = re_nfa_build(b, node->left, next);
+        if (-1 == first) {
+            return -1;
+        }
+        body = re_nfa_build(b, node->right, next);
+        if (-1 == body) {
+            return -1;
+        }
+        return re_nfa_add(b, RE_NFA_SPLIT, first, body, -1);
+    case RE_NODE_REPEAT:
+        cur = next;
+        if (-1 == node->max) {
+            split = re_nfa_add(b, RE_NFA_SPLIT, -1, next, -1);
+            if (-1 == split) {
+                return -1;
+            }
+            body = re_nfa_build(b, node->left, split);
+            if (-1 == body) {
+                return -1;
+            }
+            b->nfa->states[split].out = body;
+            cur = split;
+        } else {
+            for (i = node->min; i < node->max; ++i) {
+                body = re_nfa_build(b, node->left, cur);
+                if (-1 == body) {
+                    return -1;
+                }
+                cur = re_nfa_add(b, RE_NFA_SPLIT, body, next, -1);
+                if (-1 == cur) {
+                    return -1;
+                }
+            }
+        }
+        for (i = 0; i < node->min; ++i) {
+            cur = re_nfa_build(b, node->left, cur);
+            if (-1 == cur) {
+                return -1;
+            }
+        }
+        return cur;
+    default:
+        assert(0);
+        return -1;
+    }
+}
+
+static int
+re_nfa_compile(struct regex *regex, struct re_node *root, int reverse,
+               struct re_nfa *nfa)
+{
+    struct re_builder b;
+    int match;
+
+    memset(&b, 0, sizeof (b));
+    b.regex = regex;
+    b.nfa = nfa;
+    b.reverse = reverse;
+    match = re_nfa_add(&b, RE_NFA_MATCH, -1, -1, -1);
+    nfa->start = re_nfa_build(&b, root, match);
+    return -1 == nfa->start ? -1 : 0;
+}
+
+/**
+ * @brief split bytes into classes of bytes accepted by the same sets
+ */
+static void
+re_compute_byte_classes(struct regex *regex)
+{
+    int new_class[256];
+    int n_classes;
+    int s;
+    int c;
+    int old_class;
+    int n_new_classes;
+    int renumber[512];
+
+    memset(regex->class_of, 0, sizeof (regex->class_of));
+    n_classes = 1;
+    for (s = 0; s < regex->n_sets; ++s) {
+        // bytes of each class that are in the set move to a new class
+        for (c = 0; c < 2 * n_classes; ++c) {
+            renumber[c] = -1;
+        }
+        for (c = 0; c < 256; ++c) {
+            old_class = regex->class_of[c];
+            if (re_byteset_test(&regex->sets[s], c)) {
+                new_class[c] = n_classes + old_class;
+            } else {
+                new_class[c] = old_class;
+            }
+        }
+        // renumber classes in order of first byte
+        n_new_classes = 0;
+        for (c = 0; c < 256; ++c) {
+            if (-1 == renumber[new_class[c]]) {
+                renumber[new_class[c]] = n_new_classes++;
+            }
+            regex->class_of[c] = renumber[new_class[c]];
+        }
+        n_classes = n_new_classes;
+    }
+    regex->n_classes = n_classes;
+    for (c = 255; c >= 0; --c) {
+        regex->class_rep[regex->class_of[c]] = c;
+    }
+}
+
+static void
+re_dfa_init(struct re_dfa *dfa, const struct re_nfa *nfa, int unanchored)
+{
+    memset(dfa, 0, sizeof (*dfa));
+    dfa->nfa = nfa;
+    dfa->unanchored = unanchored;
+}
+
+static void
+re_dfa_flush(struct re_dfa *dfa)
+{
+    struct re_dfa_state *state;
+    struct re_dfa_state *next;
+    int i;
+
+    for (i = 0; i < REGEX_DFA_N_BUCKETS; ++i) {
+        for (state = dfa->buckets[i]; NULL != state; state = next) {
+            next = state->hash_next;
+            free(state);
+        }
+        dfa->buckets[i] = NULL;
+    }
+    dfa->start = NULL;
+    dfa->mem_size = 0;
+}
+
+/**
+ * @brief add the epsilon closure of NFA state @ref first to the
+ * scratch sparse set
+ */
+static void
+re_closure_add(struct regex *regex, const struct re_nfa *nfa, int first)
+{
+    const struct re_nfa_state *state;
+    int n_stack;
+    int s;
+
+    n_stack = 0;
+    regex->stack[n_stack++] = first;
+    while (n_stack > 0) {
+        s = regex->stack[--n_stack];
+        if ((unsigned int)regex->sparse[s] < (unsigned int)regex->n_dense
+            && regex->dense[regex->sparse[s]] == s) {
+            continue ;
+        }
+        regex->sparse[s] = regex->n_dense;
+        regex->dense[regex->n_dense++] = s;
+        state = &nfa->states[s];
+        if (RE_NFA_SPLIT == state->type) {
+            regex->stack[n_stack++] = state->out1;
+            regex->stack[n_stack++] = state->out;
+        }
+    }
+}
+
+static int
+re_int_cmp(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+/**
+ * @brief get the DFA state of the NFA states in the scratch sparse
+ * set, creating it if needed
+ *
+ * @param[out] flushedp set to TRUE if the DFA cache has been flushed
+ */
+static struct re_dfa_state *
+re_dfa_get_state(struct regex *regex, struct re_dfa *dfa, int *flushedp)
+{
+    const struct re_nfa *nfa;
+    struct re_dfa_state *state;
+    uint32_t hash;
+    int is_match;
+    int n;
+    int i;
+    int s;
+    size_t state_size;
+
+    nfa = dfa->nfa;
+    n = 0;
+    is_match = FALSE;
+    for (i = 0; i < regex->n_dense; ++i) {
+        s = regex->dense[i];
+        if (RE_NFA_SPLIT != nfa->states[s].type) {
+            regex->list[n++] = s;
+            if (RE_NFA_MATCH == nfa->states[s].type) {
+                is_match = TRUE;
+            }
+        }
+    }
+    qsort(regex->list, n, sizeof (int), re_int_cmp);
+    hash = 2166136261u;
+    for (i = 0; i < n; ++i) {
+        hash = (hash ^ (uint32_t)regex->list[i]) * 16777619u;
+    }
+    for (state = dfa->buckets[hash % REGEX_DFA_N_BUCKETS];
+         NULL != state; state = state->hash_next) {
+        if (state->hash == hash && state->n_nfa_states == n
+            && 0 == memcmp(state->nfa_states, regex->list,
+                           n * sizeof (int))) {
+            return state;
+        }
+    }
+    state_size = (sizeof (*state)
+                  + regex->n_classes * sizeof (state->next[0])
+                  + n * sizeof (int));
+    if (dfa->mem_size + state_size > REGEX_DFA_MAX_MEM_SIZE) {
+        re_dfa_flush(dfa);
+        *flushedp = TRUE;
+    }
+    state = malloc_safe(state_size);
+    memset(state, 0, sizeof (*state)
+           + regex->n_classes * sizeof (state->next[0]));
+    state->hash = hash;
+    state->is_match = is_match;
+    state->n_nfa_states = n;
+    state->nfa_states = (int *)&state->next[regex->n_classes];
+    memcpy(state->nfa_states, regex->list, n * sizeof (int));
+    state->hash_next = dfa->buckets[hash % REGEX_DFA_N_BUCKETS];
+    dfa->buckets[hash % REGEX_DFA_N_BUCKETS] = state;
+    dfa->mem_size += state_size;
+    return state;
+}
+
+static struct re_dfa_state *
+re_dfa_get_start(struct regex *regex, struct re_dfa *dfa)
+{
+    int flushed;
+
+    if (NULL == dfa->start) {
+        regex->n_dense = 0;
+        re_closure_add(regex, dfa->nfa, dfa->nfa->start);
+        flushed = FALSE;
+        dfa->start = re_dfa_get_state(regex, dfa, &flushed);
+    }
+    return dfa->start;
+}
+
+static struct re_dfa_state *
+re_dfa_compute_next(struct regex *regex, struct re_dfa *dfa,
+                    struct re_dfa_state *state, int byte_class)
+{
+    const struct re_nfa *nfa;
+    const struct re_nfa_state *nfa_state;
+    struct re_dfa_state *next;
+    unsigned char c;
+    int flushed;
+    int i;
+
+    nfa = dfa->nfa;
+    c = regex->class_rep[byte_class];
+    regex->n_dense = 0;
+    for (i = 0; i < state->n_nfa_states; ++i) {
+        nfa_state = &nfa->states[state->nfa_states[i]];
+        if (RE_NFA_SET == nfa_state->type
+            && re_byteset_test(&regex->sets[nfa_state->set_index], c)) {
+            re_closure_add(regex, nfa, nfa_state->out);
+        }
+    }
+    if (dfa->unanchored) {
+        re_closure_add(regex, nfa, nfa->start);
+    }
+    flushed = FALSE;
+    next = re_dfa_get_state(regex, dfa, &flushed);
+    if (!flushed) {
+        // otherwise the source state does not exist anymore
+        state->next[byte_class] = next;
+    }
+    return next;
+}
+
+static inline struct re_dfa_state *
+re_dfa_step(struct regex *regex, struct re_dfa *dfa,
+            struct re_dfa_state *state, unsigned char c)
+{
+    struct re_dfa_state *next;
+    int byte_class;
+
+    byte_class = regex->class_of[c];
+    next = state->next[byte_class];
+    if (likely(NULL != next)) {
+        return next;
+    }
+    return re_dfa_compute_next(regex, dfa, state, byte_class);
+}
+
+
+struct regex *
+regex_compile(const char *pattern, size_t pattern_size,
+              const char **errmsgp)
+{
+    struct re_parser ps;
+    struct regex *regex;
+    struct re_node *root;
+    int n_scratch;
+
+    memset(&ps, 0, sizeof (ps));
+    ps.p = (const unsigned char *)pattern;
+    ps.end = ps.p + pattern_size;
+    regex = new_safe(struct regex);
+    if (ps.p < ps.end && '^' == *ps.p) {
+        regex->anchored_start = TRUE;
+        ++ps.p;
+    }
+    if (ps.end > ps.p && '$' == ps.end[-1]) {
+        const unsigned char *bs;
+
+        // not anchored if escaped with an odd number of backslashes
+        for (bs = ps.end - 1; bs > ps.p && '\\' == bs[-1]; --bs)
+            ;
+        if (0 == (ps.end - 1 - bs) % 2) {
+            regex->anchored_end = TRUE;
+            --ps.end;
+        }
+    }
+    root = re_parse_alt(&ps);
+    if (NULL != root && ps.p < ps.end) {
+        root = re_parse_error(&ps, "unmatched ')'");
+    }
+    if (NULL != root && ps.top_level_alt
+        && (regex->anchored_start || regex->anchored_end)) {
+        // "^a|b" would be ambiguous
+        root = re_parse_error(
+            &ps, "anchored alternation must be enclosed in a group");
+    }
+    if (NULL == root) {
+        *errmsgp = ps.errmsg;
+        re_parser_free_nodes(&ps);
+        free(regex);
+        return NULL;
+    }
+    if (-1 == re_nfa_compile(regex, root, FALSE, &regex->nfa)
+        || -1 == re_nfa_compile(regex, root, TRUE, &regex->rev_nfa)) {
+        *errmsgp = "pattern too large";
+        re_parser_free_nodes(&ps);
+        free(regex->nfa.states);
+        free(regex->rev_nfa.states);
+        free(regex->sets);
+        free(regex);
+        return NULL;
+    }
+    re_parser_free_nodes(&ps);
+    re_compute_byte_classes(regex);
+
+    n_scratch = MAX(regex->nfa.n_states, regex->rev_nfa.n_states);
+    regex->stack = malloc_safe((2 * n_scratch + 1) * sizeof (int));
+    regex->sparse = malloc_safe(n_scratch * sizeof (int));
+    regex->dense = malloc_safe(n_scratch * sizeof (int));
+    regex->list = malloc_safe(n_scratch * sizeof (int));
+    re_dfa_init(&regex->dfa_search, &regex->nfa, !regex->anchored_start);
+    re_dfa_init(&regex->dfa_reverse, &regex->rev_nfa, FALSE);
+    re_dfa_init(&regex->dfa_forward, &regex->nfa, FALSE);
+    regex->matches_empty =
+        re_dfa_get_start(regex, &regex->dfa_forward)->is_match;
+    pthread_mutex_init(&regex->lock, NULL);
+    return regex;
+}
+
+void
+regex_free(struct regex *regex)
+{
+    if (NULL == regex) {
+        return ;
+    }
+    re_dfa_flush(&regex->dfa_search);
+    re_dfa_flush(&regex->dfa_reverse);
+    re_dfa_flush(&regex->dfa_forward);
+    pthread_mutex_destroy(&regex->lock);
+    free(regex->nfa.states);
+    free(regex->rev_nfa.states);
+    free(regex->sets);
+    free(regex->stack);
+    free(regex->sparse);
+    free(regex->dense);
+    free(regex->list);
+    free(regex);
+}
+
+int
+regex_matches_empty(const struct regex *regex)
+{
+    return regex->matches_empty;
+}
+
+/**
+ * @brief find the end of the first match ending in @ref text
+ */
+static int
+re_search_end(struct regex *regex, const unsigned char *text, size_t size,
+              size_t *endp)
+{
+    struct re_dfa *dfa;
+    struct re_dfa_state *state;
+    size_t pos;
+
+    dfa = &regex->dfa_search;
+    state = re_dfa_get_start(regex, dfa);
+    if (state->is_match && (!regex->anchored_end || 0 == size)) {
+        *endp = 0;
+        return TRUE;
+    }
+    for (pos = 0; pos < size; ++pos) {
+        state = re_dfa_step(regex, dfa, state, text[pos]);
+        if (state->is_match) {
+            if (!regex->anchored_end || pos + 1 == size) {
+                *endp = pos + 1;
+                return TRUE;
+            }
+        } else if (0 == state->n_nfa_states) {
+            return FALSE;
+        }
+    }
+    return FALSE;
+}
+
+int
+regex_match(struct regex *regex, const char *text, size_t text_size)
+{
+    size_t end;
+    int found;
+
+    pthread_mutex_lock(&regex->lock);
+    found = re_search_end(regex, (const unsigned char *)text, text_size,
+                          &end);
+    pthread_mutex_unlock(&regex->lock);
+    return found;
+}
+
+int
+regex_search(struct regex *regex, const char *text, size_t text_size,
+             size_t *startp, size_t *endp, int *truncatedp)
+{
+    const unsigned char *utext = (const unsigned char *)text;
+    struct re_dfa_state *state;
+    size_t end;
+    size_t start;
+    size_t pos;
+
+    pthread_mutex_lock(&regex->lock);
+    if (!re_search_end(regex, utext, text_size, &end)) {
+        pthread_mutex_unlock(&regex->lock);
+        return FALSE;
+    }
+    // leftmost start of a match ending at end: run the reversed
+    // pattern backwards
+    start = end;
+    state = re_dfa_get_start(regex, &regex->dfa_reverse);
+    for (pos = end; pos > 0; --pos) {
+        state = re_dfa_step(regex, &regex->dfa_reverse, state,
+                            utext[pos - 1]);
+        if (state->is_match) {
+            if (!regex->anchored_start || 1 == pos) {
+                start = pos - 1;
+            }
+        } else if (0 == state->n_nfa_states) {
+            break ;
+        }
+    }
+    // longest match from start
+    state = re_dfa_get_start(regex, &regex->dfa_forward);
+    for (pos = start; pos < text_size; ++pos) {
+        state = re_dfa_step(regex, &regex->dfa_forward, state, utext[pos]);
+        if (state->is_match) {
+            if (!regex->anchored_end || pos + 1 == text_size) {
+                end = MAX(end, pos + 1);
+            }
+        } else if (0 == state->n_nfa_states) {
+            break ;
+        }
+    }
+    // the match may extend if the text ends in a state with SET
+    // states left, besides the single MATCH state
+    if (NULL != truncatedp) {
+        *truncatedp = pos == text_size
+            && (state->n_nfa_states > (state->is_match ? 1 : 0)
+                || regex->anchored_end);
+    }
+    pthread_mutex_unlock(&regex->lock);
+    *startp = start;
+    *endp = end;
+    return TRUE;
+}
+
+
+#ifndef DISABLE_UTESTS
+
+#include <check.h>
+
+struct regex_search_test {
+    const char *pattern;
+    const char *text;
+    size_t text_size;
+    /** expected match, or -1 if no match */
+    int start;
+    int end;
+};
+
+#define RE_TEST(pattern, text, start, end)              \
+    { pattern, text, sizeof (text) - 1, start, end }
+
+START_TEST(test_regex_search)
+{
+    static const struct regex_search_test tests[] = {
+        RE_TEST("\\r\\n", "abc\r\ndef\r\n", 3, 5),
+        RE_TEST("\\r?\\n", "abc\ndef\r\n", 3, 4),
+        RE_TEST("\\n\\n+", "a\nb\n\n\nc", 3, 6),
+        RE_TEST("[,;]\\s*", "abc ;  def", 4, 7),
+        RE_TEST("a|bc", "xbcxa", 1, 3),
+        RE_TEST("(ab)+", "xabababa", 1, 7),
+        RE_TEST("a{2,3}", "a-aaaa", 2, 5),
+        RE_TEST("a{2}", "a-a", -1, -1),
+        RE_TEST("a{2,}", "xaaaaa", 1, 6),
+        RE_TEST("\\x00\\x00", "ab\0c\0\0d", 4, 6),
+        RE_TEST("[^a-c]", "abcd", 3, 4),
+        RE_TEST("[]a]+", "x]a]y", 1, 4),
+        RE_TEST("[a-]+", "x-a-y", 1, 4),
+        RE_TEST("\\d+\\.\\d*", "v 12.5.", 2, 6),
+        RE_TEST("\\w+", "  foo_1 ", 2, 7),
+        RE_TEST("\\W", "ab c", 2, 3),
+        RE_TEST("a.c", "a\nc abc", 4, 7),
+        RE_TEST("^ab", "abab", 0, 2),
+        RE_TEST("^ab", "xab", -1, -1),
+        RE_TEST("ab$", "abab", 2, 4),
+        RE_TEST("ab\\$", "ab$", 0, 3),
+        RE_TEST("^(a|b)*$", "abba", 0, 4),
+        RE_TEST("^(a|b)*$", "abca", -1, -1),
+        RE_TEST("(?:xy|x)z", "xxyz", 1, 4),
+        RE_TEST("", "abc", 0, 0),
+    };
+    struct regex *regex;
+    const char *errmsg;
+    size_t start;
+    size_t end;
+    int found;
+    int i;
+
+    for (i = 0; i < N_ELEM(tests); ++i) {
+        regex = regex_compile(tests[i].pattern, strlen(tests[i].pattern),
+                              &errmsg);
+        ck_assert(NULL != regex);
+        found = regex_search(regex, tests[i].text, tests[i].text_size,
+                             &start, &end, NULL);
+        if (-1 == tests[i].start) {
+            ck_assert(!found);
+        } else {
+            ck_assert(found);
+            ck_assert_int_eq(start, tests[i].start);
+            ck_assert_int_eq(end, tests[i].end);
+        }
+        ck_assert_int_eq(regex_match(regex, tests[i].text,
+                                     tests[i].text_size), found);
+        regex_free(regex);
+    }
+}
+END_TEST
+
+START_TEST(test_regex_search_truncated)
+{
+    static const struct {
+        const char *pattern;
+        const char *text;
+        int truncated;
+    } tests[] = {
+        { "(ab)+", "xaba", TRUE },
+        { "(ab)+", "xabx", FALSE },
+        { "(ab)+", "xab", TRUE },
+        { "a+", "baaa", TRUE },
+        { "a+", "baab", FALSE },
+        { "\\r\\n", "ab\r\n", FALSE },
+        { "ab$", "abab", TRUE },
+    };
+    struct regex *regex;
+    const char *errmsg;
+    size_t start;
+    size_t end;
+    int truncated;
+    int i;
+
+    for (i = 0; i < N_ELEM(tests); ++i) {
+        regex = regex_compile(tests[i].pattern, strlen(tests[i].pattern),
+                              &errmsg);
+        ck_assert(NULL != regex);
+        ck_assert(regex_search(regex, tests[i].text, strlen(tests[i].text),
+                               &start, &end, &truncated));
+        ck_assert_int_eq(truncated, tests[i].truncated);
+        regex_free(regex);
+    }
+}
+END_TEST
+
+START_TEST(test_regex_errors)
+{
+    static const char *patterns[] = {
+        "(ab", "ab)", "[ab", "*a", "a|*", "a{2", "a{3,2}", "a{1001}",
+        "a\\", "\\q", "\\x4", "a^b", "a$b", "^a|b", "a|b$", "[b-a]",
+        "(a{100}){100}",
+    };
+    const char *errmsg;
+    int i;
+
+    for (i = 0; i < N_ELEM(patterns); ++i) {
+        errmsg = NULL;
+        ck_assert(NULL == regex_compile(patterns[i], strlen(patterns[i]),
+                                        &errmsg));
+        ck_assert(NULL != errmsg);
+    }
+}
+END_TEST
+
+START_TEST(test_regex_matches_empty)
+{
+    static const char *empty_patterns[] = {
+        "", "a*", "(a|b?)", "^$", "(ab)*|c?",
+    };
+    static const char *non_empty_patterns[] = {
+        "a", "a+", "(a|b)c*", "\\r?\\n", "a{1,3}",
+    };
+    struct regex *regex;
+    const char *errmsg;
+    int i;
+
+    for (i = 0; i < N_ELEM(empty_patterns); ++i) {
+        regex = regex_compile(empty_patterns[i], strlen(empty_patterns[i]),
+                              &errmsg);
+        ck_assert(regex_matches_empty(regex));
+        regex_free(regex);
+    }
+    for (i = 0; i < N_ELEM(non_empty_patterns); ++i) {
+        regex = regex_compile(non_empty_patterns[i],
+                              strlen(non_empty_patterns[i]), &errmsg);
+        ck_assert(!regex_matches_empty(regex));
+        regex_free(regex);
+    }
+}
+END_TEST
+
+void check_regex_add_tcases(Suite *s)
+{
+    TCase *tc_regex;
+
+    tc_regex = tcase_create("utils:regex");
+    tcase_add_test(tc_regex, test_regex_search);
+    tcase_add_test(tc_regex, test_regex_search_truncated);
+    tcase_add_test(tc_regex, test_regex_errors);
+    tcase_add_test(tc_regex, test_regex_matches_empty);
+    suite_add_tcase(s, tc_regex);
+}
+
+#endif // #ifndef DISABLE_UTESTS
@@ -0,0 +1,164 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+#define _DEFAULT_SOURCE
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "utils/port.h"
+#include "utils/sidecar.h"
+
+static char *sidecar_dir;
+
+void
+sidecar_set_dir(const char *dir)
+{
+    free(sidecar_dir);
+    sidecar_dir = (NULL != dir ? strdup_safe(dir) : NULL);
+}
+
+int
+sidecar_enabled(void)
+{
+    return NULL != sidecar_dir;
+}
+
+static char *
+sidecar_path(const char *kind, const char *key, const char *suffix)
+{
+    char *path;
+
+    if (-1 == asprintf(&path, "%s/%s-%s.idx%s", sidecar_dir, kind, key, suffix)) {
+        return NULL;
+    }
+    return path;
+}
+
+/**
+ * @brief open an existing sidecar file for reading
+ *
+ * @return the open file, or NULL if sidecars are disabled or if the
+ * file does not exist
+ */
+FILE *
+sidecar_open(const char *kind, const char *key)
+{
+    char *path;
+    FILE *file;
+
+    if (NULL == sidecar_dir) {
+        return NULL;
+    }
+    path = sidecar_path(kind, key, "");
+    if (NULL == path) {
+        return NULL;
+    }
+    file = fopen(path, "rb");
+    free(path);
+    return file;
+}
+
+/**
+ * @brief start writing a sidecar file
+ *
+ * Contents are written to a temporary file, renamed to the final
+ * sidecar path by sidecar_commit() so that readers never see
+ * incomplete files.
+ *
+ * @retval 0 success, write to writer->file
+ * @retval -1 sidecars are disabled or the file cannot be created
+ */
+int
+sidecar_create(const char *kind, const char *key,
+               struct sidecar_writer *writer)
+{
+    int fd;
+
+    memset(writer, 0, sizeof (*writer));
+    if (NULL == sidecar_dir) {
+        return -1;
+    }
+    writer->path = sidecar_path(kind, key, "");
+    writer->tmp_path = sidecar_path(kind, key, ".XXXXXX");
+    if (NULL == writer->path || NULL == writer->tmp_path) {
+        sidecar_abort(writer);
+        return -1;
+    }
+    fd = mkstemp(writer->tmp_path);
+    if (-1 == fd) {
+        sidecar_abort(writer);
+        return -1;
+    }
+    writer->file = fdopen(fd, "wb");
+    if (NULL == writer->file) {
+        (void) close(fd);
+        sidecar_abort(writer);
+        return -1;
+    }
+    return 0;
+}
+
+int
+sidecar_commit(struct sidecar_writer *writer)
+{
+    int ret;
+
+    ret = fclose(writer->file);
+    writer->file = NULL;
+    if (0 == ret) {
+        ret = rename(writer->tmp_path, writer->path);
+    }
+    if (0 != ret) {
+        sidecar_abort(writer);
+        return -1;
+    }
+    free(writer->path);
+    free(writer->tmp_path);
+    memset(writer, 0, sizeof (*writer));
+    return 0;
+}
+
+void
+sidecar_abort(struct sidecar_writer *writer)
+{
+    if (NULL != writer->file) {
+        (void) fclose(writer->file);
+    }
+    if (NULL != writer->tmp_path) {
+        (void) unlink(writer->tmp_path);
+    }
+    free(writer->path);
+    free(writer->tmp_path);
+    memset(writer, 0, sizeof (*writer));
+}
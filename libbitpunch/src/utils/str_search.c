@@ -0,0 +1,348 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "utils/str_search.h"
+
+#if defined(__SSE2__)
+# define STR_SEARCH_SSE2
+# include <emmintrin.h>
+#endif
+
+#define BYTESET_ADD(set, c)  ((set)[(c) >> 6] |= 1ull << ((c) & 63))
+#define BYTESET_TEST(set, c) ((set)[(c) >> 6] & (1ull << ((c) & 63)))
+
+/*
+ * Two-Way string matching (Crochemore-Perrin), with a bad character
+ * shift on the last byte of the window, as done in musl's memmem().
+ */
+
+void
+str_searcher_init(struct str_searcher *searcher,
+                  const char *needle, size_t needle_size)
+{
+    const unsigned char *n = (const unsigned char *)needle;
+    size_t l = needle_size;
+    size_t i;
+    size_t ip, jp, k, p, ms, p0;
+
+    memset(searcher, 0, sizeof (*searcher));
+    searcher->needle = needle;
+    searcher->needle_size = needle_size;
+    if (needle_size < 2) {
+        return ;
+    }
+    for (i = 0; i < l; ++i) {
+        BYTESET_ADD(searcher->byteset, n[i]);
+        searcher->shift[n[i]] = i + 1;
+    }
+    // maximal suffix for the byte order (ip starts at -1)
+    ip = -1;
+    jp = 0;
+    k = p = 1;
+    while (jp + k < l) {
+        if (n[ip + k] == n[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                ++k;
+            }
+        } else if (n[ip + k] > n[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    ms = ip;
+    p0 = p;
+    // maximal suffix for the reverse byte order
+    ip = -1;
+    jp = 0;
+    k = p = 1;
+    while (jp + k < l) {
+        if (n[ip + k] == n[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                ++k;
+            }
+        } else if (n[ip + k] < n[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    // critical factorization: the longest of both suffixes
+    if (ip + 1 > ms + 1) {
+        ms = ip;
+    } else {
+        p = p0;
+    }
+    if (0 != memcmp(n, n + p, ms + 1)) {
+        // not periodic: no prefix memory, shift by the longest half
+        searcher->mem0 = 0;
+        p = MAX(ms, l - ms - 1) + 1;
+    } else {
+        searcher->mem0 = l - p;
+    }
+    searcher->crit_pos = ms + 1;
+    searcher->period = p;
+}
+
+static const char *
+str_searcher_find__two_way(const struct str_searcher *searcher,
+                           const char *haystack, size_t haystack_size)
+{
+    const unsigned char *n = (const unsigned char *)searcher->needle;
+    const unsigned char *h = (const unsigned char *)haystack;
+    const unsigned char *end = h + haystack_size;
+    size_t l = searcher->needle_size;
+    size_t crit_pos = searcher->crit_pos;
+    size_t mem = 0;
+    size_t k;
+
+    for (;;) {
+        if ((size_t)(end - h) < l) {
+            return NULL;
+        }
+        // check last byte of the window first
+        if (BYTESET_TEST(searcher->byteset, h[l - 1])) {
+            k = l - searcher->shift[h[l - 1]];
+            if (0 != k) {
+                if (k < mem) {
+                    k = mem;
+                }
+                h += k;
+                mem = 0;
+                continue ;
+            }
+        } else {
+            h += l;
+            mem = 0;
+            continue ;
+        }
+        // compare right half
+        for (k = MAX(crit_pos, mem); k < l && n[k] == h[k]; ++k)
+            ;
+        if (k < l) {
+            h += k - crit_pos + 1;
+            mem = 0;
+            continue ;
+        }
+        // compare left half
+        for (k = crit_pos; k > mem && n[k - 1] == h[k - 1]; --k)
+            ;
+        if (k <= mem) {
+            return (const char *)h;
+        }
+        h += searcher->period;
+        mem = searcher->mem0;
+    }
+}
+
+#ifdef STR_SEARCH_SSE2
+
+/**
+ * @brief compare the first and last needle bytes at 16 positions at
+ * once, verifying candidates with memcmp()
+ *
+ * Falls back to Two-Way for the rest of the haystack when the
+ * verification work exceeds the number of bytes scanned.
+ */
+static const char *
+str_searcher_find__sse2(const struct str_searcher *searcher,
+                        const char *haystack, size_t haystack_size)
+{
+    const char *needle = searcher->needle;
+    size_t l = searcher->needle_size;
+    __m128i first;
+    __m128i last;
+    __m128i block_first;
+    __m128i block_last;
+    unsigned int mask;
+    size_t pos;
+    size_t n_false_bytes;
+    int bit;
+
+    first = _mm_set1_epi8(needle[0]);
+    last = _mm_set1_epi8(needle[l - 1]);
+    n_false_bytes = 0;
+    pos = 0;
+    while (haystack_size - pos >= l + 15) {
+        block_first = _mm_loadu_si128((const __m128i *)(haystack + pos));
+        block_last = _mm_loadu_si128(
+            (const __m128i *)(haystack + pos + l - 1));
+        mask = _mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                          _mm_cmpeq_epi8(last, block_last)));
+        while (0 != mask) {
+            bit = __builtin_ctz(mask);
+            if (0 == memcmp(haystack + pos + bit + 1, needle + 1, l - 2)) {
+                return haystack + pos + bit;
+            }
+            n_false_bytes += l - 2;
+            mask &= mask - 1;
+        }
+        pos += 16;
+        if (unlikely(n_false_bytes > pos + 256)) {
+            break ;
+        }
+    }
+    return str_searcher_find__two_way(searcher, haystack + pos,
+                                      haystack_size - pos);
+}
+
+#endif // STR_SEARCH_SSE2
+
+const char *
+str_searcher_find(const struct str_searcher *searcher,
+                  const char *haystack, size_t haystack_size)
+{
+    switch (searcher->needle_size) {
+    case 0:
+        return haystack;
+    case 1:
+        return memchr(haystack, searcher->needle[0], haystack_size);
+    default:
+        if (haystack_size < searcher->needle_size) {
+            return NULL;
+        }
+#ifdef STR_SEARCH_SSE2
+        return str_searcher_find__sse2(searcher, haystack, haystack_size);
+#else
+        return str_searcher_find__two_way(searcher, haystack, haystack_size);
+#endif
+    }
+}
+
+
+#ifndef DISABLE_UTESTS
+
+#include <check.h>
+
+static void
+check_str_search(const char *haystack, size_t haystack_size,
+                 const char *needle, size_t needle_size)
+{
+    struct str_searcher searcher;
+    const char *expected;
+
+    str_searcher_init(&searcher, needle, needle_size);
+    expected = memmem(haystack, haystack_size, needle, needle_size);
+    ck_assert(str_searcher_find(&searcher, haystack, haystack_size)
+              == expected);
+    if (needle_size >= 2) {
+        ck_assert(str_searcher_find__two_way(&searcher,
+                                             haystack, haystack_size)
+                  == expected);
+    }
+}
+
+START_TEST(test_str_search)
+{
+    static const char *needles[] = {
+        "\r\n", "\0\0", "ab", "aab", "aba", "abab", "aaaa", "abcabd",
+        "--delimiter--", "babbabbabba", "aaaaaaaaaaaaaaaaaaaaaaab",
+        "aaaaaaaabaaaaaaaa",
+    };
+    static const size_t needle_sizes[] = {
+        2, 2, 2, 3, 3, 4, 4, 6, 13, 11, 24, 17,
+    };
+    char haystack[300];
+    unsigned int seed;
+    size_t haystack_size;
+    size_t needle_size;
+    const char *needle;
+    int alphabet;
+    int i;
+    int j;
+    size_t k;
+
+    // known needles in random haystacks made of their own bytes,
+    // then in periodic haystacks (worst cases)
+    seed = 42;
+    for (i = 0; i < N_ELEM(needles); ++i) {
+        needle = needles[i];
+        needle_size = needle_sizes[i];
+        for (j = 0; j < 200; ++j) {
+            haystack_size = rand_r(&seed) % sizeof (haystack);
+            for (k = 0; k < haystack_size; ++k) {
+                haystack[k] = needle[rand_r(&seed) % needle_size];
+            }
+            check_str_search(haystack, haystack_size, needle, needle_size);
+        }
+        memset(haystack, needle[0], sizeof (haystack));
+        check_str_search(haystack, sizeof (haystack), needle, needle_size);
+        memcpy(haystack + sizeof (haystack) - needle_size,
+               needle, needle_size);
+        check_str_search(haystack, sizeof (haystack), needle, needle_size);
+    }
+    // random needles and haystacks over small alphabets
+    for (j = 0; j < 5000; ++j) {
+        char random_needle[16];
+
+        alphabet = 2 + rand_r(&seed) % 3;
+        needle_size = 1 + rand_r(&seed) % sizeof (random_needle);
+        for (k = 0; k < needle_size; ++k) {
+            random_needle[k] = 'a' + rand_r(&seed) % alphabet;
+        }
+        haystack_size = rand_r(&seed) % sizeof (haystack);
+        for (k = 0; k < haystack_size; ++k) {
+            haystack[k] = 'a' + rand_r(&seed) % alphabet;
+        }
+        check_str_search(haystack, haystack_size,
+                         random_needle, needle_size);
+    }
+}
+END_TEST
+
+void check_str_search_add_tcases(Suite *s)
+{
+    TCase *tc_str_search;
+
+    tc_str_search = tcase_create("utils:str_search");
+    tcase_add_test(tc_str_search, test_str_search);
+    suite_add_tcase(s, tc_str_search);
+}
+
+#endif // #ifndef DISABLE_UTESTS
@@ -65,6 +65,9 @@ static PyObject *
 expr_value_to_native_PyObject_nodestroy(struct BoardObject *dtree,
                                         expr_value_t value_eval);
 static PyObject *
+expr_value_to_data_PyObject(struct BoardObject *dtree,
+                            expr_value_t value_eval);
+static PyObject *
 eval_expr_as_python_object(struct DataItemObject *cont, const char *expr);
 
 static PyObject *
@@ -192,11 +195,14 @@ node_info_to_python(const struct ast_node_hdl *node)
 
 static PyObject *
 bitpunch_error_context_info_to_python(
-    struct bitpunch_error_context_info *ctx_info)
+    struct bitpunch_error *err, int ctx_i)
 {
+    struct bitpunch_error_context_info *ctx_info;
     PyObject *context_obj = NULL;
     PyObject *info_obj;
 
+    ctx_info = &err->contexts[ctx_i];
+
     context_obj = PyDict_New();
     if (NULL == context_obj) {
         return NULL;
@@ -228,7 +234,8 @@ bitpunch_error_context_info_to_python(
     if (NULL != ctx_info->message) {
         PyDict_SetItem(context_obj,
                        PyString_FromString("contextmsg"),
-                       PyString_FromString(ctx_info->message));
+                       PyString_FromString(
+                           bitpunch_error_get_context_message(err, ctx_i)));
     }
 
     return context_obj;
@@ -276,7 +283,7 @@ bitpunch_error_get_info_as_PyObject(struct bitpunch_error *err)
     }
     PyDict_SetItem(errobj,
                    PyString_FromString("reason"),
-                   PyString_FromString(err->reason));
+                   PyString_FromString(bitpunch_error_get_reason(err)));
     if (err->n_contexts == 0) {
         return errobj;
     }
@@ -288,8 +295,7 @@ bitpunch_error_get_info_as_PyObject(struct bitpunch_error *err)
     for (ctx_i = 0; ctx_i < err->n_contexts; ++ctx_i) {
         PyObject *context_obj;
 
-        context_obj = bitpunch_error_context_info_to_python(
-            &err->contexts[ctx_i]);
+        context_obj = bitpunch_error_context_info_to_python(err, ctx_i);
         if (NULL == context_obj) {
             goto err;
         }
@@ -967,6 +973,8 @@ typedef struct BoardObject {
     PyObject_HEAD
     struct bitpunch_board *board;
     //ARRAY_HEAD(datasource_array, struct ast_node_hdl) data_sources;
+    /** return bytes-like values as memoryviews of the data */
+    char zero_copy;
 } BoardObject;
 
 PyDoc_STRVAR(Board__doc__,
@@ -1489,6 +1497,20 @@ static PyMethodDef Board_methods[] = {
     { NULL, NULL, 0, NULL }
 };
 
+static PyMemberDef Board_members[] = {
+    { "zero_copy", T_BOOL, offsetof (BoardObject, zero_copy), 0,
+      "If True, bytes and string values converted to python (e.g. by\n"
+      "make_python_object() or Tracker.read_items()) are returned as\n"
+      "read-only memoryview objects referencing the data source or\n"
+      "filtered data contents instead of copies, that keep the contents\n"
+      "alive. Keys and str() conversions are still copied.\n"
+      "\n"
+      "False by default."
+    },
+
+    { NULL, 0, 0, 0, NULL }
+};
+
 static int
 Board_clear(BoardObject *self)
 {
@@ -1675,7 +1697,7 @@ static PyTypeObject BoardType = {
     0,                         /* tp_iter */
     0,                         /* tp_iternext */
     Board_methods,             /* tp_methods */
-    0,                         /* tp_members */
+    Board_members,             /* tp_members */
     0,                         /* tp_getset */
     0,                         /* tp_base */
     0,                         /* tp_dict */
@@ -1703,6 +1725,177 @@ BoardType_setup(void)
 
 
 
+/*
+ * DataBuffer
+ */
+
+PyDoc_STRVAR(DataBuffer__doc__,
+             "Read-only buffer referencing bytes-like value contents, "
+             "exported through memoryview objects");
+
+typedef struct DataBufferObject {
+    PyObject_HEAD
+    /** board owning the schema of the value's box */
+    struct BoardObject *dtree;
+    /** value holding a reference to the contents */
+    expr_value_t value;
+    /** pin of data source contents for data values */
+    struct bitpunch_data_pin pin;
+    const char *buf;
+    int64_t len;
+} DataBufferObject;
+
+static PyTypeObject DataBufferType;
+
+/**
+ * @brief wrap a bytes-like value into a memoryview without copying
+ * its contents
+ *
+ * Bytes and strings keep the data they reference pinned, data values
+ * get their data source range pinned for the lifetime of the buffer.
+ *
+ * @note this function call steals @ref value, unless it returns
+ * NULL with no exception set
+ *
+ * @return a new memoryview object, NULL with no exception set if @ref
+ * value cannot be shared, or NULL with an exception set on error
+ */
+static PyObject *
+DataBuffer_memoryview_from_value(struct BoardObject *dtree,
+                                 expr_value_t value)
+{
+    DataBufferObject *self;
+    struct bitpunch_data_source *ds;
+    int64_t start_offset;
+    int64_t end_offset;
+    const char *buf;
+    PyObject *memview;
+
+    switch (value.type) {
+    case EXPR_VALUE_TYPE_STRING:
+        if (NULL == value.string.from_box) {
+            return NULL;
+        }
+        break ;
+    case EXPR_VALUE_TYPE_BYTES:
+        if (NULL == value.bytes.from_box) {
+            return NULL;
+        }
+        break ;
+    case EXPR_VALUE_TYPE_DATA:
+    case EXPR_VALUE_TYPE_DATA_RANGE:
+        break ;
+    default:
+        return NULL;
+    }
+    self = PyObject_New(DataBufferObject, &DataBufferType);
+    if (NULL == self) {
+        expr_value_destroy(value);
+        return NULL;
+    }
+    self->dtree = dtree;
+    Py_INCREF(self->dtree);
+    memset(&self->pin, 0, sizeof (self->pin));
+    self->value = expr_value_unset();
+    switch (value.type) {
+    case EXPR_VALUE_TYPE_STRING:
+        self->buf = value.string.str;
+        self->len = value.string.len;
+        break ;
+    case EXPR_VALUE_TYPE_BYTES:
+        self->buf = value.bytes.buf;
+        self->len = value.bytes.len;
+        break ;
+    default: /* data */
+        ds = value.data.ds;
+        if (EXPR_VALUE_TYPE_DATA_RANGE == value.type) {
+            start_offset = value.data_range.start_offset;
+            end_offset = value.data_range.end_offset;
+        } else {
+            start_offset = 0;
+            end_offset = (int64_t)ds->ds_data_length;
+        }
+        if (-1 == bitpunch_data_source_pin_range(
+                ds, start_offset, end_offset - start_offset,
+                &self->pin, &buf)) {
+            Py_DECREF(self);
+            expr_value_destroy(value);
+            PyErr_SetString(PyExc_IOError, "error reading from data source");
+            return NULL;
+        }
+        self->buf = buf;
+        self->len = end_offset - start_offset;
+        break ;
+    }
+    self->value = value;
+    memview = PyMemoryView_FromObject((PyObject *)self);
+    Py_DECREF(self);
+    return memview;
+}
+
+static void
+DataBuffer_dealloc(DataBufferObject *self)
+{
+    if (NULL != self->pin.handle) {
+        bitpunch_data_source_unpin(self->value.data.ds, &self->pin);
+    }
+    expr_value_destroy(self->value);
+    Py_DECREF(self->dtree);
+    PyObject_Del(self);
+}
+
+static int
+DataBuffer_bf_getbuffer(DataBufferObject *exporter,
+                        Py_buffer *view, int flags)
+{
+    return PyBuffer_FillInfo(view, (PyObject *)exporter,
+                             (void *)exporter->buf, (Py_ssize_t)exporter->len,
+                             TRUE /* read-only */, flags);
+}
+
+static PyBufferProcs DataBuffer_as_buffer = {
+    .bf_getbuffer = (getbufferproc)DataBuffer_bf_getbuffer,
+};
+
+static PyTypeObject DataBufferType = {
+    PyObject_HEAD_INIT(NULL)
+    0,                         /* ob_size */
+    "bitpunch.DataBuffer",     /* tp_name */
+    sizeof(DataBufferObject),  /* tp_basicsize */
+    0,                         /* tp_itemsize */
+    0,                         /* tp_dealloc */
+    0,                         /* tp_print */
+    0,                         /* tp_getattr */
+    0,                         /* tp_setattr */
+    0,                         /* tp_compare */
+    0,                         /* tp_repr */
+    0,                         /* tp_as_number */
+    0,                         /* tp_as_sequence */
+    0,                         /* tp_as_mapping */
+    0,                         /* tp_hash */
+    0,                         /* tp_call */
+    0,                         /* tp_str */
+    0,                         /* tp_getattro */
+    0,                         /* tp_setattro */
+    &DataBuffer_as_buffer,     /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT |
+    Py_TPFLAGS_HAVE_NEWBUFFER, /* tp_flags */
+    DataBuffer__doc__,         /* tp_doc */
+};
+
+static int
+DataBufferType_setup(void)
+{
+    DataBufferType.ob_type = &PyType_Type;
+    DataBufferType.tp_dealloc = (destructor)DataBuffer_dealloc;
+    if (PyType_Ready(&DataBufferType) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+
+
 /*
  * DataItem
  */
@@ -1917,6 +2110,10 @@ DataItem_get_location(DataItemObject *self, PyObject *args);
 static PyObject *
 DataItem_get_filter_type(DataItemObject *self);
 
+static PyObject *
+DataItem_read_int_array(DataItemObject *self,
+                        PyObject *args, PyObject *kwds);
+
 static PyObject *
 DataItem___unicode__(DataItemObject *self, PyObject *args);
 
@@ -1955,6 +2152,18 @@ static PyMethodDef DataItem_methods[] = {
       "get the DataItem's type of filter ('composite', 'array', "
       "'integer' etc.)"
     },
+    { "read_int_array",
+      (PyCFunction)DataItem_read_int_array, METH_VARARGS | METH_KEYWORDS,
+      "read integer values of array items in bulk\n"
+      "\n"
+      "Returns a bytearray of native 64-bit signed integers, suitable "
+      "for numpy.frombuffer(result, dtype=numpy.int64).\n"
+      "\n"
+      "keyword arguments:\n"
+      "start -- index of the first item to read (default is 0)\n"
+      "count -- maximum number of items to read (default is all "
+      "remaining items)"
+    },
     { "__unicode__",
       (PyCFunction)DataItem___unicode__, METH_NOARGS,
       "convert to unicode string"
@@ -2314,6 +2523,60 @@ DataItem_get_location(DataItemObject *self, PyObject *args)
     return Py_BuildValue("ii", item_offset, item_size);
 }
 
+static PyObject *
+DataItem_read_int_array(DataItemObject *self,
+                        PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = { "start", "count", NULL };
+    long long start = 0;
+    long long count = -1;
+    int64_t n_items;
+    int64_t n_read;
+    PyObject *res;
+    bitpunch_status_t bt_ret;
+    struct bitpunch_error *bp_err = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|LL", kwlist,
+                                     &start, &count)) {
+        return NULL;
+    }
+    if (start < 0) {
+        PyErr_SetString(PyExc_ValueError, "start must be non-negative");
+        return NULL;
+    }
+    if (-1 == DataItem_apply_dpath_filters(self)
+        || -1 == DataItem_convert_dpath_to_box(self)) {
+        return NULL;
+    }
+    bt_ret = box_get_n_items(self->dpath.box, &n_items, &bp_err);
+    if (BITPUNCH_OK != bt_ret) {
+        set_bitpunch_error(bp_err, bt_ret);
+        return NULL;
+    }
+    n_items = MAX(n_items - start, 0);
+    if (count >= 0 && count < n_items) {
+        n_items = count;
+    }
+    res = PyByteArray_FromStringAndSize(NULL, n_items * sizeof (int64_t));
+    if (NULL == res) {
+        return NULL;
+    }
+    bt_ret = box_read_values_bulk(self->dpath.box, start, n_items,
+                                  (int64_t *)PyByteArray_AS_STRING(res),
+                                  &n_read, &bp_err);
+    if (BITPUNCH_OK != bt_ret) {
+        Py_DECREF(res);
+        set_bitpunch_error(bp_err, bt_ret);
+        return NULL;
+    }
+    if (n_read < n_items
+        && -1 == PyByteArray_Resize(res, n_read * sizeof (int64_t))) {
+        Py_DECREF(res);
+        return NULL;
+    }
+    return res;
+}
+
 static int
 DataItem_read_value(DataItemObject *self)
 {
@@ -2581,6 +2844,10 @@ DataItem_bf_getbuffer(DataItemObject *exporter,
         exporter->dpath,
         &filtered_data_source, &data_offset, &data_size,
         &exporter->filtered_box, &bp_err);
+    if (BITPUNCH_OK == bt_ret) {
+        bt_ret = box_pin_data(exporter->filtered_box, filtered_data_source,
+                              data_offset, data_size, &buf, &bp_err);
+    }
     if (BITPUNCH_OK != bt_ret) {
         PyObject *errobj;
 
@@ -2596,7 +2863,6 @@ DataItem_bf_getbuffer(DataItemObject *exporter,
         view->obj = NULL;
         return -1;
     }
-    buf = filtered_data_source->ds_data + data_offset;
     return PyBuffer_FillInfo(view, (PyObject *)exporter,
                              (void *)buf, (Py_ssize_t)data_size,
                              TRUE /* read-only */, flags);
@@ -3033,7 +3299,7 @@ box_to_native_PyObject(struct BoardObject *dtree, struct box *box)
         set_bitpunch_error(bp_err, bt_ret);
         return NULL;
     }
-    return expr_value_to_native_PyObject(dtree, value_eval);
+    return expr_value_to_data_PyObject(dtree, value_eval);
 }
 
 static PyObject *
@@ -3067,7 +3333,7 @@ tracker_item_to_deep_PyObject(BoardObject *dtree, struct tracker *tk)
         }
         // TODO: may be interesting to return DataItem items instead
         // of native values
-        res = expr_value_to_native_PyObject(dtree, value_eval);
+        res = expr_value_to_data_PyObject(dtree, value_eval);
     }
     return res;
 }
@@ -3428,21 +3694,13 @@ Tracker_get_n_items(TrackerObject *self)
  */
 
 static PyObject *
-Tracker_get_item_key(TrackerObject *self)
+Tracker_item_key_to_PyObject(TrackerObject *self,
+                             expr_value_t key, int twin_index)
 {
-    bitpunch_status_t bt_ret;
-    expr_value_t key;
-    int twin_index;
     PyObject *py_key_value;
     PyObject *py_key_arg;
     PyObject *res;
-    struct bitpunch_error *bp_err = NULL;
 
-    bt_ret = tracker_get_item_key_multi(self->tk, &key, &twin_index, &bp_err);
-    if (BITPUNCH_OK != bt_ret) {
-        set_bitpunch_error(bp_err, bt_ret);
-        return NULL;
-    }
     py_key_value = expr_value_to_native_PyObject(self->dtree, key);
     if (NULL == py_key_value) {
         return NULL;
@@ -3465,6 +3723,22 @@ Tracker_get_item_key(TrackerObject *self)
     return res;
 }
 
+static PyObject *
+Tracker_get_item_key(TrackerObject *self)
+{
+    bitpunch_status_t bt_ret;
+    expr_value_t key;
+    int twin_index;
+    struct bitpunch_error *bp_err = NULL;
+
+    bt_ret = tracker_get_item_key_multi(self->tk, &key, &twin_index, &bp_err);
+    if (BITPUNCH_OK != bt_ret) {
+        set_bitpunch_error(bp_err, bt_ret);
+        return NULL;
+    }
+    return Tracker_item_key_to_PyObject(self, key, twin_index);
+}
+
 static PyObject *
 Tracker_get_size(TrackerObject *self)
 {
@@ -3515,26 +3789,28 @@ Tracker_get_location(TrackerObject *self)
 static PyObject *
 Tracker_read_item_raw(TrackerObject *self)
 {
+    struct tracker *tk;
     bitpunch_status_t bt_ret;
-    const char *item_contents;
+    int64_t item_offset;
     int64_t item_size;
-    Py_buffer view;
-    PyObject *memview;
+    expr_value_t value;
     struct bitpunch_error *bp_err = NULL;
 
-    bt_ret = tracker_read_item_raw(self->tk, &item_contents, &item_size,
-                                   &bp_err);
+    tk = self->tk;
+    bt_ret = tracker_get_item_location(tk, &item_offset, &item_size,
+                                       &bp_err);
+    if (BITPUNCH_OK == bt_ret) {
+        bt_ret = box_apply_filter(tk->box, &bp_err);
+    }
     if (BITPUNCH_OK != bt_ret) {
         set_bitpunch_error(bp_err, bt_ret);
         return NULL;
     }
-    if (-1 == PyBuffer_FillInfo(&view, NULL,
-                                (void *)item_contents, item_size,
-                                TRUE /* read-only */, PyBUF_FULL_RO)) {
-        return NULL;
-    }
-    memview = PyMemoryView_FromBuffer(&view); /* view gets stolen */
-    return memview;
+    // the memoryview keeps the contents pinned for its own lifetime
+    value = expr_value_as_data_range(tk->box->ds_out,
+                                     item_offset, item_offset + item_size);
+    bitpunch_data_source_acquire(tk->box->ds_out);
+    return DataBuffer_memoryview_from_value(self->dtree, value);
 }
 
 static PyObject *
@@ -3543,6 +3819,130 @@ Tracker_read_item_value(TrackerObject *self)
     return tracker_item_to_shallow_PyObject(self->dtree, self->tk);
 }
 
+static PyObject *
+Tracker_item_record_to_PyObject(TrackerObject *self,
+                                struct tracker_item_record *record)
+{
+    PyObject *py_key;
+    PyObject *py_value;
+    PyObject *res;
+
+    py_key = Tracker_item_key_to_PyObject(self, record->key,
+                                          record->nth_twin);
+    record->key = expr_value_unset();
+    if (NULL == py_key) {
+        return NULL;
+    }
+    if (NULL != record->box) {
+        py_value = DataItem_new_from_box(self->dtree, record->box);
+    } else {
+        py_value = expr_value_to_data_PyObject(self->dtree,
+                                               record->value);
+        record->value = expr_value_unset();
+    }
+    if (NULL == py_value) {
+        Py_DECREF(py_key);
+        return NULL;
+    }
+    res = Py_BuildValue("(NLLN)", py_key,
+                        (PY_LONG_LONG)record->offset,
+                        (PY_LONG_LONG)record->size, py_value);
+    return res;
+}
+
+static PyObject *
+Tracker_read_items(TrackerObject *self, PyObject *args)
+{
+    bitpunch_status_t bt_ret;
+    long max_items;
+    struct tracker_item_record *records;
+    int64_t n_records;
+    int64_t i;
+    PyObject *item;
+    PyObject *res;
+    struct bitpunch_error *bp_err = NULL;
+
+    if (!PyArg_ParseTuple(args, "l", &max_items)) {
+        return NULL;
+    }
+    if (max_items <= 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "number of items to read must be positive");
+        return NULL;
+    }
+    records = PyMem_New(struct tracker_item_record, max_items);
+    if (NULL == records) {
+        return PyErr_NoMemory();
+    }
+    bt_ret = tracker_read_items_batch(
+        self->tk, records, max_items,
+        TRACKER_BATCH_KEY | TRACKER_BATCH_LOCATION | TRACKER_BATCH_VALUE,
+        &n_records, &bp_err);
+    // an error after some items were read is held back by
+    // tracker_read_items_batch(), and reported by the next call
+    if (BITPUNCH_OK != bt_ret && BITPUNCH_NO_ITEM != bt_ret) {
+        assert(0 == n_records);
+        PyMem_Free(records);
+        set_bitpunch_error(bp_err, bt_ret);
+        return NULL;
+    }
+    res = PyList_New(n_records);
+    for (i = 0; i < n_records; ++i) {
+        item = NULL;
+        if (NULL != res) {
+            item = Tracker_item_record_to_PyObject(self, &records[i]);
+            if (NULL == item) {
+                Py_CLEAR(res);
+            } else {
+                PyList_SET_ITEM(res, i, item);
+            }
+        }
+        tracker_item_record_destroy(&records[i]);
+    }
+    PyMem_Free(records);
+    return res;
+}
+
+static PyObject *
+Tracker_iter_chunks(TrackerObject *self, PyObject *args)
+{
+    PyObject *functools;
+    PyObject *read_items;
+    PyObject *partial;
+    PyObject *sentinel;
+    PyObject *res;
+    long max_items;
+
+    if (!PyArg_ParseTuple(args, "l", &max_items)) {
+        return NULL;
+    }
+    functools = PyImport_ImportModule("functools");
+    if (NULL == functools) {
+        return NULL;
+    }
+    read_items = PyObject_GetAttrString((PyObject *)self, "read_items");
+    if (NULL == read_items) {
+        Py_DECREF(functools);
+        return NULL;
+    }
+    partial = PyObject_CallMethod(functools, "partial", "Ol",
+                                  read_items, max_items);
+    Py_DECREF(read_items);
+    Py_DECREF(functools);
+    if (NULL == partial) {
+        return NULL;
+    }
+    sentinel = PyList_New(0);
+    if (NULL == sentinel) {
+        Py_DECREF(partial);
+        return NULL;
+    }
+    res = PyCallIter_New(partial, sentinel);
+    Py_DECREF(partial);
+    Py_DECREF(sentinel);
+    return res;
+}
+
 static PyMethodDef Tracker_methods[] = {
 
     /* move functions */
@@ -3652,6 +4052,30 @@ static PyMethodDef Tracker_methods[] = {
       "structured types (blocks and arrays) or as native Python types"
     },
 
+    /* bulk functions */
+
+    { "read_items",
+      (PyCFunction)Tracker_read_items, METH_VARARGS,
+      "Advance the tracker through up to n next items, and return\n"
+      "them as a list of (key, offset, size, value) tuples, value being\n"
+      "a DataItem object for structured types (blocks and arrays) or a\n"
+      "native Python type.\n"
+      "\n"
+      "The tracker is left on the last returned item. If reading an\n"
+      "item fails, the items read before it are returned and the next\n"
+      "call raises the error, or the error is raised right away with\n"
+      "the tracker left unchanged if no item could be read.\n"
+      "\n"
+      "Return an empty list and leave the tracker at the end of the\n"
+      "container when there are no more items."
+    },
+
+    { "iter_chunks",
+      (PyCFunction)Tracker_iter_chunks, METH_VARARGS,
+      "Return an iterator over the next items, yielding lists of up to\n"
+      "n items as returned by read_items()."
+    },
+
     { NULL, NULL, 0, NULL }
 };
 
@@ -3948,6 +4372,10 @@ Tracker_bf_getbuffer(TrackerObject *exporter,
     if (BITPUNCH_OK == bt_ret) {
         bt_ret = box_apply_filter(tk->box, &bp_err);
     }
+    if (BITPUNCH_OK == bt_ret) {
+        bt_ret = box_pin_data(tk->box, tk->box->ds_in,
+                              item_offset, item_size, &buf, &bp_err);
+    }
     if (BITPUNCH_OK != bt_ret) {
         PyObject *errobj;
 
@@ -3963,7 +4391,6 @@ Tracker_bf_getbuffer(TrackerObject *exporter,
         view->obj = NULL;
         return -1;
     }
-    buf = tk->box->ds_in->ds_data + item_offset;
     return PyBuffer_FillInfo(view, (PyObject *)exporter,
                              (void *)buf, (Py_ssize_t)item_size,
                              TRUE /* read-only */, flags);
@@ -4072,6 +4499,27 @@ expr_value_from_PyObject(PyObject *py_expr, int create_data_source,
     return 0;
 }
 
+static PyObject *
+data_source_range_to_PyString(struct bitpunch_data_source *ds,
+                              int64_t start_offset, int64_t end_offset)
+{
+    PyObject *res;
+
+    res = PyString_FromStringAndSize(
+        NULL, (Py_ssize_t)(end_offset - start_offset));
+    if (NULL == res) {
+        return NULL;
+    }
+    if (-1 == bitpunch_data_source_read_range(
+            ds, start_offset, end_offset - start_offset,
+            PyString_AS_STRING(res))) {
+        Py_DECREF(res);
+        PyErr_SetString(PyExc_IOError, "error reading from data source");
+        return NULL;
+    }
+    return res;
+}
+
 /**
  * @brief convert an expression into a native-typed python object
  */
@@ -4092,14 +4540,14 @@ expr_value_to_native_PyObject_nodestroy(BoardObject *dtree,
         return PyString_FromStringAndSize(value_eval.bytes.buf,
                                           (Py_ssize_t)value_eval.bytes.len);
     case EXPR_VALUE_TYPE_DATA:
-        return PyString_FromStringAndSize(
-            value_eval.data.ds->ds_data,
-            (Py_ssize_t)value_eval.data.ds->ds_data_length);
+        return data_source_range_to_PyString(
+            value_eval.data.ds,
+            0, (int64_t)value_eval.data.ds->ds_data_length);
     case EXPR_VALUE_TYPE_DATA_RANGE:
-        return PyString_FromStringAndSize(
-            value_eval.data.ds->ds_data + value_eval.data_range.start_offset,
-            (Py_ssize_t)(value_eval.data_range.end_offset -
-                         value_eval.data_range.start_offset));
+        return data_source_range_to_PyString(
+            value_eval.data.ds,
+            value_eval.data_range.start_offset,
+            value_eval.data_range.end_offset);
     default:
         return PyErr_Format(PyExc_ValueError,
                             "unsupported expression type '%d'",
@@ -4123,6 +4571,31 @@ expr_value_to_native_PyObject(BoardObject *dtree,
     return res;
 }
 
+/**
+ * @brief convert a data value into a python object, as a memoryview
+ * of bytes-like contents if zero-copy is enabled on the board, or as
+ * a native-typed python object otherwise
+ *
+ * @note this function call destroys or steals @ref value_eval
+ */
+static PyObject *
+expr_value_to_data_PyObject(BoardObject *dtree,
+                            expr_value_t value_eval)
+{
+    PyObject *res;
+
+    if (NULL != dtree && dtree->zero_copy) {
+        res = DataBuffer_memoryview_from_value(dtree, value_eval);
+        if (NULL != res) {
+            return res;
+        }
+        if (NULL != PyErr_Occurred()) {
+            return NULL;
+        }
+    }
+    return expr_value_to_native_PyObject(dtree, value_eval);
+}
+
 /**
  * @brief convert an expression into a DataItem if expression refers
  * to a data source item, or a native-typed python object otherwise
@@ -4137,7 +4610,7 @@ expr_value_and_dpath_to_PyObject(BoardObject *dtree,
     DataItemObject *item;
 
     if (EXPR_DPATH_TYPE_NONE == dpath.type) {
-        return expr_value_to_native_PyObject(dtree, value);
+        return expr_value_to_data_PyObject(dtree, value);
     }
     item = (DataItemObject *)DataItem_new(&DataItemType, NULL, NULL);
     if (NULL == item) {
@@ -4303,6 +4776,121 @@ mod_bitpunch_notify_file_change(PyObject *self, PyObject *args)
     return Py_None;
 }
 
+static PyObject *
+mod_bitpunch_set_file_cache_limits(PyObject *self, PyObject *args)
+{
+    Py_ssize_t max_entries;
+    Py_ssize_t max_bytes;
+
+    if (!PyArg_ParseTuple(args, "nn", &max_entries, &max_bytes)) {
+        return NULL;
+    }
+    if (max_entries < 0 || max_bytes < 0) {
+        PyErr_SetString(PyExc_ValueError, "cache limits must be positive");
+        return NULL;
+    }
+    bitpunch_data_source_set_file_cache_limits((size_t)max_entries,
+                                               (size_t)max_bytes);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+mod_bitpunch_get_file_cache_stats(PyObject *self)
+{
+    struct bitpunch_file_cache_stats stats;
+
+    bitpunch_data_source_get_file_cache_stats(&stats);
+    return Py_BuildValue("{sKsKsKsKsnsn}",
+                         "hits", (unsigned long long)stats.n_hits,
+                         "misses", (unsigned long long)stats.n_misses,
+                         "evictions", (unsigned long long)stats.n_evictions,
+                         "invalidations",
+                         (unsigned long long)stats.n_invalidations,
+                         "entries", (Py_ssize_t)stats.n_entries,
+                         "bytes", (Py_ssize_t)stats.n_bytes);
+}
+
+static PyObject *
+mod_bitpunch_set_filter_cache_limits(PyObject *self, PyObject *args)
+{
+    Py_ssize_t max_entries;
+    Py_ssize_t max_bytes;
+
+    if (!PyArg_ParseTuple(args, "nn", &max_entries, &max_bytes)) {
+        return NULL;
+    }
+    if (max_entries < 0 || max_bytes < 0) {
+        PyErr_SetString(PyExc_ValueError, "cache limits must be positive");
+        return NULL;
+    }
+    bitpunch_set_filter_cache_limits((size_t)max_entries,
+                                     (size_t)max_bytes);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+mod_bitpunch_get_filter_cache_stats(PyObject *self)
+{
+    struct bitpunch_filter_cache_stats stats;
+
+    bitpunch_get_filter_cache_stats(&stats);
+    return Py_BuildValue("{sKsKsKsnsn}",
+                         "hits", (unsigned long long)stats.n_hits,
+                         "misses", (unsigned long long)stats.n_misses,
+                         "evictions", (unsigned long long)stats.n_evictions,
+                         "entries", (Py_ssize_t)stats.n_entries,
+                         "bytes", (Py_ssize_t)stats.n_bytes);
+}
+
+static PyObject *
+mod_bitpunch_get_alloc_stats(PyObject *self)
+{
+    struct bitpunch_alloc_stats stats;
+
+    bitpunch_get_alloc_stats(&stats);
+    return Py_BuildValue("{sKsKsKsKsKsKsKsn}",
+                         "box_allocs", (unsigned long long)stats.n_box_allocs,
+                         "box_reuses", (unsigned long long)stats.n_box_reuses,
+                         "box_frees", (unsigned long long)stats.n_box_frees,
+                         "tracker_allocs",
+                         (unsigned long long)stats.n_tracker_allocs,
+                         "tracker_reuses",
+                         (unsigned long long)stats.n_tracker_reuses,
+                         "tracker_frees",
+                         (unsigned long long)stats.n_tracker_frees,
+                         "slabs", (unsigned long long)stats.n_slabs,
+                         "bytes", (Py_ssize_t)stats.n_bytes);
+}
+
+static PyObject *
+mod_bitpunch_set_index_dir(PyObject *self, PyObject *args)
+{
+    const char *dir;
+
+    if (!PyArg_ParseTuple(args, "z", &dir)) {
+        return NULL;
+    }
+    bitpunch_set_index_dir(dir);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+mod_bitpunch_set_array_prescan(PyObject *self, PyObject *args)
+{
+    int n_workers;
+    PY_LONG_LONG min_array_size = -1;
+
+    if (!PyArg_ParseTuple(args, "i|L", &n_workers, &min_array_size)) {
+        return NULL;
+    }
+    bitpunch_set_array_prescan(n_workers, (int64_t)min_array_size);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyObject *
 mod_bitpunch_enable_debug_mode(PyObject *self)
 {
@@ -4344,6 +4932,50 @@ static PyMethodDef bitpunch_methods[] = {
       "changed (so to refresh the cache)"
     },
 
+    { "set_file_cache_limits", (PyCFunction)mod_bitpunch_set_file_cache_limits,
+      METH_VARARGS,
+      "set the limits of the file data source cache (max number of "
+      "entries, max total bytes): least recently used files not in use "
+      "are evicted beyond them"
+    },
+
+    { "get_file_cache_stats", (PyCFunction)mod_bitpunch_get_file_cache_stats,
+      METH_NOARGS,
+      "return a dict of file data source cache statistics"
+    },
+
+    { "set_filter_cache_limits",
+      (PyCFunction)mod_bitpunch_set_filter_cache_limits,
+      METH_VARARGS,
+      "set the limits of the filter output cache, holding decompressed "
+      "blocks (max number of entries, max total bytes): least recently "
+      "used outputs are evicted beyond them"
+    },
+
+    { "get_filter_cache_stats",
+      (PyCFunction)mod_bitpunch_get_filter_cache_stats,
+      METH_NOARGS,
+      "return a dict of filter output cache statistics"
+    },
+
+    { "get_alloc_stats", (PyCFunction)mod_bitpunch_get_alloc_stats,
+      METH_NOARGS,
+      "return a dict of box and tracker allocation statistics"
+    },
+
+    { "set_index_dir", (PyCFunction)mod_bitpunch_set_index_dir,
+      METH_VARARGS,
+      "set the directory where index sidecar files are saved and "
+      "reloaded across sessions (None to disable them)"
+    },
+
+    { "set_array_prescan", (PyCFunction)mod_bitpunch_set_array_prescan,
+      METH_VARARGS,
+      "set_array_prescan(n_workers, min_array_size=-1): pre-scan large "
+      "arrays of items with a @sync attribute with n_workers parallel "
+      "workers (0 to disable)"
+    },
+
 #ifdef DEBUG
     { "enable_debug_mode", (PyCFunction)mod_bitpunch_enable_debug_mode,
       METH_NOARGS,
@@ -4391,6 +5023,11 @@ initmodel_ext(void)
     PyModule_AddObject(bitpunch_m,
                        "IndexKey", (PyObject *)&IndexKeyType);
 
+    /* DataBuffer */
+    if (DataBufferType_setup() < 0) {
+        return ;
+    }
+
     /* DataItem */
     if (DataItemType_setup() < 0) {
         return ;
@@ -114,6 +114,25 @@ class CLI(NestedCmd):
         except OSError as e:
             if e.errno != errno.EEXIST:
                 raise
+        # sidecar indexes (e.g. deflate checkpoints) make browsing
+        # the same large files again much faster, they are only saved
+        # when an index directory is chosen
+        self.index_dir = None
+        index_dir = os.environ.get('BITPUNCH_INDEX_DIR')
+        if index_dir:
+            self._set_index_dir(index_dir)
+
+    def _set_index_dir(self, index_dir):
+        try:
+            os.makedirs(index_dir)
+        except OSError as e:
+            if e.errno != errno.EEXIST:
+                logging.warning('unable to create index directory %s: %s',
+                                index_dir, e)
+                return False
+        model.set_index_dir(index_dir)
+        self.index_dir = index_dir
+        return True
 
     def preloop(self):
         super(CLI, self).preloop()
@@ -768,6 +787,29 @@ class CLI(NestedCmd):
                                'invalid log level "%s"' % loglevel)
         self.stdout.write('log level set to "%s"\n' % loglevel)
 
+    def do_set_indexdir(self, value):
+        """Set the directory where index sidecar files are saved
+
+    Sidecar indexes (e.g. deflate checkpoints) speed up browsing the
+    same large files again in later sessions. They are disabled
+    unless a directory is set here or with $BITPUNCH_INDEX_DIR.
+
+    Usage: set indexdir (<directory>|off)
+"""
+        if not value:
+            raise CommandError('set indexdir', 'missing argument')
+
+        if value == 'off':
+            model.set_index_dir(None)
+            self.index_dir = None
+            self.stdout.write('index sidecars disabled\n')
+            return
+        index_dir = os.path.expanduser(value)
+        if not self._set_index_dir(index_dir):
+            raise CommandError('set indexdir',
+                               'unable to create directory "%s"' % index_dir)
+        self.stdout.write('index directory set to "%s"\n' % index_dir)
+
     def complete_set_loglevel(self, text, *ignored):
         logging.debug('complete_set_loglevel text="%s"' % (text))
         return [level for level in CLI.LOGLEVELS.keys()
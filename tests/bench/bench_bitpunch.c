@@ -0,0 +1,920 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/*
+ * Micro-benchmarks of common browsing patterns.
+ *
+ * Each benchmark builds a schema and a synthetic data buffer, then
+ * times a browsing loop over the model (or the evaluation of an
+ * expression on each browsed item). Run "bench_bitpunch -l" to
+ * list available benchmarks, and pass benchmark names as arguments
+ * to only run a subset.
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <assert.h>
+
+#include "api/bitpunch_api.h"
+#include "core/browse.h"
+#include "core/browse_internal.h"
+#include "core/expr.h"
+#include "utils/port.h"
+
+struct bench_spec;
+
+typedef bitpunch_status_t
+(*bench_run_func_t)(const struct bench_spec *bench,
+                    struct tracker *tk, int64_t *n_itemsp);
+
+struct bench_spec {
+    const char *name;
+    const char *description;
+    const char *schema;
+    /** expression evaluated in the model to get the browsed items */
+    const char *items_expr;
+    /** expression evaluated in the scope of each item (expr.*) */
+    const char *eval_expr;
+    /** fill the data buffer, of size n_items * item_size */
+    void (*fill_contents)(char *contents, int64_t n_items);
+    size_t item_size;
+    bench_run_func_t run;
+};
+
+static int64_t bench_n_items = 1000000;
+static int bench_n_rounds = 5;
+
+
+/*
+ * generic runners
+ */
+
+static bitpunch_status_t
+bench_run_read_values(const struct bench_spec *bench,
+                      struct tracker *tk, int64_t *n_itemsp)
+{
+    bitpunch_status_t bt_ret;
+    expr_value_t value;
+    int64_t n_items;
+
+    n_items = 0;
+    bt_ret = tracker_goto_first_item(tk, NULL);
+    while (BITPUNCH_OK == bt_ret) {
+        bt_ret = tracker_read_item_value(tk, &value, NULL);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        expr_value_destroy(value);
+        ++n_items;
+        bt_ret = tracker_goto_next_item(tk, NULL);
+    }
+    *n_itemsp = n_items;
+    return BITPUNCH_NO_ITEM == bt_ret ? BITPUNCH_OK : bt_ret;
+}
+
+static bitpunch_status_t
+bench_run_read_values_bulk(const struct bench_spec *bench,
+                           struct tracker *tk, int64_t *n_itemsp)
+{
+    bitpunch_status_t bt_ret;
+    int64_t *values;
+    int64_t n_items;
+
+    bt_ret = box_get_n_items(tk->box, &n_items, NULL);
+    if (BITPUNCH_OK != bt_ret) {
+        return bt_ret;
+    }
+    values = malloc_safe(n_items * sizeof (int64_t));
+    bt_ret = box_read_values_bulk(tk->box, 0, n_items, values, n_itemsp,
+                                  NULL);
+    free(values);
+    return bt_ret;
+}
+
+static bitpunch_status_t
+bench_run_iterate(const struct bench_spec *bench,
+                  struct tracker *tk, int64_t *n_itemsp)
+{
+    bitpunch_status_t bt_ret;
+    int64_t n_items;
+
+    n_items = 0;
+    bt_ret = tracker_goto_first_item(tk, NULL);
+    while (BITPUNCH_OK == bt_ret) {
+        ++n_items;
+        bt_ret = tracker_goto_next_item(tk, NULL);
+    }
+    *n_itemsp = n_items;
+    return BITPUNCH_NO_ITEM == bt_ret ? BITPUNCH_OK : bt_ret;
+}
+
+static bitpunch_status_t
+bench_run_read_records(const struct bench_spec *bench,
+                       struct tracker *tk, int64_t *n_itemsp)
+{
+    bitpunch_status_t bt_ret;
+    expr_value_t key;
+    int nth_twin;
+    int64_t item_offset;
+    int64_t item_size;
+    expr_value_t value;
+    int64_t n_items;
+
+    n_items = 0;
+    bt_ret = tracker_goto_first_item(tk, NULL);
+    while (BITPUNCH_OK == bt_ret) {
+        bt_ret = tracker_get_item_key_multi(tk, &key, &nth_twin, NULL);
+        if (BITPUNCH_OK == bt_ret) {
+            expr_value_destroy(key);
+            bt_ret = tracker_get_item_location(tk, &item_offset, &item_size,
+                                               NULL);
+        }
+        if (BITPUNCH_OK == bt_ret) {
+            bt_ret = tracker_read_item_value(tk, &value, NULL);
+        }
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        expr_value_destroy(value);
+        ++n_items;
+        bt_ret = tracker_goto_next_item(tk, NULL);
+    }
+    *n_itemsp = n_items;
+    return BITPUNCH_NO_ITEM == bt_ret ? BITPUNCH_OK : bt_ret;
+}
+
+#define BENCH_BATCH_SIZE 256
+
+static bitpunch_status_t
+bench_run_read_records_batch(const struct bench_spec *bench,
+                             struct tracker *tk, int64_t *n_itemsp)
+{
+    bitpunch_status_t bt_ret;
+    struct tracker_item_record records[BENCH_BATCH_SIZE];
+    int64_t n_records;
+    int64_t i;
+    int64_t n_items;
+
+    n_items = 0;
+    do {
+        bt_ret = tracker_read_items_batch(
+            tk, records, BENCH_BATCH_SIZE,
+            TRACKER_BATCH_KEY | TRACKER_BATCH_LOCATION | TRACKER_BATCH_VALUE,
+            &n_records, NULL);
+        for (i = 0; i < n_records; ++i) {
+            tracker_item_record_destroy(&records[i]);
+        }
+        n_items += n_records;
+    } while (BITPUNCH_OK == bt_ret);
+    *n_itemsp = n_items;
+    return BITPUNCH_NO_ITEM == bt_ret ? BITPUNCH_OK : bt_ret;
+}
+
+static bitpunch_status_t
+bench_run_eval_expr(const struct bench_spec *bench,
+                    struct tracker *tk, int64_t *n_itemsp)
+{
+    bitpunch_status_t bt_ret;
+    struct ast_node_hdl *expr;
+    struct box *item_box;
+    expr_value_t value;
+    int64_t n_items;
+
+    expr = NULL;
+    n_items = 0;
+    bt_ret = tracker_goto_first_item(tk, NULL);
+    while (BITPUNCH_OK == bt_ret) {
+        bt_ret = tracker_get_filtered_item_box(tk, &item_box, NULL);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        if (NULL == expr) {
+            // parse and compile once in the scope of the first item
+            bt_ret = bitpunch_eval_expr(NULL, bench->eval_expr, item_box,
+                                        0u, &expr, &value, NULL, NULL);
+        } else {
+            bt_ret = expr_evaluate_value(expr, item_box, NULL, &value, NULL);
+        }
+        box_delete(item_box);
+        if (BITPUNCH_OK != bt_ret) {
+            return bt_ret;
+        }
+        expr_value_destroy(value);
+        ++n_items;
+        bt_ret = tracker_goto_next_item(tk, NULL);
+    }
+    *n_itemsp = n_items;
+    return BITPUNCH_NO_ITEM == bt_ret ? BITPUNCH_OK : bt_ret;
+}
+
+
+/*
+ * integer filter
+ */
+
+static void
+fill_contents_fixint32(char *contents, int64_t n_items)
+{
+    int64_t i;
+    uint32_t value;
+
+    for (i = 0; i < n_items; ++i) {
+        value = htole32((uint32_t)i);
+        memcpy(contents + i * sizeof (uint32_t), &value, sizeof (uint32_t));
+    }
+}
+
+
+
+/*
+ * string filter
+ */
+
+static void
+fill_contents_crlf_lines(char *contents, int64_t n_items)
+{
+    int64_t i;
+    char *line;
+
+    // 30 characters followed by CRLF
+    for (i = 0; i < n_items; ++i) {
+        line = contents + i * 32;
+        memset(line, 'a' + i % 26, 30);
+        memcpy(line + 30, "\r\n", 2);
+    }
+}
+
+
+/*
+ * varint filter
+ */
+
+static void
+fill_contents_varints(char *contents, int64_t n_items)
+{
+    int64_t i;
+    char *varints;
+
+    // four varints per item: 1, 2, 1 and 1 bytes
+    for (i = 0; i < n_items; ++i) {
+        varints = contents + i * 5;
+        varints[0] = i & 0x7f;
+        varints[1] = 0x80 | (i & 0x7f);
+        varints[2] = 1 + (i >> 7 & 0x3f);
+        varints[3] = (i >> 3) & 0x7f;
+        varints[4] = 0x42;
+    }
+}
+
+static void
+fill_contents_sst_entries(char *contents, int64_t n_items)
+{
+    int64_t i;
+    char *entry;
+
+    // key_shared_size (2 bytes), key_non_shared_size (1 byte),
+    // value_size (1 byte), key_non_shared (4 bytes), value (3 bytes)
+    for (i = 0; i < n_items; ++i) {
+        entry = contents + i * 11;
+        entry[0] = 0x80 | (i & 0x3f);
+        entry[1] = 1;
+        entry[2] = 4;
+        entry[3] = 3;
+        memcpy(entry + 4, &i, 4);
+        memcpy(entry + 8, "val", 3);
+    }
+}
+
+#define BENCH_SCHEMA_SST_ENTRIES                                        \
+    "let VarInt = varint;\n"                                            \
+    "let KeyValue = struct {\n"                                         \
+    "    key_shared_size: VarInt;\n"                                    \
+    "    key_non_shared_size: VarInt;\n"                                \
+    "    value_size: VarInt;\n"                                         \
+    "    key_non_shared: [key_non_shared_size] byte;\n"                 \
+    "    value: [value_size] byte;\n"                                   \
+    "};\n"                                                              \
+    "let Root = struct { entries: [] KeyValue; };\n"
+
+
+/*
+ * formatted_integer filter
+ */
+
+static void
+fill_contents_octal_fields(char *contents, int64_t n_items)
+{
+    int64_t i;
+
+    // ustar-like size fields: 11 octal digits and a NUL terminator
+    for (i = 0; i < n_items; ++i) {
+        snprintf(contents + i * 12, 12, "%011llo",
+                 (unsigned long long)(i * 4099) & 077777777777ull);
+    }
+}
+
+
+/*
+ * expressions
+ */
+
+static void
+fill_contents_record(char *contents, int64_t n_items)
+{
+    int64_t i;
+    uint32_t values[2];
+
+    for (i = 0; i < n_items; ++i) {
+        values[0] = htole32((uint32_t)i);
+        values[1] = htole32((uint32_t)(i * 7));
+        memcpy(contents + i * sizeof (values), values, sizeof (values));
+    }
+}
+
+static void
+fill_contents_padded(char *contents, int64_t n_items)
+{
+    int64_t i;
+    uint32_t size;
+
+    for (i = 0; i < n_items; ++i) {
+        size = htole32((uint32_t)(1 + i % 4));
+        memcpy(contents + i * 8, &size, sizeof (size));
+        memset(contents + i * 8 + 4, 0, 4);
+    }
+}
+
+
+/*
+ * scope lookups
+ */
+
+static void
+fill_contents_mp4_box(char *contents, int64_t n_items)
+{
+    int64_t i;
+    uint32_t values[4];
+
+    for (i = 0; i < n_items; ++i) {
+        values[0] = htobe32(16);                        // size
+        values[1] = htobe32((uint32_t)(i % 4));         // atom
+        values[2] = htobe32((uint32_t)(i & 1) << 24);   // version, flags
+        values[3] = htobe32((uint32_t)i);
+        memcpy(contents + i * sizeof (values), values, sizeof (values));
+    }
+}
+
+#define BENCH_SCHEMA_MP4_BOX                                            \
+    "let MP4Int = integer { @signed: false; @endian: 'big'; };\n"       \
+    "let u8 = [1] byte <> MP4Int;\n"                                    \
+    "let u32 = [4] byte <> MP4Int;\n"                                   \
+    "let BoxHeader = struct { size: u32; atom: u32; };\n"               \
+    "let FullBoxHeader = struct {\n"                                    \
+    "    BoxHeader;\n"                                                  \
+    "    version: u8;\n"                                                \
+    "    flags: [3] byte;\n"                                            \
+    "};\n"                                                              \
+    "let Box = struct {\n"                                              \
+    "    FullBoxHeader;\n"                                              \
+    "    if (atom == 1) { created: u32; }\n"                            \
+    "    if (atom == 2) { modified: u32; }\n"                           \
+    "    if (atom == 3) { duration: u32; }\n"                           \
+    "    if (atom == 0) { value: u32; }\n"                              \
+    "    let payload_size = size - 12;\n"                               \
+    "};\n"                                                              \
+    "let Root = struct { boxes: [] Box; };\n"
+
+static void
+fill_contents_header(char *contents, int64_t n_items)
+{
+    int64_t i;
+    int j;
+    uint32_t values[8];
+
+    for (i = 0; i < n_items; ++i) {
+        for (j = 0; j < 8; ++j) {
+            values[j] = htole32((uint32_t)(i + j));
+        }
+        memcpy(contents + i * sizeof (values), values, sizeof (values));
+    }
+}
+
+#define BENCH_SCHEMA_HEADER                                             \
+    "let u32 = [4] byte <> integer { @signed: false; "                  \
+    "                                @endian: 'little'; };\n"           \
+    "let Header = struct {\n"                                           \
+    "    mode: u32; uid: u32; gid: u32; mtime: u32;\n"                  \
+    "    chksum: u32; typeflag: u32; devmajor: u32; devminor: u32;\n"   \
+    "};\n"                                                              \
+    "let Root = struct { headers: [] Header; };\n"
+
+#define BENCH_SCHEMA_RECORD                                             \
+    "let u32 = [4] byte <> integer { @signed: false; "                  \
+    "                                @endian: 'little'; };\n"           \
+    "let Record = struct {\n"                                           \
+    "    a: u32;\n"                                                     \
+    "    b: u32;\n"                                                     \
+    "    let blocks = (a + 511) / 512;\n"                               \
+    "    let padded = blocks * 512;\n"                                  \
+    "};\n"                                                              \
+    "let Root = struct { records: [] Record; };\n"
+
+
+/*
+ * arrays
+ */
+
+#define NESTED_N_SEGMENTS 2
+#define NESTED_N_ENTRIES  3
+#define NESTED_ENTRY_SIZE 4
+#define NESTED_SEGMENT_SIZE (1 + NESTED_N_ENTRIES * NESTED_ENTRY_SIZE)
+#define NESTED_PAGE_SIZE (1 + NESTED_N_SEGMENTS * NESTED_SEGMENT_SIZE)
+
+static void
+fill_contents_nested_pages(char *contents, int64_t n_items)
+{
+    int64_t i;
+    int s, e;
+    char *page;
+    char *segment;
+    char *entry;
+
+    for (i = 0; i < n_items; ++i) {
+        page = contents + i * NESTED_PAGE_SIZE;
+        page[0] = NESTED_PAGE_SIZE - 1;
+        for (s = 0; s < NESTED_N_SEGMENTS; ++s) {
+            segment = page + 1 + s * NESTED_SEGMENT_SIZE;
+            segment[0] = NESTED_SEGMENT_SIZE - 1;
+            for (e = 0; e < NESTED_N_ENTRIES; ++e) {
+                entry = segment + 1 + e * NESTED_ENTRY_SIZE;
+                entry[0] = NESTED_ENTRY_SIZE - 1;
+                memset(entry + 1, 'a' + e, NESTED_ENTRY_SIZE - 1);
+            }
+        }
+    }
+}
+
+#define BENCH_SCHEMA_NESTED_PAGES                                       \
+    "let u8 = [1] byte <> integer { @signed: false; };\n"               \
+    "let Entry = struct { len: u8; data: [len] byte; };\n"              \
+    "let Entries = struct { items: [] Entry; };\n"                      \
+    "let Segment = struct { size: u8; entries: [size] byte <> Entries; };\n" \
+    "let Segments = struct { items: [] Segment; };\n"                   \
+    "let Page = struct { size: u8; segments: [size] byte <> Segments; };\n" \
+    "let Root = struct { pages: [] Page; };\n"
+
+static const struct bench_spec bench_specs[] = {
+    {
+        .name = "integer.constant",
+        .description = "read [] FixInt32 with constant attributes",
+        .schema =
+        "let FixInt32 = [4] byte <> integer { @signed: false; "
+        "                                     @endian: 'little'; };\n"
+        "let Root = struct { values: [] FixInt32; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_fixint32,
+        .item_size = 4,
+        .run = bench_run_read_values,
+    },
+    {
+        .name = "integer.bulk",
+        .description = "bulk-read [] FixInt32 with constant attributes",
+        .schema =
+        "let FixInt32 = [4] byte <> integer { @signed: false; "
+        "                                     @endian: 'little'; };\n"
+        "let Root = struct { values: [] FixInt32; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_fixint32,
+        .item_size = 4,
+        .run = bench_run_read_values_bulk,
+    },
+    {
+        .name = "integer.dynamic",
+        .description = "read [] FixInt32 with conditional attributes",
+        .schema =
+        "let FixInt32 = [4] byte <> integer { @signed: false; "
+        "                                     if (true) { "
+        "                                         @endian: 'little'; "
+        "                                     } };\n"
+        "let Root = struct { values: [] FixInt32; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_fixint32,
+        .item_size = 4,
+        .run = bench_run_read_values,
+    },
+    {
+        .name = "string.crlf",
+        .description = "read [] string lines with a constant CRLF boundary",
+        .schema =
+        "let Line = string { @boundary: '\\r\\n'; };\n"
+        "let Root = struct { lines: [] Line; };\n",
+        .items_expr = "Model.lines",
+        .fill_contents = fill_contents_crlf_lines,
+        .item_size = 32,
+        .run = bench_run_read_values,
+    },
+    {
+        .name = "string.crlf_dynamic",
+        .description = "read [] string lines with a conditional CRLF boundary",
+        .schema =
+        "let Line = string { if (true) { @boundary: '\\r\\n'; } };\n"
+        "let Root = struct { lines: [] Line; };\n",
+        .items_expr = "Model.lines",
+        .fill_contents = fill_contents_crlf_lines,
+        .item_size = 32,
+        .run = bench_run_read_values,
+    },
+    {
+        .name = "string.crlf_regex",
+        .description = "read [] string lines with a regex CRLF boundary",
+        .schema =
+        "let Line = string { @boundary_regex: '\\r?\\n'; };\n"
+        "let Root = struct { lines: [] Line; };\n",
+        .items_expr = "Model.lines",
+        .fill_contents = fill_contents_crlf_lines,
+        .item_size = 32,
+        .run = bench_run_read_values,
+    },
+    {
+        .name = "varint.iterate",
+        .description = "read [] varint values one by one",
+        .schema = "let Root = struct { values: [] varint; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_varints,
+        .item_size = 5,
+        .run = bench_run_read_values,
+    },
+    {
+        .name = "varint.bulk",
+        .description = "bulk-read [] varint values",
+        .schema = "let Root = struct { values: [] varint; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_varints,
+        .item_size = 5,
+        .run = bench_run_read_values_bulk,
+    },
+    {
+        .name = "varint.zigzag.iterate",
+        .description = "read [] zigzag varint values one by one",
+        .schema = "let Root = struct { "
+        "values: [] varint { @zigzag: true; }; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_varints,
+        .item_size = 5,
+        .run = bench_run_read_values,
+    },
+    {
+        .name = "varint.zigzag.bulk",
+        .description = "bulk-read [] zigzag varint values",
+        .schema = "let Root = struct { "
+        "values: [] varint { @zigzag: true; }; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_varints,
+        .item_size = 5,
+        .run = bench_run_read_values_bulk,
+    },
+    {
+        .name = "varint.sst_entries",
+        .description = "read varint sizes of LevelDB-like key/value entries",
+        .schema = BENCH_SCHEMA_SST_ENTRIES,
+        .items_expr = "Model.entries",
+        .eval_expr = "key_shared_size + key_non_shared_size + value_size",
+        .fill_contents = fill_contents_sst_entries,
+        .item_size = 11,
+        .run = bench_run_eval_expr,
+    },
+    {
+        .name = "formatted_integer.octal",
+        .description = "read [] tar octal fields with constant attributes",
+        .schema =
+        "let OctalInt = [12] byte <> string { @boundary: '\\0'; } "
+        "    <> formatted_integer { @base: 8; @empty_value: 0; };\n"
+        "let Root = struct { values: [] OctalInt; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_octal_fields,
+        .item_size = 12,
+        .run = bench_run_read_values,
+    },
+    {
+        .name = "formatted_integer.octal_dynamic",
+        .description = "read [] tar octal fields with conditional attributes",
+        .schema =
+        "let OctalInt = [12] byte <> string { @boundary: '\\0'; } "
+        "    <> formatted_integer { if (true) { @base: 8; } "
+        "                           @empty_value: 0; };\n"
+        "let Root = struct { values: [] OctalInt; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_octal_fields,
+        .item_size = 12,
+        .run = bench_run_read_values,
+    },
+    {
+        .name = "iterate.records",
+        .description = "read key, location and value of [] FixInt32 items",
+        .schema =
+        "let FixInt32 = [4] byte <> integer { @signed: false; "
+        "                                     @endian: 'little'; };\n"
+        "let Root = struct { values: [] FixInt32; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_fixint32,
+        .item_size = 4,
+        .run = bench_run_read_records,
+    },
+    {
+        .name = "iterate.batch",
+        .description = "batch-read key, location and value of [] FixInt32 items",
+        .schema =
+        "let FixInt32 = [4] byte <> integer { @signed: false; "
+        "                                     @endian: 'little'; };\n"
+        "let Root = struct { values: [] FixInt32; };\n",
+        .items_expr = "Model.values",
+        .fill_contents = fill_contents_fixint32,
+        .item_size = 4,
+        .run = bench_run_read_records_batch,
+    },
+    {
+        .name = "expr.arith",
+        .description = "evaluate integer arithmetic on record fields",
+        .schema = BENCH_SCHEMA_RECORD,
+        .items_expr = "Model.records",
+        .eval_expr = "(a + 511) / 512 * 512 + (b & 0xff) - b % 256",
+        .fill_contents = fill_contents_record,
+        .item_size = 8,
+        .run = bench_run_eval_expr,
+    },
+    {
+        .name = "expr.compare",
+        .description = "evaluate boolean tests on record fields",
+        .schema = BENCH_SCHEMA_RECORD,
+        .items_expr = "Model.records",
+        .eval_expr = "(a & 3) == 1 && b >= a || !(a < 1000) && b != 0",
+        .fill_contents = fill_contents_record,
+        .item_size = 8,
+        .run = bench_run_eval_expr,
+    },
+    {
+        .name = "expr.named",
+        .description = "evaluate arithmetic on named expressions",
+        .schema = BENCH_SCHEMA_RECORD,
+        .items_expr = "Model.records",
+        .eval_expr = "padded - a + (b >> 4 & 0xf) * 2",
+        .fill_contents = fill_contents_record,
+        .item_size = 8,
+        .run = bench_run_eval_expr,
+    },
+    {
+        .name = "expr.size",
+        .description = "iterate records sized by an arithmetic expression",
+        .schema =
+        "let u32 = [4] byte <> integer { @signed: false; "
+        "                                @endian: 'little'; };\n"
+        "let Padded = struct { size: u32; data: [(size + 3) / 4 * 4] byte; };\n"
+        "let Root = struct { records: [] Padded; };\n",
+        .items_expr = "Model.records",
+        .fill_contents = fill_contents_padded,
+        .item_size = 8,
+        .run = bench_run_iterate,
+    },
+    {
+        .name = "struct.named",
+        .description = "access trailing fields of constant-size structs",
+        .schema = BENCH_SCHEMA_HEADER,
+        .items_expr = "Model.headers",
+        .eval_expr = "devminor - devmajor + typeflag",
+        .fill_contents = fill_contents_header,
+        .item_size = 32,
+        .run = bench_run_eval_expr,
+    },
+    {
+        .name = "scope.anonymous",
+        .description = "lookup names declared in nested anonymous fields",
+        .schema = BENCH_SCHEMA_MP4_BOX,
+        .items_expr = "Model.boxes",
+        .eval_expr = "size + atom + version + payload_size",
+        .fill_contents = fill_contents_mp4_box,
+        .item_size = 16,
+        .run = bench_run_eval_expr,
+    },
+    {
+        .name = "scope.iterate",
+        .description = "iterate boxes with conditional fields",
+        .schema = BENCH_SCHEMA_MP4_BOX,
+        .items_expr = "Model.boxes",
+        .fill_contents = fill_contents_mp4_box,
+        .item_size = 16,
+        .run = bench_run_iterate,
+    },
+    {
+        .name = "array.nested_slack",
+        .description = "count items of nested slack arrays",
+        .schema = BENCH_SCHEMA_NESTED_PAGES,
+        .items_expr = "Model.pages",
+        .eval_expr = "len(segments.items) "
+        "+ len(segments.items[0].entries.items) "
+        "+ len(segments.items[1].entries.items)",
+        .fill_contents = fill_contents_nested_pages,
+        .item_size = NESTED_PAGE_SIZE,
+        .run = bench_run_eval_expr,
+    },
+};
+
+
+static double
+timespec_diff(const struct timespec *start, const struct timespec *end)
+{
+    return (double)(end->tv_sec - start->tv_sec)
+        + (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int
+bench_launch(const struct bench_spec *bench)
+{
+    struct ast_node_hdl *schema;
+    struct bitpunch_board *board;
+    struct bitpunch_data_source *ds;
+    char *contents;
+    size_t contents_size;
+    expr_dpath_t dpath;
+    struct tracker *tk;
+    struct bitpunch_error *bp_err;
+    bitpunch_status_t bt_ret;
+    struct timespec start, end;
+    double elapsed, best;
+    int64_t n_items;
+    int round;
+    int ret;
+
+    ret = bitpunch_schema_create_from_string(&schema, bench->schema);
+    if (-1 == ret) {
+        fprintf(stderr, "%s: error compiling schema\n", bench->name);
+        return -1;
+    }
+    contents_size = bench_n_items * bench->item_size;
+    contents = malloc_safe(contents_size);
+    bench->fill_contents(contents, bench_n_items);
+    bitpunch_data_source_create_from_memory(
+        &ds, contents, contents_size, TRUE);
+
+    board = bitpunch_board_new();
+    bitpunch_board_add_let_expression(
+        board, "data", bitpunch_data_source_to_filter(ds));
+    bitpunch_board_add_let_expression(board, "Schema", schema);
+    bt_ret = bitpunch_board_add_expr(board, "Model", "data <> Schema.Root");
+    if (BITPUNCH_OK != bt_ret) {
+        fprintf(stderr, "%s: error adding model expression\n", bench->name);
+        ret = -1;
+        goto end;
+    }
+    best = -1.0;
+    for (round = 0; round < bench_n_rounds; ++round) {
+        bp_err = NULL;
+        bt_ret = bitpunch_eval_expr(board, bench->items_expr, NULL, 0u,
+                                    NULL, NULL, &dpath, &bp_err);
+        if (BITPUNCH_OK == bt_ret) {
+            bt_ret = track_dpath_contents(dpath, &tk, &bp_err);
+            expr_dpath_destroy(dpath);
+        }
+        if (BITPUNCH_OK == bt_ret) {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            bt_ret = bench->run(bench, tk, &n_items);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            tracker_delete(tk);
+        }
+        if (BITPUNCH_OK != bt_ret) {
+            fprintf(stderr, "%s: error %s: %s\n",
+                    bench->name, bitpunch_status_pretty(bt_ret),
+                    NULL != bp_err ? bitpunch_error_get_reason(bp_err) : "");
+            bitpunch_error_destroy(bp_err);
+            ret = -1;
+            goto end;
+        }
+        elapsed = timespec_diff(&start, &end);
+        if (best < 0.0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    printf("%-24s %10"PRIi64" items  %8.3f ms  %8.1f ns/item  "
+           "%8.3f M/s  (%s)\n",
+           bench->name, n_items, best * 1e3,
+           n_items > 0 ? best * 1e9 / n_items : 0.0,
+           best > 0.0 ? n_items / best / 1e6 : 0.0,
+           bench->description);
+    ret = 0;
+
+  end:
+    bitpunch_board_free(board);
+    (void) bitpunch_data_source_release(ds);
+    return ret;
+}
+
+static int
+bench_is_selected(const struct bench_spec *bench,
+                  int n_names, char *names[])
+{
+    int i;
+    size_t len;
+
+    if (0 == n_names) {
+        return TRUE;
+    }
+    for (i = 0; i < n_names; ++i) {
+        // match exact name or dot-separated prefix (e.g. "integer")
+        len = strlen(names[i]);
+        if (0 == strncmp(bench->name, names[i], len)
+            && ('\0' == bench->name[len] || '.' == bench->name[len])) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void
+usage(void)
+{
+    fprintf(stderr,
+            "usage: bench_bitpunch [-n items][-r rounds][-l][-h] "
+            "[bench-name...]\n"
+            "  -n: number of items per benchmark (default %"PRIi64")\n"
+            "  -r: number of timed rounds, best is reported (default %d)\n"
+            "  -l: list available benchmarks\n"
+            "  -h: show usage help\n",
+            bench_n_items, bench_n_rounds);
+}
+
+int main(int argc, char *argv[])
+{
+    int opt;
+    int i;
+    int n_failed;
+
+    while (-1 != (opt = getopt(argc, argv, "n:r:lh"))) {
+        switch (opt) {
+        case 'n':
+            bench_n_items = strtoll(optarg, NULL, 0);
+            break ;
+        case 'r':
+            bench_n_rounds = atoi(optarg);
+            break ;
+        case 'l':
+            for (i = 0; i < N_ELEM(bench_specs); ++i) {
+                printf("%-24s %s\n",
+                       bench_specs[i].name, bench_specs[i].description);
+            }
+            exit(EXIT_SUCCESS);
+        case 'h':
+        case '?':
+        default:
+            usage();
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (bench_n_items <= 0 || bench_n_rounds <= 0) {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+    if (-1 == bitpunch_init()) {
+        exit(EXIT_FAILURE);
+    }
+    n_failed = 0;
+    for (i = 0; i < N_ELEM(bench_specs); ++i) {
+        if (bench_is_selected(&bench_specs[i], argc - optind, argv + optind)) {
+            if (-1 == bench_launch(&bench_specs[i])) {
+                ++n_failed;
+            }
+        }
+    }
+    bitpunch_cleanup();
+    return (n_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
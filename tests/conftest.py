@@ -1,6 +1,7 @@
 import pytest
 import re
 import os
+import struct
 
 from bitpunch import model
 from bitpunch_cli import CLI
@@ -57,3 +58,6 @@ def make_testcase(param):
 def load_test_dat(test_file, dat_file):
     dat_dir = os.path.dirname(os.path.realpath(test_file))
     return open(os.path.join(dat_dir, dat_file), 'rb').read()
+
+def unpack_int_array(buf):
+    return list(struct.unpack('=%dq' % (len(buf) / 8), bytes(buf)))
@@ -69,6 +69,14 @@ Suite *bitpunch_suite(void)
     check_filter_varint_add_tcases(s);
     check_formatted_integer_add_tcases(s);
     check_dep_resolver_add_tcases(s);
+    check_int_decode_add_tcases(s);
+    check_str_search_add_tcases(s);
+    check_regex_add_tcases(s);
+    check_lazy_fmt_add_tcases(s);
+    check_data_source_add_tcases(s);
+    check_expr_bytecode_add_tcases(s);
+    check_scope_add_tcases(s);
+    check_threads_add_tcases(s);
     return s;
 }
 
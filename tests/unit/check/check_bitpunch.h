@@ -45,5 +45,13 @@ void check_filter_base64_add_tcases(Suite *s);
 void check_filter_varint_add_tcases(Suite *s);
 void check_formatted_integer_add_tcases(Suite *s);
 void check_dep_resolver_add_tcases(Suite *s);
+void check_int_decode_add_tcases(Suite *s);
+void check_str_search_add_tcases(Suite *s);
+void check_regex_add_tcases(Suite *s);
+void check_lazy_fmt_add_tcases(Suite *s);
+void check_data_source_add_tcases(Suite *s);
+void check_expr_bytecode_add_tcases(Suite *s);
+void check_scope_add_tcases(Suite *s);
+void check_threads_add_tcases(Suite *s);
 
 #endif /*__CHECK_BITPUNCH_H__*/
@@ -0,0 +1,269 @@
+/* -*- c-file-style: "cc-mode" -*- */
+/*
+ * Copyright (c) 2017, Jonathan Gramain <jonathan.gramain@gmail.com>. All
+ * rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * * The names of the bitpunch project contributors may not be used to
+ *   endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+ * TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/*
+ * Concurrent readers: several threads browse the same compiled schema,
+ * through data sources shared between threads (a memory source) or
+ * opened by path (going through the file data source cache), each
+ * thread with its own boards and trackers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+#include <check.h>
+
+#include "api/bitpunch_api.h"
+#include "core/browse.h"
+#include "core/browse_internal.h"
+#include "core/expr.h"
+#include "check_bitpunch.h"
+
+#define CHECK_THREADS_N_THREADS    8
+#define CHECK_THREADS_N_ITERATIONS 4
+#define CHECK_THREADS_N_RECORDS    2000
+
+static const char *check_threads_schema_def =
+    "let u8 = byte <> integer { @signed: false; };\n"
+    "let u32 = [4] byte <> integer { @signed: false; @endian: 'big'; };\n"
+    "let Record = struct {\n"
+    "    size: u8;\n"
+    "    value: u32;\n"
+    "    data: [size] byte;\n"
+    "};\n"
+    "let Root = struct {\n"
+    "    records: [] Record;\n"
+    "};\n";
+
+static struct ast_node_hdl *check_threads_schema_hdl;
+static char *check_threads_contents;
+static size_t check_threads_contents_size;
+static int64_t check_threads_expected_sum;
+static int64_t check_threads_last_value;
+static char check_threads_path[] = "/tmp/check_threads.XXXXXX";
+static struct bitpunch_data_source *check_threads_shared_ds;
+
+struct check_threads_worker {
+    pthread_t thread;
+    int worker_idx;
+    int n_errors;
+};
+
+
+static void threads_setup(void)
+{
+    int ret;
+    int i;
+    size_t offset;
+    uint32_t value;
+    int fd;
+
+    ret = bitpunch_schema_create_from_string(
+        &check_threads_schema_hdl, check_threads_schema_def);
+    assert(0 == ret);
+
+    check_threads_contents = malloc(CHECK_THREADS_N_RECORDS * (1 + 4 + 7));
+    assert(NULL != check_threads_contents);
+    offset = 0;
+    check_threads_expected_sum = 0;
+    for (i = 0; i < CHECK_THREADS_N_RECORDS; ++i) {
+        check_threads_contents[offset] = (char)(i % 8);
+        value = (uint32_t)(i * 37 + 11);
+        check_threads_contents[offset + 1] = (char)(value >> 24);
+        check_threads_contents[offset + 2] = (char)(value >> 16);
+        check_threads_contents[offset + 3] = (char)(value >> 8);
+        check_threads_contents[offset + 4] = (char)value;
+        memset(check_threads_contents + offset + 5, 0xaa, i % 8);
+        offset += 5 + i % 8;
+        check_threads_expected_sum += value;
+        check_threads_last_value = value;
+    }
+    check_threads_contents_size = offset;
+
+    fd = mkstemp(check_threads_path);
+    assert(-1 != fd);
+    ret = write(fd, check_threads_contents, check_threads_contents_size);
+    assert(ret == (int)check_threads_contents_size);
+    close(fd);
+
+    bitpunch_data_source_create_from_memory(
+        &check_threads_shared_ds,
+        check_threads_contents, check_threads_contents_size, FALSE);
+}
+
+static void threads_teardown(void)
+{
+    (void) bitpunch_data_source_release(check_threads_shared_ds);
+    (void) unlink(check_threads_path);
+    free(check_threads_contents);
+    bitpunch_schema_free(check_threads_schema_hdl);
+}
+
+static int
+check_threads_browse(struct bitpunch_data_source *ds)
+{
+    struct bitpunch_board *board;
+    expr_dpath_t dpath;
+    struct tracker *tk;
+    struct box *item_box;
+    struct ast_node_hdl *value_expr;
+    expr_value_t value;
+    bitpunch_status_t bt_ret;
+    int64_t sum;
+    int64_t n_items;
+    char last_expr[64];
+    int n_errors;
+
+    n_errors = 0;
+    board = bitpunch_board_new();
+    bitpunch_board_add_let_expression(
+        board, "data", bitpunch_data_source_to_filter(ds));
+    bitpunch_board_add_let_expression(
+        board, "Schema", check_threads_schema_hdl);
+    bt_ret = bitpunch_board_add_expr(board, "Model", "data <> Schema.Root");
+    if (BITPUNCH_OK != bt_ret) {
+        bitpunch_board_free(board);
+        return 1;
+    }
+    bt_ret = bitpunch_eval_expr(board, "Model.records", NULL, 0u,
+                                NULL, NULL, &dpath, NULL);
+    if (BITPUNCH_OK == bt_ret) {
+        bt_ret = track_dpath_contents(dpath, &tk, NULL);
+        expr_dpath_destroy(dpath);
+    }
+    if (BITPUNCH_OK != bt_ret) {
+        bitpunch_board_free(board);
+        return 1;
+    }
+    value_expr = NULL;
+    sum = 0;
+    n_items = 0;
+    bt_ret = tracker_goto_first_item(tk, NULL);
+    while (BITPUNCH_OK == bt_ret) {
+        bt_ret = tracker_get_filtered_item_box(tk, &item_box, NULL);
+        if (BITPUNCH_OK != bt_ret) {
+            break ;
+        }
+        if (NULL == value_expr) {
+            bt_ret = bitpunch_eval_expr(NULL, "value", item_box, 0u,
+                                        &value_expr, &value, NULL, NULL);
+        } else {
+            bt_ret = expr_evaluate_value(value_expr, item_box, NULL,
+                                         &value, NULL);
+        }
+        box_delete(item_box);
+        if (BITPUNCH_OK != bt_ret) {
+            break ;
+        }
+        sum += value.integer;
+        expr_value_destroy(value);
+        ++n_items;
+        bt_ret = tracker_goto_next_item(tk, NULL);
+    }
+    tracker_delete(tk);
+    if (BITPUNCH_NO_ITEM != bt_ret
+        || CHECK_THREADS_N_RECORDS != n_items
+        || check_threads_expected_sum != sum) {
+        ++n_errors;
+    }
+    snprintf(last_expr, sizeof (last_expr),
+             "Model.records[%d].value", CHECK_THREADS_N_RECORDS - 1);
+    bt_ret = bitpunch_eval_expr(board, last_expr, NULL, 0u,
+                                NULL, &value, NULL, NULL);
+    if (BITPUNCH_OK != bt_ret || check_threads_last_value != value.integer) {
+        ++n_errors;
+    }
+    if (BITPUNCH_OK == bt_ret) {
+        expr_value_destroy(value);
+    }
+    bitpunch_board_free(board);
+    return n_errors;
+}
+
+static void *
+check_threads_worker_run(void *arg)
+{
+    struct check_threads_worker *worker;
+    struct bitpunch_data_source *ds;
+    int iteration;
+
+    worker = (struct check_threads_worker *)arg;
+    for (iteration = 0; iteration < CHECK_THREADS_N_ITERATIONS; ++iteration) {
+        if (0 == (worker->worker_idx + iteration) % 2) {
+            if (-1 == bitpunch_data_source_create_from_file_path(
+                    &ds, check_threads_path)) {
+                ++worker->n_errors;
+                continue ;
+            }
+        } else {
+            ds = check_threads_shared_ds;
+            bitpunch_data_source_acquire(ds);
+        }
+        worker->n_errors += check_threads_browse(ds);
+        (void) bitpunch_data_source_release(ds);
+    }
+    return NULL;
+}
+
+START_TEST(threads_concurrent_readers)
+{
+    struct check_threads_worker workers[CHECK_THREADS_N_THREADS];
+    int i;
+    int ret;
+
+    for (i = 0; i < CHECK_THREADS_N_THREADS; ++i) {
+        workers[i].worker_idx = i;
+        workers[i].n_errors = 0;
+        ret = pthread_create(&workers[i].thread, NULL,
+                             check_threads_worker_run, &workers[i]);
+        ck_assert_int_eq(ret, 0);
+    }
+    for (i = 0; i < CHECK_THREADS_N_THREADS; ++i) {
+        ret = pthread_join(workers[i].thread, NULL);
+        ck_assert_int_eq(ret, 0);
+        ck_assert_int_eq(workers[i].n_errors, 0);
+    }
+}
+END_TEST
+
+
+void check_threads_add_tcases(Suite *s)
+{
+    TCase *tc_threads;
+
+    tc_threads = tcase_create("threads.concurrent_readers");
+    tcase_add_unchecked_fixture(tc_threads, threads_setup, threads_teardown);
+    tcase_add_test(tc_threads, threads_concurrent_readers);
+    suite_add_tcase(s, tc_threads);
+}
@@ -1,5 +1,8 @@
 #!/usr/bin/env python
 
+import gc
+import os
+
 import pytest
 
 from bitpunch import model
@@ -370,3 +373,263 @@ def test_array_two_dimensional_items(params_array_two_dimensional_items):
     assert dtree.eval_expr('sizeof(table.integers[1])') == row1_size
     assert dtree.table.integers[2].values[3].value == 6
     assert dtree.eval_expr('table.integers[2].values[3].value') == 6
+
+
+#
+# Index caches of variable-size arrays persist in sidecar files
+#
+
+spec_array_index_sidecar = """
+
+let u8 = byte <> integer { @signed: false; };
+
+let Record = struct {
+    size: u8;
+    data: [size] byte;
+};
+
+let Schema = struct {
+    records: [] Record;
+};
+
+"""
+
+
+def make_array_index_sidecar_testcase(path):
+    board = model.Board()
+    board.add_data_source('data', path=path)
+    board.add_spec('Spec', spec_array_index_sidecar)
+    return board.eval_expr('data <> Spec.Schema')
+
+
+def test_array_index_sidecar(tmpdir):
+    records = [chr(i % 7) * (i % 7) for i in range(5000)]
+    data_path = str(tmpdir.join('records.bin'))
+    index_dir = tmpdir.mkdir('index')
+    with open(data_path, 'wb') as f:
+        f.write(''.join(chr(len(r)) + r for r in records))
+
+    model.set_index_dir(str(index_dir))
+    try:
+        dtree = make_array_index_sidecar_testcase(data_path)
+        assert dtree.records[4000].data == records[4000]
+        # the index sidecar gets saved when the array cache goes away
+        del dtree
+        gc.collect()
+        assert len([name for name in os.listdir(str(index_dir))
+                    if name.startswith('array-')]) == 1
+
+        # a new session resumes from the saved marks
+        dtree = make_array_index_sidecar_testcase(data_path)
+        for index in (4999, 10, 4000, 2345, 0, 4001):
+            assert dtree.records[index].data == records[index]
+        assert len(dtree.records) == len(records)
+        del dtree
+        gc.collect()
+
+        # changing the data invalidates the sidecar
+        records[3] = 'abcdef'
+        with open(data_path, 'wb') as f:
+            f.write(''.join(chr(len(r)) + r for r in records))
+        model.notify_file_change(data_path)
+        dtree = make_array_index_sidecar_testcase(data_path)
+        for index in (4999, 3, 4):
+            assert dtree.records[index].data == records[index]
+    finally:
+        model.set_index_dir(None)
+
+
+#
+# Parallel pre-scan of arrays of items with a sync pattern
+#
+
+spec_array_prescan = """
+
+let u8 = byte <> integer { @signed: false; };
+
+let Page = struct {
+    magic: [4] byte;
+    size: u8;
+    data: [size] byte;
+    @sync: 'SYNC';
+};
+
+let Schema = struct {
+    pages: [] Page;
+};
+
+"""
+
+
+def make_array_prescan_testcase(path):
+    board = model.Board()
+    board.add_data_source('data', path=path)
+    board.add_spec('Spec', spec_array_prescan)
+    return board.eval_expr('data <> Spec.Schema')
+
+
+def test_array_prescan(tmpdir):
+    # some payloads contain the sync pattern, so that workers may
+    # start in the middle of a page and need to be resynchronized
+    pages = []
+    for i in range(3000):
+        if i % 5 == 0:
+            pages.append('xSYNC\x03SYNCabc' + chr(i % 251) * (i % 13))
+        else:
+            pages.append(chr(i % 251) * (i % 37))
+    data_path = str(tmpdir.join('pages.bin'))
+    with open(data_path, 'wb') as f:
+        f.write(''.join('SYNC' + chr(len(p)) + p for p in pages))
+
+    for n_workers in (2, 3, 7, 16):
+        model.set_array_prescan(n_workers, 0)
+        try:
+            dtree = make_array_prescan_testcase(data_path)
+            for index in (2999, 0, 1234, 5, 2500):
+                assert dtree.pages[index].data == pages[index]
+            assert len(dtree.pages) == len(pages)
+        finally:
+            model.set_array_prescan(0)
+
+
+#
+# Boxes and trackers of browsed items are recycled
+#
+
+def test_array_alloc_reuse():
+    board = model.Board()
+    board.add_data_source('data', data=''.join(chr(i) for i in range(200)))
+    board.add_spec('Spec', """
+let u8 = byte <> integer { @signed: false; };
+let Schema = struct { values: [] u8; };
+""")
+    dtree = board.eval_expr('data <> Spec.Schema')
+
+    stats = model.get_alloc_stats()
+    assert sum(dtree.values) == sum(range(200))
+    new_stats = model.get_alloc_stats()
+    n_box_allocs = new_stats['box_allocs'] - stats['box_allocs']
+    n_box_reuses = new_stats['box_reuses'] - stats['box_reuses']
+    assert n_box_allocs > 0
+    # freed item boxes get reused, few slabs are needed
+    assert n_box_reuses > n_box_allocs / 2
+    assert new_stats['slabs'] - stats['slabs'] <= 2
+
+
+#
+# An item of a slack array overflowing the available space is an
+# error, it does not end the array
+#
+
+spec_array_slack_overflow = """
+let u8 = byte <> integer { @signed: false; };
+let Entry = struct { len: u8; data: [len] byte; };
+let Entries = struct { items: [] Entry; };
+let Schema = struct {
+    n: u8;
+    entries: [n] byte <> Entries;
+    trailer: [] byte;
+};
+"""
+
+data_array_slack_overflow = """
+# n
+08
+# entries
+02 "ab" 01 "c" 05 "de"
+# trailer
+"end"
+"""
+
+def test_array_slack_overflow():
+    dtree = conftest.make_testcase({
+        'spec': spec_array_slack_overflow,
+        'data': data_array_slack_overflow,
+    })['dtree']
+
+    assert str(dtree.entries.items[0].data) == 'ab'
+    assert str(dtree.entries.items[1].data) == 'c'
+    with pytest.raises(model.OutOfBoundsError):
+        print len(dtree.entries.items)
+    with pytest.raises(model.OutOfBoundsError):
+        print dtree.entries.items[2]
+    assert str(dtree.trailer) == 'end'
+
+
+#
+# Trackers read items in batches of (key, offset, size, value) records
+#
+
+spec_array_tracker_batch = """
+let u8 = byte <> integer { @signed: false; };
+let u16 = [2] byte <> integer { @signed: false; @endian: 'big'; };
+let Item = struct { value: u16; };
+let Schema = struct {
+    n: u8;
+    values: [n] u16;
+    items: [] Item;
+};
+"""
+
+data_array_tracker_batch = """
+# n
+05
+# values
+00 00 00 01 00 02 00 03 00 04
+# items
+01 00 02 00 03 00
+"""
+
+def test_array_tracker_batch():
+    dtree = conftest.make_testcase({
+        'spec': spec_array_tracker_batch,
+        'data': data_array_tracker_batch,
+    })['dtree']
+
+    tk = model.Tracker(dtree.values)
+    assert tk.read_items(2) == [(0, 1, 2, 0), (1, 3, 2, 1)]
+    # tracker stays on the last item read
+    assert tk.get_item_key() == 1
+    assert tk.read_items(10) == [(2, 5, 2, 2), (3, 7, 2, 3), (4, 9, 2, 4)]
+    assert tk.read_items(10) == []
+
+    tk = model.Tracker(dtree.values)
+    assert [len(chunk) for chunk in tk.iter_chunks(2)] == [2, 2, 1]
+
+    tk = model.Tracker(dtree.items)
+    records = [record for chunk in tk.iter_chunks(2) for record in chunk]
+    assert [(key, offset, size) for key, offset, size, _ in records] == \
+        [(0, 11, 2), (1, 13, 2), (2, 15, 2)]
+    assert [item.value for _, _, _, item in records] == [0x100, 0x200, 0x300]
+
+    with pytest.raises(ValueError):
+        model.Tracker(dtree.values).read_items(0)
+
+
+spec_array_tracker_batch_error = """
+let Number = [2] byte <> formatted_integer;
+let Schema = struct {
+    numbers: [] Number;
+};
+"""
+
+data_array_tracker_batch_error = """
+"1234zz56"
+"""
+
+def test_array_tracker_batch_error():
+    dtree = conftest.make_testcase({
+        'spec': spec_array_tracker_batch_error,
+        'data': data_array_tracker_batch_error,
+    })['dtree']
+
+    tk = model.Tracker(dtree.numbers)
+    # items read before the error are returned first
+    assert tk.read_items(10) == [(0, 0, 2, 12), (1, 2, 2, 34)]
+    assert tk.get_item_key() == 1
+    # the error is then raised, without skipping the invalid item
+    with pytest.raises(model.DataError):
+        tk.read_items(10)
+    with pytest.raises(model.DataError):
+        tk.read_items(10)
+    assert tk.get_item_key() == 1
@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+
+import pytest
+
+from bitpunch import model
+import conftest
+
+#
+# Regular expression match operator "=~"
+#
+
+spec_file_match_operator = """
+
+let u8 = byte <> integer { @signed: false; };
+let Line = string { @boundary: '\\n'; };
+
+let Schema = struct {
+    version: Line;
+    magic: [4] byte;
+    if (magic =~ '^PK\\\\x03\\\\x04$') {
+        zip_flags: u8;
+    }
+    if (version =~ '^v\\\\d+\\\\.\\\\d+$') {
+        release: u8;
+    }
+    rest: [] byte;
+
+    let is_beta = version =~ '-(alpha|beta)[0-9]*$';
+    let const_match = 'abc' =~ 'b+';
+};
+
+"""
+
+data_file_match_operator_release = """
+"v1.2" 0a
+"PK" 03 04
+# zip_flags
+01
+# release
+02
+"tail"
+"""
+
+data_file_match_operator_beta = """
+"v1.3-beta2" 0a
+"ZIP" 00
+"tail"
+"""
+
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_file_match_operator,
+        'data': data_file_match_operator_release,
+        'is_release': True,
+    }, {
+        'spec': spec_file_match_operator,
+        'data': data_file_match_operator_beta,
+        'is_release': False,
+    }])
+def params_match_operator(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_match_operator(params_match_operator):
+    params = params_match_operator
+    dtree = params['dtree']
+
+    assert dtree.const_match == True
+    if params['is_release']:
+        assert dtree.zip_flags == 1
+        assert dtree.release == 2
+        assert dtree.is_beta == False
+        assert model.make_python_object(dtree.rest) == 'tail'
+    else:
+        with pytest.raises(AttributeError):
+            print dtree.zip_flags
+        with pytest.raises(AttributeError):
+            print dtree.release
+        assert dtree.is_beta == True
+        assert model.make_python_object(dtree.rest) == 'tail'
+
+    # expressions evaluated on the fly
+    assert dtree.eval_expr('version =~ "^v1\\\\."') == True
+    assert dtree.eval_expr('version =~ "^v2"') == False
+    assert dtree.eval_expr('rest =~ "a.l$"') == True
+
+
+@pytest.fixture(
+    scope='module',
+    params=[
+        # invalid pattern
+        "let Schema = struct { s: [4] byte; let m = s =~ '(a'; };",
+        # pattern not constant
+        "let Schema = struct { s: [4] byte; let m = s =~ s; };",
+        # subject is not a string nor bytes
+        "let Schema = struct { let m = 42 =~ '4'; };",
+    ])
+def params_match_operator_invalid(request):
+    return request.param
+
+
+def test_match_operator_invalid(params_match_operator_invalid):
+    board = model.Board()
+    with pytest.raises(OSError):
+        board.add_spec('Spec', params_match_operator_invalid)
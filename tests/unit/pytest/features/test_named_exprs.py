@@ -105,6 +105,14 @@ def test_named_exprs_1(params_named_exprs_1):
         assert (dtree.eval_expr('&untyped[{0}].?value'.format(i))
                 == 6 + 2 * i)
 
+    # evaluate again on the same boxes (possibly memoized results)
+    for i in range(3):
+        untyped = dtree.untyped[i]
+        for _ in range(2):
+            assert untyped['?value'] == i + 1
+            assert untyped.eval_expr('?value') == i + 1
+            assert untyped.eval_expr('&?value') == 6 + 2 * i
+
 
 spec_file_named_exprs_2_1 = """
 
@@ -84,3 +84,48 @@ def test_user_function_extern_use_spec():
     board.register_function('get_answer_to_universe', get_answer_to_universe)
 
     assert board.eval_expr('the_answer') == 42
+
+
+
+#
+# Named expressions calling external functions must not be memoized
+#
+
+spec_file_user_function_not_memoized = """
+
+extern get_next_count;
+
+let Schema = struct {
+    contents: [] byte;
+    let ?count = get_next_count;
+};
+
+"""
+
+data_file_user_function_not_memoized = """
+"Some useless contents"
+"""
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_file_user_function_not_memoized,
+        'data': data_file_user_function_not_memoized,
+    }])
+def params_user_function_not_memoized(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_user_function_not_memoized(params_user_function_not_memoized):
+    params = params_user_function_not_memoized
+    board, dtree = params['board'], params['dtree']
+
+    counter = [0]
+    def get_next_count():
+        counter[0] += 1
+        return counter[0]
+
+    board.register_function('get_next_count', get_next_count)
+
+    assert dtree['?count'] == 1
+    assert dtree['?count'] == 2
@@ -0,0 +1,173 @@
+#!/usr/bin/env python
+
+import gc
+import os
+import pytest
+import random
+import struct
+import zlib
+
+from bitpunch import model
+
+
+def raw_deflate(contents):
+    compressor = zlib.compressobj(9, zlib.DEFLATED, -15)
+    return compressor.compress(contents) + compressor.flush()
+
+
+spec_deflate = """
+
+let u32 = [4] byte <> integer { @signed: false; @endian: 'little'; };
+
+let Schema = struct {
+    output_size: u32;
+    input_size: u32;
+    payload: [input_size] byte <> deflate { @output_size: output_size; };
+    trailer: [] byte;
+};
+
+"""
+
+spec_deflate_checkpoints = """
+
+let u32 = [4] byte <> integer { @signed: false; @endian: 'little'; };
+
+let Schema = struct {
+    output_size: u32;
+    input_size: u32;
+    payload: [input_size] byte <> deflate {
+        @output_size: output_size;
+        @checkpoint_span: 65536;
+    };
+    trailer: [] byte;
+};
+
+"""
+
+def make_deflate_data(contents, output_size=None):
+    compressed = raw_deflate(contents)
+    if output_size is None:
+        output_size = len(contents)
+    return (struct.pack('<II', output_size, len(compressed))
+            + compressed + 'END')
+
+
+def make_deflate_testcase(contents, output_size=None, spec=spec_deflate,
+                          zero_copy=False):
+    board = model.Board()
+    board.zero_copy = zero_copy
+    board.add_data_source('data', make_deflate_data(contents, output_size))
+    board.add_spec('Spec', spec)
+    return board.eval_expr('data <> Spec.Schema')
+
+
+def make_deflate_file_testcase(path, spec=spec_deflate):
+    board = model.Board()
+    board.add_data_source('data', path=path)
+    board.add_spec('Spec', spec)
+    return board.eval_expr('data <> Spec.Schema')
+
+
+def test_deflate():
+    contents = ''.join('line %d\n' % i for i in range(100000))
+    dtree = make_deflate_testcase(contents)
+
+    assert dtree.payload[:10] == contents[:10]
+    # inflated lazily up to the highest offset requested
+    assert dtree.eval_expr('payload[500000..500020]') == \
+        contents[500000:500020]
+    assert len(dtree.payload) == len(contents)
+    assert dtree.payload == contents
+    assert dtree.trailer == 'END'
+
+
+def test_deflate_empty():
+    dtree = make_deflate_testcase('')
+    assert len(dtree.payload) == 0
+    assert dtree.trailer == 'END'
+
+
+def test_deflate_errors():
+    dtree = make_deflate_testcase('hello', output_size=4)
+    with pytest.raises(model.DataError):
+        print dtree.payload
+    dtree = make_deflate_testcase('hello', output_size=6)
+    with pytest.raises(model.DataError):
+        print dtree.payload
+
+
+def test_deflate_checkpoints(tmpdir):
+    rnd = random.Random(42)
+    contents = ''.join('%d:%x\n' % (i, rnd.getrandbits(32))
+                       for i in range(200000))
+    data_path = str(tmpdir.join('data.bin'))
+    index_dir = tmpdir.mkdir('index')
+    with open(data_path, 'wb') as f:
+        f.write(make_deflate_data(contents))
+
+    model.set_index_dir(str(index_dir))
+    try:
+        # sidecars are keyed on the input file identity, in-memory
+        # data gets none
+        dtree = make_deflate_testcase(contents,
+                                      spec=spec_deflate_checkpoints)
+        assert dtree.payload[-20:] == contents[-20:]
+        assert len(os.listdir(str(index_dir))) == 0
+
+        dtree = make_deflate_file_testcase(data_path,
+                                           spec=spec_deflate_checkpoints)
+        # the index sidecar gets saved once fully inflated
+        assert dtree.payload[-20:] == contents[-20:]
+        assert len(os.listdir(str(index_dir))) == 1
+
+        # a new session resumes inflating from the saved checkpoints
+        dtree = make_deflate_file_testcase(data_path,
+                                           spec=spec_deflate_checkpoints)
+        for offset in (len(contents) - 100, 1000000, 500000, 10, 700000):
+            assert dtree.eval_expr('payload[%d..%d]' % (
+                offset, offset + 100)) == contents[offset:offset + 100]
+        assert dtree.payload == contents
+        assert dtree.trailer == 'END'
+    finally:
+        model.set_index_dir(None)
+
+
+def test_deflate_output_cache():
+    contents = ''.join('line %d\n' % i for i in range(10000))
+    dtree = make_deflate_testcase(contents)
+
+    stats = model.get_filter_cache_stats()
+    assert dtree.payload[:10] == contents[:10]
+    # filtering the same compressed block again reuses its output
+    for i in range(3):
+        assert dtree.eval_expr('payload[100..110]') == contents[100:110]
+    new_stats = model.get_filter_cache_stats()
+    assert new_stats['hits'] > stats['hits']
+    assert new_stats['entries'] >= 1
+
+    model.set_filter_cache_limits(0, 0)
+    try:
+        assert model.get_filter_cache_stats()['entries'] == 0
+        assert dtree.eval_expr('payload[100..110]') == contents[100:110]
+        assert model.get_filter_cache_stats()['entries'] == 0
+    finally:
+        model.set_filter_cache_limits(256, 256 * 1024 * 1024)
+
+
+def test_deflate_zero_copy():
+    contents = ''.join('line %d\n' % i for i in range(10000))
+
+    obj = model.make_python_object(make_deflate_testcase(contents))
+    assert obj['payload'] == contents
+
+    obj = model.make_python_object(
+        make_deflate_testcase(contents, zero_copy=True))
+    payload = obj['payload']
+    assert isinstance(payload, memoryview)
+    assert isinstance(obj['trailer'], memoryview)
+    assert obj['trailer'].tobytes() == 'END'
+    assert obj['output_size'] == len(contents)
+    # views keep the inflated contents alive
+    del obj
+    gc.collect()
+    assert payload.tobytes() == contents
@@ -196,3 +196,49 @@ def test_file_string_array(params_file_string_array):
     assert dtree.eval_expr('^^self') == 'hello\nhola\nbonjour\n'
 
     os.unlink(TEST_FILE_PATH)
+
+
+#
+# File data source cache
+#
+
+spec_file_cache = """
+
+let data = file {{ @path: "{file_path}"; }};
+
+""".format(file_path=TEST_FILE_PATH)
+
+
+def eval_file_data():
+    board = model.Board()
+    board.add_spec('Spec', spec_file_cache)
+    return board.eval_expr('Spec.data')
+
+
+def test_file_cache():
+    with open(TEST_FILE_PATH, 'w') as f:
+        f.write('foobar')
+    stats = model.get_file_cache_stats()
+    assert eval_file_data() == 'foobar'
+    assert eval_file_data() == 'foobar'
+    new_stats = model.get_file_cache_stats()
+    assert new_stats['hits'] > stats['hits']
+    assert new_stats['entries'] >= 1
+
+    # changes are detected without notify_file_change()
+    stats = new_stats
+    with open(TEST_FILE_PATH, 'w') as f:
+        f.write('foobarbaz')
+    os.utime(TEST_FILE_PATH, (0, 0))
+    assert eval_file_data() == 'foobarbaz'
+    new_stats = model.get_file_cache_stats()
+    assert new_stats['invalidations'] > stats['invalidations']
+
+    # unused entries are evicted beyond the cache limits
+    model.set_file_cache_limits(0, 0)
+    stats = model.get_file_cache_stats()
+    assert stats['entries'] == 0
+    assert stats['evictions'] > new_stats['evictions']
+    model.set_file_cache_limits(1024, 1024 * 1024 * 1024)
+
+    os.unlink(TEST_FILE_PATH)
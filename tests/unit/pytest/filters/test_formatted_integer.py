@@ -0,0 +1,157 @@
+#!/usr/bin/env python
+
+import pytest
+
+from bitpunch import model
+import conftest
+
+#
+# Text-formatted integers, long enough to be parsed eight digits at a
+# time
+#
+
+spec_formatted_integer_constant_attributes = """
+let Field = string { @boundary: ' '; };
+let Dec = Field <> formatted_integer;
+let UDec = Field <> formatted_integer { @signed: false; };
+let Oct = Field <> formatted_integer { @base: 8; @empty_value: 0; };
+let Hex = Field <> formatted_integer { @base: 16; };
+
+let Schema = struct {
+    a: Dec;
+    b: Dec;
+    c: UDec;
+    d: Oct;
+    e: Oct;
+    f: Oct;
+    g: Hex;
+    h: Hex;
+};
+"""
+
+spec_formatted_integer_dynamic_attributes = """
+let Field = string { @boundary: ' '; };
+let Dec = Field <> formatted_integer { if (true) { @base: 10; } };
+let UDec = Field <> formatted_integer { if (true) { @signed: false; } };
+let Oct = Field <> formatted_integer {
+    if (true) { @base: 8; @empty_value: 0; }
+};
+let Hex = Field <> formatted_integer { if (true) { @base: 16; } };
+
+let Schema = struct {
+    a: Dec;
+    b: Dec;
+    c: UDec;
+    d: Oct;
+    e: Oct;
+    f: Oct;
+    g: Hex;
+    h: Hex;
+};
+"""
+
+data_formatted_integer = """
+"1234567890123456789 "
+"-9223372036854775807 "
+"00000000000000000042 "
+"00000001750 "
+" "
+"777777777777777777777 "
+"DEADbeef0123456 "
+"7fffffffffffffff "
+"""
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_formatted_integer_constant_attributes,
+        'data': data_formatted_integer,
+    }, {
+        'spec': spec_formatted_integer_dynamic_attributes,
+        'data': data_formatted_integer,
+    }])
+def params_formatted_integer(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_formatted_integer(params_formatted_integer):
+    params = params_formatted_integer
+    dtree = params['dtree']
+
+    assert dtree.a == 1234567890123456789
+    assert dtree.b == -9223372036854775807
+    assert dtree.c == 42
+    assert dtree.d == 01750
+    assert dtree.e == 0
+    assert dtree.f == 0777777777777777777777
+    assert dtree.g == 0xDEADBEEF0123456
+    assert dtree.h == 0x7fffffffffffffff
+
+
+#
+# Errors must be reported the same way whether attributes are
+# constant or not
+#
+
+spec_formatted_integer_errors_constant_attributes = """
+let Field = string { @boundary: ' '; };
+let Dec = Field <> formatted_integer;
+let UDec = Field <> formatted_integer { @signed: false; };
+let Oct = Field <> formatted_integer { @base: 8; };
+
+let Schema = struct {
+    overflow: Dec;
+    wrapped: Dec;
+    invalid: Dec;
+    sign: UDec;
+    empty: Dec;
+    not_octal: Oct;
+};
+"""
+
+spec_formatted_integer_errors_dynamic_attributes = """
+let Field = string { @boundary: ' '; };
+let Dec = Field <> formatted_integer { if (true) { @base: 10; } };
+let UDec = Field <> formatted_integer { if (true) { @signed: false; } };
+let Oct = Field <> formatted_integer { if (true) { @base: 8; } };
+
+let Schema = struct {
+    overflow: Dec;
+    wrapped: Dec;
+    invalid: Dec;
+    sign: UDec;
+    empty: Dec;
+    not_octal: Oct;
+};
+"""
+
+data_formatted_integer_errors = """
+"9223372036854775808 "
+"20496382304121724020 "
+"1234567:9 "
+"-12345678 "
+" "
+"1234567812345678 "
+"""
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_formatted_integer_errors_constant_attributes,
+        'data': data_formatted_integer_errors,
+    }, {
+        'spec': spec_formatted_integer_errors_dynamic_attributes,
+        'data': data_formatted_integer_errors,
+    }])
+def params_formatted_integer_errors(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_formatted_integer_errors(params_formatted_integer_errors):
+    params = params_formatted_integer_errors
+    dtree = params['dtree']
+
+    for name in ['overflow', 'wrapped', 'invalid', 'sign',
+                 'empty', 'not_octal']:
+        with pytest.raises(model.DataError):
+            print getattr(dtree, name)
@@ -0,0 +1,210 @@
+#!/usr/bin/env python
+
+import pytest
+
+from bitpunch import model
+import conftest
+
+#
+# Fixed-size binary integers
+#
+
+spec_integer_constant_attributes = """
+let s8 = byte <> integer { @signed: true; };
+let u8 = byte <> integer { @signed: false; };
+let LE = integer { @signed: false; @endian: 'little'; };
+let SBE = integer { @signed: true; @endian: 'big'; };
+
+let Schema = struct {
+    a: s8;
+    b: u8;
+    c: [2] byte <> LE;
+    d: [4] byte <> LE;
+    e: [8] byte <> LE;
+    f: [2] byte <> SBE;
+    g: [4] byte <> SBE;
+    h: [8] byte <> SBE;
+};
+"""
+
+data_integer_constant_attributes = """
+# a
+ff
+# b
+ff
+# c
+01 02
+# d
+01 02 03 04
+# e
+01 02 03 04 05 06 07 08
+# f
+ff fe
+# g
+ff ff ff fd
+# h
+ff ff ff ff ff ff ff fc
+"""
+
+spec_integer_dynamic_attributes = """
+let u8 = byte <> integer { @signed: false; };
+
+let Schema = struct {
+    is_signed: u8;
+    let Integer = integer {
+        if (is_signed == 1) {
+            @signed: true;
+        } else {
+            @signed: false;
+        }
+        @endian: 'big';
+    };
+    value: [2] byte <> Integer;
+};
+"""
+
+data_integer_dynamic_attributes_1 = """
+# is_signed
+00
+# value
+ff fe
+"""
+
+data_integer_dynamic_attributes_2 = """
+# is_signed
+01
+# value
+ff fe
+"""
+
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_integer_constant_attributes,
+        'data': data_integer_constant_attributes,
+        'values': { 'a': -1, 'b': 255, 'c': 0x0201, 'd': 0x04030201,
+                    'e': 0x0807060504030201, 'f': -2, 'g': -3, 'h': -4 },
+    }, {
+        'spec': spec_integer_dynamic_attributes,
+        'data': data_integer_dynamic_attributes_1,
+        'values': { 'value': 0xfffe },
+    }, {
+        'spec': spec_integer_dynamic_attributes,
+        'data': data_integer_dynamic_attributes_2,
+        'values': { 'value': -2 },
+    }])
+def params_integer(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_integer(params_integer):
+    params = params_integer
+    dtree, values = params['dtree'], params['values']
+
+    for name, value in values.iteritems():
+        assert getattr(dtree, name) == value
+
+
+#
+# Errors must be reported the same way whether attributes are
+# constant or not
+#
+
+spec_integer_errors = """
+let u = integer { @signed: false; };
+let LE = integer { @signed: false; @endian: 'little'; };
+
+let Schema = struct {
+    no_endian: [2] byte <> u;
+    bad_size: [3] byte <> LE;
+};
+"""
+
+data_integer_errors = """
+00 01 00 01 02
+"""
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_integer_errors,
+        'data': data_integer_errors,
+    }])
+def params_integer_errors(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_integer_errors(params_integer_errors):
+    params = params_integer_errors
+    dtree = params['dtree']
+
+    with pytest.raises(ValueError):
+        print dtree.no_endian
+    with pytest.raises(NotImplementedError):
+        print dtree.bad_size
+
+
+#
+# Bulk read of integer arrays
+#
+
+spec_integer_bulk = """
+let u8 = byte <> integer { @signed: false; };
+let s16be = [2] byte <> integer { @signed: true; @endian: 'big'; };
+let u32le = [4] byte <> integer { @signed: false; @endian: 'little'; };
+let s16dyn = [2] byte <> integer {
+    @signed: true;
+    if (true) {
+        @endian: 'big';
+    }
+};
+
+let Schema = struct {
+    n: u8;
+    a: [n] s16be;
+    b: [n] s16dyn;
+    c: [] u32le;
+};
+"""
+
+data_integer_bulk = """
+# n
+05
+# a
+00 01 ff ff 80 00 7f ff 00 00
+# b
+00 01 ff ff 80 00 7f ff 00 00
+# c
+01 00 00 00 ff ff ff ff 00 00 00 80
+"""
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_integer_bulk,
+        'data': data_integer_bulk,
+    }])
+def params_integer_bulk(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_integer_bulk(params_integer_bulk):
+    params = params_integer_bulk
+    dtree = params['dtree']
+
+    expected_ab = [1, -1, -32768, 32767, 0]
+    # constant attributes (fast path)
+    assert conftest.unpack_int_array(dtree.a.read_int_array()) == expected_ab
+    # conditional attributes (generic path)
+    assert conftest.unpack_int_array(dtree.b.read_int_array()) == expected_ab
+    assert conftest.unpack_int_array(dtree.c.read_int_array()) == \
+        [1, 0xffffffff, 0x80000000]
+
+    assert conftest.unpack_int_array(
+        dtree.a.read_int_array(start=1, count=3)) == \
+        expected_ab[1:4]
+    assert conftest.unpack_int_array(dtree.a.read_int_array(start=3)) == \
+        expected_ab[3:]
+    assert conftest.unpack_int_array(dtree.a.read_int_array(start=10)) == []
+    assert conftest.unpack_int_array(dtree.c.read_int_array(count=0)) == []
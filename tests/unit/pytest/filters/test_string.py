@@ -45,6 +45,67 @@ data_string_table_multi_char_boundary = """
 """
 
 
+spec_string_table_crlf_boundary = """
+let Line = string { @boundary: '\\r\\n'; };
+
+let Schema = struct {
+    string_table: [] Line;
+};
+"""
+
+data_string_table_crlf_boundary = """
+"Bonjour" 0d 0a "Hello" 0d 0a "Guten Tag" 0d 0a "Hola" 0d 0a "Privet" 0d 0a
+"""
+
+spec_string_table_double_nul_boundary = """
+let cstr = string { @boundary: '\\0\\0'; };
+
+let Schema = struct {
+    string_table: [] cstr;
+};
+"""
+
+data_string_table_double_nul_boundary = """
+"Bonjour" 00 00 "Hello" 00 00 "Guten Tag" 00 00 "Hola" 00 00 "Privet"
+"""
+
+
+spec_string_table_regex_boundary_newline = """
+let Line = string { @boundary_regex: '\\r?\\n'; };
+
+let Schema = struct {
+    string_table: [] Line;
+};
+"""
+
+data_string_table_regex_boundary_newline = """
+"Bonjour" 0d 0a "Hello" 0a "Guten Tag" 0d 0a "Hola" 0a "Privet" 0a
+"""
+
+spec_string_table_regex_boundary_separator = """
+let Item = string { @boundary_regex: '[,;]\\\\s*'; };
+
+let Schema = struct {
+    string_table: [] Item;
+};
+"""
+
+data_string_table_regex_boundary_separator = """
+"Bonjour, Hello;Guten Tag;   Hola," 09 "Privet"
+"""
+
+spec_string_table_regex_boundary_nul_run = """
+let cstr = string { @boundary_regex: '\\\\x00+'; };
+
+let Schema = struct {
+    string_table: [] cstr;
+};
+"""
+
+data_string_table_regex_boundary_nul_run = """
+"Bonjour" 00 "Hello" 00 00 00 "Guten Tag" 00 00 "Hola" 00 "Privet" 00
+"""
+
 spec_string_table_dynamic_boundary_1 = """
 let Schema = struct {
     let cstr = string { @boundary: delimiter; };
@@ -148,6 +209,21 @@ data_file_string_table_dynamic_boundary_2_3 = """
     }, {
         'spec': spec_string_table_multi_char_boundary,
         'data': data_string_table_multi_char_boundary,
+    }, {
+        'spec': spec_string_table_crlf_boundary,
+        'data': data_string_table_crlf_boundary,
+    }, {
+        'spec': spec_string_table_double_nul_boundary,
+        'data': data_string_table_double_nul_boundary,
+    }, {
+        'spec': spec_string_table_regex_boundary_newline,
+        'data': data_string_table_regex_boundary_newline,
+    }, {
+        'spec': spec_string_table_regex_boundary_separator,
+        'data': data_string_table_regex_boundary_separator,
+    }, {
+        'spec': spec_string_table_regex_boundary_nul_run,
+        'data': data_string_table_regex_boundary_nul_run,
     }, {
         'spec': spec_string_table_dynamic_boundary_1,
         'data': data_string_table_dynamic_boundary_1,
@@ -178,3 +254,34 @@ def test_string(params_string):
     for i, s in enumerate(dtree.string_table):
         assert model.make_python_object(dtree.string_table) == \
             ['Bonjour', 'Hello', 'Guten Tag', 'Hola', 'Privet']
+
+
+#
+# Regular expression boundaries are checked at compile time
+#
+
+@pytest.fixture(
+    scope='module',
+    params=[
+        # both kinds of boundaries
+        "let S = string { @boundary: ','; @boundary_regex: ',+'; };",
+        # matches an empty string
+        "let S = string { @boundary_regex: ',*'; };",
+        # invalid pattern
+        "let S = string { @boundary_regex: '(,'; };",
+        # not constant
+        "let S = string { if (true) { @boundary_regex: ','; } };",
+    ])
+def params_string_regex_boundary_invalid(request):
+    return request.param
+
+
+def test_string_regex_boundary_invalid(params_string_regex_boundary_invalid):
+    board = model.Board()
+    spec = params_string_regex_boundary_invalid + """
+let Schema = struct {
+    string_table: [] S;
+};
+"""
+    with pytest.raises(OSError):
+        board.add_spec('Spec', spec)
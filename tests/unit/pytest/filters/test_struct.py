@@ -37,3 +37,83 @@ def test_empty_struct(params_empty_struct):
     assert memoryview(dtree.empty) == ''
     assert model.make_python_object(dtree.empty) == {}
     assert dtree.eval_expr('sizeof empty') == 0
+
+
+#
+# Fields following a constant-size prefix are located at a static
+# offset, the remaining ones are browsed from the first variable-size
+# field on
+#
+
+spec_static_offsets = """
+
+let u8 = byte <> integer { @signed: false; };
+let u16 = [2] byte <> integer { @signed: false; @endian: 'big'; };
+
+let Header = struct {
+    magic: [2] byte;
+    version: u8;
+};
+
+let Schema = struct {
+    Header;
+    flags: u8;
+    size: u16;
+    data: [size] byte;
+    if (flags == 1) {
+        extra: u8;
+    }
+    tail: u16;
+    last: u8;
+};
+
+"""
+
+data_static_offsets = """
+# magic, version
+'PK' 03
+# flags
+01
+# size
+00 03
+# data
+'abc'
+# extra
+2a
+# tail
+12 34
+# last
+ff
+"""
+
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_static_offsets,
+        'data': data_static_offsets,
+    }])
+def params_static_offsets(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_static_offsets(params_static_offsets):
+    params = params_static_offsets
+    dtree = params['dtree']
+
+    # direct access in any order
+    assert dtree.size == 3
+    assert dtree.size.get_offset() == 4
+    assert dtree.flags == 1
+    assert dtree.flags.get_offset() == 3
+    assert dtree.data == 'abc'
+    assert dtree.data.get_offset() == 6
+    assert dtree.version == 3
+    assert dtree.magic == 'PK'
+    assert dtree.last == 0xff
+    assert dtree.last.get_offset() == 12
+    assert dtree.tail == 0x1234
+    assert dtree.extra == 42
+    assert dtree.eval_expr('version + flags + size') == 7
+    assert list(dtree.iter_keys()) == ['magic', 'version', 'flags', 'size',
+                                       'data', 'extra', 'tail', 'last']
@@ -166,3 +166,196 @@ def test_varint_in_blocks(params_varint_in_blocks):
     assert model.make_python_object(block0.data) == 'weeeeeeeez'
     block1 = dtree.blocks[1]
     assert model.make_python_object(block1.data) == 'wiiiiiiiiz'
+
+
+#
+# Bulk read of varint arrays
+#
+
+spec_varint_bulk = """
+let u8 = [1] byte <> integer { @signed: false; };
+let vbe = varint { @endian: 'big'; };
+
+let Schema = struct {
+    n: u8;
+    le: [n] varint;
+    be: [n] vbe;
+    slack: [] varint;
+};
+"""
+
+data_varint_bulk = """
+# n
+05
+# le
+00 7f 80 01 ff ff 03 80 80 80 80 80 80 80 80 80 01
+# be
+00 7f 81 00 83 ff 7f 81 80 80 80 80 80 80 80 80 00
+# slack
+01 80 02 ff 7f 00 96 01
+"""
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_varint_bulk,
+        'data': data_varint_bulk,
+    }])
+def params_varint_bulk(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_varint_bulk(params_varint_bulk):
+    params = params_varint_bulk
+    dtree = params['dtree']
+
+    expected = [0, 0x7f, 0x80, 0xffff, -0x8000000000000000]
+    for array in [dtree.le, dtree.be]:
+        assert [n for n in array] == expected
+        assert conftest.unpack_int_array(array.read_int_array()) == expected
+        assert conftest.unpack_int_array(
+            array.read_int_array(start=2, count=2)) == \
+            expected[2:4]
+
+    # slack arrays get their item count from the decoded run
+    expected = [1, 0x100, 0x3fff, 0, 150]
+    assert conftest.unpack_int_array(dtree.slack.read_int_array()) == expected
+    assert len(dtree.slack) == len(expected)
+    assert conftest.unpack_int_array(dtree.slack.read_int_array(start=3)) == \
+        expected[3:]
+
+
+#
+# Signed varints: zigzag (protobuf sint32/sint64) and sign-extended
+# (signed LEB128) encodings
+#
+
+spec_varint_signed = """
+let u8 = [1] byte <> integer { @signed: false; };
+let ZigZag = varint { @zigzag: true; };
+let SLEB128 = varint { @signed: true; };
+let ZigZagBE = varint { @zigzag: true; @endian: 'big'; };
+
+let Schema = struct {
+    zz: ZigZag;
+    sleb: SLEB128;
+    zzbe: ZigZagBE;
+    mode: u8;
+    let Dynamic = varint {
+        if (mode == 1) {
+            @zigzag: true;
+        }
+        if (mode == 2) {
+            @signed: true;
+        }
+    };
+    dyn: Dynamic;
+    n: u8;
+    zz_array: [n] ZigZag;
+    sleb_array: [n] SLEB128;
+};
+"""
+
+data_varint_signed = """
+# zz
+ab 02
+# sleb
+c0 bb 78
+# zzbe
+80 01
+# mode
+{mode}
+# dyn
+7f
+# n
+05
+# zz_array
+00 01 02 03 ff ff ff ff ff ff ff ff ff 01
+# sleb_array
+00 3f 40 7f 80 7f
+"""
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_varint_signed,
+        'data': data_varint_signed.format(mode='00'),
+        'dyn': 127,
+    }, {
+        'spec': spec_varint_signed,
+        'data': data_varint_signed.format(mode='01'),
+        'dyn': -64,
+    }, {
+        'spec': spec_varint_signed,
+        'data': data_varint_signed.format(mode='02'),
+        'dyn': -1,
+    }])
+def params_varint_signed(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_varint_signed(params_varint_signed):
+    params = params_varint_signed
+    dtree = params['dtree']
+
+    assert dtree.zz == -150
+    assert dtree.sleb == -123456
+    assert dtree.zzbe == -1
+    assert dtree.dyn == params['dyn']
+
+    expected_zz = [0, -1, 1, -2, -0x8000000000000000]
+    assert [n for n in dtree.zz_array] == expected_zz
+    assert conftest.unpack_int_array(dtree.zz_array.read_int_array()) == \
+        expected_zz
+    expected_sleb = [0, 63, -64, -1, -128]
+    assert [n for n in dtree.sleb_array] == expected_sleb
+    assert conftest.unpack_int_array(dtree.sleb_array.read_int_array()) == \
+        expected_sleb
+
+
+spec_varint_signed_conflict = """
+let u8 = [1] byte <> integer { @signed: false; };
+
+let Schema = struct {
+    mode: u8;
+    let Dynamic = varint {
+        @signed: true;
+        if (mode == 1) {
+            @zigzag: true;
+        }
+    };
+    value: Dynamic;
+};
+"""
+
+data_varint_signed_conflict = """
+# mode
+01
+# value
+42
+"""
+
+@pytest.fixture(
+    scope='module',
+    params=[{
+        'spec': spec_varint_signed_conflict,
+        'data': data_varint_signed_conflict,
+    }])
+def params_varint_signed_conflict(request):
+    return conftest.make_testcase(request.param)
+
+
+def test_varint_signed_conflict(params_varint_signed_conflict):
+    params = params_varint_signed_conflict
+    dtree = params['dtree']
+
+    # dynamic attributes: error at read time
+    with pytest.raises(ValueError):
+        print dtree.value
+
+    # constant attributes: error at compile time
+    board = model.Board()
+    with pytest.raises(OSError):
+        board.add_spec('Spec', """
+let Schema = varint { @signed: true; @zigzag: true; };
+""")